@@ -25,6 +25,7 @@
 
 #include "FileSystem.h"
 #include "Commandline.h"
+#include "launch/TelemetryRing.h"
 
 BaseInstance::BaseInstance(SettingsObjectPtr globalSettings, SettingsObjectPtr settings, const QString &rootDir)
     : QObject()
@@ -53,6 +54,29 @@ BaseInstance::BaseInstance(SettingsObjectPtr globalSettings, SettingsObjectPtr s
 
     m_settings->registerPassthrough(globalSettings->getSetting("ConsoleMaxLines"), nullptr);
     m_settings->registerPassthrough(globalSettings->getSetting("ConsoleOverflowStop"), nullptr);
+
+    // Supervision, see LaunchTask
+    m_settings->registerSetting("RestartPolicy", "Never");
+    m_settings->registerSetting("RestartBackoffMax", 300);
+    m_settings->registerSetting("CrashLoopRestarts", 5);
+    m_settings->registerSetting("CrashLoopWindow", 600);
+    m_settings->registerSetting("StopTimeout", 30);
+
+    // Resource limits through cgroups, see CGroup
+    m_settings->registerSetting("ResourceLimits", false);
+    m_settings->registerSetting("CpuWeight", 100);
+    m_settings->registerSetting("CpuQuota", 0);
+    m_settings->registerSetting("MemoryMax", 0);
+    m_settings->registerSetting("IoWeight", 100);
+
+    // Sampling of the server process, see ProcessTelemetry
+    m_settings->registerSetting("TelemetryEnabled", true);
+    m_settings->registerSetting("TelemetryInterval", 5);
+    m_settings->registerSetting("TelemetryGcParsing", true);
+
+    // Console commands, see CommandChannel
+    m_settings->registerSetting("CommandRate", 20);
+    m_settings->registerSetting("CommandQueueSize", 1000);
 }
 
 QString BaseInstance::getPreLaunchCommand()
@@ -186,6 +210,15 @@ SettingsObjectPtr BaseInstance::settings() const
     return m_settings;
 }
 
+std::shared_ptr<TelemetryRing> BaseInstance::telemetry()
+{
+    if(!m_telemetry)
+    {
+        m_telemetry = std::make_shared<TelemetryRing>();
+    }
+    return m_telemetry;
+}
+
 bool BaseInstance::canLaunch() const
 {
     return (!hasVersionBroken() && !isRunning());
@@ -34,8 +34,11 @@
 #include "multiservermc_logic_export.h"
 
 #include "minecraft/launch/MinecraftServerTarget.h"
+#include "launch/ResourceUsage.h"
+#include <memory>
 
 class QDir;
+class TelemetryRing;
 class Task;
 class LaunchTask;
 class BaseInstance;
@@ -215,6 +218,20 @@ public:
         }
     }
 
+    /// what the running instance uses, invalid when it is not running or nothing is measured
+    ResourceUsage resourceUsage() const
+    {
+        return m_resourceUsage;
+    }
+    void setResourceUsage(const ResourceUsage &usage)
+    {
+        m_resourceUsage = usage;
+        emit resourceUsageChanged(this);
+    }
+
+    /// telemetry samples of the instance's server process, kept across launches
+    std::shared_ptr<TelemetryRing> telemetry();
+
     virtual bool canLaunch() const;
     virtual bool canEdit() const = 0;
     virtual bool canExport() const = 0;
@@ -242,6 +259,11 @@ signals:
 
     void launchTaskChanged(shared_qobject_ptr<LaunchTask>);
 
+    /*!
+     * \brief Signal emitted for every new sample of the instance's resource usage
+     */
+    void resourceUsageChanged(BaseInstance *inst);
+
     void runningStatusChanged(bool running);
 
     void statusChanged(Status from, Status to);
@@ -262,6 +284,8 @@ private: /* data */
     bool m_crashed = false;
     bool m_hasUpdate = false;
     bool m_hasBrokenVersion = false;
+    ResourceUsage m_resourceUsage;
+    std::shared_ptr<TelemetryRing> m_telemetry;
 };
 
 Q_DECLARE_METATYPE(shared_qobject_ptr<BaseInstance>)
@@ -0,0 +1,319 @@
+#include "DirectoryEventWatcher.h"
+
+#include <QFileSystemWatcher>
+#include <QSocketNotifier>
+#include <QFileInfo>
+#include <QFile>
+#include <QDir>
+#include <QDebug>
+
+#ifdef Q_OS_LINUX
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+namespace {
+#ifdef Q_OS_LINUX
+const uint32_t watchMask =
+    IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_CLOSE_WRITE | IN_ATTRIB |
+    IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+#endif
+}
+
+DirectoryEventWatcher::DirectoryEventWatcher(QObject *parent) : QObject(parent)
+{
+    m_flushTimer.setSingleShot(true);
+    connect(&m_flushTimer, &QTimer::timeout, this, &DirectoryEventWatcher::flush);
+#ifdef Q_OS_LINUX
+    m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if(m_fd >= 0)
+    {
+        m_notifier = new QSocketNotifier(m_fd, QSocketNotifier::Read, this);
+        connect(m_notifier, &QSocketNotifier::activated, this, &DirectoryEventWatcher::readInotifyEvents);
+        return;
+    }
+    qWarning() << "Could not initialize inotify, falling back to directory rescans. errno:" << errno;
+#endif
+    m_fallback = new QFileSystemWatcher(this);
+    connect(m_fallback, &QFileSystemWatcher::directoryChanged, this, &DirectoryEventWatcher::fallbackDirectoryChanged);
+}
+
+DirectoryEventWatcher::~DirectoryEventWatcher()
+{
+#ifdef Q_OS_LINUX
+    if(m_fd >= 0)
+    {
+        delete m_notifier;
+        m_notifier = nullptr;
+        ::close(m_fd);
+        m_fd = -1;
+    }
+#endif
+}
+
+bool DirectoryEventWatcher::providesEvents() const
+{
+    return m_fd >= 0;
+}
+
+void DirectoryEventWatcher::setCoalesceInterval(int msec)
+{
+    m_coalesceInterval = msec;
+}
+
+void DirectoryEventWatcher::setMaximumLatency(int msec)
+{
+    m_maximumLatency = msec;
+}
+
+void DirectoryEventWatcher::setEventLimit(int limit)
+{
+    m_eventLimit = limit;
+}
+
+bool DirectoryEventWatcher::addPath(const QString &path)
+{
+    auto absPath = QFileInfo(path).absoluteFilePath();
+    if(m_fallback)
+    {
+        return m_fallback->addPath(absPath);
+    }
+#ifdef Q_OS_LINUX
+    if(m_pathToWatch.contains(absPath))
+    {
+        return true;
+    }
+    int wd = inotify_add_watch(m_fd, QFile::encodeName(absPath).constData(), watchMask);
+    if(wd < 0)
+    {
+        qWarning() << "Could not watch" << absPath << "errno:" << errno;
+        return false;
+    }
+    m_watchToPath[wd] = absPath;
+    m_pathToWatch[absPath] = wd;
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool DirectoryEventWatcher::removePath(const QString &path)
+{
+    auto absPath = QFileInfo(path).absoluteFilePath();
+    m_pendingEvents.remove(absPath);
+    m_pendingRescans.removeAll(absPath);
+    if(m_fallback)
+    {
+        return m_fallback->removePath(absPath);
+    }
+#ifdef Q_OS_LINUX
+    auto iter = m_pathToWatch.find(absPath);
+    if(iter == m_pathToWatch.end())
+    {
+        return false;
+    }
+    int wd = *iter;
+    m_pathToWatch.erase(iter);
+    m_watchToPath.remove(wd);
+    inotify_rm_watch(m_fd, wd);
+    return true;
+#else
+    return false;
+#endif
+}
+
+QStringList DirectoryEventWatcher::directories() const
+{
+    if(m_fallback)
+    {
+        return m_fallback->directories();
+    }
+    return m_pathToWatch.keys();
+}
+
+void DirectoryEventWatcher::readInotifyEvents()
+{
+#ifdef Q_OS_LINUX
+    alignas(alignof(struct inotify_event)) char buffer[16384];
+    while(true)
+    {
+        ssize_t length = ::read(m_fd, buffer, sizeof(buffer));
+        if(length <= 0)
+        {
+            break;
+        }
+        char *ptr = buffer;
+        while(ptr < buffer + length)
+        {
+            auto event = reinterpret_cast<const struct inotify_event *>(ptr);
+            ptr += sizeof(struct inotify_event) + event->len;
+
+            if(event->mask & IN_Q_OVERFLOW)
+            {
+                // we lost track, everything has to be listed again
+                for(auto & path: m_pathToWatch.keys())
+                {
+                    queueRescan(path);
+                }
+                continue;
+            }
+
+            auto pathIter = m_watchToPath.find(event->wd);
+            if(pathIter == m_watchToPath.end())
+            {
+                continue;
+            }
+            QString path = *pathIter;
+
+            if(event->mask & IN_IGNORED)
+            {
+                // the kernel dropped the watch (directory deleted or unmounted)
+                m_watchToPath.remove(event->wd);
+                m_pathToWatch.remove(path);
+                queueRescan(path);
+                continue;
+            }
+            if(event->mask & (IN_DELETE_SELF | IN_MOVE_SELF))
+            {
+                queueRescan(path);
+                continue;
+            }
+            if(!event->len)
+            {
+                continue;
+            }
+            QString name = QFile::decodeName(event->name);
+            if(event->mask & IN_MOVED_FROM)
+            {
+                m_pendingMoves[event->cookie] = {path, name};
+                scheduleFlush();
+            }
+            else if(event->mask & IN_MOVED_TO)
+            {
+                auto moveIter = m_pendingMoves.find(event->cookie);
+                if(moveIter != m_pendingMoves.end())
+                {
+                    auto from = *moveIter;
+                    m_pendingMoves.erase(moveIter);
+                    if(from.path == path)
+                    {
+                        queueEvent(path, {DirectoryEvent::Renamed, name, from.name});
+                    }
+                    else
+                    {
+                        queueEvent(from.path, {DirectoryEvent::Removed, from.name, QString()});
+                        queueEvent(path, {DirectoryEvent::Created, name, QString()});
+                    }
+                }
+                else
+                {
+                    queueEvent(path, {DirectoryEvent::Created, name, QString()});
+                }
+            }
+            else if(event->mask & IN_CREATE)
+            {
+                queueEvent(path, {DirectoryEvent::Created, name, QString()});
+            }
+            else if(event->mask & IN_DELETE)
+            {
+                queueEvent(path, {DirectoryEvent::Removed, name, QString()});
+            }
+            else if(event->mask & (IN_CLOSE_WRITE | IN_ATTRIB))
+            {
+                queueEvent(path, {DirectoryEvent::Modified, name, QString()});
+            }
+        }
+    }
+#endif
+}
+
+void DirectoryEventWatcher::fallbackDirectoryChanged(const QString &path)
+{
+    queueRescan(path);
+}
+
+void DirectoryEventWatcher::queueEvent(const QString &path, const DirectoryEvent &event)
+{
+    if(m_pendingRescans.contains(path))
+    {
+        // already going to list the whole thing
+        return;
+    }
+    auto & events = m_pendingEvents[path];
+    if(event.type == DirectoryEvent::Modified && !events.isEmpty())
+    {
+        // a file being written triggers lots of these, one is enough
+        auto & last = events.last();
+        if(last.name == event.name && (last.type == DirectoryEvent::Modified || last.type == DirectoryEvent::Created))
+        {
+            scheduleFlush();
+            return;
+        }
+    }
+    events.append(event);
+    if(events.size() > m_eventLimit)
+    {
+        queueRescan(path);
+        return;
+    }
+    scheduleFlush();
+}
+
+void DirectoryEventWatcher::queueRescan(const QString &path)
+{
+    m_pendingEvents.remove(path);
+    if(!m_pendingRescans.contains(path))
+    {
+        m_pendingRescans.append(path);
+    }
+    scheduleFlush();
+}
+
+void DirectoryEventWatcher::scheduleFlush()
+{
+    if(!m_flushTimer.isActive())
+    {
+        m_firstPending.start();
+    }
+    else if(m_firstPending.elapsed() >= m_maximumLatency)
+    {
+        // keep the running timer, it will fire soon enough
+        return;
+    }
+    m_flushTimer.start(m_coalesceInterval);
+}
+
+void DirectoryEventWatcher::flushMoves()
+{
+    // whatever was moved out and did not come back into a watched directory is gone
+    for(auto & move: m_pendingMoves)
+    {
+        queueEvent(move.path, {DirectoryEvent::Removed, move.name, QString()});
+    }
+    m_pendingMoves.clear();
+}
+
+void DirectoryEventWatcher::flush()
+{
+    flushMoves();
+    m_flushTimer.stop();
+
+    auto rescans = m_pendingRescans;
+    auto events = m_pendingEvents;
+    m_pendingRescans.clear();
+    m_pendingEvents.clear();
+
+    for(auto & path: rescans)
+    {
+        emit rescanRequired(path);
+    }
+    for(auto iter = events.begin(); iter != events.end(); iter++)
+    {
+        if(iter->isEmpty())
+        {
+            continue;
+        }
+        emit eventsReady(iter.key(), *iter);
+    }
+}
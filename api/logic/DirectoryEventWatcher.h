@@ -0,0 +1,105 @@
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QTimer>
+#include <QElapsedTimer>
+
+#include "multiservermc_logic_export.h"
+
+class QFileSystemWatcher;
+class QSocketNotifier;
+
+/**
+ * A single change to an entry of a watched directory.
+ *
+ * Names are relative to the watched directory.
+ */
+struct DirectoryEvent
+{
+    enum Type
+    {
+        Created,
+        Removed,
+        Modified,
+        Renamed
+    };
+    Type type;
+    QString name;
+    // only used by Renamed
+    QString oldName;
+};
+
+/**
+ * Watches directories (non-recursively) and reports what changed inside of them.
+ *
+ * On Linux, this uses inotify directly so the names and kinds of changes are known.
+ * Bursts of events are coalesced and delivered together once the directory goes quiet
+ * (or the maximum latency is reached).
+ *
+ * If the precise events are not available (other platforms, inotify queue overflow,
+ * too many changes at once, the directory itself was moved), rescanRequired is emitted
+ * instead and the consumer should fall back to listing the directory.
+ */
+class MULTISERVERMC_LOGIC_EXPORT DirectoryEventWatcher : public QObject
+{
+    Q_OBJECT
+public:
+    explicit DirectoryEventWatcher(QObject *parent = nullptr);
+    virtual ~DirectoryEventWatcher();
+
+    bool addPath(const QString &path);
+    bool removePath(const QString &path);
+    QStringList directories() const;
+
+    /// Time without new events after which the pending events are delivered
+    void setCoalesceInterval(int msec);
+    /// Upper bound on how long events are held back while the directory keeps changing
+    void setMaximumLatency(int msec);
+    /// Number of pending events for a directory above which a rescan is requested instead
+    void setEventLimit(int limit);
+
+    /// true if the precise per-entry events are available
+    bool providesEvents() const;
+
+signals:
+    void eventsReady(const QString &path, const QList<DirectoryEvent> &events);
+    void rescanRequired(const QString &path);
+
+private slots:
+    void readInotifyEvents();
+    void fallbackDirectoryChanged(const QString &path);
+    void flush();
+
+private:
+    void queueEvent(const QString &path, const DirectoryEvent &event);
+    void queueRescan(const QString &path);
+    void scheduleFlush();
+    void flushMoves();
+
+private:
+    struct PendingMove
+    {
+        QString path;
+        QString name;
+    };
+
+    int m_fd = -1;
+    QSocketNotifier *m_notifier = nullptr;
+    QFileSystemWatcher *m_fallback = nullptr;
+
+    QHash<int, QString> m_watchToPath;
+    QHash<QString, int> m_pathToWatch;
+
+    QHash<quint32, PendingMove> m_pendingMoves;
+    QHash<QString, QList<DirectoryEvent>> m_pendingEvents;
+    QStringList m_pendingRescans;
+
+    QTimer m_flushTimer;
+    QElapsedTimer m_firstPending;
+    int m_coalesceInterval = 150;
+    int m_maximumLatency = 1000;
+    int m_eventLimit = 2000;
+};
@@ -10,6 +10,7 @@
 #include "tasks/Task.h"
 #include "meta/Index.h"
 #include "FileSystem.h"
+#include "java/JavaProbeCache.h"
 #include <QDebug>
 
 
@@ -19,6 +20,7 @@ struct Env::Private
     shared_qobject_ptr<HttpMetaCache> m_metacache;
     std::shared_ptr<IIconList> m_iconlist;
     shared_qobject_ptr<Meta::Index> m_metadataIndex;
+    std::shared_ptr<JavaProbeCache> m_javaProbeCache;
     QString m_jarsPath;
     QSet<QString> m_features;
 };
@@ -83,6 +85,14 @@ shared_qobject_ptr<Meta::Index> Env::metadataIndex()
     return d->m_metadataIndex;
 }
 
+std::shared_ptr<JavaProbeCache> Env::javaProbeCache()
+{
+    if (!d->m_javaProbeCache)
+    {
+        d->m_javaProbeCache = std::make_shared<JavaProbeCache>(QDir("cache").absoluteFilePath("javaprobes.cache"));
+    }
+    return d->m_javaProbeCache;
+}
 
 void Env::initHttpMetaCache()
 {
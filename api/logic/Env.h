@@ -13,6 +13,7 @@ class QNetworkAccessManager;
 class HttpMetaCache;
 class BaseVersionList;
 class BaseVersion;
+class JavaProbeCache;
 
 namespace Meta
 {
@@ -52,6 +53,9 @@ public:
 
     shared_qobject_ptr<Meta::Index> metadataIndex();
 
+    /// Results of probing java binaries, shared by everything that checks java
+    std::shared_ptr<JavaProbeCache> javaProbeCache();
+
     QString getJarsPath();
     void setJarsPath(const QString & path);
 
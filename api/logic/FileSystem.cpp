@@ -10,6 +10,10 @@
 #include <QUrl>
 #include <QStandardPaths>
 #include <QTextStream>
+#include <algorithm>
+
+#include "tasks/ConcurrentProgress.h"
+#include "tasks/ParallelJobs.h"
 
 #if defined Q_OS_WIN32
     #include <windows.h>
@@ -23,6 +27,15 @@
     #include <shlobj.h>
 #else
     #include <utime.h>
+    #include <unistd.h>
+#endif
+
+#if defined Q_OS_LINUX
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <sys/ioctl.h>
+    #include <sys/stat.h>
+    #include <linux/fs.h>
 #endif
 
 namespace FS {
@@ -105,21 +118,30 @@ bool ensureFolderPathExists(QString foldernamepath)
     return success;
 }
 
-bool copy::operator()(const QString &offset)
-{
-    //NOTE always deep copy on windows. the alternatives are too messy.
-    #if defined Q_OS_WIN32
-    m_followSymlinks = true;
-    #endif
+namespace {
 
-    auto src = PathCombine(m_src.absolutePath(), offset);
-    auto dst = PathCombine(m_dst.absolutePath(), offset);
+struct CopyJob
+{
+    QString src;
+    QString dst;
+    qint64 size;
+    bool hardlink;
+};
+
+/*
+ * Walks the source tree, creates the folders and symlinks and collects the files to copy.
+ */
+bool collectCopyJobs(const QDir &srcRoot, const QDir &dstRoot, const QString &offset, bool followSymlinks,
+                     const IPathMatcher * blacklist, const IPathMatcher * hardlinks, QList<CopyJob> &jobs)
+{
+    auto src = PathCombine(srcRoot.absolutePath(), offset);
+    auto dst = PathCombine(dstRoot.absolutePath(), offset);
 
     QFileInfo currentSrc(src);
     if (!currentSrc.exists())
         return false;
 
-    if(!m_followSymlinks && currentSrc.isSymLink())
+    if(!followSymlinks && currentSrc.isSymLink())
     {
         qDebug() << "creating symlink" << src << " - " << dst;
         if (!ensureFilePathExists(dst))
@@ -131,13 +153,13 @@ bool copy::operator()(const QString &offset)
     }
     else if(currentSrc.isFile())
     {
-        qDebug() << "copying file" << src << " - " << dst;
         if (!ensureFilePathExists(dst))
         {
             qWarning() << "Cannot create path!";
             return false;
         }
-        return QFile::copy(src, dst);
+        bool hardlink = hardlinks && hardlinks->matches(offset);
+        jobs.append({src, dst, currentSrc.size(), hardlink});
     }
     else if(currentSrc.isDir())
     {
@@ -152,11 +174,11 @@ bool copy::operator()(const QString &offset)
         {
             auto inner_offset = PathCombine(offset, f);
             // ignore and skip stuff that matches the blacklist.
-            if(m_blacklist && m_blacklist->matches(inner_offset))
+            if(blacklist && blacklist->matches(inner_offset))
             {
                 continue;
             }
-            if(!operator()(inner_offset))
+            if(!collectCopyJobs(srcRoot, dstRoot, inner_offset, followSymlinks, blacklist, hardlinks, jobs))
             {
                 qWarning() << "Failed to copy" << inner_offset;
                 return false;
@@ -171,6 +193,172 @@ bool copy::operator()(const QString &offset)
     return true;
 }
 
+bool runCopyJob(const CopyJob & job)
+{
+#if !defined Q_OS_WIN32
+    if(job.hardlink)
+    {
+        if(::link(QFile::encodeName(job.src).constData(), QFile::encodeName(job.dst).constData()) == 0)
+        {
+            return true;
+        }
+        // different filesystem, or not supported by it
+        qDebug() << "Could not hard link" << job.src << "- copying instead";
+    }
+#endif
+    if(!copyFile(job.src, job.dst))
+    {
+        qWarning() << "Failed to copy file" << job.src << "to" << job.dst;
+        return false;
+    }
+    return true;
+}
+
+}
+
+bool copy::operator()()
+{
+    //NOTE always deep copy on windows. the alternatives are too messy.
+    #if defined Q_OS_WIN32
+    m_followSymlinks = true;
+    #endif
+
+    QList<CopyJob> jobs;
+    if(!collectCopyJobs(m_src, m_dst, QString(), m_followSymlinks, m_blacklist, m_hardlinks, jobs))
+    {
+        return false;
+    }
+
+    if(m_progress)
+    {
+        qint64 totalBytes = 0;
+        for(auto & job: jobs)
+        {
+            totalBytes += job.size;
+        }
+        m_progress->addTotal(totalBytes);
+    }
+
+    auto copyJob = [&](int index) -> bool
+    {
+        auto & job = jobs.at(index);
+        if(!runCopyJob(job))
+        {
+            return false;
+        }
+        if(m_progress)
+        {
+            m_progress->addDone(job.size);
+        }
+        return true;
+    };
+    return ParallelJobs::run(jobs.size(), copyJob, m_progress, m_threads);
+}
+
+bool copyFile(const QString &src, const QString &dst)
+{
+#if defined Q_OS_LINUX
+    int in = ::open(QFile::encodeName(src).constData(), O_RDONLY | O_CLOEXEC);
+    if(in < 0)
+    {
+        return false;
+    }
+    struct stat st;
+    if(::fstat(in, &st) != 0)
+    {
+        ::close(in);
+        return false;
+    }
+    int out = ::open(QFile::encodeName(dst).constData(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, st.st_mode & 07777);
+    if(out < 0)
+    {
+        ::close(in);
+        return false;
+    }
+
+    bool ok = false;
+#if defined FICLONE
+    // copy-on-write clone, on btrfs, XFS and the like, this does not copy any data at all
+    ok = ::ioctl(out, FICLONE, in) == 0;
+#endif
+    if(!ok)
+    {
+        off_t remaining = st.st_size;
+        bool inKernel = true;
+        ok = true;
+        while(remaining > 0)
+        {
+            ssize_t copied = -1;
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27))
+            if(inKernel)
+            {
+                copied = ::copy_file_range(in, nullptr, out, nullptr, remaining, 0);
+                if(copied < 0 && (errno == EXDEV || errno == ENOSYS || errno == EINVAL || errno == EOPNOTSUPP))
+                {
+                    // both files keep their offsets, continue with the plain copy below
+                    inKernel = false;
+                    continue;
+                }
+            }
+            else
+#endif
+            {
+                inKernel = false;
+                char buffer[128 * 1024];
+                ssize_t got = ::read(in, buffer, std::min<off_t>(sizeof(buffer), remaining));
+                copied = got;
+                for(ssize_t written = 0; got > 0 && written < got;)
+                {
+                    ssize_t result = ::write(out, buffer + written, got - written);
+                    if(result < 0)
+                    {
+                        if(errno == EINTR)
+                        {
+                            continue;
+                        }
+                        copied = -1;
+                        break;
+                    }
+                    written += result;
+                }
+            }
+            if(copied < 0)
+            {
+                if(errno == EINTR)
+                {
+                    continue;
+                }
+                ok = false;
+                break;
+            }
+            if(copied == 0)
+            {
+                // the file got shorter while we were copying it
+                break;
+            }
+            remaining -= copied;
+        }
+    }
+    if(ok)
+    {
+        // same as QFile::copy, the permissions should not be affected by umask
+        ::fchmod(out, st.st_mode & 07777);
+    }
+    ::close(in);
+    if(::close(out) != 0)
+    {
+        ok = false;
+    }
+    if(!ok)
+    {
+        ::unlink(QFile::encodeName(dst).constData());
+    }
+    return ok;
+#else
+    return QFile::copy(src, dst);
+#endif
+}
+
 bool deletePath(QString path)
 {
     bool OK = true;
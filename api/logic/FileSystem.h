@@ -9,6 +9,8 @@
 #include <QDir>
 #include <QFlags>
 
+class ConcurrentProgress;
+
 namespace FS
 {
 
@@ -45,6 +47,13 @@ MULTISERVERMC_LOGIC_EXPORT bool ensureFilePathExists(QString filenamepath);
  */
 MULTISERVERMC_LOGIC_EXPORT bool ensureFolderPathExists(QString filenamepath);
 
+/**
+ * Copy a file or a folder tree
+ *
+ * Folders and symlinks are created first, then the files are copied on a pool of worker threads.
+ * On Linux, files are reflinked (copy-on-write clones) when the filesystem supports it and
+ * copied in-kernel with copy_file_range otherwise. Everything else falls back to a buffered copy.
+ */
 class MULTISERVERMC_LOGIC_EXPORT copy
 {
 public:
@@ -63,21 +72,47 @@ public:
         m_blacklist = filter;
         return *this;
     }
-    bool operator()()
+    /**
+     * Hard link the files matching the filter instead of copying them.
+     *
+     * Only use this for content that is never modified in place, like libraries and mods,
+     * as the copy and the original will share the same data.
+     */
+    copy & hardlinks(const IPathMatcher * filter)
     {
-        return operator()(QString());
+        m_hardlinks = filter;
+        return *this;
     }
-
-private:
-    bool operator()(const QString &offset);
+    /// Report the copied bytes to, and check for cancellation in, the given progress object
+    copy & reportTo(ConcurrentProgress * progress)
+    {
+        m_progress = progress;
+        return *this;
+    }
+    /// Number of files copied at the same time, 0 for one per CPU core
+    copy & threads(int threads)
+    {
+        m_threads = threads;
+        return *this;
+    }
+    bool operator()();
 
 private:
     bool m_followSymlinks = true;
     const IPathMatcher * m_blacklist = nullptr;
+    const IPathMatcher * m_hardlinks = nullptr;
+    ConcurrentProgress * m_progress = nullptr;
+    int m_threads = 0;
     QDir m_src;
     QDir m_dst;
 };
 
+/**
+ * Copy a single file, using the fastest method the platform and filesystem support.
+ * The destination must not exist.
+ */
+MULTISERVERMC_LOGIC_EXPORT bool copyFile(const QString &src, const QString &dst);
+
 /**
  * Delete a folder recursively
  */
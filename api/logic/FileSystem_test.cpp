@@ -4,6 +4,7 @@
 #include "TestUtil.h"
 
 #include "FileSystem.h"
+#include "tasks/ConcurrentProgress.h"
 
 class FileSystemTest : public QObject
 {
@@ -111,6 +112,35 @@ slots:
         f();
     }
 
+    void test_copyParallel()
+    {
+        QTemporaryDir sourceDir;
+        QTemporaryDir targetDir;
+        QByteArray contents(100 * 1024, 'x');
+        for(int i = 0; i < 50; i++)
+        {
+            FS::write(FS::PathCombine(sourceDir.path(), "sub", QString("file%1").arg(i)), contents);
+        }
+
+        ConcurrentProgress progress;
+        FS::copy c(sourceDir.path(), FS::PathCombine(targetDir.path(), "copy"));
+        c.threads(4).reportTo(&progress);
+        QVERIFY(c());
+
+        QDir copied(FS::PathCombine(targetDir.path(), "copy", "sub"));
+        QCOMPARE(copied.entryList(QDir::Files).size(), 50);
+        QCOMPARE(FS::read(copied.absoluteFilePath("file7")), contents);
+        QCOMPARE(progress.done(), qint64(50 * contents.size()));
+        QCOMPARE(progress.total(), qint64(50 * contents.size()));
+
+        // a canceled copy fails
+        ConcurrentProgress canceled;
+        canceled.cancel();
+        FS::copy c2(sourceDir.path(), FS::PathCombine(targetDir.path(), "copy2"));
+        c2.reportTo(&canceled);
+        QVERIFY(!c2());
+    }
+
     void test_getDesktop()
     {
         QCOMPARE(FS::getDesktopDir(), QStandardPaths::writableLocation(QStandardPaths::DesktopLocation));
@@ -5,7 +5,7 @@
 #include "pathmatcher/RegexpMatcher.h"
 #include <QtConcurrentRun>
 
-InstanceCopyTask::InstanceCopyTask(InstancePtr origInstance, bool copySaves, bool keepPlaytime)
+InstanceCopyTask::InstanceCopyTask(InstancePtr origInstance, bool copySaves, bool keepPlaytime, bool linkReadOnly)
 {
     m_origInstance = origInstance;
     m_keepPlaytime = keepPlaytime;
@@ -17,16 +17,47 @@ InstanceCopyTask::InstanceCopyTask(InstancePtr origInstance, bool copySaves, boo
         matcherReal->caseSensitive(false);
         m_matcher.reset(matcherReal);
     }
+
+    if(linkReadOnly)
+    {
+        // content that is only ever replaced as a whole, never modified in place
+        m_linkMatcher.reset(new RegexpMatcher("^(libraries|jarmods|[.]?minecraft/(mods|coremods))/"));
+    }
+}
+
+bool InstanceCopyTask::canAbort() const
+{
+    return m_copyProgress != nullptr;
+}
+
+bool InstanceCopyTask::abort()
+{
+    if(!m_copyProgress)
+    {
+        return false;
+    }
+    m_copyProgress->cancel();
+    return true;
 }
 
 void InstanceCopyTask::executeTask()
 {
     setStatus(tr("Copying instance %1").arg(m_origInstance->name()));
+    // pending settings changes of the original have to be in the copy
+    m_origInstance->settings()->saveNow();
+
+    m_copyProgress = std::make_shared<ConcurrentProgress>();
+    connect(m_copyProgress.get(), &ConcurrentProgress::progress, this, &InstanceCopyTask::setProgress);
 
     FS::copy folderCopy(m_origInstance->instanceRoot(), m_stagingPath);
-    folderCopy.followSymlinks(false).blacklist(m_matcher.get());
+    folderCopy.followSymlinks(false).blacklist(m_matcher.get()).hardlinks(m_linkMatcher.get()).reportTo(m_copyProgress.get());
 
-    m_copyFuture = QtConcurrent::run(QThreadPool::globalInstance(), folderCopy);
+    // the progress object has to outlive the copy, even if this task does not
+    auto progress = m_copyProgress;
+    m_copyFuture = QtConcurrent::run(QThreadPool::globalInstance(), [folderCopy, progress]() mutable
+    {
+        return folderCopy();
+    });
     connect(&m_copyFutureWatcher, &QFutureWatcher<bool>::finished, this, &InstanceCopyTask::copyFinished);
     connect(&m_copyFutureWatcher, &QFutureWatcher<bool>::canceled, this, &InstanceCopyTask::copyAborted);
     m_copyFutureWatcher.setFuture(m_copyFuture);
@@ -34,6 +65,13 @@ void InstanceCopyTask::executeTask()
 
 void InstanceCopyTask::copyFinished()
 {
+    bool canceled = m_copyProgress->isCanceled();
+    m_copyProgress.reset();
+    if(canceled)
+    {
+        emitAborted();
+        return;
+    }
     auto successful = m_copyFuture.result();
     if(!successful)
     {
@@ -10,12 +10,16 @@
 #include "BaseVersion.h"
 #include "BaseInstance.h"
 #include "InstanceTask.h"
+#include "tasks/ConcurrentProgress.h"
 
 class MULTISERVERMC_LOGIC_EXPORT InstanceCopyTask : public InstanceTask
 {
     Q_OBJECT
 public:
-    explicit InstanceCopyTask(InstancePtr origInstance, bool copySaves, bool keepPlaytime);
+    explicit InstanceCopyTask(InstancePtr origInstance, bool copySaves, bool keepPlaytime, bool linkReadOnly);
+
+    bool canAbort() const override;
+    bool abort() override;
 
 protected:
     //! Entry point for tasks.
@@ -28,5 +32,7 @@ private: /* data */
     QFuture<bool> m_copyFuture;
     QFutureWatcher<bool> m_copyFutureWatcher;
     std::unique_ptr<IPathMatcher> m_matcher;
+    std::unique_ptr<IPathMatcher> m_linkMatcher;
+    std::shared_ptr<ConcurrentProgress> m_copyProgress;
     bool m_keepPlaytime;
 };
@@ -38,6 +38,21 @@ InstanceImportTask::InstanceImportTask(const QUrl sourceUrl)
     m_sourceUrl = sourceUrl;
 }
 
+bool InstanceImportTask::canAbort() const
+{
+    return m_extractState != nullptr;
+}
+
+bool InstanceImportTask::abort()
+{
+    if(!m_extractState)
+    {
+        return false;
+    }
+    m_extractState->cancel();
+    return true;
+}
+
 void InstanceImportTask::executeTask()
 {
     if (m_sourceUrl.isLocalFile())
@@ -81,6 +96,18 @@ void InstanceImportTask::downloadProgressChanged(qint64 current, qint64 total)
     setProgress(current / 2, total);
 }
 
+void InstanceImportTask::extractProgressChanged(qint64 current, qint64 total)
+{
+    if(m_downloadRequired)
+    {
+        setProgress(total / 2 + current / 2, total);
+    }
+    else
+    {
+        setProgress(current, total);
+    }
+}
+
 void InstanceImportTask::processZipPack()
 {
     setStatus(tr("Extracting modpack"));
@@ -129,7 +156,15 @@ void InstanceImportTask::processZipPack()
     }
 
     // make sure we extract just the pack
-    m_extractFuture = QtConcurrent::run(QThreadPool::globalInstance(), MSMCZip::extractSubDir, m_packZip.get(), root, extractDir.absolutePath());
+    m_extractState = std::make_shared<MSMCZip::ExtractState>();
+    connect(m_extractState.get(), &MSMCZip::ExtractState::progress, this, &InstanceImportTask::extractProgressChanged);
+    auto zip = m_packZip.get();
+    auto state = m_extractState;
+    auto target = extractDir.absolutePath();
+    m_extractFuture = QtConcurrent::run(QThreadPool::globalInstance(), [zip, root, target, state]()
+    {
+        return MSMCZip::extractSubDir(zip, root, target, state.get());
+    });
     connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::finished, this, &InstanceImportTask::extractFinished);
     connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::canceled, this, &InstanceImportTask::extractAborted);
     m_extractFutureWatcher.setFuture(m_extractFuture);
@@ -138,6 +173,13 @@ void InstanceImportTask::processZipPack()
 void InstanceImportTask::extractFinished()
 {
     m_packZip.reset();
+    bool canceled = m_extractState->isCanceled();
+    m_extractState.reset();
+    if (canceled)
+    {
+        emitAborted();
+        return;
+    }
     if (!m_extractFuture.result())
     {
         emitFailed(tr("Failed to extract modpack"));
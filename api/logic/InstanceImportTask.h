@@ -31,6 +31,10 @@ namespace Flame
 {
     class FileResolvingTask;
 }
+namespace MSMCZip
+{
+    class ExtractState;
+}
 
 class MULTISERVERMC_LOGIC_EXPORT InstanceImportTask : public InstanceTask
 {
@@ -38,6 +42,9 @@ class MULTISERVERMC_LOGIC_EXPORT InstanceImportTask : public InstanceTask
 public:
     explicit InstanceImportTask(const QUrl sourceUrl);
 
+    bool canAbort() const override;
+    bool abort() override;
+
 protected:
     //! Entry point for tasks.
     virtual void executeTask() override;
@@ -52,6 +59,7 @@ private slots:
     void downloadSucceeded();
     void downloadFailed(QString reason);
     void downloadProgressChanged(qint64 current, qint64 total);
+    void extractProgressChanged(qint64 current, qint64 total);
     void extractFinished();
     void extractAborted();
 
@@ -64,6 +72,7 @@ private: /* data */
     std::unique_ptr<QuaZip> m_packZip;
     QFuture<nonstd::optional<QStringList>> m_extractFuture;
     QFutureWatcher<nonstd::optional<QStringList>> m_extractFutureWatcher;
+    std::shared_ptr<MSMCZip::ExtractState> m_extractState;
     enum class ModpackType{
         Unknown,
         MultiServerMC,
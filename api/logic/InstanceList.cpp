@@ -14,7 +14,6 @@
  */
 
 #include <QDir>
-#include <QDirIterator>
 #include <QSet>
 #include <QFile>
 #include <QThread>
@@ -22,11 +21,12 @@
 #include <QXmlStreamReader>
 #include <QTimer>
 #include <QDebug>
-#include <QFileSystemWatcher>
 #include <QUuid>
+#include <QDateTime>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QtConcurrentMap>
 
 #include "InstanceList.h"
 #include "BaseInstance.h"
@@ -52,16 +52,22 @@ InstanceList::InstanceList(SettingsObjectPtr settings, const QString & instDir,
     }
 
     connect(this, &InstanceList::instancesChanged, this, &InstanceList::providerUpdated);
+    connect(&m_probeWatcher, &QFutureWatcher<InstanceStub>::resultsReadyAt, this, &InstanceList::instancesProbed);
+    connect(&m_probeWatcher, &QFutureWatcher<InstanceStub>::finished, this, &InstanceList::probingFinished);
 
     // NOTE: canonicalPath requires the path to exist. Do not move this above the creation block!
     m_instDir = QDir(instDir).canonicalPath();
-    m_watcher = new QFileSystemWatcher(this);
-    connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &InstanceList::instanceDirContentsChanged);
+    m_watcher = new DirectoryEventWatcher(this);
+    connect(m_watcher, &DirectoryEventWatcher::rescanRequired, this, &InstanceList::instanceDirContentsChanged);
+    connect(m_watcher, &DirectoryEventWatcher::eventsReady, this, &InstanceList::instanceDirEvents);
     m_watcher->addPath(m_instDir);
 }
 
 InstanceList::~InstanceList()
 {
+    m_loading = false;
+    m_probeWatcher.cancel();
+    m_probeWatcher.waitForFinished();
 }
 
 int InstanceList::rowCount(const QModelIndex &parent) const
@@ -107,7 +113,38 @@ QVariant InstanceList::data(const QModelIndex &index, int role) const
     }
     case Qt::ToolTipRole:
     {
-        return pdata->instanceRoot();
+        auto usage = pdata->resourceUsage();
+        if(!usage.valid)
+        {
+            return pdata->instanceRoot();
+        }
+        return tr("%1\nCPU: %2%, memory: %3 MiB, disk read/written: %4/%5 MiB").arg(pdata->instanceRoot())
+            .arg(usage.cpuPercent, 0, 'f', 1)
+            .arg(usage.memoryBytes / (1024 * 1024))
+            .arg(usage.ioReadBytes / (1024 * 1024))
+            .arg(usage.ioWriteBytes / (1024 * 1024));
+    }
+    case CpuUsageRole:
+    case MemoryUsageRole:
+    case IoReadRole:
+    case IoWriteRole:
+    {
+        auto usage = pdata->resourceUsage();
+        if(!usage.valid)
+        {
+            return QVariant();
+        }
+        switch(role)
+        {
+            case CpuUsageRole:
+                return usage.cpuPercent;
+            case MemoryUsageRole:
+                return usage.memoryBytes;
+            case IoReadRole:
+                return usage.ioReadBytes;
+            default:
+                return usage.ioWriteBytes;
+        }
     }
     case Qt::DecorationRole:
     {
@@ -280,59 +317,246 @@ static QMap<InstanceId, InstanceLocator> getIdMapping(const QList<InstancePtr> &
     return out;
 }
 
-QList< InstanceId > InstanceList::discoverInstances()
+namespace {
+// Reads an instance folder, runs on the worker threads
+struct InstanceProbe
 {
-    qDebug() << "Discovering instances in" << m_instDir;
-    QList<InstanceId> out;
-    QDirIterator iter(m_instDir, QDir::Dirs | QDir::NoDot | QDir::NoDotDot | QDir::Readable | QDir::Hidden, QDirIterator::FollowSymlinks);
-    while (iter.hasNext())
+    typedef InstanceStub result_type;
+
+    QString instDir;
+    std::shared_ptr<const InstanceListSnapshot> snapshot;
+
+    InstanceStub operator()(const InstanceId &id) const
     {
-        QString subDir = iter.next();
-        QFileInfo dirInfo(subDir);
-        if (!QFileInfo(FS::PathCombine(subDir, "instance.cfg")).exists())
-            continue;
+        InstanceStub stub;
+        stub.id = id;
+        QString subDir = FS::PathCombine(instDir, id);
+        QString configPath = FS::PathCombine(subDir, "instance.cfg");
+        QFileInfo configInfo(configPath);
+        if (!configInfo.exists())
+            return stub;
         // if it is a symlink, ignore it if it goes to the instance folder
+        QFileInfo dirInfo(subDir);
         if(dirInfo.isSymLink())
         {
             QFileInfo targetInfo(dirInfo.symLinkTarget());
-            QFileInfo instDirInfo(m_instDir);
+            QFileInfo instDirInfo(instDir);
             if(targetInfo.canonicalPath() == instDirInfo.canonicalFilePath())
             {
                 qDebug() << "Ignoring symlink" << subDir << "that leads into the instances folder";
-                continue;
+                return stub;
             }
         }
-        auto id = dirInfo.fileName();
-        out.append(id);
-        qDebug() << "Found instance ID" << id;
+        stub.configModified = configInfo.lastModified().toMSecsSinceEpoch();
+        stub.configSize = configInfo.size();
+        auto cached = snapshot ? snapshot->validEntry(id, configInfo) : nullptr;
+        if(cached)
+        {
+            stub.config = cached->config;
+            stub.fromSnapshot = true;
+        }
+        else
+        {
+            stub.config.loadFile(configPath);
+        }
+        stub.valid = true;
+        return stub;
     }
-    instanceSet = out.toSet();
-    m_instancesProbed = true;
-    return out;
+};
+}
+
+QList< InstanceId > InstanceList::discoverInstances()
+{
+    qDebug() << "Discovering instances in" << m_instDir;
+    // only the directory listing happens here, the folders are checked by probeInstances
+    m_discoveredDirModified = QFileInfo(m_instDir).lastModified().toMSecsSinceEpoch();
+    QDir instDir(m_instDir);
+    return instDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::Readable | QDir::Hidden);
+}
+
+QFuture<InstanceStub> InstanceList::probeInstances(const QList<InstanceId> &ids)
+{
+    InstanceProbe probe;
+    probe.instDir = m_instDir;
+    probe.snapshot = m_snapshot;
+    return QtConcurrent::mapped(ids, probe);
 }
 
 InstanceList::InstListError InstanceList::loadList()
 {
-    auto existingIds = getIdMapping(m_instances);
+    if(m_loading)
+    {
+        // take over from the background load, whatever it already added is kept
+        m_loading = false;
+        m_probeWatcher.cancel();
+        m_probeWatcher.waitForFinished();
+    }
 
-    QList<InstancePtr> newList;
+    loadSnapshot();
+    auto future = probeInstances(discoverInstances());
+    future.waitForFinished();
+    auto stubs = future.results();
 
-    for(auto & id: discoverInstances())
+    m_loadingKnownIds = getIdMapping(m_instances).keys().toSet();
+    addProbed(stubs);
+    finishLoading(stubs);
+    return NoError;
+}
+
+void InstanceList::loadListAsync()
+{
+    if(m_loading)
     {
-        if(existingIds.contains(id))
+        return;
+    }
+    m_loading = true;
+    loadSnapshot();
+    m_loadingKnownIds = getIdMapping(m_instances).keys().toSet();
+    auto ids = discoverInstances();
+    if(m_snapshot && m_instances.isEmpty() && m_snapshot->instanceDirModified() == m_discoveredDirModified)
+    {
+        // nothing was added or removed since the snapshot was taken, show it while the configs are checked
+        QList<InstanceStub> stubs;
+        for(auto & id: m_snapshot->ids())
         {
-            auto instPair = existingIds[id];
-            existingIds.remove(id);
-            qDebug() << "Should keep and soft-reload" << id;
+            auto entry = m_snapshot->entry(id);
+            InstanceStub stub;
+            stub.id = id;
+            stub.config = entry->config;
+            stub.configModified = entry->configModified;
+            stub.configSize = entry->configSize;
+            stub.valid = true;
+            stub.fromSnapshot = true;
+            stubs.append(stub);
+            m_unverifiedIds.insert(id);
         }
-        else
+        addProbed(stubs);
+        qDebug() << "Showing" << stubs.size() << "instances from the instance list snapshot";
+    }
+    m_probeWatcher.setFuture(probeInstances(ids));
+}
+
+void InstanceList::loadSnapshot()
+{
+    if(m_snapshotLoaded || m_snapshotPath.isEmpty())
+    {
+        return;
+    }
+    m_snapshotLoaded = true;
+    auto snapshot = std::make_shared<InstanceListSnapshot>();
+    if(snapshot->load(m_snapshotPath, m_instDir))
+    {
+        m_snapshot = snapshot;
+    }
+}
+
+void InstanceList::updateSnapshot(const QList<InstanceStub> &stubs)
+{
+    QHash<InstanceId, const InstanceStub *> stubsById;
+    for(auto & stub: stubs)
+    {
+        if(stub.valid)
         {
-            InstancePtr instPtr = loadInstance(id);
-            if(instPtr)
+            stubsById.insert(stub.id, &stub);
+        }
+    }
+    auto snapshot = std::make_shared<InstanceListSnapshot>();
+    snapshot->setInstanceDir(m_instDir, m_discoveredDirModified);
+    for(auto & instance: m_instances)
+    {
+        auto stub = stubsById.value(instance->id());
+        if(!stub)
+        {
+            continue;
+        }
+        InstanceListSnapshot::Entry entry;
+        entry.configModified = stub->configModified;
+        entry.configSize = stub->configSize;
+        entry.config = stub->config;
+        snapshot->insert(stub->id, entry);
+    }
+    if(!m_snapshotPath.isEmpty() && (!m_snapshot || *m_snapshot != *snapshot))
+    {
+        snapshot->save(m_snapshotPath);
+    }
+    m_snapshot = snapshot;
+}
+
+void InstanceList::instancesProbed(int begin, int end)
+{
+    if(!m_loading)
+    {
+        return;
+    }
+    QList<InstanceStub> stubs;
+    for(int i = begin; i < end; i++)
+    {
+        stubs.append(m_probeWatcher.resultAt(i));
+    }
+    addProbed(stubs);
+}
+
+void InstanceList::probingFinished()
+{
+    if(!m_loading)
+    {
+        return;
+    }
+    m_loading = false;
+    finishLoading(m_probeWatcher.future().results());
+}
+
+void InstanceList::addProbed(const QList<InstanceStub> &stubs)
+{
+    QList<InstancePtr> newList;
+    for(auto & stub: stubs)
+    {
+        if(!stub.valid)
+        {
+            continue;
+        }
+        if(m_loadingKnownIds.contains(stub.id))
+        {
+            if(m_unverifiedIds.remove(stub.id) && !stub.fromSnapshot)
             {
-                newList.append(instPtr);
+                // the snapshot was out of date for this one
+                auto inst = getInstanceById(stub.id);
+                auto settings = std::dynamic_pointer_cast<INISettingsObject>(inst->settings());
+                if(settings)
+                {
+                    settings->setContents(stub.config);
+                    propertiesChanged(inst.get());
+                }
+                continue;
             }
+            qDebug() << "Should keep and soft-reload" << stub.id;
+            continue;
         }
+        m_loadingKnownIds.insert(stub.id);
+        InstancePtr instPtr = loadInstance(stub);
+        if(instPtr)
+        {
+            newList.append(instPtr);
+        }
+    }
+    if(newList.size())
+    {
+        add(newList);
+    }
+}
+
+void InstanceList::finishLoading(const QList<InstanceStub> &stubs)
+{
+    auto existingIds = getIdMapping(m_instances);
+    QSet<InstanceId> found;
+    for(auto & stub: stubs)
+    {
+        if(!stub.valid)
+        {
+            continue;
+        }
+        found.insert(stub.id);
+        existingIds.remove(stub.id);
     }
 
     // TODO: looks like a general algorithm with a few specifics inserted. Do something about it.
@@ -383,12 +607,13 @@ InstanceList::InstListError InstanceList::loadList()
             removeNow();
         }
     }
-    if(newList.size())
-    {
-        add(newList);
-    }
+    instanceSet = found;
+    m_instancesProbed = true;
+    m_loadingKnownIds.clear();
+    m_unverifiedIds.clear();
+    updateSnapshot(stubs);
     m_dirty = false;
-    return NoError;
+    emit loadingFinished();
 }
 
 void InstanceList::saveNow()
@@ -406,6 +631,7 @@ void InstanceList::add(const QList<InstancePtr> &t)
     for(auto & ptr : t)
     {
         connect(ptr.get(), &BaseInstance::propertiesChanged, this, &InstanceList::propertiesChanged);
+        connect(ptr.get(), &BaseInstance::resourceUsageChanged, this, &InstanceList::resourceUsageChanged);
     }
     endInsertRows();
 }
@@ -479,15 +705,26 @@ void InstanceList::propertiesChanged(BaseInstance *inst)
     }
 }
 
-InstancePtr InstanceList::loadInstance(const InstanceId& id)
+void InstanceList::resourceUsageChanged(BaseInstance *inst)
+{
+    int i = getInstIndex(inst);
+    if (i != -1)
+    {
+        emit dataChanged(index(i), index(i), {Qt::ToolTipRole, CpuUsageRole, MemoryUsageRole, IoReadRole, IoWriteRole});
+    }
+}
+
+InstancePtr InstanceList::loadInstance(const InstanceStub& stub)
 {
     if(!m_groupsLoaded)
     {
         loadGroupList();
     }
 
-    auto instanceRoot = FS::PathCombine(m_instDir, id);
-    auto instanceSettings = std::make_shared<INISettingsObject>(FS::PathCombine(instanceRoot, "instance.cfg"));
+    auto instanceRoot = FS::PathCombine(m_instDir, stub.id);
+    auto instanceSettings = std::make_shared<INISettingsObject>(FS::PathCombine(instanceRoot, "instance.cfg"), stub.config);
+    // lives as long as the instance, changes like the play time are written together
+    instanceSettings->setSaveDelay(250);
     InstancePtr inst;
 
     instanceSettings->registerSetting("InstanceType", "Legacy");
@@ -674,10 +911,147 @@ void InstanceList::loadGroupList()
 
 void InstanceList::instanceDirContentsChanged(const QString& path)
 {
-    Q_UNUSED(path);
+    if(path != m_instDir)
+    {
+        // one of the new folders we were waiting on, see if it became an instance
+        auto id = QFileInfo(path).fileName();
+        if(updateInstances({}, {id}))
+        {
+            saveGroupList();
+        }
+        return;
+    }
     emit instancesChanged();
 }
 
+void InstanceList::instanceDirEvents(const QString& path, const QList<DirectoryEvent>& events)
+{
+    if(m_loading)
+    {
+        // do not mix with a load in progress, it may have already passed the changed folders
+        instanceDirContentsChanged(m_instDir);
+        return;
+    }
+    if(path != m_instDir)
+    {
+        instanceDirContentsChanged(path);
+        return;
+    }
+    QSet<InstanceId> removed;
+    QSet<InstanceId> candidates;
+    for(auto & event: events)
+    {
+        switch(event.type)
+        {
+            case DirectoryEvent::Removed:
+                removed.insert(event.name);
+                candidates.remove(event.name);
+                break;
+            case DirectoryEvent::Renamed:
+            {
+                removed.insert(event.oldName);
+                candidates.remove(event.oldName);
+                candidates.insert(event.name);
+                removed.remove(event.name);
+                // the instance keeps its group when its folder is renamed
+                auto groupIter = m_instanceGroupIndex.find(event.oldName);
+                if(groupIter != m_instanceGroupIndex.end())
+                {
+                    m_instanceGroupIndex[event.name] = *groupIter;
+                    m_instanceGroupIndex.remove(event.oldName);
+                }
+                break;
+            }
+            case DirectoryEvent::Created:
+            case DirectoryEvent::Modified:
+                candidates.insert(event.name);
+                removed.remove(event.name);
+                break;
+        }
+    }
+    if(updateInstances(removed, candidates))
+    {
+        saveGroupList();
+    }
+}
+
+bool InstanceList::updateInstances(const QSet<InstanceId> &removed, const QSet<InstanceId> &candidates)
+{
+    bool groupsChanged = false;
+
+    // folders that are no more (or no longer instances)
+    for(auto & id: removed)
+    {
+        if(m_pendingDirs.remove(id))
+        {
+            m_watcher->removePath(FS::PathCombine(m_instDir, id));
+        }
+        if(QFileInfo(FS::PathCombine(m_instDir, id, "instance.cfg")).exists())
+        {
+            continue;
+        }
+        auto inst = getInstanceById(id);
+        if(!inst)
+        {
+            continue;
+        }
+        int row = getInstIndex(inst.get());
+        qDebug() << "Instance" << id << "is gone";
+        beginRemoveRows(QModelIndex(), row, row);
+        m_instances.removeAt(row);
+        endRemoveRows();
+        inst->invalidate();
+        instanceSet.remove(id);
+        groupsChanged |= m_instanceGroupIndex.contains(id);
+    }
+
+    // new folders, the ones that are instances get added
+    InstanceProbe probe;
+    probe.instDir = m_instDir;
+    probe.snapshot = m_snapshot;
+    QList<InstancePtr> newList;
+    for(auto & id: candidates)
+    {
+        if(getInstanceById(id))
+        {
+            continue;
+        }
+        QString dirPath = FS::PathCombine(m_instDir, id);
+        QFileInfo dirInfo(dirPath);
+        if(!dirInfo.isDir() || id == "_MSMC_TEMP")
+        {
+            continue;
+        }
+        auto stub = probe(id);
+        if(!stub.valid)
+        {
+            // probably still being copied in, wait for the config to appear
+            if(!m_pendingDirs.contains(id) && m_watcher->addPath(dirPath))
+            {
+                m_pendingDirs.insert(id);
+            }
+            continue;
+        }
+        if(m_pendingDirs.remove(id))
+        {
+            m_watcher->removePath(dirPath);
+        }
+        qDebug() << "New instance" << id;
+        auto inst = loadInstance(stub);
+        if(inst)
+        {
+            newList.append(inst);
+            instanceSet.insert(id);
+            groupsChanged |= m_instanceGroupIndex.contains(id);
+        }
+    }
+    if(newList.size())
+    {
+        add(newList);
+    }
+    return groupsChanged;
+}
+
 void InstanceList::on_InstFolderChanged(const Setting &setting, QVariant value)
 {
     QString newInstDir = QDir(value.toString()).canonicalPath();
@@ -687,7 +1061,14 @@ void InstanceList::on_InstFolderChanged(const Setting &setting, QVariant value)
         {
             saveGroupList();
         }
+        m_watcher->removePath(m_instDir);
+        for(auto & id: m_pendingDirs)
+        {
+            m_watcher->removePath(FS::PathCombine(m_instDir, id));
+        }
+        m_pendingDirs.clear();
         m_instDir = newInstDir;
+        m_watcher->addPath(m_instDir);
         m_groupsLoaded = false;
         emit instancesChanged();
     }
@@ -835,9 +1216,9 @@ bool InstanceList::commitStagedInstance(const QString& path, const QString& inst
             return false;
         }
         m_instanceGroupIndex[instID] = groupName;
-        instanceSet.insert(instID);
         m_groupNameCache.insert(groupName);
-        emit instancesChanged();
+        // only the new instance is loaded, no need to go over the whole folder again
+        updateInstances({}, {instID});
         emit instanceSelectRequest(instID);
     }
     saveGroupList();
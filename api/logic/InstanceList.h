@@ -19,19 +19,38 @@
 #include <QAbstractListModel>
 #include <QSet>
 #include <QList>
+#include <QFutureWatcher>
 
 #include "BaseInstance.h"
+#include "settings/INIFile.h"
+#include "InstanceListSnapshot.h"
+#include "DirectoryEventWatcher.h"
 
 #include "multiservermc_logic_export.h"
 
 #include "QObjectPtr.h"
 
-class QFileSystemWatcher;
 class InstanceTask;
 using InstanceId = QString;
 using GroupId = QString;
 using InstanceLocator = std::pair<InstancePtr, int>;
 
+/**
+ * What is read from an instance folder before the instance itself is created.
+ *
+ * Produced on worker threads, turned into the real instance on the GUI thread.
+ */
+struct InstanceStub
+{
+    InstanceId id;
+    INIFile config;
+    qint64 configModified = 0;
+    qint64 configSize = 0;
+    bool valid = false;
+    // config taken from the snapshot instead of parsing the file
+    bool fromSnapshot = false;
+};
+
 enum class InstCreateError
 {
     NoCreateError = 0,
@@ -69,7 +88,11 @@ public:
     {
         GroupRole = Qt::UserRole,
         InstancePointerRole = 0x34B1CB48, ///< Return pointer to real instance
-        InstanceIDRole = 0x34B1CB49 ///< Return id if the instance
+        InstanceIDRole = 0x34B1CB49, ///< Return id if the instance
+        CpuUsageRole = 0x34B1CB4A, ///< Percent of one CPU the running instance uses, invalid when not measured
+        MemoryUsageRole = 0x34B1CB4B, ///< Bytes of memory charged to the running instance
+        IoReadRole = 0x34B1CB4C, ///< Bytes the running instance read from disk
+        IoWriteRole = 0x34B1CB4D ///< Bytes the running instance wrote to disk
     };
     /*!
      * \brief Error codes returned by functions in the InstanceList class.
@@ -92,9 +115,27 @@ public:
         return m_instances.count();
     }
 
+    /// Load the instance list, block until it is done
     InstListError loadList();
+    /// Start loading the instance list in the background, instances are added as they are read
+    void loadListAsync();
+    bool isLoading() const
+    {
+        return m_loading;
+    }
     void saveNow();
 
+    /**
+     * Keep a snapshot of the instance list in the file at path.
+     *
+     * loadListAsync() then shows the instances from it right away when the instance folder did not change,
+     * and instance.cfg files that did not change are not parsed again.
+     */
+    void setSnapshotPath(const QString &path)
+    {
+        m_snapshotPath = path;
+    }
+
 
     InstancePtr getInstanceById(QString id) const;
     QModelIndex getInstanceIndexById(const QString &id) const;
@@ -133,6 +174,7 @@ signals:
     void instancesChanged();
     void instanceSelectRequest(QString instanceId);
     void groupsChanged(QSet<QString> groups);
+    void loadingFinished();
 
 public slots:
     void on_InstFolderChanged(const Setting &setting, QVariant value);
@@ -140,8 +182,12 @@ public slots:
 
 private slots:
     void propertiesChanged(BaseInstance *inst);
+    void resourceUsageChanged(BaseInstance *inst);
     void providerUpdated();
     void instanceDirContentsChanged(const QString &path);
+    void instanceDirEvents(const QString &path, const QList<DirectoryEvent> &events);
+    void instancesProbed(int begin, int end);
+    void probingFinished();
 
 private:
     int getInstIndex(BaseInstance *inst) const;
@@ -151,7 +197,14 @@ private:
     void loadGroupList();
     void saveGroupList();
     QList<InstanceId> discoverInstances();
-    InstancePtr loadInstance(const InstanceId& id);
+    QFuture<InstanceStub> probeInstances(const QList<InstanceId> &ids);
+    void addProbed(const QList<InstanceStub> &stubs);
+    void finishLoading(const QList<InstanceStub> &stubs);
+    void loadSnapshot();
+    void updateSnapshot(const QList<InstanceStub> &stubs);
+    /// Add and remove single instances, returns true if the group list needs saving
+    bool updateInstances(const QSet<InstanceId> &removed, const QSet<InstanceId> &candidates);
+    InstancePtr loadInstance(const InstanceStub& stub);
 
 private:
     int m_watchLevel = 0;
@@ -161,11 +214,24 @@ private:
 
     SettingsObjectPtr m_globalSettings;
     QString m_instDir;
-    QFileSystemWatcher * m_watcher;
+    DirectoryEventWatcher * m_watcher;
+    // new folders without an instance.cfg yet, watched until one shows up
+    QSet<InstanceId> m_pendingDirs;
     // FIXME: this is so inefficient that looking at it is almost painful.
     QSet<QString> m_collapsedGroups;
     QMap<InstanceId, GroupId> m_instanceGroupIndex;
     QSet<InstanceId> instanceSet;
     bool m_groupsLoaded = false;
     bool m_instancesProbed = false;
+
+    bool m_loading = false;
+    QSet<InstanceId> m_loadingKnownIds;
+    QFutureWatcher<InstanceStub> m_probeWatcher;
+    qint64 m_discoveredDirModified = 0;
+
+    QString m_snapshotPath;
+    bool m_snapshotLoaded = false;
+    std::shared_ptr<const InstanceListSnapshot> m_snapshot;
+    // instances shown from the snapshot that were not checked against their files yet
+    QSet<InstanceId> m_unverifiedIds;
 };
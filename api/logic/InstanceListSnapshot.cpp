@@ -0,0 +1,147 @@
+#include "InstanceListSnapshot.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+
+#include "FileSystem.h"
+
+namespace {
+const quint32 SNAPSHOT_MAGIC = 0x4d534c53; // "MSLS"
+const quint32 SNAPSHOT_VERSION = 1;
+}
+
+bool InstanceListSnapshot::load(const QString &path, const QString &instDir)
+{
+    QByteArray data;
+    try
+    {
+        data = FS::read(path);
+    }
+    catch (const FS::FileSystemException &)
+    {
+        return false;
+    }
+
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_5_6);
+    quint32 magic = 0, version = 0;
+    in >> magic >> version;
+    if(magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION)
+    {
+        qDebug() << "Ignoring instance list snapshot" << path << "with unknown format";
+        return false;
+    }
+
+    QString snapshotInstDir;
+    qint64 instDirModified = 0;
+    quint32 count = 0;
+    in >> snapshotInstDir >> instDirModified >> count;
+    if(snapshotInstDir != instDir)
+    {
+        qDebug() << "Ignoring instance list snapshot" << path << "taken for" << snapshotInstDir;
+        return false;
+    }
+
+    QStringList ids;
+    QHash<QString, Entry> entries;
+    for(quint32 i = 0; i < count && in.status() == QDataStream::Ok; i++)
+    {
+        QString id;
+        Entry entry;
+        QMap<QString, QVariant> config;
+        in >> id >> entry.configModified >> entry.configSize >> config;
+        for(auto iter = config.begin(); iter != config.end(); iter++)
+        {
+            entry.config.insert(iter.key(), iter.value());
+        }
+        ids.append(id);
+        entries.insert(id, entry);
+    }
+    if(in.status() != QDataStream::Ok)
+    {
+        qWarning() << "Instance list snapshot" << path << "is truncated or corrupted";
+        return false;
+    }
+
+    m_instDir = snapshotInstDir;
+    m_instDirModified = instDirModified;
+    m_ids = ids;
+    m_entries = entries;
+    return true;
+}
+
+bool InstanceListSnapshot::save(const QString &path) const
+{
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_6);
+    out << SNAPSHOT_MAGIC << SNAPSHOT_VERSION;
+    out << m_instDir << m_instDirModified << quint32(m_ids.size());
+    for(auto & id: m_ids)
+    {
+        const auto entry = m_entries.value(id);
+        out << id << entry.configModified << entry.configSize << static_cast<const QMap<QString, QVariant> &>(entry.config);
+    }
+    try
+    {
+        FS::write(path, data);
+    }
+    catch (const FS::FileSystemException &e)
+    {
+        qWarning() << "Failed to write instance list snapshot:" << e.cause();
+        return false;
+    }
+    return true;
+}
+
+void InstanceListSnapshot::insert(const QString &id, const Entry &entry)
+{
+    if(!m_entries.contains(id))
+    {
+        m_ids.append(id);
+    }
+    m_entries.insert(id, entry);
+}
+
+const InstanceListSnapshot::Entry *InstanceListSnapshot::entry(const QString &id) const
+{
+    auto iter = m_entries.find(id);
+    if(iter == m_entries.end())
+    {
+        return nullptr;
+    }
+    return &(*iter);
+}
+
+const InstanceListSnapshot::Entry *InstanceListSnapshot::validEntry(const QString &id, const QFileInfo &configInfo) const
+{
+    auto found = entry(id);
+    if(!found)
+    {
+        return nullptr;
+    }
+    if(found->configModified != configInfo.lastModified().toMSecsSinceEpoch() || found->configSize != configInfo.size())
+    {
+        return nullptr;
+    }
+    return found;
+}
+
+bool InstanceListSnapshot::operator==(const InstanceListSnapshot &other) const
+{
+    if(m_instDir != other.m_instDir || m_instDirModified != other.m_instDirModified || m_ids != other.m_ids)
+    {
+        return false;
+    }
+    for(auto & id: m_ids)
+    {
+        const auto a = m_entries.value(id);
+        const auto b = other.m_entries.value(id);
+        if(a.configModified != b.configModified || a.configSize != b.configSize || a.config != b.config)
+        {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QFileInfo>
+
+#include "settings/INIFile.h"
+
+#include "multiservermc_logic_export.h"
+
+/**
+ * Compact binary copy of what the instance list reads from the instance folders.
+ *
+ * Lets the instance list show up right away on startup and skip parsing the instance.cfg
+ * files that did not change since the last run. An entry is only trusted while its
+ * instance.cfg still has the same modification time and size.
+ */
+class MULTISERVERMC_LOGIC_EXPORT InstanceListSnapshot
+{
+public:
+    struct Entry
+    {
+        qint64 configModified = 0;
+        qint64 configSize = 0;
+        INIFile config;
+    };
+
+    /// Read a snapshot, fails if it is unreadable, from an incompatible version or for a different folder
+    bool load(const QString &path, const QString &instDir);
+    bool save(const QString &path) const;
+
+    void setInstanceDir(const QString &instDir, qint64 modified)
+    {
+        m_instDir = instDir;
+        m_instDirModified = modified;
+    }
+    QString instanceDir() const
+    {
+        return m_instDir;
+    }
+    /// Modification time of the instance folder when the snapshot was taken
+    qint64 instanceDirModified() const
+    {
+        return m_instDirModified;
+    }
+
+    void insert(const QString &id, const Entry &entry);
+    /// Instance IDs in the order they were inserted
+    QStringList ids() const
+    {
+        return m_ids;
+    }
+    const Entry *entry(const QString &id) const;
+    /// The snapshot entry for id if the config file described by configInfo did not change since
+    const Entry *validEntry(const QString &id, const QFileInfo &configInfo) const;
+
+    bool operator==(const InstanceListSnapshot &other) const;
+    bool operator!=(const InstanceListSnapshot &other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    QString m_instDir;
+    qint64 m_instDirModified = 0;
+    QStringList m_ids;
+    QHash<QString, Entry> m_entries;
+};
@@ -0,0 +1,102 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QSignalSpy>
+#include "TestUtil.h"
+
+#include "FileSystem.h"
+#include "InstanceList.h"
+#include "settings/INISettingsObject.h"
+
+class InstanceListBench : public QObject
+{
+    Q_OBJECT
+
+    SettingsObjectPtr makeGlobalSettings(const QString &path)
+    {
+        auto settings = std::make_shared<INISettingsObject>(FS::PathCombine(path, "global.cfg"));
+        settings->registerSetting("PreLaunchCommand", "");
+        settings->registerSetting("WrapperCommand", "");
+        settings->registerSetting("PostExitCommand", "");
+        settings->registerSetting("ShowConsole", false);
+        settings->registerSetting("AutoCloseConsole", false);
+        settings->registerSetting("ShowConsoleOnError", true);
+        settings->registerSetting("LogPrePostOutput", true);
+        settings->registerSetting("ConsoleMaxLines", 100000);
+        settings->registerSetting("ConsoleOverflowStop", true);
+        return settings;
+    }
+
+    void makeInstances(const QString &instDir, int count)
+    {
+        for(int i = 0; i < count; i++)
+        {
+            QString config = QString("InstanceType=Null\nname=Instance %1\niconKey=default\ntotalTimePlayed=1234\n").arg(i);
+            FS::write(FS::PathCombine(instDir, QString("inst%1").arg(i, 4, 10, QChar('0')), "instance.cfg"), config.toUtf8());
+        }
+    }
+
+private
+slots:
+    void bench_loadList_data()
+    {
+        QTest::addColumn<bool>("useSnapshot");
+        QTest::newRow("cold") << false;
+        QTest::newRow("snapshot") << true;
+    }
+    void bench_loadList()
+    {
+        QFETCH(bool, useSnapshot);
+        QTemporaryDir tempDir;
+        QString instDir = FS::PathCombine(tempDir.path(), "instances");
+        QString snapshotPath = FS::PathCombine(tempDir.path(), "instancelist.snapshot");
+        makeInstances(instDir, 1000);
+        auto globalSettings = makeGlobalSettings(tempDir.path());
+        if(useSnapshot)
+        {
+            InstanceList list(globalSettings, instDir);
+            list.setSnapshotPath(snapshotPath);
+            list.loadList();
+        }
+
+        // time until the whole list is there
+        QBENCHMARK
+        {
+            InstanceList list(globalSettings, instDir);
+            if(useSnapshot)
+            {
+                list.setSnapshotPath(snapshotPath);
+            }
+            list.loadList();
+            QCOMPARE(list.count(), 1000);
+        }
+    }
+
+    void bench_firstRows()
+    {
+        QTemporaryDir tempDir;
+        QString instDir = FS::PathCombine(tempDir.path(), "instances");
+        QString snapshotPath = FS::PathCombine(tempDir.path(), "instancelist.snapshot");
+        makeInstances(instDir, 1000);
+        auto globalSettings = makeGlobalSettings(tempDir.path());
+        {
+            InstanceList list(globalSettings, instDir);
+            list.setSnapshotPath(snapshotPath);
+            list.loadList();
+        }
+
+        // the snapshot is shown right away, the rest of the time is the background check
+        QBENCHMARK
+        {
+            InstanceList list(globalSettings, instDir);
+            list.setSnapshotPath(snapshotPath);
+            QSignalSpy spy(&list, &InstanceList::loadingFinished);
+            list.loadListAsync();
+            QCOMPARE(list.count(), 1000);
+            spy.wait(10000);
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(InstanceListBench)
+
+#include "InstanceList_bench.moc"
@@ -0,0 +1,157 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QSignalSpy>
+#include "TestUtil.h"
+
+#include "FileSystem.h"
+#include "InstanceList.h"
+#include "settings/INISettingsObject.h"
+
+class InstanceListTest : public QObject
+{
+    Q_OBJECT
+
+    SettingsObjectPtr makeGlobalSettings(const QString &path)
+    {
+        auto settings = std::make_shared<INISettingsObject>(FS::PathCombine(path, "global.cfg"));
+        settings->registerSetting("PreLaunchCommand", "");
+        settings->registerSetting("WrapperCommand", "");
+        settings->registerSetting("PostExitCommand", "");
+        settings->registerSetting("ShowConsole", false);
+        settings->registerSetting("AutoCloseConsole", false);
+        settings->registerSetting("ShowConsoleOnError", true);
+        settings->registerSetting("LogPrePostOutput", true);
+        settings->registerSetting("ConsoleMaxLines", 100000);
+        settings->registerSetting("ConsoleOverflowStop", true);
+        return settings;
+    }
+
+    void writeInstance(const QString &instDir, const QString &id, const QString &name)
+    {
+        QString config = QString("InstanceType=Null\nname=%1\niconKey=default\ntotalTimePlayed=1234\n").arg(name);
+        FS::write(FS::PathCombine(instDir, id, "instance.cfg"), config.toUtf8());
+    }
+
+    void makeInstances(const QString &instDir, int count)
+    {
+        for(int i = 0; i < count; i++)
+        {
+            writeInstance(instDir, QString("inst%1").arg(i, 4, 10, QChar('0')), QString("Instance %1").arg(i));
+        }
+    }
+
+private
+slots:
+    void test_loadList()
+    {
+        QTemporaryDir tempDir;
+        QString instDir = FS::PathCombine(tempDir.path(), "instances");
+        makeInstances(instDir, 20);
+        // not an instance
+        FS::ensureFolderPathExists(FS::PathCombine(instDir, "junk"));
+
+        InstanceList list(makeGlobalSettings(tempDir.path()), instDir);
+        QCOMPARE(list.loadList(), InstanceList::NoError);
+        QCOMPARE(list.count(), 20);
+        QVERIFY(list.getInstanceById("inst0007"));
+        QCOMPARE(list.getInstanceById("inst0007")->name(), QString("Instance 7"));
+        QVERIFY(!list.getInstanceById("junk"));
+    }
+
+    void test_loadListAsync()
+    {
+        QTemporaryDir tempDir;
+        QString instDir = FS::PathCombine(tempDir.path(), "instances");
+        makeInstances(instDir, 50);
+
+        InstanceList list(makeGlobalSettings(tempDir.path()), instDir);
+        QSignalSpy spy(&list, &InstanceList::loadingFinished);
+        list.loadListAsync();
+        QVERIFY(list.isLoading());
+        QVERIFY(spy.wait(10000));
+        QVERIFY(!list.isLoading());
+        QCOMPARE(list.count(), 50);
+    }
+
+    void test_incrementalUpdates()
+    {
+        QTemporaryDir tempDir;
+        QString instDir = FS::PathCombine(tempDir.path(), "instances");
+        makeInstances(instDir, 5);
+
+        InstanceList list(makeGlobalSettings(tempDir.path()), instDir);
+        list.loadList();
+        QCOMPARE(list.count(), 5);
+        auto kept = list.getInstanceById("inst0001");
+
+        QSignalSpy insertSpy(&list, &QAbstractItemModel::rowsInserted);
+        writeInstance(instDir, "added", "Added instance");
+        QVERIFY(insertSpy.wait(5000));
+        QCOMPARE(list.count(), 6);
+        QVERIFY(list.getInstanceById("added"));
+
+        QSignalSpy removeSpy(&list, &QAbstractItemModel::rowsRemoved);
+        QVERIFY(FS::deletePath(FS::PathCombine(instDir, "inst0002")));
+        QVERIFY(removeSpy.wait(5000));
+        QCOMPARE(list.count(), 5);
+        QVERIFY(!list.getInstanceById("inst0002"));
+
+        // the instances that did not change are the same objects
+        QCOMPARE(list.getInstanceById("inst0001"), kept);
+    }
+
+    void test_snapshot()
+    {
+        QTemporaryDir tempDir;
+        QString instDir = FS::PathCombine(tempDir.path(), "instances");
+        QString snapshotPath = FS::PathCombine(tempDir.path(), "cache", "instancelist.snapshot");
+        makeInstances(instDir, 10);
+        auto globalSettings = makeGlobalSettings(tempDir.path());
+
+        {
+            InstanceList list(globalSettings, instDir);
+            list.setSnapshotPath(snapshotPath);
+            list.loadList();
+            QCOMPARE(list.count(), 10);
+        }
+        QVERIFY(QFileInfo(snapshotPath).exists());
+
+        // changing a config does not change the instance folder, the snapshot is used and then corrected
+        writeInstance(instDir, "inst0003", "Renamed instance");
+        {
+            InstanceList list(globalSettings, instDir);
+            list.setSnapshotPath(snapshotPath);
+            QSignalSpy spy(&list, &InstanceList::loadingFinished);
+            list.loadListAsync();
+            QCOMPARE(list.count(), 10);
+            QVERIFY(spy.wait(10000));
+            QCOMPARE(list.count(), 10);
+            QCOMPARE(list.getInstanceById("inst0003")->name(), QString("Renamed instance"));
+        }
+
+        // a new instance changes the folder, the snapshot is not shown but still used for the unchanged configs
+        writeInstance(instDir, "inst0100", "New instance");
+        {
+            InstanceList list(globalSettings, instDir);
+            list.setSnapshotPath(snapshotPath);
+            QSignalSpy spy(&list, &InstanceList::loadingFinished);
+            list.loadListAsync();
+            QVERIFY(spy.wait(10000));
+            QCOMPARE(list.count(), 11);
+            QCOMPARE(list.getInstanceById("inst0100")->name(), QString("New instance"));
+        }
+
+        // a broken snapshot is ignored
+        FS::write(snapshotPath, "garbage");
+        {
+            InstanceList list(globalSettings, instDir);
+            list.setSnapshotPath(snapshotPath);
+            list.loadList();
+            QCOMPARE(list.count(), 11);
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(InstanceListTest)
+
+#include "InstanceList_test.moc"
@@ -1,6 +1,13 @@
 #include "LoggedProcess.h"
 #include "MessageLevel.h"
 #include <QDebug>
+#include <QFile>
+
+#if defined(Q_OS_UNIX)
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#endif
 
 LoggedProcess::LoggedProcess(QObject *parent) : QProcess(parent)
 {
@@ -10,6 +17,9 @@ LoggedProcess::LoggedProcess(QObject *parent) : QProcess(parent)
     connect(this, SIGNAL(finished(int,QProcess::ExitStatus)), SLOT(on_exit(int,QProcess::ExitStatus)));
     connect(this, SIGNAL(error(QProcess::ProcessError)), this, SLOT(on_error(QProcess::ProcessError)));
     connect(this, &QProcess::stateChanged, this, &LoggedProcess::on_stateChange);
+
+    m_stop_timer.setSingleShot(true);
+    connect(&m_stop_timer, &QTimer::timeout, this, &LoggedProcess::escalateStop);
 }
 
 LoggedProcess::~LoggedProcess()
@@ -63,8 +73,16 @@ void LoggedProcess::on_exit(int exit_code, QProcess::ExitStatus status)
         m_out_leftover.clear();
     }
 
+    m_stop_timer.stop();
+
     // based on state, send signals
-    if (!m_is_aborting)
+    if (m_is_stopping && !m_is_aborting)
+    {
+        //: Message displayed after the instance exits due to a stop request
+        emit log({tr("Process stopped with code %1.").arg(exit_code)}, MessageLevel::MultiServerMC);
+        changeState(LoggedProcess::Finished);
+    }
+    else if (!m_is_aborting)
     {
         if (status == QProcess::NormalExit)
         {
@@ -113,9 +131,86 @@ void LoggedProcess::on_error(QProcess::ProcessError error)
 void LoggedProcess::kill()
 {
     m_is_aborting = true;
+    m_stop_timer.stop();
+#if defined(Q_OS_UNIX)
+    signalProcessGroup(SIGKILL);
+#endif
     QProcess::kill();
 }
 
+void LoggedProcess::stop(const QByteArray &command, int timeoutMs)
+{
+    if (m_state != LoggedProcess::Running || m_is_stopping)
+    {
+        return;
+    }
+    m_is_stopping = true;
+    m_stop_timeout = timeoutMs;
+    write(command);
+    m_stop_timer.start(m_stop_timeout);
+}
+
+void LoggedProcess::escalateStop()
+{
+    if (!m_is_terminating)
+    {
+        m_is_terminating = true;
+        emit log({tr("Process did not stop within %1 seconds, terminating it.").arg(m_stop_timeout / 1000)}, MessageLevel::Warning);
+#if defined(Q_OS_UNIX)
+        signalProcessGroup(SIGTERM);
+        m_stop_timer.start(m_stop_timeout);
+#else
+        // there is nothing like SIGTERM for console processes
+        kill();
+#endif
+        return;
+    }
+    emit log({tr("Process did not terminate within %1 seconds, killing it.").arg(m_stop_timeout / 1000)}, MessageLevel::Warning);
+    kill();
+}
+
+void LoggedProcess::setCGroupProcsPath(const QString &procsPath)
+{
+    m_cgroup_procs = QFile::encodeName(procsPath);
+}
+
+void LoggedProcess::setupChildProcess()
+{
+#if defined(Q_OS_UNIX)
+    // own process group, so wrappers and anything the server starts can be stopped along with it
+    ::setpgid(0, 0);
+    // before exec, so nothing the server runs escapes the limits. Only async signal safe calls here.
+    if (!m_cgroup_procs.isEmpty())
+    {
+        int fd = ::open(m_cgroup_procs.constData(), O_WRONLY | O_CLOEXEC);
+        if (fd >= 0)
+        {
+            // nowhere to report a failure to from here
+            ssize_t written = ::write(fd, "0", 1);
+            Q_UNUSED(written);
+            ::close(fd);
+        }
+    }
+#endif
+}
+
+void LoggedProcess::signalProcessGroup(int signal)
+{
+#if defined(Q_OS_UNIX)
+    pid_t pid = pid_t(processId());
+    if (pid <= 0)
+    {
+        return;
+    }
+    if (::kill(-pid, signal) != 0)
+    {
+        ::kill(pid, signal);
+    }
+#else
+    Q_UNUSED(signal);
+#endif
+}
+
 int LoggedProcess::exitCode() const
 {
     return m_exit_code;
@@ -142,6 +237,16 @@ void LoggedProcess::on_stateChange(QProcess::ProcessState state)
             break; // let's not - there are too many that handle this already.
         case QProcess::Starting:
         {
+            // started again after it ended, by a supervised restart
+            if(m_state == LoggedProcess::FailedToStart || m_state == LoggedProcess::Finished ||
+               m_state == LoggedProcess::Crashed || m_state == LoggedProcess::Aborted)
+            {
+                m_state = LoggedProcess::NotRunning;
+                m_is_aborting = false;
+                m_is_stopping = false;
+                m_is_terminating = false;
+                m_exit_code = 0;
+            }
             if(m_state != LoggedProcess::NotRunning)
             {
                 qWarning() << "Wrong state change for process from state" << m_state << "to" << (int) LoggedProcess::Starting;
@@ -16,6 +16,7 @@
 #pragma once
 
 #include <QProcess>
+#include <QTimer>
 #include "MessageLevel.h"
 #include "multiservermc_logic_export.h"
 
@@ -48,16 +49,33 @@ public:
 
     void setDetachable(bool detachable);
 
+    /// move the process into the cgroup with this cgroup.procs file right after it forks
+    void setCGroupProcsPath(const QString &procsPath);
+
+    /// true when the process exited after a stop() or kill()
+    bool stopRequested() const
+    {
+        return m_is_stopping || m_is_aborting;
+    }
+
 signals:
     void log(QStringList lines, MessageLevel::Enum level);
     void stateChanged(LoggedProcess::State state);
 
 public slots:
     /**
-     * @brief kill the process - equivalent to kill -9
+     * @brief kill the process and its process group - equivalent to kill -9
      */
     void kill();
 
+    /**
+     * @brief stop the process gracefully
+     *
+     * Writes command to the standard input first. If the process is still around after timeoutMs,
+     * its process group gets SIGTERM, and SIGKILL after another timeoutMs.
+     */
+    void stop(const QByteArray &command, int timeoutMs);
+
 
 private slots:
     void on_stdErr();
@@ -69,8 +87,13 @@ private slots:
 public slots:
     void writeToStdin(const QByteArray &data);
 
+protected:
+    void setupChildProcess() override;
+
 private:
     void changeState(LoggedProcess::State state);
+    void escalateStop();
+    void signalProcessGroup(int signal);
 
 private:
     QString m_err_leftover;
@@ -80,4 +103,9 @@ private:
     int m_exit_code = 0;
     bool m_is_aborting = false;
     bool m_is_detachable = false;
+    bool m_is_stopping = false;
+    bool m_is_terminating = false;
+    int m_stop_timeout = 0;
+    QTimer m_stop_timer;
+    QByteArray m_cgroup_procs;
 };
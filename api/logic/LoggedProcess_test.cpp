@@ -0,0 +1,71 @@
+#include <QTest>
+#include <QSignalSpy>
+#include <QElapsedTimer>
+#include "TestUtil.h"
+
+#include "LoggedProcess.h"
+
+class LoggedProcessTest : public QObject
+{
+    Q_OBJECT
+private
+slots:
+#if defined(Q_OS_UNIX)
+    void test_stopGracefully()
+    {
+        LoggedProcess process;
+        QStringList output;
+        connect(&process, &LoggedProcess::log, [&output](QStringList lines, MessageLevel::Enum) { output.append(lines); });
+        QSignalSpy running(&process, &LoggedProcess::started);
+        process.start("sh", {"-c", "read line; echo \"got $line\"; exit 3"});
+        QVERIFY(running.wait(5000));
+        QCOMPARE(process.state(), LoggedProcess::Running);
+
+        QSignalSpy finished(&process, SIGNAL(finished(int,QProcess::ExitStatus)));
+        process.stop("stop\n", 5000);
+        QVERIFY(finished.wait(5000));
+        QCOMPARE(process.state(), LoggedProcess::Finished);
+        QVERIFY(process.stopRequested());
+        QCOMPARE(process.exitCode(), 3);
+        QVERIFY(output.contains("got stop"));
+    }
+
+    void test_stopEscalates()
+    {
+        LoggedProcess process;
+        QSignalSpy running(&process, &LoggedProcess::started);
+        // ignores the stop command and SIGTERM, only SIGKILL gets rid of it and its child
+        process.start("sh", {"-c", "trap '' TERM; sleep 30 & wait"});
+        QVERIFY(running.wait(5000));
+
+        QSignalSpy finished(&process, SIGNAL(finished(int,QProcess::ExitStatus)));
+        QElapsedTimer timer;
+        timer.start();
+        process.stop("stop\n", 200);
+        QVERIFY(finished.wait(5000));
+        QCOMPARE(process.state(), LoggedProcess::Aborted);
+        QVERIFY(timer.elapsed() >= 400);
+    }
+
+    void test_startAgain()
+    {
+        LoggedProcess process;
+        QSignalSpy finished(&process, SIGNAL(finished(int,QProcess::ExitStatus)));
+        process.start("sh", {"-c", "exit 1"});
+        QVERIFY(finished.wait(5000));
+        QCOMPARE(process.state(), LoggedProcess::Finished);
+        QCOMPARE(process.exitCode(), 1);
+
+        // like a supervised restart does
+        process.start("sh", {"-c", "exit 0"});
+        QVERIFY(finished.wait(5000));
+        QCOMPARE(process.state(), LoggedProcess::Finished);
+        QCOMPARE(process.exitCode(), 0);
+        QVERIFY(!process.stopRequested());
+    }
+#endif
+};
+
+QTEST_GUILESS_MAIN(LoggedProcessTest)
+
+#include "LoggedProcess_test.moc"
@@ -21,6 +21,16 @@
 #include "FileSystem.h"
 
 #include <QDebug>
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QVector>
+#include <QHash>
+#include <algorithm>
+
+#if defined(Q_OS_LINUX)
+#include <fcntl.h>
+#endif
 
 // ours
 bool MSMCZip::mergeZipFiles(QuaZip *into, QFileInfo from, QSet<QString> &contained, const JlCompress::FilterFunction filter)
@@ -207,23 +217,36 @@ bool MSMCZip::findFilesInZip(QuaZip * zip, const QString & what, QStringList & r
 }
 
 
-// ours
-nonstd::optional<QStringList> MSMCZip::extractSubDir(QuaZip *zip, const QString & subdir, const QString &target)
+namespace {
+
+// below this, extracting on the calling thread is faster than opening the archive again on each worker
+const int parallelExtractThreshold = 64;
+// rough cost of creating a file, in bytes, for balancing the work between threads
+const qint64 perFileCost = 16 * 1024;
+
+struct ExtractJob
+{
+    int index;
+    QString name;
+    QString path;
+    qint64 size;
+    qint64 compressedSize;
+};
+
+// whether an entry extracted to path stays within root, names like "../x" or "/x" must not escape it
+bool isInsideTarget(const QString & root, const QString & path)
+{
+    QString cleanPath = QDir::cleanPath(path);
+    return cleanPath == root || cleanPath.startsWith(root + '/');
+}
+
+nonstd::optional<QStringList> extractSubDirSequential(QuaZip *zip, const QString & subdir, const QString &target)
 {
     QDir directory(target);
+    QString targetRoot = QDir::cleanPath(directory.absolutePath());
     QStringList extracted;
 
-    qDebug() << "Extracting subdir" << subdir << "from" << zip->getZipName() << "to" << target;
-    auto numEntries = zip->getEntriesCount();
-    if(numEntries < 0) {
-        qWarning() << "Failed to enumerate files in archive";
-        return nonstd::nullopt;
-    }
-    else if(numEntries == 0) {
-        qDebug() << "Extracting empty archives seems odd...";
-        return extracted;
-    }
-    else if (!zip->goToFirstFile())
+    if (!zip->goToFirstFile())
     {
         qWarning() << "Failed to seek to first file in zip";
         return nonstd::nullopt;
@@ -238,6 +261,12 @@ nonstd::optional<QStringList> MSMCZip::extractSubDir(QuaZip *zip, const QString
         }
         name.remove(0, subdir.size());
         QString absFilePath = directory.absoluteFilePath(name);
+        if(!isInsideTarget(targetRoot, absFilePath))
+        {
+            qWarning() << "Refusing to extract" << name << "outside of" << targetRoot;
+            JlCompress::removeFile(extracted);
+            return nonstd::nullopt;
+        }
         if(name.isEmpty())
         {
             absFilePath += "/";
@@ -254,6 +283,289 @@ nonstd::optional<QStringList> MSMCZip::extractSubDir(QuaZip *zip, const QString
     return extracted;
 }
 
+/*
+ * Extracts a contiguous range of jobs using its own handle to the archive.
+ * The entries are visited in central directory order, so skipping to the next job is cheap.
+ */
+class ExtractWorker : public QRunnable
+{
+public:
+    ExtractWorker(const QString & zipName, const QVector<ExtractJob> & jobs, int first, int last,
+                  MSMCZip::ExtractState * state, std::atomic<bool> & failed)
+        : m_zipName(zipName), m_jobs(jobs), m_first(first), m_last(last), m_state(state), m_failed(failed)
+    {
+    }
+
+    void run() override
+    {
+        if(!extractRange())
+        {
+            m_failed = true;
+        }
+    }
+
+private:
+    bool shouldStop() const
+    {
+        return m_failed || (m_state && m_state->isCanceled());
+    }
+
+    bool extractRange()
+    {
+        QuaZip zip(m_zipName);
+        if(!zip.open(QuaZip::mdUnzip))
+        {
+            qWarning() << "Could not open archive for unzipping:" << m_zipName << "Error:" << zip.getZipError();
+            return false;
+        }
+        int index = 0;
+        if(!zip.goToFirstFile())
+        {
+            return false;
+        }
+        QByteArray buffer(256 * 1024, Qt::Uninitialized);
+        for(int i = m_first; i < m_last; i++)
+        {
+            if(shouldStop())
+            {
+                return false;
+            }
+            auto & job = m_jobs[i];
+            while(index < job.index)
+            {
+                if(!zip.goToNextFile())
+                {
+                    qWarning() << "Archive" << m_zipName << "ended unexpectedly";
+                    return false;
+                }
+                index++;
+            }
+            if(!extractCurrent(zip, job, buffer))
+            {
+                qWarning() << "Failed to extract file" << job.name << "to" << job.path;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool extractCurrent(QuaZip & zip, const ExtractJob & job, QByteArray & buffer)
+    {
+        QuaZipFileInfo64 info;
+        zip.getCurrentFileInfo(&info);
+
+        QuaZipFile inFile(&zip);
+        if(!inFile.open(QIODevice::ReadOnly) || inFile.getZipError() != UNZ_OK)
+        {
+            return false;
+        }
+        QFile outFile(job.path);
+        if(!outFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        {
+            return false;
+        }
+#if defined(Q_OS_LINUX)
+        if(job.size > 0)
+        {
+            // reserve the space in one go, avoids fragmentation and repeated block allocation
+            posix_fallocate(outFile.handle(), 0, job.size);
+        }
+#endif
+        qint64 written = 0;
+        while(true)
+        {
+            qint64 read = inFile.read(buffer.data(), buffer.size());
+            if(read < 0)
+            {
+                return false;
+            }
+            if(read == 0)
+            {
+                break;
+            }
+            if(outFile.write(buffer.constData(), read) != read)
+            {
+                return false;
+            }
+            written += read;
+        }
+        inFile.close();
+        if(inFile.getZipError() != UNZ_OK)
+        {
+            return false;
+        }
+        if(written != job.size)
+        {
+            // fallocate may have reserved more than what was actually there
+            outFile.resize(written);
+        }
+        outFile.close();
+        auto permissions = info.getPermissions();
+        if(permissions)
+        {
+            outFile.setPermissions(permissions | QFileDevice::ReadOwner | QFileDevice::WriteOwner);
+        }
+        if(m_state)
+        {
+            m_state->addDone(job.size);
+        }
+        return true;
+    }
+
+private:
+    QString m_zipName;
+    const QVector<ExtractJob> & m_jobs;
+    int m_first;
+    int m_last;
+    MSMCZip::ExtractState * m_state;
+    std::atomic<bool> & m_failed;
+};
+
+}
+
+// ours
+nonstd::optional<QStringList> MSMCZip::extractSubDir(QuaZip *zip, const QString & subdir, const QString &target, ExtractState * state)
+{
+    QDir directory(target);
+    QStringList extracted;
+
+    qDebug() << "Extracting subdir" << subdir << "from" << zip->getZipName() << "to" << target;
+    auto numEntries = zip->getEntriesCount();
+    if(numEntries < 0) {
+        qWarning() << "Failed to enumerate files in archive";
+        return nonstd::nullopt;
+    }
+    else if(numEntries == 0) {
+        qDebug() << "Extracting empty archives seems odd...";
+        return extracted;
+    }
+
+    // archives opened from an IO device cannot be opened again by the workers
+    if(zip->getZipName().isEmpty() || (numEntries < parallelExtractThreshold && !state))
+    {
+        return extractSubDirSequential(zip, subdir, target);
+    }
+
+    // read the whole central directory once
+    auto entries = zip->getFileInfoList64();
+    if(entries.size() != numEntries)
+    {
+        qWarning() << "Failed to read the central directory of" << zip->getZipName();
+        return nonstd::nullopt;
+    }
+
+    QString targetRoot = QDir::cleanPath(directory.absolutePath());
+    QSet<QString> directories;
+    directories.insert(targetRoot);
+    QVector<ExtractJob> jobs;
+    QHash<QString, int> jobByPath;
+    qint64 totalBytes = 0;
+    for(int i = 0; i < entries.size(); i++)
+    {
+        auto & entry = entries[i];
+        QString name = entry.name;
+        if(!name.startsWith(subdir))
+        {
+            continue;
+        }
+        name.remove(0, subdir.size());
+        QString absFilePath = directory.absoluteFilePath(name);
+        QString cleanPath = QDir::cleanPath(absFilePath);
+        if(!isInsideTarget(targetRoot, absFilePath))
+        {
+            qWarning() << "Refusing to extract" << name << "outside of" << targetRoot;
+            return nonstd::nullopt;
+        }
+        if(name.isEmpty() || name.endsWith('/'))
+        {
+            if(name.isEmpty())
+            {
+                absFilePath += "/";
+            }
+            directories.insert(cleanPath);
+            extracted.append(absFilePath);
+            continue;
+        }
+        directories.insert(QFileInfo(cleanPath).absolutePath());
+        auto existing = jobByPath.find(cleanPath);
+        if(existing != jobByPath.end())
+        {
+            // the same name twice, the last entry wins like when extracting one after the other
+            totalBytes -= jobs[*existing].size;
+            jobs[*existing].index = -1;
+        }
+        else
+        {
+            extracted.append(absFilePath);
+        }
+        jobByPath[cleanPath] = jobs.size();
+        jobs.append({i, name, absFilePath, (qint64) entry.uncompressedSize, (qint64) entry.compressedSize});
+        totalBytes += entry.uncompressedSize;
+    }
+    // two workers must never write to the same file
+    jobs.erase(std::remove_if(jobs.begin(), jobs.end(), [](const ExtractJob & job) { return job.index < 0; }), jobs.end());
+
+    // create the directory structure in one go, parents first
+    auto sortedDirectories = directories.toList();
+    std::sort(sortedDirectories.begin(), sortedDirectories.end());
+    for(auto & dir: sortedDirectories)
+    {
+        if(!QDir().mkpath(dir))
+        {
+            qWarning() << "Failed to create directory" << dir;
+            return nonstd::nullopt;
+        }
+    }
+
+    if(state)
+    {
+        state->setTotal(totalBytes);
+    }
+
+    // split the jobs into contiguous ranges of roughly the same cost
+    int threads = state && state->threads() > 0 ? state->threads() : QThread::idealThreadCount();
+    threads = std::max(1, std::min(threads, (int) jobs.size()));
+    qint64 totalCost = 0;
+    for(auto & job: jobs)
+    {
+        totalCost += job.compressedSize + perFileCost;
+    }
+    qint64 costPerThread = totalCost / threads + 1;
+
+    std::atomic<bool> failed {false};
+    if(threads == 1)
+    {
+        // likely on a worker of some other pool already, don't start another one
+        ExtractWorker(zip->getZipName(), jobs, 0, jobs.size(), state, failed).run();
+    }
+    else
+    {
+        QThreadPool pool;
+        pool.setMaxThreadCount(threads);
+        int first = 0;
+        qint64 cost = 0;
+        for(int i = 0; i < jobs.size(); i++)
+        {
+            cost += jobs[i].compressedSize + perFileCost;
+            if(cost >= costPerThread || i == jobs.size() - 1)
+            {
+                pool.start(new ExtractWorker(zip->getZipName(), jobs, first, i + 1, state, failed));
+                first = i + 1;
+                cost = 0;
+            }
+        }
+        pool.waitForDone();
+    }
+
+    if(failed || (state && state->isCanceled()))
+    {
+        JlCompress::removeFile(extracted);
+        return nonstd::nullopt;
+    }
+    qDebug() << "Extracted" << jobs.size() << "files using" << threads << "threads";
+    return extracted;
+}
+
 // ours
 bool MSMCZip::extractRelFile(QuaZip *zip, const QString &file, const QString &target)
 {
@@ -261,7 +573,7 @@ bool MSMCZip::extractRelFile(QuaZip *zip, const QString &file, const QString &ta
 }
 
 // ours
-nonstd::optional<QStringList> MSMCZip::extractDir(QString fileCompressed, QString dir)
+nonstd::optional<QStringList> MSMCZip::extractDir(QString fileCompressed, QString dir, ExtractState * state)
 {
     QuaZip zip(fileCompressed);
     if (!zip.open(QuaZip::mdUnzip))
@@ -274,11 +586,11 @@ nonstd::optional<QStringList> MSMCZip::extractDir(QString fileCompressed, QStrin
         qWarning() << "Could not open archive for unzipping:" << fileCompressed << "Error:" << zip.getZipError();;
         return nonstd::nullopt;
     }
-    return MSMCZip::extractSubDir(&zip, "", dir);
+    return MSMCZip::extractSubDir(&zip, "", dir, state);
 }
 
 // ours
-nonstd::optional<QStringList> MSMCZip::extractDir(QString fileCompressed, QString subdir, QString dir)
+nonstd::optional<QStringList> MSMCZip::extractDir(QString fileCompressed, QString subdir, QString dir, ExtractState * state)
 {
     QuaZip zip(fileCompressed);
     if (!zip.open(QuaZip::mdUnzip))
@@ -291,7 +603,7 @@ nonstd::optional<QStringList> MSMCZip::extractDir(QString fileCompressed, QStrin
         qWarning() << "Could not open archive for unzipping:" << fileCompressed << "Error:" << zip.getZipError();;
         return nonstd::nullopt;
     }
-    return MSMCZip::extractSubDir(&zip, subdir, dir);
+    return MSMCZip::extractSubDir(&zip, subdir, dir, state);
 }
 
 // ours
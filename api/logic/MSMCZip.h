@@ -19,6 +19,7 @@
 #include <QFileInfo>
 #include <QSet>
 #include "minecraft/mod/Mod.h"
+#include "tasks/ConcurrentProgress.h"
 #include <functional>
 
 #include "multiservermc_logic_export.h"
@@ -28,6 +29,29 @@
 
 namespace MSMCZip
 {
+    /**
+     * Progress and cancellation of an extraction running on worker threads.
+     */
+    class MULTISERVERMC_LOGIC_EXPORT ExtractState : public ConcurrentProgress
+    {
+    public:
+        explicit ExtractState(const ConcurrentProgress * cancelWith = nullptr) : ConcurrentProgress(cancelWith)
+        {
+        }
+
+        /// how many threads may inflate files at the same time, 0 for one per CPU core
+        void setThreads(int threads)
+        {
+            m_threads = threads;
+        }
+        int threads() const
+        {
+            return m_threads;
+        }
+
+    private:
+        int m_threads = 0;
+    };
 
     /**
      * Merge two zip files, using a filter function
@@ -57,8 +81,12 @@ namespace MSMCZip
 
     /**
      * Extract a subdirectory from an archive
+     *
+     * The central directory is read once, the directories are created up front and the files
+     * are then inflated and written in parallel, each worker using its own handle to the archive.
+     * With a state limited to one thread, everything happens on the calling thread.
      */
-    nonstd::optional<QStringList> MULTISERVERMC_LOGIC_EXPORT extractSubDir(QuaZip *zip, const QString & subdir, const QString &target);
+    nonstd::optional<QStringList> MULTISERVERMC_LOGIC_EXPORT extractSubDir(QuaZip *zip, const QString & subdir, const QString &target, ExtractState * state = nullptr);
 
     bool MULTISERVERMC_LOGIC_EXPORT extractRelFile(QuaZip *zip, const QString & file, const QString &target);
 
@@ -67,9 +95,10 @@ namespace MSMCZip
      *
      * \param fileCompressed The name of the archive.
      * \param dir The directory to extract to, the current directory if left empty.
+     * \param state Optional progress reporting and cancellation.
      * \return The list of the full paths of the files extracted, empty on failure.
      */
-    nonstd::optional<QStringList> MULTISERVERMC_LOGIC_EXPORT extractDir(QString fileCompressed, QString dir);
+    nonstd::optional<QStringList> MULTISERVERMC_LOGIC_EXPORT extractDir(QString fileCompressed, QString dir, ExtractState * state = nullptr);
 
     /**
      * Extract a subdirectory from an archive
@@ -77,9 +106,10 @@ namespace MSMCZip
      * \param fileCompressed The name of the archive.
      * \param subdir The directory within the archive to extract
      * \param dir The directory to extract to, the current directory if left empty.
+     * \param state Optional progress reporting and cancellation.
      * \return The list of the full paths of the files extracted, empty on failure.
      */
-    nonstd::optional<QStringList> MULTISERVERMC_LOGIC_EXPORT extractDir(QString fileCompressed, QString subdir, QString dir);
+    nonstd::optional<QStringList> MULTISERVERMC_LOGIC_EXPORT extractDir(QString fileCompressed, QString subdir, QString dir, ExtractState * state = nullptr);
 
     /**
      * Extract a single file from an archive into a directory
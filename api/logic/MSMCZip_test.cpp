@@ -0,0 +1,190 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include "TestUtil.h"
+
+#include <quazip.h>
+#include <quazipfile.h>
+
+#include "FileSystem.h"
+#include "MSMCZip.h"
+
+typedef QMap<QString, QByteArray> ZipEntries;
+
+static bool writeZip(const QString &path, const ZipEntries &entries)
+{
+    QuaZip zip(path);
+    if(!zip.open(QuaZip::mdCreate))
+    {
+        return false;
+    }
+    for(auto iter = entries.begin(); iter != entries.end(); iter++)
+    {
+        QuaZipFile file(&zip);
+        if(!file.open(QIODevice::WriteOnly, QuaZipNewInfo(iter.key())))
+        {
+            return false;
+        }
+        file.write(iter.value());
+        file.close();
+    }
+    zip.close();
+    return zip.getZipError() == 0;
+}
+
+/// Add an entry to an existing archive, even if it has one with that name already
+static bool appendToZip(const QString &path, const QString &name, const QByteArray &data)
+{
+    QuaZip zip(path);
+    if(!zip.open(QuaZip::mdAdd))
+    {
+        return false;
+    }
+    QuaZipFile file(&zip);
+    if(!file.open(QIODevice::WriteOnly, QuaZipNewInfo(name)))
+    {
+        return false;
+    }
+    file.write(data);
+    file.close();
+    zip.close();
+    return zip.getZipError() == 0;
+}
+
+static ZipEntries makeEntries(const QString &prefix, int count)
+{
+    ZipEntries entries;
+    for(int i = 0; i < count; i++)
+    {
+        entries.insert(QString("%1dir%2/file%3.txt").arg(prefix).arg(i % 5).arg(i), QByteArray::number(i).repeated(i + 1));
+    }
+    return entries;
+}
+
+class MSMCZipTest : public QObject
+{
+    Q_OBJECT
+
+private
+slots:
+    // below the threshold on the calling thread, above it on workers, and always on workers when there is a state
+    void test_extractSubDir_data()
+    {
+        QTest::addColumn<int>("count");
+        QTest::addColumn<bool>("withState");
+        QTest::newRow("sequential") << 10 << false;
+        QTest::newRow("parallel") << 300 << false;
+        QTest::newRow("parallel, with state") << 10 << true;
+    }
+    void test_extractSubDir()
+    {
+        QFETCH(int, count);
+        QFETCH(bool, withState);
+        QTemporaryDir tempDir;
+        QString zipPath = FS::PathCombine(tempDir.path(), "test.zip");
+        auto wanted = makeEntries("sub/", count);
+        auto entries = wanted;
+        entries.unite(makeEntries("other/", 3));
+        QVERIFY(writeZip(zipPath, entries));
+
+        QString target = FS::PathCombine(tempDir.path(), "target");
+        MSMCZip::ExtractState state;
+        auto extracted = MSMCZip::extractDir(zipPath, "sub/", target, withState ? &state : nullptr);
+        QVERIFY(extracted.has_value());
+        QCOMPARE(extracted->size(), count);
+        for(auto iter = wanted.begin(); iter != wanted.end(); iter++)
+        {
+            QString path = FS::PathCombine(target, iter.key().mid(4));
+            QVERIFY(extracted->contains(path));
+            QCOMPARE(FS::read(path), iter.value());
+        }
+        QVERIFY(!QFileInfo(FS::PathCombine(target, "other")).exists());
+        if(withState)
+        {
+            QCOMPARE(state.done(), state.total());
+        }
+    }
+
+    void test_singleThread()
+    {
+        QTemporaryDir tempDir;
+        QString zipPath = FS::PathCombine(tempDir.path(), "test.zip");
+        auto entries = makeEntries("", 100);
+        QVERIFY(writeZip(zipPath, entries));
+
+        QString target = FS::PathCombine(tempDir.path(), "target");
+        MSMCZip::ExtractState state;
+        state.setThreads(1);
+        auto extracted = MSMCZip::extractDir(zipPath, target, &state);
+        QVERIFY(extracted.has_value());
+        QCOMPARE(extracted->size(), entries.size());
+        QCOMPARE(FS::read(FS::PathCombine(target, "dir2/file7.txt")), entries["dir2/file7.txt"]);
+    }
+
+    // entries must not be written outside of the target, whichever way the archive is extracted
+    void test_zipSlip_data()
+    {
+        QTest::addColumn<int>("count");
+        QTest::addColumn<QString>("evilName");
+        QTest::newRow("sequential, parent") << 10 << "../evil.txt";
+        QTest::newRow("sequential, nested parent") << 10 << "zzz/../../evil.txt";
+        QTest::newRow("parallel, parent") << 300 << "../evil.txt";
+        QTest::newRow("parallel, nested parent") << 300 << "zzz/../../evil.txt";
+    }
+    void test_zipSlip()
+    {
+        QFETCH(int, count);
+        QFETCH(QString, evilName);
+        QTemporaryDir tempDir;
+        QString zipPath = FS::PathCombine(tempDir.path(), "test.zip");
+        auto entries = makeEntries("", count);
+        entries.insert(evilName, "gotcha");
+        QVERIFY(writeZip(zipPath, entries));
+
+        QString target = FS::PathCombine(tempDir.path(), "target");
+        QVERIFY(!MSMCZip::extractDir(zipPath, target).has_value());
+        QVERIFY(!QFileInfo(FS::PathCombine(tempDir.path(), "evil.txt")).exists());
+        // nothing half done is left behind
+        QVERIFY(!QFileInfo(FS::PathCombine(target, "dir0/file0.txt")).exists());
+    }
+
+    // the last of several entries with the same name wins, and no two workers write the same file
+    void test_duplicateNames_data()
+    {
+        QTest::addColumn<int>("count");
+        QTest::newRow("sequential") << 10;
+        QTest::newRow("parallel") << 300;
+    }
+    void test_duplicateNames()
+    {
+        QFETCH(int, count);
+        QTemporaryDir tempDir;
+        QString zipPath = FS::PathCombine(tempDir.path(), "test.zip");
+        QVERIFY(writeZip(zipPath, makeEntries("", count)));
+        QVERIFY(appendToZip(zipPath, "dir0/file0.txt", QByteArray(100000, 'a')));
+        QVERIFY(appendToZip(zipPath, "dir0/file0.txt", "last"));
+
+        QString target = FS::PathCombine(tempDir.path(), "target");
+        auto extracted = MSMCZip::extractDir(zipPath, target);
+        QVERIFY(extracted.has_value());
+        QCOMPARE(extracted->toSet().size(), count);
+        QCOMPARE(FS::read(FS::PathCombine(target, "dir0/file0.txt")), QByteArray("last"));
+    }
+
+    void test_canceled()
+    {
+        QTemporaryDir tempDir;
+        QString zipPath = FS::PathCombine(tempDir.path(), "test.zip");
+        QVERIFY(writeZip(zipPath, makeEntries("", 100)));
+
+        ConcurrentProgress everything;
+        MSMCZip::ExtractState state(&everything);
+        everything.cancel();
+        QString target = FS::PathCombine(tempDir.path(), "target");
+        QVERIFY(!MSMCZip::extractDir(zipPath, target, &state).has_value());
+        QVERIFY(!QFileInfo(FS::PathCombine(target, "dir0/file0.txt")).exists());
+    }
+};
+
+QTEST_GUILESS_MAIN(MSMCZipTest)
+
+#include "MSMCZip_test.moc"
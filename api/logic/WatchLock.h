@@ -2,19 +2,33 @@
 #pragma once
 
 #include <QString>
-#include <QFileSystemWatcher>
+#include "DirectoryEventWatcher.h"
 
+/**
+ * Stops watching a directory while we change it ourselves.
+ *
+ * Only needed when the watcher cannot tell what changed; with per-entry events
+ * the changes are told apart and the watch is left alone, so no outside changes get lost.
+ */
 struct WatchLock
 {
-    WatchLock(QFileSystemWatcher * watcher, const QString& directory)
+    WatchLock(DirectoryEventWatcher * watcher, const QString& directory)
         : m_watcher(watcher), m_directory(directory)
     {
-        m_watcher->removePath(m_directory);
+        m_locked = !m_watcher->providesEvents();
+        if(m_locked)
+        {
+            m_watcher->removePath(m_directory);
+        }
     }
     ~WatchLock()
     {
-        m_watcher->addPath(m_directory);
+        if(m_locked)
+        {
+            m_watcher->addPath(m_directory);
+        }
     }
-    QFileSystemWatcher * m_watcher;
+    DirectoryEventWatcher * m_watcher;
     QString m_directory;
+    bool m_locked;
 };
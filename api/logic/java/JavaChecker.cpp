@@ -4,6 +4,7 @@
 #include <Commandline.h>
 #include <QFile>
 #include <QProcess>
+#include <QTimer>
 #include <QMap>
 #include <QCoreApplication>
 #include <QDebug>
@@ -14,8 +15,26 @@ JavaChecker::JavaChecker(QObject *parent) : QObject(parent)
 {
 }
 
+bool JavaChecker::isPlainProbe() const
+{
+    return m_args.isEmpty() && m_minMem == 0 && m_maxMem == 0 && m_permGen == 64;
+}
+
 void JavaChecker::performCheck()
 {
+    JavaCheckResult staticResult;
+    if(m_allowStaticProbe && isPlainProbe() && JavaUtils::ProbeJavaStatically(m_path, staticResult))
+    {
+        qDebug() << "Java checker read" << m_path << "from its metadata:" << staticResult.javaVersion.toString() << staticResult.realPlatform;
+        staticResult.id = m_id;
+        // callers expect the result after performCheck returns, like with a JVM
+        QTimer::singleShot(0, this, [this, staticResult]()
+        {
+            emit checkFinished(staticResult);
+        });
+        return;
+    }
+
     QString checkerJar = FS::PathCombine(ENV.getJarsPath(), "JavaCheck.jar");
 
     QStringList args;
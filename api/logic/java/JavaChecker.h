@@ -38,6 +38,8 @@ class MULTISERVERMC_LOGIC_EXPORT JavaChecker : public QObject
 public:
     explicit JavaChecker(QObject *parent = 0);
     void performCheck();
+    /// No extra arguments or memory settings, only the binary itself is checked
+    bool isPlainProbe() const;
 
     QString m_path;
     QString m_args;
@@ -45,6 +47,8 @@ public:
     int m_minMem = 0;
     int m_maxMem = 0;
     int m_permGen = 64;
+    /// Allow answering plain probes from the release file and binary header, without starting the JVM
+    bool m_allowStaticProbe = true;
 
 signals:
     void checkFinished(JavaCheckResult result);
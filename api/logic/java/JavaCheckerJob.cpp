@@ -14,17 +14,90 @@
  */
 
 #include "JavaCheckerJob.h"
+#include "JavaProbeCache.h"
 
 #include <QDebug>
+#include <QThread>
 
-void JavaCheckerJob::partFinished(JavaCheckResult result)
+JavaCheckerJob::JavaCheckerJob(QString job_name, std::shared_ptr<JavaProbeCache> cache)
+    : Task(), m_job_name(job_name), m_cache(cache)
+{
+    setMaxConcurrent(0);
+}
+
+void JavaCheckerJob::setMaxConcurrent(int maxConcurrent)
+{
+    if(maxConcurrent <= 0)
+    {
+        // a starting JVM keeps a core busy for a while, leave some of them to everything else
+        maxConcurrent = qBound(1, QThread::idealThreadCount() / 2, 4);
+    }
+    m_maxConcurrent = maxConcurrent;
+}
+
+bool JavaCheckerJob::addJavaCheckerAction(JavaCheckerPtr base)
+{
+    javacheckers.append(base);
+    // if this is already running, the action needs to be started right away!
+    if (isRunning())
+    {
+        javaresults.append(JavaCheckResult());
+        setProgress(num_finished, javacheckers.size());
+        queueChecker(javacheckers.size() - 1);
+        startCheckers();
+    }
+    return true;
+}
+
+void JavaCheckerJob::queueChecker(int index)
+{
+    auto checker = javacheckers[index];
+    // checks with extra arguments or memory settings test more than the binary, their results are not shared
+    if(m_cache && checker->isPlainProbe())
+    {
+        JavaCheckResult cached;
+        if(m_cache->lookup(checker->m_path, cached))
+        {
+            cached.id = checker->m_id;
+            checkerDone(index, cached);
+            return;
+        }
+        auto realPath = JavaProbeKey::forBinary(checker->m_path).realPath;
+        if(!realPath.isEmpty())
+        {
+            auto followers = m_followers.find(realPath);
+            if(followers != m_followers.end())
+            {
+                // the same binary through another path, its probe is already on the way
+                followers->append(index);
+                return;
+            }
+            m_followers.insert(realPath, {});
+            m_leaders.insert(index, realPath);
+        }
+    }
+    m_queued.append(index);
+}
+
+void JavaCheckerJob::startCheckers()
+{
+    while(m_running < m_maxConcurrent && !m_queued.isEmpty())
+    {
+        auto checker = javacheckers[m_queued.takeFirst()];
+        connect(checker.get(), &JavaChecker::checkFinished, this, &JavaCheckerJob::partFinished);
+        m_running++;
+        checker->performCheck();
+    }
+}
+
+void JavaCheckerJob::checkerDone(int index, const JavaCheckResult &result)
 {
     num_finished++;
     qDebug() << m_job_name.toLocal8Bit() << "progress:" << num_finished << "/"
                 << javacheckers.size();
     setProgress(num_finished, javacheckers.size());
 
-    javaresults.replace(result.id, result);
+    javaresults.replace(index, result);
 
     if (num_finished == javacheckers.size())
     {
@@ -32,13 +105,55 @@ void JavaCheckerJob::partFinished(JavaCheckResult result)
     }
 }
 
+void JavaCheckerJob::partFinished(JavaCheckResult result)
+{
+    m_running--;
+    int index = -1;
+    for(int i = 0; i < javacheckers.size(); i++)
+    {
+        if(javacheckers[i].get() == sender())
+        {
+            index = i;
+            break;
+        }
+    }
+    if(index < 0)
+    {
+        return;
+    }
+    auto leader = m_leaders.find(index);
+    if(leader != m_leaders.end())
+    {
+        m_cache->insert(javacheckers[index]->m_path, result);
+        auto followers = m_followers.take(*leader);
+        m_leaders.erase(leader);
+        for(int follower: followers)
+        {
+            auto followerResult = result;
+            followerResult.path = javacheckers[follower]->m_path;
+            followerResult.id = javacheckers[follower]->m_id;
+            checkerDone(follower, followerResult);
+        }
+    }
+    checkerDone(index, result);
+    startCheckers();
+}
+
 void JavaCheckerJob::executeTask()
 {
     qDebug() << m_job_name.toLocal8Bit() << " started.";
-    for (auto iter : javacheckers)
+    if(javacheckers.isEmpty())
+    {
+        emitSucceeded();
+        return;
+    }
+    for(int i = 0; i < javacheckers.size(); i++)
     {
         javaresults.append(JavaCheckResult());
-        connect(iter.get(), SIGNAL(checkFinished(JavaCheckResult)), SLOT(partFinished(JavaCheckResult)));
-        iter->performCheck();
     }
+    for(int i = 0; i < javacheckers.size(); i++)
+    {
+        queueChecker(i);
+    }
+    startCheckers();
 }
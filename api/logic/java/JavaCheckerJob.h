@@ -16,46 +16,60 @@
 #pragma once
 
 #include <QtNetwork>
+#include <QHash>
+#include <memory>
 #include "JavaChecker.h"
 #include "tasks/Task.h"
 
 class JavaCheckerJob;
+class JavaProbeCache;
 typedef shared_qobject_ptr<JavaCheckerJob> JavaCheckerJobPtr;
 
-// FIXME: this just seems horribly redundant
+/**
+ * Runs a batch of java checks.
+ *
+ * With a probe cache, checks of binaries that did not change since they were last probed are
+ * answered from the cache and binaries reached through several paths are only started once.
+ * Only a few JVMs are started at the same time, the rest of the checks wait for them.
+ */
 class JavaCheckerJob : public Task
 {
     Q_OBJECT
 public:
-    explicit JavaCheckerJob(QString job_name) : Task(), m_job_name(job_name) {};
+    explicit JavaCheckerJob(QString job_name, std::shared_ptr<JavaProbeCache> cache = nullptr);
     virtual ~JavaCheckerJob() {};
 
-    bool addJavaCheckerAction(JavaCheckerPtr base)
-    {
-        javacheckers.append(base);
-        // if this is already running, the action needs to be started right away!
-        if (isRunning())
-        {
-            setProgress(num_finished, javacheckers.size());
-            connect(base.get(), &JavaChecker::checkFinished, this, &JavaCheckerJob::partFinished);
-            base->performCheck();
-        }
-        return true;
-    }
+    bool addJavaCheckerAction(JavaCheckerPtr base);
     QList<JavaCheckResult> getResults()
     {
         return javaresults;
     }
 
+    /// How many JVMs may run at the same time, 0 for a default based on the number of cores
+    void setMaxConcurrent(int maxConcurrent);
+
 private slots:
     void partFinished(JavaCheckResult result);
 
 protected:
     virtual void executeTask() override;
 
+private:
+    void queueChecker(int index);
+    void startCheckers();
+    void checkerDone(int index, const JavaCheckResult &result);
+
 private:
     QString m_job_name;
+    std::shared_ptr<JavaProbeCache> m_cache;
     QList<JavaCheckerPtr> javacheckers;
     QList<JavaCheckResult> javaresults;
     int num_finished = 0;
+    int m_maxConcurrent = 0;
+    int m_running = 0;
+    QList<int> m_queued;
+    /// real path of a binary being probed -> checkers waiting for its result
+    QHash<QString, QList<int>> m_followers;
+    /// checker -> real path it leads the probe of
+    QHash<int, QString> m_leaders;
 };
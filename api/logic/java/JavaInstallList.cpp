@@ -22,6 +22,8 @@
 #include "java/JavaInstallList.h"
 #include "java/JavaCheckerJob.h"
 #include "java/JavaUtils.h"
+#include "java/JavaProbeCache.h"
+#include "Env.h"
 #include "MSMCStrings.h"
 #include "minecraft/VersionFilterData.h"
 
@@ -149,7 +151,7 @@ void JavaListLoadTask::executeTask()
     JavaUtils ju;
     QList<QString> candidate_paths = ju.FindJavaPaths();
 
-    m_job = new JavaCheckerJob("Java detection");
+    m_job = new JavaCheckerJob("Java detection", ENV.javaProbeCache());
     connect(m_job.get(), &Task::finished, this, &JavaListLoadTask::javaCheckerFinished);
     connect(m_job.get(), &Task::progress, this, &Task::setProgress);
 
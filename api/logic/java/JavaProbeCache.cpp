@@ -0,0 +1,178 @@
+#include "JavaProbeCache.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QDebug>
+
+#include "FileSystem.h"
+
+#if defined(Q_OS_UNIX)
+#include <sys/stat.h>
+#endif
+
+namespace {
+const quint32 CACHE_MAGIC = 0x4d534a50; // "MSJP"
+const quint32 CACHE_VERSION = 1;
+
+QDataStream &operator<<(QDataStream &out, const JavaProbeKey &key)
+{
+    return out << key.realPath << key.size << key.modified << key.inode;
+}
+
+QDataStream &operator>>(QDataStream &in, JavaProbeKey &key)
+{
+    return in >> key.realPath >> key.size >> key.modified >> key.inode;
+}
+
+QDataStream &operator<<(QDataStream &out, const JavaCheckResult &result)
+{
+    out << result.mojangPlatform << result.realPlatform << result.javaVersion.toString() << result.javaVendor;
+    out << result.outLog << result.is_64bit << qint32(result.validity);
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, JavaCheckResult &result)
+{
+    QString version;
+    qint32 validity = 0;
+    in >> result.mojangPlatform >> result.realPlatform >> version >> result.javaVendor;
+    in >> result.outLog >> result.is_64bit >> validity;
+    result.javaVersion = version;
+    result.validity = JavaCheckResult::Validity(validity);
+    return in;
+}
+}
+
+JavaProbeKey JavaProbeKey::forBinary(const QString &path)
+{
+    JavaProbeKey key;
+    QFileInfo info(path);
+    auto realPath = info.canonicalFilePath();
+    if(realPath.isEmpty())
+    {
+        return key;
+    }
+    QFileInfo realInfo(realPath);
+    key.realPath = realPath;
+    key.size = realInfo.size();
+    key.modified = realInfo.lastModified().toMSecsSinceEpoch();
+#if defined(Q_OS_UNIX)
+    // catches binaries replaced by the package manager within the same second with the same size
+    struct stat status;
+    if(stat(QFile::encodeName(realPath).constData(), &status) == 0)
+    {
+        key.inode = quint64(status.st_ino);
+    }
+#endif
+    return key;
+}
+
+bool JavaProbeKey::operator==(const JavaProbeKey &other) const
+{
+    return realPath == other.realPath && size == other.size && modified == other.modified && inode == other.inode;
+}
+
+JavaProbeCache::JavaProbeCache(const QString &path) : m_path(path)
+{
+}
+
+bool JavaProbeCache::lookup(const QString &path, JavaCheckResult &result)
+{
+    load();
+    auto key = JavaProbeKey::forBinary(path);
+    if(!key.isValid())
+    {
+        return false;
+    }
+    auto iter = m_entries.find(key.realPath);
+    if(iter == m_entries.end() || iter->key != key)
+    {
+        return false;
+    }
+    result = iter->result;
+    result.path = path;
+    return true;
+}
+
+void JavaProbeCache::insert(const QString &path, const JavaCheckResult &result)
+{
+    if(result.validity == JavaCheckResult::Validity::Errored)
+    {
+        return;
+    }
+    load();
+    auto key = JavaProbeKey::forBinary(path);
+    if(!key.isValid())
+    {
+        return;
+    }
+    m_entries.insert(key.realPath, {key, result});
+    save();
+}
+
+void JavaProbeCache::load()
+{
+    if(m_loaded)
+    {
+        return;
+    }
+    m_loaded = true;
+    QByteArray data;
+    try
+    {
+        data = FS::read(m_path);
+    }
+    catch (const FS::FileSystemException &)
+    {
+        return;
+    }
+
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_5_6);
+    quint32 magic = 0, version = 0, count = 0;
+    in >> magic >> version;
+    if(magic != CACHE_MAGIC || version != CACHE_VERSION)
+    {
+        qDebug() << "Ignoring java probe cache" << m_path << "with unknown format";
+        return;
+    }
+    in >> count;
+
+    QHash<QString, Entry> entries;
+    for(quint32 i = 0; i < count && in.status() == QDataStream::Ok; i++)
+    {
+        Entry entry;
+        in >> entry.key >> entry.result;
+        entries.insert(entry.key.realPath, entry);
+    }
+    if(in.status() != QDataStream::Ok)
+    {
+        qWarning() << "Java probe cache" << m_path << "is truncated or corrupted";
+        return;
+    }
+    m_entries = entries;
+}
+
+bool JavaProbeCache::save() const
+{
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_6);
+    out << CACHE_MAGIC << CACHE_VERSION << quint32(m_entries.size());
+    for(auto & entry: m_entries)
+    {
+        out << entry.key << entry.result;
+    }
+    try
+    {
+        FS::write(m_path, data);
+    }
+    catch (const FS::FileSystemException &e)
+    {
+        qWarning() << "Failed to write java probe cache:" << e.cause();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <QString>
+#include <QHash>
+
+#include "JavaChecker.h"
+
+#include "multiservermc_logic_export.h"
+
+/**
+ * Identifies a java binary by what it resolves to and what is on disk there.
+ * When any of it changes, the binary has to be probed again.
+ */
+struct MULTISERVERMC_LOGIC_EXPORT JavaProbeKey
+{
+    /// the binary with all symlinks resolved
+    QString realPath;
+    qint64 size = 0;
+    qint64 modified = 0;
+    /// 0 where there are no inodes
+    quint64 inode = 0;
+
+    /// The key of the binary at path, invalid if it does not exist
+    static JavaProbeKey forBinary(const QString &path);
+
+    bool isValid() const
+    {
+        return !realPath.isEmpty();
+    }
+    bool operator==(const JavaProbeKey &other) const;
+    bool operator!=(const JavaProbeKey &other) const
+    {
+        return !(*this == other);
+    }
+};
+
+/**
+ * Results of running JavaCheck.jar, shared by everything that probes java binaries and
+ * kept across restarts, so a JVM only has to be started for binaries that changed.
+ *
+ * Only results of plain probes (no extra arguments or memory settings) belong here.
+ * Probes that errored are not kept, they may have just run out of time on a busy machine.
+ * Not thread safe, meant to be used from the GUI thread like the probes themselves.
+ */
+class MULTISERVERMC_LOGIC_EXPORT JavaProbeCache
+{
+public:
+    explicit JavaProbeCache(const QString &path);
+
+    /// A cached result for the binary, with its path set to path
+    bool lookup(const QString &path, JavaCheckResult &result);
+    /// Remember the result of probing the binary at path, saves the cache right away
+    void insert(const QString &path, const JavaCheckResult &result);
+
+    QString path() const
+    {
+        return m_path;
+    }
+
+private:
+    struct Entry
+    {
+        JavaProbeKey key;
+        JavaCheckResult result;
+    };
+
+    void load();
+    bool save() const;
+
+private:
+    QString m_path;
+    bool m_loaded = false;
+    QHash<QString, Entry> m_entries;
+};
@@ -0,0 +1,107 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QSignalSpy>
+#include "TestUtil.h"
+
+#include "FileSystem.h"
+#include "java/JavaProbeCache.h"
+#include "java/JavaCheckerJob.h"
+
+static JavaCheckResult validResult()
+{
+    JavaCheckResult result;
+    result.validity = JavaCheckResult::Validity::Valid;
+    result.javaVersion = QString("17.0.2");
+    result.javaVendor = "Eclipse Adoptium";
+    result.realPlatform = "amd64";
+    result.mojangPlatform = "64";
+    result.is_64bit = true;
+    return result;
+}
+
+class JavaProbeCacheTest : public QObject
+{
+    Q_OBJECT
+private
+slots:
+    void test_lookup()
+    {
+        QTemporaryDir tempDir;
+        QString javaPath = FS::PathCombine(tempDir.path(), "jdk", "bin", "java");
+        QString cachePath = FS::PathCombine(tempDir.path(), "javaprobes.cache");
+        FS::write(javaPath, "not really java");
+
+        JavaCheckResult result;
+        {
+            JavaProbeCache cache(cachePath);
+            QVERIFY(!cache.lookup(javaPath, result));
+            cache.insert(javaPath, validResult());
+            QVERIFY(cache.lookup(javaPath, result));
+            QCOMPARE(result.javaVersion.toString(), QString("17.0.2"));
+            QCOMPARE(result.path, javaPath);
+        }
+
+        // kept across restarts
+        {
+            JavaProbeCache cache(cachePath);
+            QVERIFY(cache.lookup(javaPath, result));
+            QCOMPARE(result.javaVendor, QString("Eclipse Adoptium"));
+            QVERIFY(result.is_64bit);
+        }
+
+        // a changed binary has to be probed again
+        FS::write(javaPath, "a different java");
+        {
+            JavaProbeCache cache(cachePath);
+            QVERIFY(!cache.lookup(javaPath, result));
+        }
+    }
+
+    void test_erroredNotKept()
+    {
+        QTemporaryDir tempDir;
+        QString javaPath = FS::PathCombine(tempDir.path(), "java");
+        FS::write(javaPath, "java");
+        JavaProbeCache cache(FS::PathCombine(tempDir.path(), "javaprobes.cache"));
+        JavaCheckResult errored;
+        cache.insert(javaPath, errored);
+        QVERIFY(!cache.lookup(javaPath, errored));
+    }
+
+#if defined(Q_OS_UNIX)
+    void test_jobUsesCache()
+    {
+        QTemporaryDir tempDir;
+        QString javaPath = FS::PathCombine(tempDir.path(), "jdk", "bin", "java");
+        QString linkPath = FS::PathCombine(tempDir.path(), "java");
+        FS::write(javaPath, "not really java");
+        QVERIFY(QFile::link(javaPath, linkPath));
+        auto cache = std::make_shared<JavaProbeCache>(FS::PathCombine(tempDir.path(), "javaprobes.cache"));
+        cache->insert(javaPath, validResult());
+
+        // both paths lead to the same known binary, nothing has to be started
+        JavaCheckerJob job("test", cache);
+        int id = 0;
+        for(auto & path: {javaPath, linkPath})
+        {
+            JavaCheckerPtr checker(new JavaChecker());
+            checker->m_path = path;
+            checker->m_id = id++;
+            job.addJavaCheckerAction(checker);
+        }
+        QSignalSpy spy(&job, &Task::succeeded);
+        job.start();
+        QCOMPARE(spy.count(), 1);
+        auto results = job.getResults();
+        QCOMPARE(results.size(), 2);
+        QCOMPARE(results[0].path, javaPath);
+        QCOMPARE(results[1].path, linkPath);
+        QCOMPARE(results[1].id, 1);
+        QVERIFY(results[1].validity == JavaCheckResult::Validity::Valid);
+    }
+#endif
+};
+
+QTEST_GUILESS_MAIN(JavaProbeCacheTest)
+
+#include "JavaProbeCache_test.moc"
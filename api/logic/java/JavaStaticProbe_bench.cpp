@@ -0,0 +1,74 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QSignalSpy>
+#include "TestUtil.h"
+
+#include "FileSystem.h"
+#include "java/JavaUtils.h"
+#include "java/JavaCheckerJob.h"
+
+/// Just enough of an ELF header to tell the architecture
+static QByteArray elfHeader(quint8 machine)
+{
+    QByteArray header(64, '\0');
+    header.replace(0, 4, "\x7f" "ELF");
+    header[4] = 2; // 64 bit
+    header[5] = 1; // little endian
+    header[18] = char(machine);
+    return header;
+}
+
+/// A JDK with a release file and a bin/java that is not a JVM at all
+static QString makeJdk(const QString &root, const QString &version, const QString &arch = "x86_64",
+                       quint8 machine = 0x3e, bool jreLayout = false)
+{
+    auto binDir = jreLayout ? FS::PathCombine(root, "jre", "bin") : FS::PathCombine(root, "bin");
+    auto javaPath = FS::PathCombine(binDir, "java");
+    FS::write(javaPath, elfHeader(machine));
+    QFile::setPermissions(javaPath, QFile::permissions(javaPath) | QFile::ExeOwner);
+    if(!version.isEmpty())
+    {
+        QString release = QString("IMPLEMENTOR=\"Eclipse Adoptium\"\nJAVA_VERSION=\"%1\"\nOS_ARCH=\"%2\"\nOS_NAME=\"Linux\"\n").arg(version, arch);
+        FS::write(FS::PathCombine(root, "release"), release.toUtf8());
+    }
+    return javaPath;
+}
+
+class JavaStaticProbeBench : public QObject
+{
+    Q_OBJECT
+private
+slots:
+#if defined(Q_OS_UNIX)
+    void bench_discovery()
+    {
+        QTemporaryDir tempDir;
+        QStringList paths;
+        for(int i = 0; i < 50; i++)
+        {
+            paths.append(makeJdk(FS::PathCombine(tempDir.path(), QString("jdk-%1").arg(i)), QString("17.0.%1").arg(i)));
+        }
+        // a full discovery pass over 50 installs without a probe cache, none of them start a JVM
+        QBENCHMARK
+        {
+            JavaCheckerJob job("discovery");
+            int id = 0;
+            for(auto & path: paths)
+            {
+                JavaCheckerPtr checker(new JavaChecker());
+                checker->m_path = path;
+                checker->m_id = id++;
+                job.addJavaCheckerAction(checker);
+            }
+            QSignalSpy spy(&job, &Task::succeeded);
+            job.start();
+            QVERIFY(spy.count() == 1 || spy.wait(10000));
+            QCOMPARE(job.getResults().size(), paths.size());
+        }
+    }
+#endif
+};
+
+QTEST_GUILESS_MAIN(JavaStaticProbeBench)
+
+#include "JavaStaticProbe_bench.moc"
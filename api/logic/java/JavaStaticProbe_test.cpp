@@ -0,0 +1,131 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QSignalSpy>
+#include "TestUtil.h"
+
+#include "FileSystem.h"
+#include "java/JavaUtils.h"
+#include "java/JavaCheckerJob.h"
+
+/// Just enough of an ELF header to tell the architecture
+static QByteArray elfHeader(quint8 machine)
+{
+    QByteArray header(64, '\0');
+    header.replace(0, 4, "\x7f" "ELF");
+    header[4] = 2; // 64 bit
+    header[5] = 1; // little endian
+    header[18] = char(machine);
+    return header;
+}
+
+/// A JDK with a release file and a bin/java that is not a JVM at all
+static QString makeJdk(const QString &root, const QString &version, const QString &arch = "x86_64",
+                       quint8 machine = 0x3e, bool jreLayout = false)
+{
+    auto binDir = jreLayout ? FS::PathCombine(root, "jre", "bin") : FS::PathCombine(root, "bin");
+    auto javaPath = FS::PathCombine(binDir, "java");
+    FS::write(javaPath, elfHeader(machine));
+    QFile::setPermissions(javaPath, QFile::permissions(javaPath) | QFile::ExeOwner);
+    if(!version.isEmpty())
+    {
+        QString release = QString("IMPLEMENTOR=\"Eclipse Adoptium\"\nJAVA_VERSION=\"%1\"\nOS_ARCH=\"%2\"\nOS_NAME=\"Linux\"\n").arg(version, arch);
+        FS::write(FS::PathCombine(root, "release"), release.toUtf8());
+    }
+    return javaPath;
+}
+
+class JavaStaticProbeTest : public QObject
+{
+    Q_OBJECT
+private
+slots:
+    void test_binaryArchitecture()
+    {
+        QTemporaryDir tempDir;
+        auto path = FS::PathCombine(tempDir.path(), "java");
+        FS::write(path, elfHeader(0xb7));
+        QCOMPARE(JavaUtils::BinaryArchitecture(path), QString("aarch64"));
+        FS::write(path, "#!/bin/sh\nexec java \"$@\"\n");
+        QCOMPARE(JavaUtils::BinaryArchitecture(path), QString());
+    }
+
+#if defined(Q_OS_UNIX)
+    void test_release()
+    {
+        QTemporaryDir tempDir;
+        auto javaPath = makeJdk(FS::PathCombine(tempDir.path(), "jdk-17"), "17.0.2");
+        JavaCheckResult result;
+        QVERIFY(JavaUtils::ProbeJavaStatically(javaPath, result));
+        QVERIFY(result.validity == JavaCheckResult::Validity::Valid);
+        QCOMPARE(result.path, javaPath);
+        QCOMPARE(result.javaVersion.toString(), QString("17.0.2"));
+        QCOMPARE(result.javaVendor, QString("Eclipse Adoptium"));
+        QCOMPARE(result.realPlatform, QString("amd64"));
+        QCOMPARE(result.mojangPlatform, QString("64"));
+        QVERIFY(result.is_64bit);
+    }
+
+    void test_jreLayout()
+    {
+        QTemporaryDir tempDir;
+        auto javaPath = makeJdk(FS::PathCombine(tempDir.path(), "jdk8"), "1.8.0_312", "amd64", 0x3e, true);
+        JavaCheckResult result;
+        QVERIFY(JavaUtils::ProbeJavaStatically(javaPath, result));
+        QCOMPARE(result.javaVersion.toString(), QString("1.8.0_312"));
+    }
+
+    void test_rejected()
+    {
+        QTemporaryDir tempDir;
+        JavaCheckResult result;
+
+        // no release file, only the JVM can tell
+        auto bare = makeJdk(FS::PathCombine(tempDir.path(), "bare"), QString());
+        QVERIFY(!JavaUtils::ProbeJavaStatically(bare, result));
+
+        // release file for a different architecture than the binary
+        auto mixed = makeJdk(FS::PathCombine(tempDir.path(), "mixed"), "17.0.2", "aarch64", 0x3e);
+        QVERIFY(!JavaUtils::ProbeJavaStatically(mixed, result));
+
+        // not in a bin folder
+        auto loose = FS::PathCombine(tempDir.path(), "java");
+        FS::write(loose, elfHeader(0x3e));
+        QFile::setPermissions(loose, QFile::permissions(loose) | QFile::ExeOwner);
+        QVERIFY(!JavaUtils::ProbeJavaStatically(loose, result));
+    }
+
+    void test_checkerJob()
+    {
+        QTemporaryDir tempDir;
+        QStringList paths;
+        for(int i = 0; i < 3; i++)
+        {
+            paths.append(makeJdk(FS::PathCombine(tempDir.path(), QString("jdk-%1").arg(i)), QString("17.0.%1").arg(i)));
+        }
+        // none of these binaries can run, the results can only come from the release files
+        JavaCheckerJob job("discovery");
+        int id = 0;
+        for(auto & path: paths)
+        {
+            JavaCheckerPtr checker(new JavaChecker());
+            checker->m_path = path;
+            checker->m_id = id++;
+            job.addJavaCheckerAction(checker);
+        }
+        QSignalSpy spy(&job, &Task::succeeded);
+        job.start();
+        QVERIFY(spy.count() == 1 || spy.wait(10000));
+        auto results = job.getResults();
+        QCOMPARE(results.size(), paths.size());
+        for(int i = 0; i < results.size(); i++)
+        {
+            QVERIFY(results[i].validity == JavaCheckResult::Validity::Valid);
+            QCOMPARE(results[i].javaVersion.toString(), QString("17.0.%1").arg(i));
+        }
+    }
+#endif
+};
+
+QTEST_GUILESS_MAIN(JavaStaticProbeTest)
+
+#include "JavaStaticProbe_test.moc"
@@ -17,6 +17,11 @@
 #include <QString>
 #include <QDir>
 #include <QStringList>
+#include <QFile>
+#include <QFileInfo>
+#include <QtEndian>
+#include <QMap>
+#include <cstring>
 
 #include <settings/Setting.h>
 
@@ -397,3 +402,184 @@ QList<QString> JavaUtils::FindJavaPaths()
     return javas;
 }
 #endif
+
+namespace {
+/// KEY="value" lines of a release file
+QMap<QString, QString> readReleaseFile(const QString &path)
+{
+    QMap<QString, QString> values;
+    QFile file(path);
+    if(!file.open(QIODevice::ReadOnly | QIODevice::Text) || file.size() > 64 * 1024)
+    {
+        return values;
+    }
+    for(auto line: QString::fromUtf8(file.readAll()).split('\n', QString::SkipEmptyParts))
+    {
+        int equals = line.indexOf('=');
+        if(equals <= 0)
+        {
+            continue;
+        }
+        auto value = line.mid(equals + 1).trimmed();
+        if(value.size() >= 2 && value.startsWith('"') && value.endsWith('"'))
+        {
+            value = value.mid(1, value.size() - 2);
+        }
+        values.insert(line.left(equals).trimmed(), value);
+    }
+    return values;
+}
+
+QString elfArchitecture(const uchar *header, qint64 size)
+{
+    if(size < 20)
+    {
+        return QString();
+    }
+    bool is64 = header[4] == 2;
+    bool bigEndian = header[5] == 2;
+    quint16 machine = bigEndian ? qFromBigEndian<quint16>(header + 18) : qFromLittleEndian<quint16>(header + 18);
+    switch(machine)
+    {
+        case 0x03:
+            return "i386";
+        case 0x3e:
+            return "amd64";
+        case 0x28:
+            return "arm";
+        case 0xb7:
+            return "aarch64";
+        case 0x15:
+            return (is64 && !bigEndian) ? "ppc64le" : QString();
+        default:
+            return QString();
+    }
+}
+
+QString peArchitecture(const uchar *header, qint64 size)
+{
+    if(size < 0x40)
+    {
+        return QString();
+    }
+    quint32 peOffset = qFromLittleEndian<quint32>(header + 0x3c);
+    if(peOffset + 6 > size || memcmp(header + peOffset, "PE\0\0", 4) != 0)
+    {
+        return QString();
+    }
+    switch(qFromLittleEndian<quint16>(header + peOffset + 4))
+    {
+        case 0x14c:
+            return "x86";
+        case 0x8664:
+            return "amd64";
+        case 0xaa64:
+            return "aarch64";
+        default:
+            return QString();
+    }
+}
+
+QString machOArchitecture(const uchar *header, qint64 size)
+{
+    // only thin 64 bit binaries, universal ones depend on how the JVM gets started
+    if(size < 8 || qFromLittleEndian<quint32>(header) != 0xfeedfacf)
+    {
+        return QString();
+    }
+    switch(qFromLittleEndian<quint32>(header + 4))
+    {
+        case 0x01000007:
+            return "x86_64";
+        case 0x0100000c:
+            return "aarch64";
+        default:
+            return QString();
+    }
+}
+
+// the os.arch names different JVMs use for the same thing
+QString normalizedArchitecture(const QString &arch)
+{
+    if(arch == "x86_64" || arch == "amd64")
+    {
+        return "amd64";
+    }
+    if(arch == "i386" || arch == "i586" || arch == "i686" || arch == "x86")
+    {
+        return "x86";
+    }
+    if(arch == "arm64")
+    {
+        return "aarch64";
+    }
+    return arch;
+}
+}
+
+QString JavaUtils::BinaryArchitecture(const QString &path)
+{
+    QFile file(path);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        return QString();
+    }
+    // enough for the DOS stub and PE header of any java.exe
+    auto header = file.read(4096);
+    auto bytes = reinterpret_cast<const uchar *>(header.constData());
+    if(header.startsWith("\x7f" "ELF"))
+    {
+        return elfArchitecture(bytes, header.size());
+    }
+    if(header.startsWith("MZ"))
+    {
+        return peArchitecture(bytes, header.size());
+    }
+    return machOArchitecture(bytes, header.size());
+}
+
+bool JavaUtils::ProbeJavaStatically(const QString &path, JavaCheckResult &result)
+{
+    QFileInfo binary(QFileInfo(path).canonicalFilePath());
+    if(!binary.isFile() || !binary.isExecutable())
+    {
+        return false;
+    }
+    // <home>/bin/java, with JDK 8 also <jdk>/jre/bin/java where the release file is in <jdk>
+    QDir home = binary.dir();
+    if(home.dirName() != "bin" || !home.cdUp())
+    {
+        return false;
+    }
+    auto releasePath = home.absoluteFilePath("release");
+    if(!QFileInfo(releasePath).isFile() && home.dirName() == "jre")
+    {
+        releasePath = QDir(home.absoluteFilePath("..")).absoluteFilePath("release");
+    }
+    auto release = readReleaseFile(releasePath);
+    auto version = release.value("JAVA_VERSION");
+    auto vendor = release.value("IMPLEMENTOR");
+    auto arch = BinaryArchitecture(binary.absoluteFilePath());
+    if(version.isEmpty() || vendor.isEmpty() || arch.isEmpty())
+    {
+        return false;
+    }
+    // a release file that does not belong to the binary is worse than none
+    auto releaseArch = release.value("OS_ARCH");
+    if(!releaseArch.isEmpty() && normalizedArchitecture(releaseArch) != normalizedArchitecture(arch))
+    {
+        qDebug() << "Release file of" << path << "says" << releaseArch << "but the binary is" << arch;
+        return false;
+    }
+
+    result.path = path;
+    result.validity = JavaCheckResult::Validity::Valid;
+    result.javaVersion = version;
+    result.javaVendor = vendor;
+    result.realPlatform = arch;
+    auto normalized = normalizedArchitecture(arch);
+    result.is_64bit = normalized == "amd64" || normalized == "aarch64" || normalized == "ppc64le";
+    result.mojangPlatform = result.is_64bit ? "64" : "32";
+    result.outLog = QString("Read from %1").arg(releasePath);
+    return true;
+}
@@ -38,6 +38,16 @@ public:
     QList<QString> FindJavaPaths();
     JavaInstallPtr GetDefaultJava();
 
+    /**
+     * Find out what a java binary is without starting it: from the release file of its
+     * installation and the executable header of the binary itself.
+     * Fails for installs where the metadata is missing or does not match the binary,
+     * those have to be checked by running JavaCheck.jar.
+     */
+    static bool ProbeJavaStatically(const QString &path, JavaCheckResult &result);
+    /// The os.arch a JVM started from the binary would report, empty if the format is not recognized
+    static QString BinaryArchitecture(const QString &path);
+
 #ifdef Q_OS_WIN
     QList<JavaInstallPtr> FindJavaFromRegistryKey(DWORD keyType, QString keyName, QString keyJavaDir, QString subkeySuffix = "");
 #endif
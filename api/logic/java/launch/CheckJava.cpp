@@ -19,6 +19,8 @@
 #include <QStandardPaths>
 #include <QFileInfo>
 #include <sys.h>
+#include <Env.h>
+#include <java/JavaProbeCache.h>
 
 void CheckJava::executeTask()
 {
@@ -61,6 +63,14 @@ void CheckJava::executeTask()
     // if timestamps are not the same, or something is missing, check!
     if (javaUnixTime != storedUnixTime || storedVersion.size() == 0 || storedArchitecture.size() == 0 || storedVendor.size() == 0)
     {
+        // another instance or the java list may have probed this binary already
+        JavaCheckResult cached;
+        if (ENV.javaProbeCache()->lookup(realJavaPath, cached))
+        {
+            checkJavaFinished(cached);
+            return;
+        }
+        m_realJavaPath = realJavaPath;
         m_JavaChecker = new JavaChecker();
         emit logLine(QString("Checking Java version..."), MessageLevel::MultiServerMC);
         connect(m_JavaChecker.get(), &JavaChecker::checkFinished, this, &CheckJava::checkJavaFinished);
@@ -80,6 +90,11 @@ void CheckJava::executeTask()
 
 void CheckJava::checkJavaFinished(JavaCheckResult result)
 {
+    if (m_JavaChecker)
+    {
+        ENV.javaProbeCache()->insert(m_realJavaPath, result);
+        m_JavaChecker.reset();
+    }
     switch (result.validity)
     {
         case JavaCheckResult::Validity::Errored:
@@ -40,6 +40,7 @@ private:
 
 private:
     QString m_javaPath;
+    QString m_realJavaPath;
     qlonglong m_javaUnixTime;
     JavaCheckerPtr m_JavaChecker;
 };
@@ -0,0 +1,227 @@
+#include "BatchLauncher.h"
+
+#include "launch/LaunchTask.h"
+
+namespace {
+// how often the queues are looked at, staggering and timeouts are only as precise as this
+const int scheduleInterval = 250;
+}
+
+BatchLauncher::BatchLauncher(const QList<InstancePtr> &instances, const BatchLaunchOptions &options, QObject *parent)
+    : Task(parent), m_options(options)
+{
+    m_options.parallel = qMax(m_options.parallel, 1);
+    for(auto & instance: instances)
+    {
+        if(!instance || m_entries.contains(instance->id()))
+        {
+            continue;
+        }
+        Entry entry;
+        entry.instance = instance;
+        m_entries.insert(instance->id(), entry);
+        m_order.append(instance->id());
+    }
+    connect(&m_scheduleTimer, &QTimer::timeout, this, &BatchLauncher::schedule);
+}
+
+void BatchLauncher::executeTask()
+{
+    if(m_order.isEmpty())
+    {
+        emitFailed(tr("There are no instances to launch."));
+        return;
+    }
+    for(auto & id: m_order)
+    {
+        if(m_entries[id].instance->isRunning())
+        {
+            setState(id, State::Failed, tr("It is already running."));
+            continue;
+        }
+        m_updateQueue.append(id);
+    }
+    setStatus(tr("Updating %1 instances...").arg(m_order.size()));
+    m_scheduleTimer.start(scheduleInterval);
+    schedule();
+}
+
+bool BatchLauncher::abort()
+{
+    // the servers that are already up stay up, the rest isn't started
+    m_aborted = true;
+    m_scheduleTimer.stop();
+    m_updateQueue.clear();
+    for(auto & task: m_updateTasks)
+    {
+        task->abort();
+    }
+    for(auto & id: m_updateTasks.keys() + m_startQueue)
+    {
+        setState(id, State::Failed, tr("Aborted."));
+    }
+    m_updateTasks.clear();
+    m_startQueue.clear();
+    emitFailed(tr("Aborted."));
+    return true;
+}
+
+void BatchLauncher::schedule()
+{
+    if(m_aborted)
+    {
+        return;
+    }
+    while(m_updateTasks.size() < m_options.parallel && !m_updateQueue.isEmpty())
+    {
+        startUpdate(m_updateQueue.takeFirst());
+    }
+    if(!m_updateTasks.isEmpty() || !m_updateQueue.isEmpty())
+    {
+        return;
+    }
+
+    int starting = 0;
+    for(auto & id: m_order)
+    {
+        auto & entry = m_entries[id];
+        if(entry.state != State::Starting)
+        {
+            continue;
+        }
+        if(entry.startTime.elapsed() > qint64(m_options.readyTimeout) * 1000)
+        {
+            // it may still come up, but the batch doesn't wait for it any longer
+            setState(id, State::Failed, tr("It didn't report being ready within %1 seconds.").arg(m_options.readyTimeout));
+            continue;
+        }
+        starting++;
+    }
+    if(starting < m_options.parallel && !m_startQueue.isEmpty()
+        && (!m_sinceLastStart.isValid() || m_sinceLastStart.elapsed() >= m_options.stagger))
+    {
+        m_sinceLastStart.start();
+        startServer(m_startQueue.takeFirst());
+    }
+    finishIfDone();
+}
+
+void BatchLauncher::startUpdate(const QString &id)
+{
+    auto & entry = m_entries[id];
+    auto task = entry.instance->createUpdateTask(Net::Mode::Online);
+    if(!task)
+    {
+        m_startQueue.append(id);
+        return;
+    }
+    setState(id, State::Updating);
+    m_updateTasks.insert(id, task);
+    auto raw = task.get();
+    connect(raw, &Task::finished, this, [this, id, raw]()
+    {
+        if(m_aborted)
+        {
+            return;
+        }
+        if(raw->wasSuccessful())
+        {
+            m_startQueue.append(id);
+        }
+        else
+        {
+            setState(id, State::Failed, tr("Updating it failed: %1").arg(raw->failReason()));
+        }
+        // deleted later, after this signal is through
+        m_updateTasks.remove(id);
+        schedule();
+    });
+    task->start();
+}
+
+void BatchLauncher::startServer(const QString &id)
+{
+    auto & entry = m_entries[id];
+    auto instance = entry.instance;
+    if(!instance->reloadSettings() || !instance->canLaunch())
+    {
+        setState(id, State::Failed, tr("It can't be launched."));
+        return;
+    }
+    auto task = instance->createLaunchTask(0);
+    if(!task)
+    {
+        setState(id, State::Failed, tr("Couldn't instantiate a launcher."));
+        return;
+    }
+    entry.startTime.start();
+    m_serversRunning++;
+    setState(id, State::Starting);
+    setStatus(tr("Starting %1...").arg(instance->name()));
+
+    // the instance keeps the launch task, nothing here needs to
+    auto raw = task.get();
+    connect(raw, &LaunchTask::readyForLaunch, raw, &LaunchTask::proceed);
+    connect(raw, &LaunchTask::requestProgress, raw, [raw](Task *)
+    {
+        raw->proceed();
+    });
+    connect(raw, &LaunchTask::lineLogged, this, [this, id](const QString &line, MessageLevel::Enum)
+    {
+        double seconds = 0;
+        if(m_entries[id].state == State::Starting && m_options.isReady && m_options.isReady(line, seconds))
+        {
+            setState(id, State::Ready, QString::number(seconds, 'f', 3));
+            finishIfDone();
+        }
+    });
+    connect(raw, &Task::finished, this, [this, id, raw]()
+    {
+        if(m_entries[id].state == State::Starting)
+        {
+            setState(id, State::Failed, raw->wasSuccessful() ? tr("The server exited before it was ready.") : raw->failReason());
+        }
+        m_serversRunning--;
+        emit serverFinished(m_entries[id].instance);
+        finishIfDone();
+    });
+    task->start();
+}
+
+void BatchLauncher::setState(const QString &id, State state, const QString &detail)
+{
+    auto & entry = m_entries[id];
+    entry.state = state;
+    emit instanceStateChanged(entry.instance, state, detail);
+}
+
+void BatchLauncher::finishIfDone()
+{
+    if(!isRunning() || !m_updateTasks.isEmpty() || !m_updateQueue.isEmpty() || !m_startQueue.isEmpty())
+    {
+        return;
+    }
+    int ready = 0;
+    for(auto & entry: m_entries)
+    {
+        switch(entry.state)
+        {
+            case State::Ready:
+                ready++;
+                break;
+            case State::Failed:
+                break;
+            default:
+                return;
+        }
+    }
+    m_scheduleTimer.stop();
+    if(ready == m_entries.size())
+    {
+        emitSucceeded();
+    }
+    else
+    {
+        emitFailed(tr("%1 of %2 servers are ready.").arg(ready).arg(m_entries.size()));
+    }
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QList>
+#include <QMap>
+#include <functional>
+
+#include "BaseInstance.h"
+#include "tasks/Task.h"
+#include "QObjectPtr.h"
+
+#include "multiservermc_logic_export.h"
+
+struct BatchLaunchOptions
+{
+    /// how many instances may be updating or starting up at the same time
+    int parallel = 4;
+    /// msecs between two server starts
+    int stagger = 5000;
+    /// seconds a server gets to print "Done (...)!" before it counts as not ready
+    int readyTimeout = 600;
+    /// whether a console line says the server is ready, and after how many seconds of starting up
+    /// without it no server ever counts as ready
+    std::function<bool(const QString &line, double &seconds)> isReady;
+};
+
+/**
+ * Starts many instances without any windows.
+ *
+ * First every instance is updated, at most `parallel` at a time. A library or asset that several
+ * of them need is only downloaded and hashed once, see Net::Download. Then the servers are started,
+ * at most `parallel` at a time and `stagger` msecs apart, and each counts as ready once isReady()
+ * matches a line it prints, like "Done (12.345s)!" for Minecraft servers.
+ *
+ * The task succeeds once every server is ready, and fails once all of them are either ready or not.
+ * The servers keep running either way, and serverFinished() is emitted for them after the task is
+ * done, so the launcher has to be kept until serversRunning() drops to 0.
+ */
+class MULTISERVERMC_LOGIC_EXPORT BatchLauncher : public Task
+{
+    Q_OBJECT
+public:
+    enum class State
+    {
+        Queued,
+        Updating,
+        Starting,
+        Ready,
+        Failed
+    };
+
+    explicit BatchLauncher(const QList<InstancePtr> &instances, const BatchLaunchOptions &options, QObject *parent = nullptr);
+
+    State state(const QString &instanceId) const
+    {
+        return m_entries.value(instanceId).state;
+    }
+
+    /// servers started by the batch that didn't stop yet, they outlive the task itself
+    int serversRunning() const
+    {
+        return m_serversRunning;
+    }
+
+signals:
+    /// detail is the startup time in seconds for Ready, or the reason for Failed
+    void instanceStateChanged(InstancePtr instance, BatchLauncher::State state, const QString &detail);
+    /// a server started by the batch stopped, whether or not it was ever ready
+    void serverFinished(InstancePtr instance);
+
+protected:
+    virtual void executeTask() override;
+    virtual bool canAbort() const override
+    {
+        return true;
+    }
+    virtual bool abort() override;
+
+private slots:
+    void schedule();
+
+private:
+    struct Entry
+    {
+        InstancePtr instance;
+        State state = State::Queued;
+        QElapsedTimer startTime;
+    };
+
+    void setState(const QString &id, State state, const QString &detail = QString());
+    void startUpdate(const QString &id);
+    void startServer(const QString &id);
+    void finishIfDone();
+
+private:
+    BatchLaunchOptions m_options;
+    QList<QString> m_order;
+    QMap<QString, Entry> m_entries;
+
+    QList<QString> m_updateQueue;
+    QMap<QString, shared_qobject_ptr<Task>> m_updateTasks;
+    QList<QString> m_startQueue;
+    QElapsedTimer m_sinceLastStart;
+    QTimer m_scheduleTimer;
+    bool m_aborted = false;
+    int m_serversRunning = 0;
+};
@@ -0,0 +1,248 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QElapsedTimer>
+#include "TestUtil.h"
+
+#include "FileSystem.h"
+#include "NullInstance.h"
+#include "launch/BatchLauncher.h"
+#include "launch/LaunchStep.h"
+#include "launch/LaunchTask.h"
+#include "settings/INISettingsObject.h"
+
+// runs until told to stop, and prints the line the batch waits for when told to
+class FakeServerStep : public LaunchStep
+{
+    Q_OBJECT
+public:
+    explicit FakeServerStep(LaunchTask *parent) : LaunchStep(parent)
+    {
+    }
+    void ready()
+    {
+        emit logLine("[12:00:00] [Server thread/INFO]: Done (1.234s)! For help, type \"help\"", MessageLevel::StdOut);
+    }
+    void stop()
+    {
+        emitSucceeded();
+    }
+
+protected:
+    void executeTask() override
+    {
+    }
+};
+
+class FakeServerInstance : public NullInstance
+{
+    Q_OBJECT
+public:
+    FakeServerInstance(SettingsObjectPtr globalSettings, SettingsObjectPtr settings, const QString &rootDir)
+        : NullInstance(globalSettings, settings, rootDir)
+    {
+    }
+    bool canLaunch() const override
+    {
+        return !isRunning();
+    }
+    shared_qobject_ptr<LaunchTask> createLaunchTask(int) override
+    {
+        auto task = LaunchTask::create(shared_from_this());
+        step.reset(new FakeServerStep(task.get()));
+        task->appendStep(step);
+        m_task = task;
+        return task;
+    }
+
+    shared_qobject_ptr<FakeServerStep> step;
+
+private:
+    shared_qobject_ptr<LaunchTask> m_task;
+};
+
+class BatchLauncherTest : public QObject
+{
+    Q_OBJECT
+
+    SettingsObjectPtr m_globalSettings;
+
+    QList<InstancePtr> makeInstances(const QString &path, int count)
+    {
+        if(!m_globalSettings)
+        {
+            auto settings = std::make_shared<INISettingsObject>(FS::PathCombine(path, "global.cfg"));
+            settings->registerSetting("PreLaunchCommand", "");
+            settings->registerSetting("WrapperCommand", "");
+            settings->registerSetting("PostExitCommand", "");
+            settings->registerSetting("ShowConsole", false);
+            settings->registerSetting("AutoCloseConsole", false);
+            settings->registerSetting("ShowConsoleOnError", true);
+            settings->registerSetting("LogPrePostOutput", true);
+            settings->registerSetting("ConsoleMaxLines", 100000);
+            settings->registerSetting("ConsoleOverflowStop", true);
+            m_globalSettings = settings;
+        }
+        QList<InstancePtr> instances;
+        for(int i = 0; i < count; i++)
+        {
+            auto root = FS::PathCombine(path, QString("server%1").arg(i));
+            auto settings = std::make_shared<INISettingsObject>(FS::PathCombine(root, "instance.cfg"));
+            instances.append(std::make_shared<FakeServerInstance>(m_globalSettings, settings, root));
+            // written right away, so reloading the settings before the launch finds the file
+            instances.last()->setName(QString("Server %1").arg(i));
+        }
+        return instances;
+    }
+
+    // what a ready server prints is up to the caller, the batch itself doesn't know about Minecraft
+    BatchLaunchOptions makeOptions()
+    {
+        BatchLaunchOptions options;
+        options.isReady = [](const QString &line, double &seconds)
+        {
+            seconds = 1.234;
+            return line.endsWith("Done (1.234s)! For help, type \"help\"");
+        };
+        return options;
+    }
+
+    FakeServerInstance *fake(const InstancePtr &instance)
+    {
+        return static_cast<FakeServerInstance *>(instance.get());
+    }
+
+private
+slots:
+    void cleanup()
+    {
+        m_globalSettings.reset();
+    }
+
+    // no more than `parallel` servers are starting up at once, and they start in the given order
+    void test_parallelLimit()
+    {
+        QTemporaryDir tempDir;
+        auto instances = makeInstances(tempDir.path(), 4);
+        auto options = makeOptions();
+        options.parallel = 2;
+        options.stagger = 0;
+        BatchLauncher batch(instances, options);
+
+        int starting = 0;
+        int mostStarting = 0;
+        QStringList startOrder;
+        connect(&batch, &BatchLauncher::instanceStateChanged, [&](InstancePtr instance, BatchLauncher::State state, const QString &)
+        {
+            if(state == BatchLauncher::State::Starting)
+            {
+                startOrder.append(instance->id());
+                mostStarting = qMax(mostStarting, ++starting);
+            }
+            else if(state == BatchLauncher::State::Ready || state == BatchLauncher::State::Failed)
+            {
+                starting--;
+            }
+        });
+
+        batch.start();
+        QTRY_COMPARE(startOrder.size(), 2);
+        QVERIFY(batch.state(instances[2]->id()) == BatchLauncher::State::Queued);
+
+        // one more once a slot frees up
+        fake(instances[0])->step->ready();
+        QTRY_COMPARE(startOrder.size(), 3);
+        QVERIFY(batch.state(instances[3]->id()) == BatchLauncher::State::Queued);
+        fake(instances[1])->step->ready();
+        QTRY_COMPARE(startOrder.size(), 4);
+        fake(instances[2])->step->ready();
+        fake(instances[3])->step->ready();
+        QTRY_VERIFY(batch.isFinished());
+
+        QVERIFY(batch.wasSuccessful());
+        QCOMPARE(mostStarting, 2);
+        QCOMPARE(startOrder, QStringList({"server0", "server1", "server2", "server3"}));
+        for(auto & instance: instances)
+        {
+            fake(instance)->step->stop();
+        }
+    }
+
+    void test_stagger()
+    {
+        QTemporaryDir tempDir;
+        auto instances = makeInstances(tempDir.path(), 2);
+        auto options = makeOptions();
+        options.parallel = 2;
+        options.stagger = 1000;
+        BatchLauncher batch(instances, options);
+
+        QList<qint64> startTimes;
+        QElapsedTimer clock;
+        connect(&batch, &BatchLauncher::instanceStateChanged, [&](InstancePtr, BatchLauncher::State state, const QString &)
+        {
+            if(state == BatchLauncher::State::Starting)
+            {
+                startTimes.append(clock.elapsed());
+            }
+        });
+
+        clock.start();
+        batch.start();
+        QTRY_COMPARE(startTimes.size(), 2);
+        QVERIFY(startTimes[1] - startTimes[0] >= options.stagger);
+        for(auto & instance: instances)
+        {
+            fake(instance)->step->stop();
+        }
+    }
+
+    // the task is done once the servers are up, but they keep running and report when they stop
+    void test_serversOutliveBatch()
+    {
+        QTemporaryDir tempDir;
+        auto instances = makeInstances(tempDir.path(), 1);
+        auto options = makeOptions();
+        options.stagger = 0;
+        BatchLauncher batch(instances, options);
+        int finished = 0;
+        connect(&batch, &BatchLauncher::serverFinished, [&](InstancePtr)
+        {
+            finished++;
+        });
+
+        batch.start();
+        QTRY_VERIFY(batch.state("server0") == BatchLauncher::State::Starting);
+        QCOMPARE(batch.serversRunning(), 1);
+        fake(instances[0])->step->ready();
+        QTRY_VERIFY(batch.isFinished());
+        QVERIFY(batch.wasSuccessful());
+        QCOMPARE(batch.serversRunning(), 1);
+
+        fake(instances[0])->step->stop();
+        QCOMPARE(finished, 1);
+        QCOMPARE(batch.serversRunning(), 0);
+        QVERIFY(!instances[0]->isRunning());
+    }
+
+    void test_notReadyInTime()
+    {
+        QTemporaryDir tempDir;
+        auto instances = makeInstances(tempDir.path(), 1);
+        auto options = makeOptions();
+        options.stagger = 0;
+        options.readyTimeout = 0;
+        BatchLauncher batch(instances, options);
+
+        batch.start();
+        QTRY_VERIFY(batch.isFinished());
+        QVERIFY(!batch.wasSuccessful());
+        QVERIFY(batch.state("server0") == BatchLauncher::State::Failed);
+        // it was started all the same and is left running
+        QCOMPARE(batch.serversRunning(), 1);
+        fake(instances[0])->step->stop();
+    }
+};
+
+QTEST_GUILESS_MAIN(BatchLauncherTest)
+
+#include "BatchLauncher_test.moc"
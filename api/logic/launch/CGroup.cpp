@@ -0,0 +1,258 @@
+#include "CGroup.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QStringList>
+#include <QRegularExpression>
+#include <QObject>
+#include <QDebug>
+
+namespace {
+const QString launcherLeaf = "multiservermc-launcher";
+
+QByteArray readFile(const QString &path)
+{
+    QFile file(path);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        return QByteArray();
+    }
+    return file.readAll();
+}
+
+bool writeFile(const QString &path, const QByteArray &data, QString &error)
+{
+    QFile file(path);
+    if(!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.flush())
+    {
+        error = QObject::tr("Couldn't write '%1' to %2: %3").arg(QString::fromUtf8(data), path, file.errorString());
+        return false;
+    }
+    return true;
+}
+
+/// "key value" lines of cpu.stat and memory.stat
+QHash<QByteArray, qint64> flatKeyedValues(const QByteArray &data)
+{
+    QHash<QByteArray, qint64> values;
+    for(auto & line: data.split('\n'))
+    {
+        int space = line.indexOf(' ');
+        if(space > 0)
+        {
+            values.insert(line.left(space), line.mid(space + 1).trimmed().toLongLong());
+        }
+    }
+    return values;
+}
+
+#if defined(Q_OS_LINUX)
+/// the cgroup of a process, from the unified hierarchy entry of /proc/<pid>/cgroup
+QString cgroupFrom(const QString &procCGroupPath)
+{
+    for(auto & line: readFile(procCGroupPath).split('\n'))
+    {
+        if(line.startsWith("0::"))
+        {
+            return QDir::cleanPath("/sys/fs/cgroup/" + QString::fromUtf8(line.mid(3).trimmed()));
+        }
+    }
+    return QString();
+}
+
+/// the cgroup MultiServerMC runs in
+QString ownCGroup()
+{
+    return cgroupFrom("/proc/self/cgroup");
+}
+#endif
+
+/// Where instance cgroups go, with the controllers they need enabled. Done once per process.
+QString instanceParent(QString &error)
+{
+    static QString parent;
+    if(!parent.isEmpty())
+    {
+        return parent;
+    }
+#if defined(Q_OS_LINUX)
+    auto own = ownCGroup();
+    if(own.isEmpty() || !QFileInfo(own + "/cgroup.controllers").exists())
+    {
+        error = QObject::tr("The cgroup v2 hierarchy is not mounted at /sys/fs/cgroup.");
+        return QString();
+    }
+    QDir baseDir(own);
+    if(baseDir.dirName() == launcherLeaf)
+    {
+        baseDir.cdUp();
+    }
+    auto base = baseDir.absolutePath();
+    auto leaf = baseDir.absoluteFilePath(launcherLeaf);
+    if(!QFileInfo(leaf).isDir() && !baseDir.mkdir(launcherLeaf))
+    {
+        error = QObject::tr("Couldn't create a cgroup in %1, it is probably not delegated to you.").arg(base);
+        return QString();
+    }
+    // a cgroup that has processes in it can't enable controllers for its children
+    if(own != leaf && !writeFile(leaf + "/cgroup.procs", "0", error))
+    {
+        return QString();
+    }
+    auto available = QString::fromUtf8(readFile(base + "/cgroup.controllers")).split(QRegularExpression("\\s+"), QString::SkipEmptyParts);
+    QStringList enable;
+    for(auto controller: {"cpu", "memory", "io"})
+    {
+        if(available.contains(controller))
+        {
+            enable.append(QString("+") + controller);
+        }
+    }
+    if(!enable.isEmpty() && !writeFile(base + "/cgroup.subtree_control", enable.join(' ').toUtf8(), error))
+    {
+        return QString();
+    }
+    parent = base;
+    return parent;
+#else
+    error = QObject::tr("Resource limits need cgroup v2, which only exists on Linux.");
+    return QString();
+#endif
+}
+
+/// Write a limit, a missing file means the controller is not enabled, which only matters for non-default values
+bool writeLimit(const QString &path, const QByteArray &value, bool isDefault, QString &error)
+{
+    if(!QFileInfo(path).exists())
+    {
+        if(isDefault)
+        {
+            return true;
+        }
+        error = QObject::tr("%1 does not exist, the controller for it is not available.").arg(path);
+        return false;
+    }
+    return writeFile(path, value, error);
+}
+}
+
+CGroup::CGroup(const QString &path) : m_path(path)
+{
+}
+
+std::shared_ptr<CGroup> CGroup::create(const QString &instanceId, const CGroupLimits &limits, QString &error)
+{
+    auto parent = instanceParent(error);
+    if(parent.isEmpty())
+    {
+        return nullptr;
+    }
+    auto name = "multiservermc-" + QString(instanceId).replace(QRegularExpression("[^A-Za-z0-9_.-]"), "_");
+    QDir parentDir(parent);
+    // left behind when MultiServerMC went away while the instance was running
+    if(!QFileInfo(parentDir.absoluteFilePath(name)).isDir() && !parentDir.mkdir(name))
+    {
+        error = QObject::tr("Couldn't create the cgroup %1.").arg(parentDir.absoluteFilePath(name));
+        return nullptr;
+    }
+    auto cgroup = std::make_shared<CGroup>(parentDir.absoluteFilePath(name));
+    if(!cgroup->applyLimits(limits, error))
+    {
+        cgroup->remove();
+        return nullptr;
+    }
+    return cgroup;
+}
+
+QString CGroup::procsPath() const
+{
+    return m_path + "/cgroup.procs";
+}
+
+QString CGroup::ofProcess(qint64 pid)
+{
+#if defined(Q_OS_LINUX)
+    return cgroupFrom(QString("/proc/%1/cgroup").arg(pid));
+#else
+    Q_UNUSED(pid);
+    return QString();
+#endif
+}
+
+bool CGroup::applyLimits(const CGroupLimits &limits, QString &error) const
+{
+    QDir dir(m_path);
+    if(!writeLimit(dir.absoluteFilePath("cpu.weight"), QByteArray::number(qBound(1, limits.cpuWeight, 10000)), limits.cpuWeight == 100, error))
+    {
+        return false;
+    }
+    // quota per 100ms period
+    QByteArray cpuMax = limits.cpuQuotaPercent > 0 ? QByteArray::number(qint64(limits.cpuQuotaPercent) * 1000) + " 100000" : "max 100000";
+    if(!writeLimit(dir.absoluteFilePath("cpu.max"), cpuMax, limits.cpuQuotaPercent <= 0, error))
+    {
+        return false;
+    }
+    QByteArray memoryMax = limits.memoryMaxBytes > 0 ? QByteArray::number(limits.memoryMaxBytes) : "max";
+    if(!writeLimit(dir.absoluteFilePath("memory.max"), memoryMax, limits.memoryMaxBytes <= 0, error))
+    {
+        return false;
+    }
+    QByteArray ioWeight = "default " + QByteArray::number(qBound(1, limits.ioWeight, 10000));
+    return writeLimit(dir.absoluteFilePath("io.weight"), ioWeight, limits.ioWeight == 100, error);
+}
+
+ResourceUsage CGroup::sample()
+{
+    ResourceUsage usage;
+    QDir dir(m_path);
+    auto cpuStat = flatKeyedValues(readFile(dir.absoluteFilePath("cpu.stat")));
+    if(!cpuStat.contains("usage_usec"))
+    {
+        return usage;
+    }
+    auto cpuUsec = cpuStat.value("usage_usec");
+    if(m_lastCpuUsec >= 0 && m_sampleTimer.isValid())
+    {
+        auto elapsedUsec = m_sampleTimer.nsecsElapsed() / 1000;
+        if(elapsedUsec > 0)
+        {
+            usage.cpuPercent = 100.0 * qMax<qint64>(cpuUsec - m_lastCpuUsec, 0) / elapsedUsec;
+        }
+    }
+    m_lastCpuUsec = cpuUsec;
+    m_sampleTimer.start();
+
+    usage.memoryBytes = readFile(dir.absoluteFilePath("memory.current")).trimmed().toLongLong();
+    usage.rssBytes = flatKeyedValues(readFile(dir.absoluteFilePath("memory.stat"))).value("anon");
+    // "8:0 rbytes=1 wbytes=2 rios=3 wios=4 dbytes=0 dios=0" per device
+    for(auto & line: readFile(dir.absoluteFilePath("io.stat")).split('\n'))
+    {
+        for(auto & field: line.split(' '))
+        {
+            if(field.startsWith("rbytes="))
+            {
+                usage.ioReadBytes += field.mid(7).toLongLong();
+            }
+            else if(field.startsWith("wbytes="))
+            {
+                usage.ioWriteBytes += field.mid(7).toLongLong();
+            }
+        }
+    }
+    usage.valid = true;
+    return usage;
+}
+
+bool CGroup::remove() const
+{
+    QDir dir(m_path);
+    auto name = dir.dirName();
+    if(!dir.cdUp() || !dir.rmdir(name))
+    {
+        qWarning() << "Couldn't remove the cgroup" << m_path;
+        return false;
+    }
+    return true;
+}
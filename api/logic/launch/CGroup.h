@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QString>
+#include <QElapsedTimer>
+#include <memory>
+
+#include "ResourceUsage.h"
+
+#include "multiservermc_logic_export.h"
+
+struct CGroupLimits
+{
+    /// 1 - 10000, 100 is what everything else gets
+    int cpuWeight = 100;
+    /// percent of one CPU, 0 for no quota
+    int cpuQuotaPercent = 0;
+    /// 0 for no limit
+    qint64 memoryMaxBytes = 0;
+    /// 1 - 10000, 100 is what everything else gets
+    int ioWeight = 100;
+};
+
+/**
+ * A cgroup v2 directory holding the processes of one instance.
+ *
+ * Instance cgroups are created below the cgroup of MultiServerMC itself, which therefore has to be
+ * delegated to the user (as systemd does for user sessions and units with Delegate=yes).
+ * MultiServerMC moves itself into a leaf next to them first, because processes may only live in
+ * leaves of a cgroup with enabled controllers.
+ */
+class MULTISERVERMC_LOGIC_EXPORT CGroup
+{
+public:
+    /// Use an existing cgroup directory
+    explicit CGroup(const QString &path);
+
+    /// Create or reuse the cgroup for the instance with the given id and apply limits to it
+    static std::shared_ptr<CGroup> create(const QString &instanceId, const CGroupLimits &limits, QString &error);
+
+    QString path() const
+    {
+        return m_path;
+    }
+    /// Processes write "0" here to move themselves into the cgroup
+    QString procsPath() const;
+
+    /// The cgroup v2 directory the process with this pid is in, empty if that can't be read
+    static QString ofProcess(qint64 pid);
+
+    bool applyLimits(const CGroupLimits &limits, QString &error) const;
+
+    /**
+     * Read the usage counters of the cgroup.
+     * CPU usage is averaged over the time since the previous sample, the first one reports 0.
+     */
+    ResourceUsage sample();
+
+    /// Remove the cgroup, only works once all its processes are gone
+    bool remove() const;
+
+private:
+    QString m_path;
+    qint64 m_lastCpuUsec = -1;
+    QElapsedTimer m_sampleTimer;
+};
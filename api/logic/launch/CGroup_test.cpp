@@ -0,0 +1,115 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QFile>
+#include <QCoreApplication>
+#include "TestUtil.h"
+
+#include "launch/CGroup.h"
+
+class CGroupTest : public QObject
+{
+    Q_OBJECT
+
+    void writeFile(const QString &path, const QByteArray &data)
+    {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(data);
+    }
+
+    QByteArray readFile(const QString &path)
+    {
+        QFile file(path);
+        file.open(QIODevice::ReadOnly);
+        return file.readAll();
+    }
+
+private
+slots:
+    void test_sample()
+    {
+        QTemporaryDir dir;
+        writeFile(dir.path() + "/cpu.stat", "usage_usec 1000\nuser_usec 800\nsystem_usec 200\n");
+        writeFile(dir.path() + "/memory.current", "104857600\n");
+        writeFile(dir.path() + "/memory.stat", "anon 52428800\nfile 41943040\n");
+        writeFile(dir.path() + "/io.stat", "8:0 rbytes=100 wbytes=200 rios=1 wios=2 dbytes=0 dios=0\n259:0 rbytes=1000 wbytes=2000 rios=3 wios=4 dbytes=0 dios=0\n");
+
+        CGroup cgroup(dir.path());
+        auto usage = cgroup.sample();
+        QVERIFY(usage.valid);
+        QCOMPARE(usage.cpuPercent, 0.0);
+        QCOMPARE(usage.memoryBytes, qint64(104857600));
+        QCOMPARE(usage.rssBytes, qint64(52428800));
+        QCOMPARE(usage.ioReadBytes, qint64(1100));
+        QCOMPARE(usage.ioWriteBytes, qint64(2200));
+
+        QTest::qSleep(50);
+        writeFile(dir.path() + "/cpu.stat", "usage_usec 1001000\n");
+        usage = cgroup.sample();
+        QVERIFY(usage.cpuPercent > 0);
+    }
+
+    void test_sampleGone()
+    {
+        QTemporaryDir dir;
+        CGroup cgroup(dir.path() + "/missing");
+        QVERIFY(!cgroup.sample().valid);
+    }
+
+    void test_applyLimits()
+    {
+        QTemporaryDir dir;
+        for(auto file: {"/cpu.weight", "/cpu.max", "/memory.max", "/io.weight"})
+        {
+            writeFile(dir.path() + file, "");
+        }
+        CGroupLimits limits;
+        limits.cpuWeight = 50;
+        limits.cpuQuotaPercent = 150;
+        limits.memoryMaxBytes = 1024 * 1024 * 1024;
+        limits.ioWeight = 20000;
+
+        CGroup cgroup(dir.path());
+        QString error;
+        QVERIFY(cgroup.applyLimits(limits, error));
+        QCOMPARE(readFile(dir.path() + "/cpu.weight"), QByteArray("50"));
+        QCOMPARE(readFile(dir.path() + "/cpu.max"), QByteArray("150000 100000"));
+        QCOMPARE(readFile(dir.path() + "/memory.max"), QByteArray("1073741824"));
+        QCOMPARE(readFile(dir.path() + "/io.weight"), QByteArray("default 10000"));
+    }
+
+    void test_applyLimitsMissingController()
+    {
+        QTemporaryDir dir;
+        writeFile(dir.path() + "/cpu.weight", "");
+        writeFile(dir.path() + "/cpu.max", "");
+
+        CGroup cgroup(dir.path());
+        QString error;
+        // defaults don't need the memory and io controllers
+        QVERIFY(cgroup.applyLimits(CGroupLimits(), error));
+
+        CGroupLimits limits;
+        limits.memoryMaxBytes = 1024;
+        QVERIFY(!cgroup.applyLimits(limits, error));
+        QVERIFY(error.contains("memory.max"));
+    }
+
+    void test_ofProcess()
+    {
+#if defined(Q_OS_LINUX)
+        auto own = CGroup::ofProcess(QCoreApplication::applicationPid());
+        if(own.isEmpty())
+        {
+            QSKIP("The cgroup v2 hierarchy is not there.");
+        }
+        QVERIFY(own.startsWith("/sys/fs/cgroup"));
+#endif
+        // long gone or never there
+        QVERIFY(CGroup::ofProcess(-1).isEmpty());
+    }
+};
+
+QTEST_GUILESS_MAIN(CGroupTest)
+
+#include "CGroup_test.moc"
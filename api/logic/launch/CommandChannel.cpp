@@ -0,0 +1,155 @@
+#include "CommandChannel.h"
+
+namespace {
+// how often a queue that ran out of tokens is looked at again
+const int pumpInterval = 50;
+}
+
+CommandChannel::CommandChannel(QObject *parent) : QObject(parent)
+{
+    m_pumpTimer.setInterval(pumpInterval);
+    connect(&m_pumpTimer, &QTimer::timeout, this, &CommandChannel::pump);
+    m_responseTimer.setSingleShot(true);
+    connect(&m_responseTimer, &QTimer::timeout, this, &CommandChannel::responseTimedOut);
+    m_sinceRefill.start();
+}
+
+void CommandChannel::setRate(int rate)
+{
+    m_rate = qMax(rate, 1);
+    m_tokens = qMin(m_tokens, double(m_rate));
+}
+
+void CommandChannel::setAvailable(bool available)
+{
+    m_available = available;
+    if(available)
+    {
+        pump();
+        return;
+    }
+    m_pumpTimer.stop();
+    // the process that was asked is gone, it won't answer any more
+    if(m_awaiting)
+    {
+        finish(CommandResult::TimedOut);
+    }
+}
+
+quint64 CommandChannel::send(const QString &command, const QString &expect, int timeoutMs)
+{
+    // one command is one line, anything else would sneak more commands past the queue
+    if(m_queue.size() >= m_capacity || command.contains('\n') || command.contains('\r'))
+    {
+        return 0;
+    }
+    Pending pending;
+    if(!expect.isEmpty())
+    {
+        pending.expect = QRegularExpression(expect);
+        if(!pending.expect.isValid())
+        {
+            return 0;
+        }
+        pending.timeoutMs = qMax(timeoutMs, 1);
+    }
+    pending.result.id = m_nextId++;
+    pending.result.command = command;
+    m_queue.append(pending);
+    emit queueChanged(m_queue.size());
+    pump();
+    return pending.result.id;
+}
+
+void CommandChannel::clear()
+{
+    auto dropped = m_queue;
+    m_queue.clear();
+    m_pumpTimer.stop();
+    if(m_awaiting)
+    {
+        finish(CommandResult::TimedOut);
+    }
+    for(auto & pending: dropped)
+    {
+        auto result = pending.result;
+        result.status = CommandResult::Dropped;
+        emit finished(result);
+    }
+    emit queueChanged(0);
+}
+
+void CommandChannel::logLine(const QString &line)
+{
+    if(m_awaiting && m_current.expect.match(line).hasMatch())
+    {
+        finish(CommandResult::Answered, line);
+    }
+}
+
+void CommandChannel::pump()
+{
+    m_tokens = qMin(double(m_rate), m_tokens + m_sinceRefill.restart() * m_rate / 1000.0);
+    if(!m_available || m_awaiting || m_queue.isEmpty())
+    {
+        m_pumpTimer.stop();
+        return;
+    }
+
+    // everything that is due goes out in one write
+    QByteArray data;
+    QList<CommandResult> sent;
+    while(!m_queue.isEmpty() && m_tokens >= 1)
+    {
+        auto pending = m_queue.takeFirst();
+        m_tokens -= 1;
+        data += pending.result.command.toUtf8() + '\n';
+        if(pending.expect.pattern().isEmpty())
+        {
+            sent.append(pending.result);
+            continue;
+        }
+        m_current = pending;
+        m_awaiting = true;
+        m_responseTimer.start(pending.timeoutMs);
+        break;
+    }
+    if(!data.isEmpty())
+    {
+        emit write(data);
+        emit queueChanged(m_queue.size());
+    }
+    for(auto & result: sent)
+    {
+        emit finished(result);
+    }
+
+    if(!m_queue.isEmpty() && !m_awaiting)
+    {
+        m_pumpTimer.start();
+    }
+    else
+    {
+        m_pumpTimer.stop();
+    }
+}
+
+void CommandChannel::responseTimedOut()
+{
+    if(m_awaiting)
+    {
+        finish(CommandResult::TimedOut);
+    }
+}
+
+void CommandChannel::finish(CommandResult::Status status, const QString &response)
+{
+    m_responseTimer.stop();
+    m_awaiting = false;
+    auto result = m_current.result;
+    result.status = status;
+    result.response = response;
+    m_current = Pending();
+    emit finished(result);
+    pump();
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QRegularExpression>
+#include <QList>
+
+#include "multiservermc_logic_export.h"
+
+/// What became of a command sent through a CommandChannel
+struct CommandResult
+{
+    enum Status
+    {
+        /// written to the server, nothing to wait for
+        Sent,
+        /// written, and the server answered with a line matching the expected response
+        Answered,
+        /// written, but no matching line came within the timeout
+        TimedOut,
+        /// never written, the queue was cleared because the server stopped
+        Dropped
+    };
+
+    quint64 id = 0;
+    QString command;
+    Status status = Sent;
+    /// the matching line for Answered
+    QString response;
+};
+
+/**
+ * Queue for the commands written to the console of a server.
+ *
+ * The queue is bounded, send() refuses commands once it is full instead of piling up more than the
+ * server can take. Commands are written at most `rate` per second, the ones due at the same time go
+ * out in one write. A command can wait for a response: a console line matching a regular expression.
+ * Until that line comes or the timeout runs out nothing after it is written, so responses can't be
+ * mixed up with those of later commands.
+ *
+ * Commands only go out while the server process runs, the rest wait for it.
+ */
+class MULTISERVERMC_LOGIC_EXPORT CommandChannel : public QObject
+{
+    Q_OBJECT
+public:
+    explicit CommandChannel(QObject *parent = nullptr);
+
+    /// commands that may wait in the queue
+    void setCapacity(int capacity)
+    {
+        m_capacity = qMax(capacity, 1);
+    }
+    /// commands per second
+    void setRate(int rate);
+    /// whether there is a process to write to
+    void setAvailable(bool available);
+
+    /**
+     * Queue a command, without the trailing newline.
+     * With a non-empty expect, the command waits up to timeoutMs for a console line matching it.
+     * Returns the id of the command, or 0 if the queue is full or the pattern is invalid.
+     */
+    quint64 send(const QString &command, const QString &expect = QString(), int timeoutMs = 10000);
+
+    /// drop everything that wasn't written yet
+    void clear();
+
+    /// commands waiting, not counting the one waiting for its response
+    int queued() const
+    {
+        return m_queue.size();
+    }
+
+    /// feed a line of the server console, it may be the response a command waits for
+    void logLine(const QString &line);
+
+signals:
+    /// the bytes to write to the server
+    void write(const QByteArray &data);
+    void finished(const CommandResult &result);
+    void queueChanged(int queued);
+
+private slots:
+    void pump();
+    void responseTimedOut();
+
+private:
+    struct Pending
+    {
+        CommandResult result;
+        QRegularExpression expect;
+        int timeoutMs = 0;
+    };
+
+    void finish(CommandResult::Status status, const QString &response = QString());
+
+private:
+    QList<Pending> m_queue;
+    /// the written command waiting for its response, if m_awaiting
+    Pending m_current;
+    bool m_awaiting = false;
+    bool m_available = false;
+    int m_capacity = 1000;
+    int m_rate = 20;
+    quint64 m_nextId = 1;
+
+    /// token bucket, one token per command, refilled at m_rate per second up to m_rate
+    double m_tokens = 20;
+    QElapsedTimer m_sinceRefill;
+    QTimer m_pumpTimer;
+    QTimer m_responseTimer;
+};
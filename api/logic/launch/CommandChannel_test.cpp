@@ -0,0 +1,108 @@
+#include <QTest>
+#include <QSignalSpy>
+#include "TestUtil.h"
+
+#include "launch/CommandChannel.h"
+
+Q_DECLARE_METATYPE(CommandResult)
+
+class CommandChannelTest : public QObject
+{
+    Q_OBJECT
+private
+slots:
+    void initTestCase()
+    {
+        qRegisterMetaType<CommandResult>();
+    }
+
+    void test_waitsForProcess()
+    {
+        CommandChannel channel;
+        QSignalSpy writes(&channel, &CommandChannel::write);
+        QVERIFY(channel.send("list"));
+        QCOMPARE(writes.size(), 0);
+        QCOMPARE(channel.queued(), 1);
+        channel.setAvailable(true);
+        QCOMPARE(writes.size(), 1);
+        QCOMPARE(writes[0][0].toByteArray(), QByteArray("list\n"));
+        QCOMPARE(channel.queued(), 0);
+    }
+
+    void test_bounded()
+    {
+        CommandChannel channel;
+        channel.setCapacity(2);
+        QVERIFY(channel.send("a"));
+        QVERIFY(channel.send("b"));
+        QCOMPARE(channel.send("c"), quint64(0));
+        // a single command can't smuggle in more lines
+        channel.setCapacity(10);
+        QCOMPARE(channel.send("a\nop Steve"), quint64(0));
+    }
+
+    void test_batchedAndRateLimited()
+    {
+        CommandChannel channel;
+        channel.setRate(3);
+        QSignalSpy writes(&channel, &CommandChannel::write);
+        for(int i = 0; i < 5; i++)
+        {
+            channel.send(QString("say %1").arg(i));
+        }
+        channel.setAvailable(true);
+        // the first three go out together, the rest once the rate allows
+        QCOMPARE(writes.size(), 1);
+        QCOMPARE(writes[0][0].toByteArray(), QByteArray("say 0\nsay 1\nsay 2\n"));
+        QCOMPARE(channel.queued(), 2);
+        QTRY_COMPARE_WITH_TIMEOUT(channel.queued(), 0, 2000);
+    }
+
+    void test_answered()
+    {
+        CommandChannel channel;
+        channel.setAvailable(true);
+        QSignalSpy writes(&channel, &CommandChannel::write);
+        QSignalSpy finished(&channel, &CommandChannel::finished);
+        auto id = channel.send("whitelist add Steve", "Added Steve to the whitelist|Player is already whitelisted");
+        channel.send("say done");
+        // the second waits for the answer to the first
+        QCOMPARE(writes.size(), 1);
+        channel.logLine("[12:00:00] [Server thread/INFO]: Steve joined the game");
+        QCOMPARE(writes.size(), 1);
+        channel.logLine("[12:00:00] [Server thread/INFO]: Added Steve to the whitelist");
+        QCOMPARE(writes.size(), 2);
+        QCOMPARE(finished.size(), 2);
+        auto result = finished[0][0].value<CommandResult>();
+        QCOMPARE(result.id, id);
+        QCOMPARE(result.status, CommandResult::Answered);
+        QCOMPARE(result.response, QString("[12:00:00] [Server thread/INFO]: Added Steve to the whitelist"));
+        QCOMPARE(finished[1][0].value<CommandResult>().status, CommandResult::Sent);
+    }
+
+    void test_timedOut()
+    {
+        CommandChannel channel;
+        channel.setAvailable(true);
+        QSignalSpy finished(&channel, &CommandChannel::finished);
+        channel.send("whitelist add Steve", "Added Steve", 50);
+        QTRY_COMPARE_WITH_TIMEOUT(finished.size(), 1, 2000);
+        QCOMPARE(finished[0][0].value<CommandResult>().status, CommandResult::TimedOut);
+    }
+
+    void test_cleared()
+    {
+        CommandChannel channel;
+        QSignalSpy finished(&channel, &CommandChannel::finished);
+        channel.send("a");
+        channel.send("b");
+        channel.clear();
+        QCOMPARE(finished.size(), 2);
+        QCOMPARE(finished[1][0].value<CommandResult>().status, CommandResult::Dropped);
+        QCOMPARE(channel.queued(), 0);
+    }
+};
+
+QTEST_GUILESS_MAIN(CommandChannelTest)
+
+#include "CommandChannel_test.moc"
@@ -31,6 +31,12 @@ public: /* methods */
     };
     virtual ~LaunchStep() {};
 
+    /// the step runs the server and may be started again when it ends, see LaunchTask restart policies
+    virtual bool canRestart() const
+    {
+        return false;
+    }
+
 private: /* methods */
     void bind(LaunchTask *parent);
 
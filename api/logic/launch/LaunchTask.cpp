@@ -28,6 +28,13 @@
 #include <QStandardPaths>
 #include <assert.h>
 
+namespace {
+// seconds before the first restart, doubled for every restart within the crash loop window
+const int restartBaseDelay = 5;
+// reading a few cgroup files every couple of seconds is next to free
+const int usageSampleInterval = 2000;
+}
+
 void LaunchTask::init()
 {
     m_instance->setRunning(true);
@@ -40,8 +47,82 @@ shared_qobject_ptr<LaunchTask> LaunchTask::create(InstancePtr inst)
     return proc;
 }
 
-LaunchTask::LaunchTask(InstancePtr instance): m_instance(instance)
+LaunchTask::LaunchTask(InstancePtr instance): m_instance(instance), m_telemetry(instance->telemetry())
 {
+    m_restartTimer.setSingleShot(true);
+    connect(&m_restartTimer, &QTimer::timeout, this, &LaunchTask::restartStep);
+    connect(&m_usageTimer, &QTimer::timeout, this, &LaunchTask::sampleResourceUsage);
+    connect(&m_commands, &CommandChannel::write, this, &LaunchTask::writeToStdin);
+    connect(&m_commands, &CommandChannel::finished, this, [this](const CommandResult &result)
+    {
+        switch(result.status)
+        {
+            case CommandResult::TimedOut:
+                onLogLine(tr("The server didn't answer the command \"%1\" in time.").arg(result.command), MessageLevel::MultiServerMC);
+                break;
+            case CommandResult::Dropped:
+                onLogLine(tr("The command \"%1\" was dropped, the server stopped before it was sent.").arg(result.command), MessageLevel::MultiServerMC);
+                break;
+            default:
+                break;
+        }
+    });
+}
+
+void LaunchTask::setCGroup(std::shared_ptr<CGroup> cgroup)
+{
+    m_cgroup = cgroup;
+    if(m_cgroup)
+    {
+        // the first sample only sets the start for measuring CPU time
+        m_cgroup->sample();
+        m_usageTimer.start(usageSampleInterval);
+    }
+    else
+    {
+        m_usageTimer.stop();
+        m_instance->setResourceUsage(ResourceUsage());
+    }
+}
+
+void LaunchTask::setPid(qint64 pid)
+{
+    m_pid = pid;
+    // the process moves itself into the cgroup after forking, where it can't tell anyone that it didn't work
+    if(pid > 0 && m_cgroup)
+    {
+        auto actual = CGroup::ofProcess(pid);
+        if(!actual.isEmpty() && actual != QDir::cleanPath(m_cgroup->path()))
+        {
+            onLogLine(tr("The server couldn't be moved into the cgroup %1 and runs in %2, without resource limits.")
+                .arg(m_cgroup->path(), actual), MessageLevel::Warning);
+            auto cgroup = m_cgroup;
+            setCGroup(nullptr);
+            cgroup->remove();
+        }
+    }
+    auto settings = m_instance->settings();
+    m_commands.setRate(settings->get("CommandRate").toInt());
+    m_commands.setCapacity(settings->get("CommandQueueSize").toInt());
+    m_commands.setAvailable(pid > 0);
+    if(pid > 0 && settings->get("TelemetryEnabled").toBool())
+    {
+        m_telemetry.setInterval(settings->get("TelemetryInterval").toInt() * 1000);
+        m_telemetry.setParseGc(settings->get("TelemetryGcParsing").toBool());
+        m_telemetry.setPid(pid);
+    }
+    else
+    {
+        m_telemetry.setPid(-1);
+    }
+}
+
+void LaunchTask::sampleResourceUsage()
+{
+    if(m_cgroup)
+    {
+        m_instance->setResourceUsage(m_cgroup->sample());
+    }
 }
 
 void LaunchTask::appendStep(shared_qobject_ptr<LaunchStep> step)
@@ -57,6 +138,10 @@ void LaunchTask::prependStep(shared_qobject_ptr<LaunchStep> step)
 
 void LaunchTask::writeToStdin(const QByteArray &data)
 {
+    if(currentStep < 0 || currentStep >= m_steps.size())
+    {
+        return;
+    }
     emit m_steps[currentStep]->stdinWrittenTo(data);
 }
 
@@ -74,6 +159,12 @@ void LaunchTask::executeTask()
 
 void LaunchTask::onReadyForLaunch()
 {
+    // restarts happen unattended
+    if(m_restartCount)
+    {
+        m_steps[currentStep]->proceed();
+        return;
+    }
     state = LaunchTask::Waiting;
     emit readyForLaunch();
 }
@@ -89,6 +180,11 @@ void LaunchTask::onStepFinished()
     }
 
     auto step = m_steps[currentStep];
+    if(shouldRestart(step))
+    {
+        scheduleRestart(step);
+        return;
+    }
     if(step->wasSuccessful())
     {
         // end?
@@ -125,6 +221,64 @@ void LaunchTask::finalizeSteps(bool successful, const QString& error)
     }
 }
 
+bool LaunchTask::shouldRestart(const shared_qobject_ptr<LaunchStep> &step) const
+{
+    // aborted means stopped by the user
+    if(state == LaunchTask::Aborted || !step->canRestart())
+    {
+        return false;
+    }
+    auto policy = m_instance->settings()->get("RestartPolicy").toString();
+    if(policy == "Always")
+    {
+        return true;
+    }
+    if(policy == "OnCrash")
+    {
+        return !step->wasSuccessful();
+    }
+    return false;
+}
+
+void LaunchTask::scheduleRestart(const shared_qobject_ptr<LaunchStep> &step)
+{
+    auto settings = m_instance->settings();
+    auto window = settings->get("CrashLoopWindow").toInt();
+    auto limit = settings->get("CrashLoopRestarts").toInt();
+    auto now = QDateTime::currentDateTimeUtc();
+    // only restarts within the window count towards a crash loop and the backoff
+    while(!m_recentRestarts.isEmpty() && m_recentRestarts.first().secsTo(now) > window)
+    {
+        m_recentRestarts.removeFirst();
+    }
+    m_lastRestartReason = step->wasSuccessful() ? tr("The server exited.") : step->failReason();
+    if(m_recentRestarts.size() >= limit)
+    {
+        auto reason = tr("The server was restarted %1 times within %2 minutes and still does not stay up. Giving up.")
+            .arg(m_recentRestarts.size()).arg(window / 60);
+        onLogLine(reason, MessageLevel::Fatal);
+        emit restartsChanged();
+        finalizeSteps(false, reason);
+        return;
+    }
+    qint64 delay = qint64(restartBaseDelay) << qMin(m_recentRestarts.size(), 16);
+    delay = qMin<qint64>(delay, qMax(settings->get("RestartBackoffMax").toInt(), restartBaseDelay));
+    m_nextRestart = now.addSecs(delay);
+    onLogLine(tr("%1 Restarting the server in %2 seconds.").arg(m_lastRestartReason).arg(delay), MessageLevel::MultiServerMC);
+    m_restartTimer.start(int(delay * 1000));
+    emit restartsChanged();
+}
+
+void LaunchTask::restartStep()
+{
+    m_nextRestart = QDateTime();
+    m_restartCount++;
+    m_recentRestarts.append(QDateTime::currentDateTimeUtc());
+    onLogLine(tr("Restarting the server, restart number %1.").arg(m_restartCount), MessageLevel::MultiServerMC);
+    emit restartsChanged();
+    m_steps[currentStep]->start();
+}
+
 void LaunchTask::onProgressReportingRequested()
 {
     state = LaunchTask::Waiting;
@@ -169,6 +323,10 @@ bool LaunchTask::canAbort() const
         case LaunchTask::Running:
         case LaunchTask::Waiting:
         {
+            if(m_restartTimer.isActive())
+            {
+                return true;
+            }
             auto step = m_steps[currentStep];
             return step->canAbort();
         }
@@ -193,6 +351,16 @@ bool LaunchTask::abort()
         case LaunchTask::Running:
         case LaunchTask::Waiting:
         {
+            // waiting for a restart, nothing is running
+            if(m_restartTimer.isActive())
+            {
+                m_restartTimer.stop();
+                m_nextRestart = QDateTime();
+                state = LaunchTask::Aborted;
+                emit restartsChanged();
+                finalizeSteps(false, tr("Aborted while waiting for a restart."));
+                return true;
+            }
             auto step = m_steps[currentStep];
             if(!step->canAbort())
             {
@@ -253,11 +421,19 @@ void LaunchTask::onLogLine(QString line, MessageLevel::Enum level)
 
     auto &model = *getLogModel();
     model.append(level, line);
+    m_telemetry.logLine(line);
+    // our own messages are no answers
+    if(level != MessageLevel::MultiServerMC)
+    {
+        m_commands.logLine(line);
+    }
+    emit lineLogged(line, level);
 }
 
 void LaunchTask::emitSucceeded()
 {
     m_instance->setRunning(false);
+    m_commands.clear();
     Task::emitSucceeded();
 }
 
@@ -265,6 +441,7 @@ void LaunchTask::emitFailed(QString reason)
 {
     m_instance->setRunning(false);
     m_instance->setCrashed(true);
+    m_commands.clear();
     Task::emitFailed(reason);
 }
 
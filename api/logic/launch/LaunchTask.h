@@ -17,12 +17,17 @@
 
 #pragma once
 #include <QProcess>
+#include <QTimer>
+#include <QDateTime>
 #include <QObjectPtr.h>
 #include "LogModel.h"
 #include "BaseInstance.h"
 #include "MessageLevel.h"
 #include "LoggedProcess.h"
 #include "LaunchStep.h"
+#include "CGroup.h"
+#include "ProcessTelemetry.h"
+#include "CommandChannel.h"
 
 #include "multiservermc_logic_export.h"
 
@@ -57,10 +62,8 @@ public: /* methods */
         return m_instance;
     }
 
-    void setPid(qint64 pid)
-    {
-        m_pid = pid;
-    }
+    /// also starts and stops sampling the process, see ProcessTelemetry
+    void setPid(qint64 pid);
 
     qint64 pid()
     {
@@ -86,8 +89,47 @@ public: /* methods */
 
     shared_qobject_ptr<LogModel> getLogModel();
 
+    /// write straight to the server, without queueing, see commands()
     void writeToStdin(const QByteArray &data);
 
+    /// the queue for commands to the server console
+    CommandChannel &commands()
+    {
+        return m_commands;
+    }
+
+    /**
+     * Supervision: with the instance's RestartPolicy set to "OnCrash" or "Always", the step running
+     * the server is started again when it ends, after an exponential backoff. Once more than
+     * CrashLoopRestarts restarts happen within CrashLoopWindow seconds, the task gives up.
+     */
+    int restartCount() const
+    {
+        return m_restartCount;
+    }
+    /// when the pending restart happens, invalid when there is none
+    QDateTime nextRestart() const
+    {
+        return m_nextRestart;
+    }
+    /// why the server was last restarted
+    QString lastRestartReason() const
+    {
+        return m_lastRestartReason;
+    }
+
+    /// the cgroup the server runs in, set up by ApplyResourceLimits. Its usage is sampled while it is set.
+    void setCGroup(std::shared_ptr<CGroup> cgroup);
+    std::shared_ptr<CGroup> cgroup() const
+    {
+        return m_cgroup;
+    }
+
+    const ProcessTelemetry &telemetry() const
+    {
+        return m_telemetry;
+    }
+
 public:
     QString substituteVariables(const QString &cmd) const;
     QString censorPrivateInfo(QString in);
@@ -106,6 +148,16 @@ signals:
 
     void requestLogging();
 
+    /**
+     * @brief emitted for every line added to the log, with the level it ended up with
+     */
+    void lineLogged(const QString &line, MessageLevel::Enum level);
+
+    /**
+     * @brief emitted when a restart is scheduled, happens or is given up on
+     */
+    void restartsChanged();
+
 
 public slots:
     void onLogLines(const QStringList& lines, MessageLevel::Enum defaultLevel = MessageLevel::MultiServerMC);
@@ -116,6 +168,10 @@ public slots:
 
 private: /*methods */
     void finalizeSteps(bool successful, const QString & error);
+    bool shouldRestart(const shared_qobject_ptr<LaunchStep> &step) const;
+    void scheduleRestart(const shared_qobject_ptr<LaunchStep> &step);
+    void restartStep();
+    void sampleResourceUsage();
 
 protected: /* data */
     InstancePtr m_instance;
@@ -125,4 +181,13 @@ protected: /* data */
     int currentStep = -1;
     State state = NotStarted;
     qint64 m_pid = -1;
+    QTimer m_restartTimer;
+    int m_restartCount = 0;
+    QList<QDateTime> m_recentRestarts;
+    QDateTime m_nextRestart;
+    QString m_lastRestartReason;
+    std::shared_ptr<CGroup> m_cgroup;
+    QTimer m_usageTimer;
+    ProcessTelemetry m_telemetry;
+    CommandChannel m_commands;
 };
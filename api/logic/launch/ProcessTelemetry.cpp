@@ -0,0 +1,185 @@
+#include "ProcessTelemetry.h"
+
+#include <QFile>
+#include <QDateTime>
+#include <QRegularExpression>
+
+#if defined(Q_OS_LINUX)
+#include <unistd.h>
+#endif
+
+namespace {
+// smaps_rollup is read on every this many samples
+const int smapsEvery = 12;
+
+QByteArray readProcFile(qint64 pid, const char *name)
+{
+    QFile file(QString("/proc/%1/%2").arg(pid).arg(name));
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        return QByteArray();
+    }
+    return file.readAll();
+}
+
+/// "Key:   1234 kB" lines of status and smaps_rollup, in bytes when there is a unit
+qint64 keyedValue(const QByteArray &data, const QByteArray &key)
+{
+    auto start = data.startsWith(key + ':') ? 0 : data.indexOf('\n' + key + ':');
+    if(start < 0)
+    {
+        return 0;
+    }
+    if(start > 0)
+    {
+        start++;
+    }
+    auto end = data.indexOf('\n', start);
+    auto fields = data.mid(start + key.size() + 1, end < 0 ? -1 : end - start - key.size() - 1).simplified().split(' ');
+    auto value = fields.value(0).toLongLong();
+    return fields.value(1) == "kB" ? value * 1024 : value;
+}
+}
+
+ProcessTelemetry::ProcessTelemetry(std::shared_ptr<TelemetryRing> ring, QObject *parent)
+    : QObject(parent), m_ring(ring)
+{
+    m_timer.setInterval(5000);
+    connect(&m_timer, &QTimer::timeout, this, &ProcessTelemetry::takeSample);
+}
+
+void ProcessTelemetry::setInterval(int msecs)
+{
+    m_timer.setInterval(qMax(msecs, 500));
+}
+
+void ProcessTelemetry::setPid(qint64 pid)
+{
+    m_pid = pid;
+    m_lastCpuTicks = -1;
+    m_samplesUntilSmaps = 0;
+    m_lastPss = 0;
+    m_gcPauses = 0;
+    m_gcPauseTotalMs = 0;
+    m_gcPauseMaxMs = 0;
+    if(m_pid <= 0)
+    {
+        m_timer.stop();
+        return;
+    }
+    m_sampling.start();
+    m_costNs = 0;
+    // the first sample only sets the start for measuring CPU time
+    sample();
+    m_timer.start();
+}
+
+void ProcessTelemetry::logLine(const QString &line)
+{
+    // most lines are not about GC, don't run the expressions on them
+    double pauseMs = 0;
+    if(!m_parseGc || m_pid <= 0 || !line.contains("GC") || !parseGcPause(line, pauseMs))
+    {
+        return;
+    }
+    m_gcPauses++;
+    m_gcPauseTotalMs += pauseMs;
+    m_gcPauseMaxMs = qMax(m_gcPauseMaxMs, pauseMs);
+}
+
+bool ProcessTelemetry::parseGcPause(const QString &line, double &pauseMs)
+{
+    static const QRegularExpression unified("GC\\(\\d+\\) Pause .* (\\d+(?:\\.\\d+)?)ms\\s*$");
+    static const QRegularExpression legacy("\\[(?:Full )?GC[ (].*, (\\d+\\.\\d+) secs\\]");
+    auto match = unified.match(line);
+    if(match.hasMatch())
+    {
+        pauseMs = match.captured(1).toDouble();
+        return true;
+    }
+    match = legacy.match(line);
+    if(match.hasMatch())
+    {
+        pauseMs = match.captured(1).toDouble() * 1000.0;
+        return true;
+    }
+    return false;
+}
+
+TelemetrySample ProcessTelemetry::sample()
+{
+    TelemetrySample sample;
+    sample.time = QDateTime::currentMSecsSinceEpoch();
+    sample.pid = m_pid;
+#if defined(Q_OS_LINUX)
+    QElapsedTimer cost;
+    cost.start();
+
+    // the command in field 2 may contain spaces and parentheses, the rest comes after the last ')'
+    auto stat = readProcFile(m_pid, "stat");
+    auto fields = stat.mid(stat.lastIndexOf(')') + 2).split(' ');
+    if(fields.size() > 17)
+    {
+        // utime and stime are fields 14 and 15, num_threads is 20
+        auto cpuTicks = fields[11].toLongLong() + fields[12].toLongLong();
+        sample.threads = fields[17].toInt();
+        if(m_lastCpuTicks >= 0 && m_sinceLastSample.isValid())
+        {
+            static const long ticksPerSecond = sysconf(_SC_CLK_TCK);
+            auto elapsedMs = m_sinceLastSample.elapsed();
+            if(elapsedMs > 0 && ticksPerSecond > 0)
+            {
+                sample.cpuPercent = 100.0 * 1000.0 * qMax<qint64>(cpuTicks - m_lastCpuTicks, 0) / ticksPerSecond / elapsedMs;
+            }
+        }
+        m_lastCpuTicks = cpuTicks;
+        m_sinceLastSample.start();
+    }
+
+    auto status = readProcFile(m_pid, "status");
+    sample.rssBytes = keyedValue(status, "VmRSS");
+    sample.swapBytes = keyedValue(status, "VmSwap");
+
+    // only readable for our own processes
+    auto io = readProcFile(m_pid, "io");
+    sample.ioReadBytes = keyedValue(io, "read_bytes");
+    sample.ioWriteBytes = keyedValue(io, "write_bytes");
+
+    if(m_samplesUntilSmaps-- <= 0)
+    {
+        m_samplesUntilSmaps = smapsEvery - 1;
+        m_lastPss = keyedValue(readProcFile(m_pid, "smaps_rollup"), "Pss");
+    }
+    sample.pssBytes = m_lastPss;
+
+    m_costNs += cost.nsecsElapsed();
+#endif
+    return sample;
+}
+
+void ProcessTelemetry::takeSample()
+{
+    auto next = sample();
+    // the process is gone, the launch step will notice soon
+    if(!next.threads)
+    {
+        return;
+    }
+    next.gcPauses = m_gcPauses;
+    next.gcPauseTotalMs = m_gcPauseTotalMs;
+    next.gcPauseMaxMs = m_gcPauseMaxMs;
+    m_gcPauses = 0;
+    m_gcPauseTotalMs = 0;
+    m_gcPauseMaxMs = 0;
+    m_ring->append(next);
+}
+
+double ProcessTelemetry::overheadPercent() const
+{
+    if(!m_sampling.isValid())
+    {
+        return 0;
+    }
+    auto elapsedNs = m_sampling.nsecsElapsed();
+    return elapsedNs > 0 ? 100.0 * m_costNs / elapsedNs : 0;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <memory>
+
+#include "TelemetryRing.h"
+
+#include "multiservermc_logic_export.h"
+
+/**
+ * Samples a running server process from /proc into a TelemetryRing.
+ *
+ * stat, status and io are read every interval. smaps_rollup makes the kernel walk the whole address
+ * space, which is not cheap for a JVM with a big heap, so it is only read every few samples.
+ * GC pauses come from the log of the server when it runs with -verbose:gc or -Xlog:gc.
+ */
+class MULTISERVERMC_LOGIC_EXPORT ProcessTelemetry : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ProcessTelemetry(std::shared_ptr<TelemetryRing> ring, QObject *parent = nullptr);
+
+    /// time between samples
+    void setInterval(int msecs);
+    /// whether log lines are checked for GC pauses
+    void setParseGc(bool parseGc)
+    {
+        m_parseGc = parseGc;
+    }
+
+    /// start sampling the given process, -1 stops sampling
+    void setPid(qint64 pid);
+    qint64 pid() const
+    {
+        return m_pid;
+    }
+
+    /// feed a line of the server log, GC pauses in it end up in the next sample
+    void logLine(const QString &line);
+
+    /// read the process once, without adding it to the ring
+    TelemetrySample sample();
+
+    /// the time spent sampling, in percent of the time sampling was on
+    double overheadPercent() const;
+
+    /**
+     * The pause time of a GC log line, in both the unified logging format of Java 9+
+     * ("GC(12) Pause Young (Normal) (G1 Evacuation Pause) 24M->4M(256M) 3.456ms")
+     * and the -verbose:gc format of Java 8 ("[GC (Allocation Failure) 512K->128K(1024K), 0.0012345 secs]").
+     */
+    static bool parseGcPause(const QString &line, double &pauseMs);
+
+private slots:
+    void takeSample();
+
+private:
+    std::shared_ptr<TelemetryRing> m_ring;
+    QTimer m_timer;
+    qint64 m_pid = -1;
+    bool m_parseGc = true;
+
+    qint64 m_lastCpuTicks = -1;
+    QElapsedTimer m_sinceLastSample;
+    int m_samplesUntilSmaps = 0;
+    qint64 m_lastPss = 0;
+
+    int m_gcPauses = 0;
+    double m_gcPauseTotalMs = 0;
+    double m_gcPauseMaxMs = 0;
+
+    QElapsedTimer m_sampling;
+    qint64 m_costNs = 0;
+};
@@ -0,0 +1,38 @@
+#include <QTest>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include "TestUtil.h"
+
+#include "launch/ProcessTelemetry.h"
+
+class ProcessTelemetryBench : public QObject
+{
+    Q_OBJECT
+private
+slots:
+#if defined(Q_OS_LINUX)
+    void bench_sample()
+    {
+        ProcessTelemetry telemetry(std::make_shared<TelemetryRing>());
+        telemetry.setPid(QCoreApplication::applicationPid());
+        QBENCHMARK
+        {
+            telemetry.sample();
+        }
+        // a sample every 5 seconds has to stay below 0.1% of one CPU
+        const int samples = 200;
+        QElapsedTimer timer;
+        timer.start();
+        for(int i = 0; i < samples; i++)
+        {
+            telemetry.sample();
+        }
+        QVERIFY(timer.nsecsElapsed() / samples < 5000000);
+        telemetry.setPid(-1);
+    }
+#endif
+};
+
+QTEST_GUILESS_MAIN(ProcessTelemetryBench)
+
+#include "ProcessTelemetry_bench.moc"
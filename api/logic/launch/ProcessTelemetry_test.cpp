@@ -0,0 +1,83 @@
+#include <QTest>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include "TestUtil.h"
+
+#include "launch/ProcessTelemetry.h"
+
+class ProcessTelemetryTest : public QObject
+{
+    Q_OBJECT
+private
+slots:
+    void test_parseGcPause_data()
+    {
+        QTest::addColumn<QString>("line");
+        QTest::addColumn<bool>("isPause");
+        QTest::addColumn<double>("pauseMs");
+
+        QTest::newRow("G1 young") << "[0.015s][info][gc] GC(0) Pause Young (Normal) (G1 Evacuation Pause) 23M->3M(256M) 3.456ms" << true << 3.456;
+        QTest::newRow("ZGC") << "[2.103s][info][gc,phases] GC(4) Pause Mark Start 0.012ms" << true << 0.012;
+        QTest::newRow("concurrent") << "[2.103s][info][gc] GC(4) Concurrent Mark 12.345ms" << false << 0.0;
+        QTest::newRow("java 8") << "[GC (Allocation Failure)  524800K->12345K(2010112K), 0.0123456 secs]" << true << 12.3456;
+        QTest::newRow("java 8 details") << "[Full GC (Ergonomics) [PSYoungGen: 1K->0K(3K)] 4K->5K(6K), [Metaspace: 1K->1K(2K)], 0.1234567 secs] [Times: user=0.01 sys=0.00, real=0.12 secs]" << true << 123.4567;
+        QTest::newRow("server log") << "[12:00:00] [Server thread/INFO]: <Steve> GC is taking 5ms" << false << 0.0;
+    }
+    void test_parseGcPause()
+    {
+        QFETCH(QString, line);
+        QFETCH(bool, isPause);
+        QFETCH(double, pauseMs);
+        double parsed = 0;
+        QCOMPARE(ProcessTelemetry::parseGcPause(line, parsed), isPause);
+        if(isPause)
+        {
+            QVERIFY(qAbs(parsed - pauseMs) < 0.0001);
+        }
+    }
+
+    void test_ringWraps()
+    {
+        TelemetryRing ring;
+        QVERIFY(ring.snapshot().isEmpty());
+        QCOMPARE(ring.last().time, qint64(0));
+        for(int i = 1; i <= TelemetryRing::Capacity + 10; i++)
+        {
+            TelemetrySample sample;
+            sample.time = i;
+            ring.append(sample);
+        }
+        auto samples = ring.snapshot();
+        QCOMPARE(samples.size(), int(TelemetryRing::Capacity));
+        QCOMPARE(samples.first().time, qint64(11));
+        QCOMPARE(samples.last().time, qint64(TelemetryRing::Capacity + 10));
+        QCOMPARE(ring.last().time, qint64(TelemetryRing::Capacity + 10));
+        QCOMPARE(ring.written(), quint64(TelemetryRing::Capacity + 10));
+    }
+
+#if defined(Q_OS_LINUX)
+    void test_sampleSelf()
+    {
+        ProcessTelemetry telemetry(std::make_shared<TelemetryRing>());
+        telemetry.setPid(QCoreApplication::applicationPid());
+        // burn some CPU so there is something to measure
+        QElapsedTimer busy;
+        busy.start();
+        volatile quint64 sum = 0;
+        while(busy.elapsed() < 100)
+        {
+            sum += busy.nsecsElapsed();
+        }
+        auto sample = telemetry.sample();
+        QCOMPARE(sample.pid, QCoreApplication::applicationPid());
+        QVERIFY(sample.threads >= 1);
+        QVERIFY(sample.rssBytes > 0);
+        QVERIFY(sample.cpuPercent > 10);
+        telemetry.setPid(-1);
+    }
+#endif
+};
+
+QTEST_GUILESS_MAIN(ProcessTelemetryTest)
+
+#include "ProcessTelemetry_test.moc"
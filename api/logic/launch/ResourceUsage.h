@@ -0,0 +1,18 @@
+#pragma once
+
+#include <QtGlobal>
+
+/// What a running instance uses right now, see CGroup::sample
+struct ResourceUsage
+{
+    /// false when nothing is being measured
+    bool valid = false;
+    /// percent of one CPU, like top shows it
+    double cpuPercent = 0;
+    /// all memory charged to the instance, including page cache
+    qint64 memoryBytes = 0;
+    /// anonymous memory, close to the resident size of the JVM
+    qint64 rssBytes = 0;
+    qint64 ioReadBytes = 0;
+    qint64 ioWriteBytes = 0;
+};
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QVector>
+
+/// One sample of a running server process, see ProcessTelemetry
+struct TelemetrySample
+{
+    /// msecs since epoch
+    qint64 time = 0;
+    /// the process the sample is from, the charts don't connect samples of different processes
+    qint64 pid = -1;
+    /// percent of one CPU, like top shows it
+    double cpuPercent = 0;
+    qint64 rssBytes = 0;
+    /// proportional set size, only refreshed every few samples, see ProcessTelemetry
+    qint64 pssBytes = 0;
+    qint64 swapBytes = 0;
+    int threads = 0;
+    qint64 ioReadBytes = 0;
+    qint64 ioWriteBytes = 0;
+    /// GC pauses seen in the log since the previous sample
+    int gcPauses = 0;
+    double gcPauseTotalMs = 0;
+    double gcPauseMaxMs = 0;
+};
+
+/**
+ * Fixed size history of telemetry samples, the oldest sample is dropped for every new one.
+ *
+ * GUI thread only, it is not thread safe: ProcessTelemetry appends from its timer and the pages read it there too.
+ */
+class TelemetryRing
+{
+public:
+    /// an hour of samples at the default interval of 5 seconds
+    static const int Capacity = 720;
+
+    void append(const TelemetrySample &sample)
+    {
+        m_samples[m_written % Capacity] = sample;
+        m_written++;
+    }
+
+    /// all samples still in the ring, oldest first
+    QVector<TelemetrySample> snapshot() const
+    {
+        auto begin = m_written > quint64(Capacity) ? m_written - Capacity : 0;
+        QVector<TelemetrySample> samples;
+        samples.reserve(int(m_written - begin));
+        for(auto i = begin; i < m_written; i++)
+        {
+            samples.append(m_samples[i % Capacity]);
+        }
+        return samples;
+    }
+
+    /// the newest sample, time is 0 when there is none
+    TelemetrySample last() const
+    {
+        if(m_written == 0)
+        {
+            return TelemetrySample();
+        }
+        return m_samples[(m_written - 1) % Capacity];
+    }
+
+    /// how many samples were ever appended
+    quint64 written() const
+    {
+        return m_written;
+    }
+
+private:
+    TelemetrySample m_samples[Capacity];
+    quint64 m_written = 0;
+};
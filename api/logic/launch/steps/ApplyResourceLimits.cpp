@@ -0,0 +1,35 @@
+#include "ApplyResourceLimits.h"
+#include "launch/LaunchTask.h"
+#include "launch/CGroup.h"
+
+void ApplyResourceLimits::executeTask()
+{
+    auto settings = m_parent->instance()->settings();
+    CGroupLimits limits;
+    limits.cpuWeight = settings->get("CpuWeight").toInt();
+    limits.cpuQuotaPercent = settings->get("CpuQuota").toInt();
+    limits.memoryMaxBytes = settings->get("MemoryMax").toLongLong() * 1024 * 1024;
+    limits.ioWeight = settings->get("IoWeight").toInt();
+
+    QString error;
+    auto cgroup = CGroup::create(m_parent->instance()->id(), limits, error);
+    if(!cgroup)
+    {
+        emit logLine(tr("Couldn't apply resource limits, the server runs without them: %1\n").arg(error), MessageLevel::Warning);
+        emitSucceeded();
+        return;
+    }
+    emit logLine(tr("Resource limits are set up in the cgroup %1, the server is moved into it when it starts\n").arg(cgroup->path()), MessageLevel::MultiServerMC);
+    m_parent->setCGroup(cgroup);
+    emitSucceeded();
+}
+
+void ApplyResourceLimits::finalize()
+{
+    auto cgroup = m_parent->cgroup();
+    if(cgroup)
+    {
+        m_parent->setCGroup(nullptr);
+        cgroup->remove();
+    }
+}
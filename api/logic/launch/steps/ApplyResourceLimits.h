@@ -0,0 +1,22 @@
+#pragma once
+
+#include "launch/LaunchStep.h"
+
+/**
+ * Puts the server into its own cgroup with the CPU, memory and IO limits from the instance settings.
+ * When that is not possible, the server starts without limits and the log says why.
+ */
+class ApplyResourceLimits: public LaunchStep
+{
+    Q_OBJECT
+public:
+    explicit ApplyResourceLimits(LaunchTask *parent) : LaunchStep(parent) {};
+    virtual ~ApplyResourceLimits() {};
+
+    void executeTask() override;
+    bool canAbort() const override
+    {
+        return false;
+    }
+    void finalize() override;
+};
@@ -0,0 +1,488 @@
+#include "LevelDatSummary.h"
+
+#include <QtEndian>
+#include <QDebug>
+#include <zlib.h>
+#include <cstring>
+#include <algorithm>
+
+namespace {
+
+enum TagType : quint8
+{
+    TagEnd = 0,
+    TagByte,
+    TagShort,
+    TagInt,
+    TagLong,
+    TagFloat,
+    TagDouble,
+    TagByteArray,
+    TagString,
+    TagList,
+    TagCompound,
+    TagIntArray,
+    TagLongArray
+};
+
+// same limit as the game uses when reading NBT
+const int maxDepth = 512;
+
+/**
+ * Sequential access to NBT data, inflating gzip data a chunk at a time when needed.
+ * Only as much of the input is inflated as has been read or skipped so far.
+ */
+class NbtSource
+{
+public:
+    NbtSource(const QByteArray &data, bool compressed) : m_input(data), m_compressed(compressed)
+    {
+        if(!m_compressed)
+        {
+            m_pos = m_input.constData();
+            m_end = m_pos + m_input.size();
+            return;
+        }
+        memset(&m_stream, 0, sizeof(m_stream));
+        m_stream.next_in = (Bytef *)m_input.constData();
+        m_stream.avail_in = m_input.size();
+        m_streamOpen = inflateInit2(&m_stream, 16 + MAX_WBITS) == Z_OK;
+    }
+    ~NbtSource()
+    {
+        if(m_streamOpen)
+        {
+            inflateEnd(&m_stream);
+        }
+    }
+
+    bool read(char *to, qint64 length)
+    {
+        while(length > 0)
+        {
+            if(m_pos == m_end && !fill())
+            {
+                return false;
+            }
+            qint64 chunk = std::min<qint64>(length, m_end - m_pos);
+            memcpy(to, m_pos, chunk);
+            m_pos += chunk;
+            to += chunk;
+            length -= chunk;
+        }
+        return true;
+    }
+
+    bool skip(qint64 length)
+    {
+        if(length < 0)
+        {
+            return false;
+        }
+        while(length > 0)
+        {
+            if(m_pos == m_end && !fill())
+            {
+                return false;
+            }
+            qint64 chunk = std::min<qint64>(length, m_end - m_pos);
+            m_pos += chunk;
+            length -= chunk;
+        }
+        return true;
+    }
+
+private:
+    bool fill()
+    {
+        if(!m_streamOpen || m_streamEnd)
+        {
+            return false;
+        }
+        while(true)
+        {
+            m_stream.next_out = (Bytef *)m_buffer;
+            m_stream.avail_out = sizeof(m_buffer);
+            int err = inflate(&m_stream, Z_SYNC_FLUSH);
+            if(err == Z_STREAM_END)
+            {
+                m_streamEnd = true;
+            }
+            else if(err != Z_OK)
+            {
+                return false;
+            }
+            size_t produced = sizeof(m_buffer) - m_stream.avail_out;
+            if(produced)
+            {
+                m_pos = m_buffer;
+                m_end = m_buffer + produced;
+                return true;
+            }
+            if(m_streamEnd)
+            {
+                return false;
+            }
+        }
+    }
+
+private:
+    const QByteArray &m_input;
+    bool m_compressed;
+    z_stream m_stream;
+    bool m_streamOpen = false;
+    bool m_streamEnd = false;
+    char m_buffer[16 * 1024];
+    const char *m_pos = nullptr;
+    const char *m_end = nullptr;
+};
+
+class SummaryReader
+{
+public:
+    SummaryReader(NbtSource &in, LevelDatSummary &out) : m_in(in), m_out(out)
+    {
+    }
+
+    bool read()
+    {
+        quint8 type;
+        if(!readByte(type) || type != TagCompound || !skipString())
+        {
+            return false;
+        }
+        while(true)
+        {
+            QByteArray name;
+            if(!readByte(type))
+            {
+                return false;
+            }
+            if(type == TagEnd)
+            {
+                // no Data compound in here
+                return false;
+            }
+            if(!readString(name))
+            {
+                return false;
+            }
+            if(type == TagCompound && name == "Data")
+            {
+                m_out.valid = true;
+                return readData();
+            }
+            if(!skipPayload(type, 1))
+            {
+                return false;
+            }
+        }
+    }
+
+private:
+    bool done() const
+    {
+        return m_out.levelName && m_out.lastPlayed && m_out.gameType && m_worldGenSeed;
+    }
+
+    bool readData()
+    {
+        bool ok = readDataTags();
+        m_out.seed = m_worldGenSeed ? m_worldGenSeed : m_randomSeed;
+        return ok;
+    }
+
+    bool readDataTags()
+    {
+        while(!done())
+        {
+            quint8 type;
+            QByteArray name;
+            if(!readByte(type))
+            {
+                return false;
+            }
+            if(type == TagEnd)
+            {
+                return true;
+            }
+            if(!readString(name))
+            {
+                return false;
+            }
+            if(type == TagString && name == "LevelName")
+            {
+                QByteArray value;
+                if(!readString(value))
+                {
+                    return false;
+                }
+                m_out.levelName = QString::fromUtf8(value);
+            }
+            else if(type == TagLong && name == "LastPlayed")
+            {
+                qint64 value;
+                if(!readLong(value))
+                {
+                    return false;
+                }
+                m_out.lastPlayed = value;
+            }
+            else if(type == TagInt && name == "GameType")
+            {
+                qint32 value;
+                if(!readInt(value))
+                {
+                    return false;
+                }
+                m_out.gameType = value;
+            }
+            else if(type == TagLong && name == "RandomSeed")
+            {
+                qint64 value;
+                if(!readLong(value))
+                {
+                    return false;
+                }
+                m_randomSeed = value;
+            }
+            else if(type == TagCompound && name == "WorldGenSettings")
+            {
+                if(!readWorldGenSettings())
+                {
+                    return false;
+                }
+            }
+            else if(!skipPayload(type, 2))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool readWorldGenSettings()
+    {
+        while(!done())
+        {
+            quint8 type;
+            QByteArray name;
+            if(!readByte(type))
+            {
+                return false;
+            }
+            if(type == TagEnd)
+            {
+                return true;
+            }
+            if(!readString(name))
+            {
+                return false;
+            }
+            if(type == TagLong && name == "seed")
+            {
+                qint64 value;
+                if(!readLong(value))
+                {
+                    return false;
+                }
+                m_worldGenSeed = value;
+            }
+            else if(!skipPayload(type, 3))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool skipPayload(quint8 type, int depth)
+    {
+        if(depth > maxDepth)
+        {
+            return false;
+        }
+        switch(type)
+        {
+            case TagByte:
+                return m_in.skip(1);
+            case TagShort:
+                return m_in.skip(2);
+            case TagInt:
+            case TagFloat:
+                return m_in.skip(4);
+            case TagLong:
+            case TagDouble:
+                return m_in.skip(8);
+            case TagByteArray:
+                return skipArray(1);
+            case TagIntArray:
+                return skipArray(4);
+            case TagLongArray:
+                return skipArray(8);
+            case TagString:
+                return skipString();
+            case TagList:
+            {
+                quint8 elementType;
+                qint32 count;
+                if(!readByte(elementType) || !readInt(count) || count < 0)
+                {
+                    return false;
+                }
+                qint64 elementSize = fixedSize(elementType);
+                if(elementSize >= 0)
+                {
+                    return m_in.skip(elementSize * count);
+                }
+                for(qint32 i = 0; i < count; i++)
+                {
+                    if(!skipPayload(elementType, depth + 1))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            case TagCompound:
+            {
+                while(true)
+                {
+                    quint8 childType;
+                    if(!readByte(childType))
+                    {
+                        return false;
+                    }
+                    if(childType == TagEnd)
+                    {
+                        return true;
+                    }
+                    if(!skipString() || !skipPayload(childType, depth + 1))
+                    {
+                        return false;
+                    }
+                }
+            }
+            default:
+                return false;
+        }
+    }
+
+    /// Size of a payload of the given type, -1 if it is not fixed
+    static qint64 fixedSize(quint8 type)
+    {
+        switch(type)
+        {
+            case TagEnd:
+                return 0;
+            case TagByte:
+                return 1;
+            case TagShort:
+                return 2;
+            case TagInt:
+            case TagFloat:
+                return 4;
+            case TagLong:
+            case TagDouble:
+                return 8;
+            default:
+                return -1;
+        }
+    }
+
+    bool skipArray(qint64 elementSize)
+    {
+        qint32 count;
+        if(!readInt(count) || count < 0)
+        {
+            return false;
+        }
+        return m_in.skip(elementSize * count);
+    }
+
+    bool skipString()
+    {
+        quint16 length;
+        return readShort(length) && m_in.skip(length);
+    }
+
+    bool readString(QByteArray &to)
+    {
+        quint16 length;
+        if(!readShort(length))
+        {
+            return false;
+        }
+        to.resize(length);
+        return m_in.read(to.data(), length);
+    }
+
+    bool readByte(quint8 &to)
+    {
+        return m_in.read((char *)&to, 1);
+    }
+
+    bool readShort(quint16 &to)
+    {
+        uchar buffer[2];
+        if(!m_in.read((char *)buffer, 2))
+        {
+            return false;
+        }
+        to = qFromBigEndian<quint16>(buffer);
+        return true;
+    }
+
+    bool readInt(qint32 &to)
+    {
+        uchar buffer[4];
+        if(!m_in.read((char *)buffer, 4))
+        {
+            return false;
+        }
+        to = qFromBigEndian<qint32>(buffer);
+        return true;
+    }
+
+    bool readLong(qint64 &to)
+    {
+        uchar buffer[8];
+        if(!m_in.read((char *)buffer, 8))
+        {
+            return false;
+        }
+        to = qFromBigEndian<qint64>(buffer);
+        return true;
+    }
+
+private:
+    NbtSource &m_in;
+    LevelDatSummary &m_out;
+    nonstd::optional<int64_t> m_worldGenSeed;
+    nonstd::optional<int64_t> m_randomSeed;
+};
+
+LevelDatSummary readSummary(const QByteArray &data, bool compressed)
+{
+    LevelDatSummary summary;
+    NbtSource source(data, compressed);
+    SummaryReader reader(source, summary);
+    if(!reader.read())
+    {
+        qWarning() << "Unable to read level.dat summary, the data is truncated or not NBT";
+        return LevelDatSummary();
+    }
+    return summary;
+}
+
+}
+
+LevelDatSummary LevelDatSummary::fromCompressed(const QByteArray &data)
+{
+    return readSummary(data, true);
+}
+
+LevelDatSummary LevelDatSummary::fromNbt(const QByteArray &data)
+{
+    return readSummary(data, false);
+}
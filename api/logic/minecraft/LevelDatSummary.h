@@ -0,0 +1,40 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <nonstd/optional>
+
+#include "multiservermc_logic_export.h"
+
+/**
+ * The few values from a level.dat that the world list shows.
+ *
+ * Reading them does not build the NBT tree: the file is inflated in small chunks while
+ * the tags are walked, everything not needed is skipped, and reading stops as soon as
+ * all the values are known.
+ */
+struct MULTISERVERMC_LOGIC_EXPORT LevelDatSummary
+{
+    /// Read a gzip compressed level.dat, as found on disk
+    static LevelDatSummary fromCompressed(const QByteArray &data);
+    /// Read uncompressed NBT data
+    static LevelDatSummary fromNbt(const QByteArray &data);
+
+    /// The file had a root compound with a Data compound in it
+    bool valid = false;
+    nonstd::optional<QString> levelName;
+    nonstd::optional<int64_t> lastPlayed;
+    nonstd::optional<int> gameType;
+    /// WorldGenSettings.seed, or RandomSeed for worlds older than 1.16
+    nonstd::optional<int64_t> seed;
+
+    bool operator==(const LevelDatSummary &other) const
+    {
+        return valid == other.valid && levelName == other.levelName && lastPlayed == other.lastPlayed
+            && gameType == other.gameType && seed == other.seed;
+    }
+    bool operator!=(const LevelDatSummary &other) const
+    {
+        return !(*this == other);
+    }
+};
@@ -16,11 +16,14 @@
 #include "launch/steps/Update.h"
 #include "launch/steps/PreLaunchCommand.h"
 #include "launch/steps/TextPrint.h"
+#include "launch/steps/ApplyResourceLimits.h"
 #include "minecraft/launch/LauncherPartLaunch.h"
 #include "minecraft/launch/DirectJavaLaunch.h"
 #include "minecraft/launch/ModMinecraftJar.h"
 #include "minecraft/launch/ScanModFolders.h"
 #include "minecraft/launch/VerifyJavaInstall.h"
+#include "minecraft/launch/TickMonitor.h"
+#include "minecraft/launch/ClassDataArchive.h"
 #include "java/launch/CheckJava.h"
 #include "java/JavaUtils.h"
 #include "meta/Index.h"
@@ -116,6 +119,17 @@ MinecraftInstance::MinecraftInstance(SettingsObjectPtr globalSettings, SettingsO
     m_settings->registerSetting("JoinServerOnLaunch", false);
     m_settings->registerSetting("JoinServerOnLaunchAddress", "");
 
+    // Tick time alerts and probes, see TickMonitor
+    m_settings->registerSetting("TickAlertTps", 15.0);
+    m_settings->registerSetting("TickAlertMspt", 50.0);
+    m_settings->registerSetting("TickAlertBehind", 5000);
+    m_settings->registerSetting("TickAlertCooldown", 300);
+    m_settings->registerSetting("TickProbeCommand", "");
+    m_settings->registerSetting("TickProbeInterval", 60);
+
+    // Training and using an AppCDS archive, see ClassDataArchive
+    m_settings->registerSetting("ClassDataSharing", false);
+
     // DEPRECATED: Read what versions the user configuration thinks should be used
     m_settings->registerSetting({"IntendedVersion", "MinecraftVersion"}, "");
     m_settings->registerSetting("LWJGLVersion", "");
@@ -128,6 +142,34 @@ MinecraftInstance::MinecraftInstance(SettingsObjectPtr globalSettings, SettingsO
     m_components->setOldConfigVersion("org.lwjgl", m_settings->get("LWJGLVersion").toString());
     m_components->setOldConfigVersion("net.minecraftforge", m_settings->get("ForgeVersion").toString());
     m_components->setOldConfigVersion("com.mumfrey.liteloader", m_settings->get("LiteloaderVersion").toString());
+
+    // overridden settings resolve to the global ones, their changes are only announced there
+    for(auto settingsObject: {m_settings, globalSettings})
+    {
+        connect(settingsObject.get(), &SettingsObject::SettingChanged, this, &MinecraftInstance::settingChanged);
+        connect(settingsObject.get(), &SettingsObject::settingReset, this, &MinecraftInstance::settingChanged);
+    }
+
+    m_tickMonitor = std::make_shared<TickMonitor>();
+    connect(m_tickMonitor.get(), &TickMonitor::alert, this, &MinecraftInstance::tickAlert);
+}
+
+void MinecraftInstance::tickAlert(const QString &message)
+{
+    if(m_launchProcess)
+    {
+        m_launchProcess->onLogLine(message, MessageLevel::Warning);
+    }
+}
+
+void MinecraftInstance::settingChanged(const Setting &setting)
+{
+    // bookkeeping that changes with every launch, not how the server is started
+    static const QSet<QString> ignored = {"lastLaunchTime", "totalTimePlayed", "notes", "iconKey", "JavaTimestamp"};
+    if(!ignored.contains(setting.id()))
+    {
+        invalidateLaunchPlan();
+    }
 }
 
 void MinecraftInstance::saveNow()
@@ -341,6 +383,11 @@ QStringList MinecraftInstance::javaArguments() const
 }
 
 QMap<QString, QString> MinecraftInstance::getVariables() const
+{
+    return variablesFor(javaArguments());
+}
+
+QMap<QString, QString> MinecraftInstance::variablesFor(const QStringList &javaArgs) const
 {
     QMap<QString, QString> out;
     out.insert("INST_NAME", name());
@@ -348,7 +395,7 @@ QMap<QString, QString> MinecraftInstance::getVariables() const
     out.insert("INST_DIR", QDir(instanceRoot()).absolutePath());
     out.insert("INST_MC_DIR", QDir(gameRoot()).absolutePath());
     out.insert("INST_JAVA", settings()->get("JavaPath").toString());
-    out.insert("INST_JAVA_ARGS", javaArguments().join(' '));
+    out.insert("INST_JAVA_ARGS", javaArgs.join(' '));
     return out;
 }
 
@@ -421,20 +468,64 @@ QStringList MinecraftInstance::processMinecraftArgs(int serverPort) const
     return parts;
 }
 
-QString MinecraftInstance::createLaunchScript(int serverPort)
+std::shared_ptr<const LaunchPlan> MinecraftInstance::launchPlan(int serverPort)
 {
-    QString launchScript;
-
     if (!m_components)
-        return QString();
+        return nullptr;
     auto profile = m_components->getProfile();
     if(!profile)
+        return nullptr;
+
+    // the game folder can switch between minecraft and .minecraft when folders are created
+    auto root = gameRoot();
+    if(m_launchPlan && m_launchPlan->profile == profile && m_launchPlan->serverPort == serverPort && m_launchPlan->gameRoot == root)
+    {
+        return m_launchPlan;
+    }
+
+    auto plan = std::make_shared<LaunchPlan>();
+    plan->profile = profile;
+    plan->gameRoot = root;
+    plan->serverPort = serverPort;
+    plan->javaPath = FS::ResolveExecutable(settings()->get("JavaPath").toString());
+    plan->javaArguments = javaArguments();
+    auto javaArchitecture = settings()->get("JavaArchitecture").toString();
+    profile->getLibraryFiles(javaArchitecture, plan->classPath, plan->nativeJars, getLocalLibraryPath(), binRoot());
+    plan->nativePath = getNativePath();
+    plan->mainClass = profile->getMainClass();
+    plan->minecraftArguments = processMinecraftArgs(serverPort);
+    plan->launchScript = launchScriptFor(*plan);
+    plan->variables = variablesFor(plan->javaArguments);
+    plan->environment = CleanEnviroment();
+    for (auto it = plan->variables.begin(); it != plan->variables.end(); ++it)
+    {
+        plan->environment.insert(it.key(), it.value());
+    }
+    m_launchPlan = plan;
+    return m_launchPlan;
+}
+
+void MinecraftInstance::invalidateLaunchPlan()
+{
+    m_launchPlan.reset();
+}
+
+QString MinecraftInstance::createLaunchScript(int serverPort)
+{
+    auto plan = launchPlan(serverPort);
+    if(!plan)
         return QString();
+    return plan->launchScript;
+}
 
-    auto mainClass = getMainClass();
-    if (!mainClass.isEmpty())
+QString MinecraftInstance::launchScriptFor(const LaunchPlan &plan) const
+{
+    QString launchScript;
+    auto profile = plan.profile;
+
+    if (!plan.mainClass.isEmpty())
     {
-        launchScript += "mainClass " + mainClass + "\n";
+        launchScript += "mainClass " + plan.mainClass + "\n";
     }
     auto appletClass = profile->getAppletClass();
     if (!appletClass.isEmpty())
@@ -442,15 +533,13 @@ QString MinecraftInstance::createLaunchScript(int serverPort)
         launchScript += "appletClass " + appletClass + "\n";
     }
 
-    if (serverPort)
+    if (plan.serverPort)
     {
-        launchScript += "serverPort " + QString::number(serverPort) + "\n";
+        launchScript += "serverPort " + QString::number(plan.serverPort) + "\n";
     }
 
     // generic minecraft params
-    for (auto param : processMinecraftArgs(
-            serverPort
-    ))
+    for (auto param : plan.minecraftArguments)
     {
         launchScript += "param " + param + "\n";
     }
@@ -470,18 +559,15 @@ QString MinecraftInstance::createLaunchScript(int serverPort)
 
     // libraries and class path.
     {
-        QStringList jars, nativeJars;
-        auto javaArchitecture = settings()->get("JavaArchitecture").toString();
-        profile->getLibraryFiles(javaArchitecture, jars, nativeJars, getLocalLibraryPath(), binRoot());
-        for(auto file: jars)
+        for(auto file: plan.classPath)
         {
             launchScript += "cp " + file + "\n";
         }
-        for(auto file: nativeJars)
+        for(auto file: plan.nativeJars)
         {
             launchScript += "ext " + file + "\n";
         }
-        launchScript += "natives " + getNativePath() + "\n";
+        launchScript += "natives " + plan.nativePath + "\n";
     }
 
     for (auto trait : profile->getTraits())
@@ -496,10 +582,16 @@ QString MinecraftInstance::createLaunchScript(int serverPort)
 QStringList MinecraftInstance::verboseDescription(int serverPort)
 {
     QStringList out;
-    out << "Main Class:" << "  " + getMainClass() << "";
-    out << "Native path:" << "  " + getNativePath() << "";
+    auto plan = launchPlan(serverPort);
+    if(!plan)
+    {
+        out << "The version profile of this instance could not be applied." << "";
+        return out;
+    }
+    out << "Main Class:" << "  " + plan->mainClass << "";
+    out << "Native path:" << "  " + plan->nativePath << "";
 
-    auto profile = m_components->getProfile();
+    auto profile = plan->profile;
 
     auto alltraits = traits();
     if(alltraits.size())
@@ -527,9 +619,6 @@ QStringList MinecraftInstance::verboseDescription(int serverPort)
     // libraries and class path.
     {
         out << "Libraries:";
-        QStringList jars, nativeJars;
-        auto javaArchitecture = settings->get("JavaArchitecture").toString();
-        profile->getLibraryFiles(javaArchitecture, jars, nativeJars, getLocalLibraryPath(), binRoot());
         auto printLibFile = [&](const QString & path)
         {
             QFileInfo info(path);
@@ -542,13 +631,13 @@ QStringList MinecraftInstance::verboseDescription(int serverPort)
                 out << "  " + path + " (missing)";
             }
         };
-        for(auto file: jars)
+        for(auto file: plan->classPath)
         {
             printLibFile(file);
         }
         out << "";
         out << "Native libraries:";
-        for(auto file: nativeJars)
+        for(auto file: plan->nativeJars)
         {
             printLibFile(file);
         }
@@ -608,9 +697,8 @@ QStringList MinecraftInstance::verboseDescription(int serverPort)
         out << "";
     }
 
-    auto params = processMinecraftArgs(serverPort);
     out << "Params:";
-    out << "  " + params.join(' ');
+    out << "  " + plan->minecraftArguments.join(' ');
     out << "";
 
     QString windowParams;
@@ -754,6 +842,12 @@ shared_qobject_ptr<LaunchTask> MinecraftInstance::createLaunchTask(int serverPor
 
     ENV.icons()->saveIcon(iconKey(), FS::PathCombine(gameRoot(), "icon.png"), "PNG");
 
+    // every step works with the same port, so they share one launch plan
+    if(!serverPort)
+    {
+        serverPort = m_settings->get("ServerPort").toInt();
+    }
+
     // print a header
     {
         process->appendStep(new TextPrint(pptr, "Minecraft folder is:\n" + gameRoot() + "\n\n", MessageLevel::MultiServerMC));
@@ -814,7 +908,7 @@ shared_qobject_ptr<LaunchTask> MinecraftInstance::createLaunchTask(int serverPor
 
     // extract native jars if needed
     {
-        process->appendStep(new ExtractNatives(pptr));
+        process->appendStep(new ExtractNatives(pptr, serverPort));
     }
 
     // verify that minimum Java requirements are met
@@ -822,23 +916,37 @@ shared_qobject_ptr<LaunchTask> MinecraftInstance::createLaunchTask(int serverPor
         process->appendStep(new VerifyJavaInstall(pptr));
     }
 
+    // put the server into its own cgroup if asked to
+    if(m_settings->get("ResourceLimits").toBool())
+    {
+        process->appendStep(new ApplyResourceLimits(pptr));
+    }
+
     {
+        // the archive is only good for what the server loads, so the mods count too
+        std::shared_ptr<ClassDataArchive> classDataArchive;
+        if(m_settings->get("ClassDataSharing").toBool())
+        {
+            classDataArchive = std::make_shared<ClassDataArchive>(FS::PathCombine(instanceRoot(), "cds"), QStringList{loaderModsDir(), coreModsDir()});
+            classDataArchive->attach(pptr);
+        }
+
         // actually launch the game
         auto method = launchMethod();
         if(method == "LauncherPart")
         {
             auto step = new LauncherPartLaunch(pptr);
             step->setWorkingDirectory(gameRoot());
-            if(!serverPort) serverPort = m_settings->get("ServerPort").toInt();
             step->setServerPort(serverPort);
+            step->setClassDataArchive(classDataArchive);
             process->appendStep(step);
         }
         else if (method == "DirectJava")
         {
             auto step = new DirectJavaLaunch(pptr);
             step->setWorkingDirectory(gameRoot());
-            if(!serverPort) serverPort = m_settings->get("ServerPort").toInt();
             step->setServerPort(serverPort);
+            step->setClassDataArchive(classDataArchive);
             process->appendStep(step);
         }
     }
@@ -850,6 +958,18 @@ shared_qobject_ptr<LaunchTask> MinecraftInstance::createLaunchTask(int serverPor
         step->setWorkingDirectory(gameRoot());
         process->appendStep(step);
     }
+    // watch the log for tick times
+    {
+        TickThresholds thresholds;
+        thresholds.minTps = m_settings->get("TickAlertTps").toDouble();
+        thresholds.maxMspt = m_settings->get("TickAlertMspt").toDouble();
+        thresholds.maxBehindMs = m_settings->get("TickAlertBehind").toLongLong();
+        thresholds.cooldown = m_settings->get("TickAlertCooldown").toInt();
+        m_tickMonitor->setThresholds(thresholds);
+        m_tickMonitor->setProbe(m_settings->get("TickProbeCommand").toString(), m_settings->get("TickProbeInterval").toInt());
+        m_tickMonitor->attach(pptr);
+    }
+
     m_launchProcess = process;
     emit launchTaskChanged(m_launchProcess);
     return m_launchProcess;
@@ -892,10 +1012,17 @@ std::shared_ptr<WorldList> MinecraftInstance::worldList() const
     if (!m_world_list)
     {
         m_world_list.reset(new WorldList(worldDir()));
+        m_world_list->setSummaryCachePath(FS::PathCombine(instanceRoot(), "worlds.cache"));
+        m_world_list->setStatsCachePath(FS::PathCombine(instanceRoot(), "worldstats.cache"));
     }
     return m_world_list;
 }
 
+std::shared_ptr<TickMonitor> MinecraftInstance::tickMonitor() const
+{
+    return m_tickMonitor;
+}
+
 std::shared_ptr<GameOptions> MinecraftInstance::gameOptionsModel() const
 {
     if (!m_game_options)
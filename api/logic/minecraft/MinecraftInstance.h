@@ -6,12 +6,15 @@
 #include <QDir>
 #include "multiservermc_logic_export.h"
 #include "minecraft/launch/MinecraftServerTarget.h"
+#include "minecraft/launch/LaunchPlan.h"
 
 class ModFolderModel;
 class WorldList;
 class GameOptions;
+class TickMonitor;
 class LaunchStep;
 class PackProfile;
+class Setting;
 
 class MULTISERVERMC_LOGIC_EXPORT MinecraftInstance: public BaseInstance
 {
@@ -71,6 +74,9 @@ public:
     std::shared_ptr<WorldList> worldList() const;
     std::shared_ptr<GameOptions> gameOptionsModel() const;
 
+    /// tick times reported in the server log, kept across launches
+    std::shared_ptr<TickMonitor> tickMonitor() const;
+
     //////  Launch stuff //////
     shared_qobject_ptr<Task> createUpdateTask(Net::Mode mode) override;
     shared_qobject_ptr<LaunchTask> createLaunchTask(int serverPort) override;
@@ -81,6 +87,11 @@ public:
     /// get arguments passed to java
     QStringList javaArguments() const;
 
+    /// get the cached plan for starting the server on serverPort, nullptr if the profile can't be applied
+    std::shared_ptr<const LaunchPlan> launchPlan(int serverPort);
+    /// forget the cached launch plan, settings and profile changes do this on their own
+    void invalidateLaunchPlan();
+
     /// get variables for launch command variable substitution/environment
     QMap<QString, QString> getVariables() const override;
 
@@ -114,6 +125,10 @@ protected:
 
 private:
     QString prettifyTimeDuration(int64_t duration);
+    QMap<QString, QString> variablesFor(const QStringList &javaArgs) const;
+    QString launchScriptFor(const LaunchPlan &plan) const;
+    void settingChanged(const Setting &setting);
+    void tickAlert(const QString &message);
 
 protected: // data
     std::shared_ptr<PackProfile> m_components;
@@ -123,6 +138,8 @@ protected: // data
     mutable std::shared_ptr<ModFolderModel> m_texture_pack_list;
     mutable std::shared_ptr<WorldList> m_world_list;
     mutable std::shared_ptr<GameOptions> m_game_options;
+    std::shared_ptr<const LaunchPlan> m_launchPlan;
+    std::shared_ptr<TickMonitor> m_tickMonitor;
 };
 
 typedef std::shared_ptr<MinecraftInstance> MinecraftInstancePtr;
@@ -0,0 +1,241 @@
+#include "RegionFile.h"
+
+#include <QFileInfo>
+#include <QDir>
+#include <QRegularExpression>
+#include <QtEndian>
+#include <QDebug>
+#include <cstring>
+#include <sstream>
+
+#include <zlib.h>
+#include <io/stream_reader.h>
+#include <tag_compound.h>
+
+namespace {
+
+/// Inflate gzip or zlib data, zlib tells them apart by their header
+bool inflateChunk(const char *compressed, qint64 size, QByteArray &data)
+{
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if(inflateInit2(&stream, 32 + MAX_WBITS) != Z_OK)
+    {
+        return false;
+    }
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(compressed));
+    stream.avail_in = uInt(size);
+    // chunk NBT usually inflates to 4 - 8 times its compressed size
+    data.resize(int(qMax<qint64>(size * 6, 64 * 1024)));
+    int err = Z_OK;
+    while(err == Z_OK)
+    {
+        if(stream.total_out == uLong(data.size()))
+        {
+            data.resize(data.size() * 2);
+        }
+        stream.next_out = reinterpret_cast<Bytef *>(data.data() + stream.total_out);
+        stream.avail_out = uInt(data.size() - stream.total_out);
+        err = inflate(&stream, Z_NO_FLUSH);
+    }
+    auto total = stream.total_out;
+    inflateEnd(&stream);
+    if(err != Z_STREAM_END)
+    {
+        return false;
+    }
+    data.resize(int(total));
+    return true;
+}
+
+}
+
+RegionFile::RegionFile(const QString &path) : m_path(path), m_file(path)
+{
+    memset(m_locations, 0, sizeof(m_locations));
+    memset(m_timestamps, 0, sizeof(m_timestamps));
+}
+
+RegionFile::~RegionFile()
+{
+    if(m_data)
+    {
+        m_file.unmap(const_cast<uchar *>(m_data));
+    }
+}
+
+bool RegionFile::open()
+{
+    if(m_data)
+    {
+        return true;
+    }
+    if(!m_file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    m_size = m_file.size();
+    if(m_size < headerSize)
+    {
+        qWarning() << m_path << "is too small to be a region file";
+        return false;
+    }
+    auto data = m_file.map(0, m_size);
+    if(!data)
+    {
+        qWarning() << "Could not map" << m_path << ":" << m_file.errorString();
+        return false;
+    }
+    for(int i = 0; i < 1024; i++)
+    {
+        m_locations[i] = qFromBigEndian<quint32>(data + i * 4);
+        m_timestamps[i] = qFromBigEndian<quint32>(data + sectorSize + i * 4);
+    }
+    m_data = data;
+    return true;
+}
+
+bool RegionFile::hasChunk(int x, int z) const
+{
+    return m_data && m_locations[index(x, z)] != 0;
+}
+
+quint32 RegionFile::timestamp(int x, int z) const
+{
+    return m_timestamps[index(x, z)];
+}
+
+QVector<RegionFile::ChunkInfo> RegionFile::chunks() const
+{
+    QVector<ChunkInfo> result;
+    if(!m_data)
+    {
+        return result;
+    }
+    for(int i = 0; i < 1024; i++)
+    {
+        if(m_locations[i] == 0)
+        {
+            continue;
+        }
+        ChunkInfo info;
+        info.x = i % 32;
+        info.z = i / 32;
+        info.sectorOffset = m_locations[i] >> 8;
+        info.sectorCount = m_locations[i] & 0xff;
+        info.timestamp = m_timestamps[i];
+        result.append(info);
+    }
+    return result;
+}
+
+int RegionFile::compression(int x, int z) const
+{
+    if(!hasChunk(x, z))
+    {
+        return 0;
+    }
+    qint64 offset = qint64(m_locations[index(x, z)] >> 8) * sectorSize;
+    if(offset < headerSize || offset + 5 > m_size)
+    {
+        return 0;
+    }
+    return m_data[offset + 4];
+}
+
+bool RegionFile::readRawChunk(int x, int z, QByteArray &data, int &compression) const
+{
+    if(!hasChunk(x, z))
+    {
+        return false;
+    }
+    auto location = m_locations[index(x, z)];
+    qint64 offset = qint64(location >> 8) * sectorSize;
+    qint64 available = qint64(location & 0xff) * sectorSize;
+    if(offset < headerSize || offset + available > m_size || available < 5)
+    {
+        qWarning() << "Chunk" << (x & 31) << (z & 31) << "of" << m_path << "points outside of the file";
+        return false;
+    }
+    qint64 length = qFromBigEndian<quint32>(m_data + offset);
+    if(length == 0 || length + 4 > available)
+    {
+        qWarning() << "Chunk" << (x & 31) << (z & 31) << "of" << m_path << "has a bad length";
+        return false;
+    }
+    compression = m_data[offset + 4];
+    if(compression & External)
+    {
+        int regionX = 0;
+        int regionZ = 0;
+        if(!regionCoordinates(QFileInfo(m_path).fileName(), regionX, regionZ))
+        {
+            return false;
+        }
+        auto name = QString("c.%1.%2.mcc").arg(regionX * 32 + (x & 31)).arg(regionZ * 32 + (z & 31));
+        QFile external(QFileInfo(m_path).dir().absoluteFilePath(name));
+        if(!external.open(QIODevice::ReadOnly))
+        {
+            qWarning() << "Chunk" << (x & 31) << (z & 31) << "of" << m_path << "is missing its" << name;
+            return false;
+        }
+        data = external.readAll();
+        return external.error() == QFile::NoError;
+    }
+    data = QByteArray(reinterpret_cast<const char *>(m_data + offset + 5), int(length - 1));
+    return true;
+}
+
+bool RegionFile::readChunkData(int x, int z, QByteArray &data) const
+{
+    QByteArray raw;
+    int compression = 0;
+    if(!readRawChunk(x, z, raw, compression))
+    {
+        return false;
+    }
+    switch(compression & ~External)
+    {
+        case GZip:
+        case Zlib:
+            return inflateChunk(raw.constData(), raw.size(), data);
+        case Uncompressed:
+            data = raw;
+            return true;
+        default:
+            qWarning() << "Chunk" << (x & 31) << (z & 31) << "of" << m_path << "uses unsupported compression" << compression;
+            return false;
+    }
+}
+
+std::unique_ptr<nbt::tag_compound> RegionFile::readChunk(int x, int z) const
+{
+    QByteArray data;
+    if(!readChunkData(x, z, data))
+    {
+        return nullptr;
+    }
+    std::istringstream input(std::string(data.constData(), data.size()));
+    try
+    {
+        return std::move(nbt::io::read_compound(input).second);
+    }
+    catch (const nbt::io::input_error &e)
+    {
+        qWarning() << "Unable to parse chunk" << (x & 31) << (z & 31) << "of" << m_path << ":" << e.what();
+        return nullptr;
+    }
+}
+
+bool RegionFile::regionCoordinates(const QString &fileName, int &x, int &z)
+{
+    static const QRegularExpression pattern("^r\\.(-?\\d+)\\.(-?\\d+)\\.mc[ar]$");
+    auto match = pattern.match(fileName);
+    if(!match.hasMatch())
+    {
+        return false;
+    }
+    x = match.captured(1).toInt();
+    z = match.captured(2).toInt();
+    return true;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <QString>
+#include <QByteArray>
+#include <QFile>
+#include <QVector>
+#include <memory>
+
+#include "multiservermc_logic_export.h"
+
+namespace nbt
+{
+class tag_compound;
+}
+
+/**
+ * Read access to the chunks of an Anvil (.mca) or McRegion (.mcr) region file.
+ *
+ * The file is mapped into memory, only the 8 KiB header is read up front. Chunks are
+ * decompressed when they are asked for, so looking at a few chunks of a big region is cheap.
+ *
+ * Chunk coordinates can be given relative to the region (0 - 31) or as absolute chunk
+ * coordinates, only their position inside the region is used.
+ * After open(), all of the const functions are safe to call from several threads at once.
+ */
+class MULTISERVERMC_LOGIC_EXPORT RegionFile
+{
+public:
+    enum Compression
+    {
+        GZip = 1,
+        Zlib = 2,
+        Uncompressed = 3,
+        LZ4 = 4,
+        // flag: the chunk is too big for the region and lives in a c.<x>.<z>.mcc file next to it
+        External = 0x80
+    };
+
+    struct ChunkInfo
+    {
+        int x = 0;
+        int z = 0;
+        quint32 sectorOffset = 0;
+        quint32 sectorCount = 0;
+        /// last time the game saved the chunk, in seconds since the epoch
+        quint32 timestamp = 0;
+    };
+
+    static const int sectorSize = 4096;
+    static const int headerSize = 2 * sectorSize;
+
+    explicit RegionFile(const QString &path);
+    ~RegionFile();
+
+    /// Map the file and read its header. Fails for files that are not region files.
+    bool open();
+    bool isOpen() const
+    {
+        return m_data != nullptr;
+    }
+    QString path() const
+    {
+        return m_path;
+    }
+
+    bool hasChunk(int x, int z) const;
+    quint32 timestamp(int x, int z) const;
+    /// All of the chunks stored in the region
+    QVector<ChunkInfo> chunks() const;
+
+    /// Compression type of a chunk, including the External flag, 0 if there is no such chunk
+    int compression(int x, int z) const;
+    /// The chunk as stored: compressed, without the length and compression type
+    bool readRawChunk(int x, int z, QByteArray &data, int &compression) const;
+    /// The uncompressed NBT of a chunk
+    bool readChunkData(int x, int z, QByteArray &data) const;
+    /// The parsed NBT of a chunk, nullptr if it is missing or broken
+    std::unique_ptr<nbt::tag_compound> readChunk(int x, int z) const;
+
+    /// Region coordinates from a file name like r.-1.2.mca
+    static bool regionCoordinates(const QString &fileName, int &x, int &z);
+
+private:
+    static int index(int x, int z)
+    {
+        return (x & 31) + (z & 31) * 32;
+    }
+
+private:
+    QString m_path;
+    QFile m_file;
+    const uchar *m_data = nullptr;
+    qint64 m_size = 0;
+    // the location and timestamp tables, converted from big endian
+    quint32 m_locations[1024];
+    quint32 m_timestamps[1024];
+};
@@ -0,0 +1,115 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QtEndian>
+#include "TestUtil.h"
+
+#include "FileSystem.h"
+#include "GZip.h"
+#include "minecraft/RegionFile.h"
+
+#include <tag_compound.h>
+#include <tag_primitive.h>
+
+/// NBT of a chunk, with its position and a few KiB of block data
+static QByteArray makeChunkNbt(qint32 x, qint32 z)
+{
+    QByteArray data;
+    auto append = [&data](const void *bytes, int size) { data.append(static_cast<const char *>(bytes), size); };
+    auto tag = [&](char type, const QByteArray &name)
+    {
+        data.append(type);
+        uchar length[2];
+        qToBigEndian(quint16(name.size()), length);
+        append(length, 2);
+        data.append(name);
+    };
+    auto intTag = [&](const QByteArray &name, qint32 value)
+    {
+        tag(3, name);
+        uchar bytes[4];
+        qToBigEndian(value, bytes);
+        append(bytes, 4);
+    };
+    tag(10, "");
+    intTag("xPos", x);
+    intTag("zPos", z);
+    tag(12, "BlockStates");
+    uchar count[4];
+    qToBigEndian(qint32(512), count);
+    append(count, 4);
+    for(int i = 0; i < 512; i++)
+    {
+        uchar bytes[8];
+        qToBigEndian(qint64(i * x + z), bytes);
+        append(bytes, 8);
+    }
+    data.append(char(0));
+    return data;
+}
+
+/// Region r.1.-1 with every second chunk present, zlib compressed except for the first one which is gzipped
+static QByteArray makeRegion()
+{
+    QByteArray header(RegionFile::headerSize, '\0');
+    QByteArray sectors;
+    for(int i = 0; i < 1024; i += 2)
+    {
+        auto nbt = makeChunkNbt(32 + i % 32, -32 + i / 32);
+        QByteArray compressed;
+        char compression = 2;
+        if(i == 0)
+        {
+            GZip::zip(nbt, compressed);
+            compression = 1;
+        }
+        else
+        {
+            compressed = qCompress(nbt).mid(4);
+        }
+        QByteArray chunk;
+        uchar length[4];
+        qToBigEndian(quint32(compressed.size() + 1), length);
+        chunk.append((const char *)length, 4);
+        chunk.append(compression);
+        chunk.append(compressed);
+        int sectorCount = (chunk.size() + 4095) / 4096;
+        chunk.append(QByteArray(sectorCount * 4096 - chunk.size(), '\0'));
+
+        uchar location[4];
+        qToBigEndian(quint32((2 + sectors.size() / 4096) << 8 | sectorCount), location);
+        header.replace(i * 4, 4, (const char *)location, 4);
+        uchar timestamp[4];
+        qToBigEndian(quint32(1600000000 + i), timestamp);
+        header.replace(4096 + i * 4, 4, (const char *)timestamp, 4);
+        sectors.append(chunk);
+    }
+    return header + sectors;
+}
+
+class RegionFileBench : public QObject
+{
+    Q_OBJECT
+private
+slots:
+    void bench_readChunks()
+    {
+        QTemporaryDir tempDir;
+        QString path = FS::PathCombine(tempDir.path(), "r.1.-1.mca");
+        FS::write(path, makeRegion());
+        RegionFile region(path);
+        QVERIFY(region.open());
+        auto chunks = region.chunks();
+        // 512 chunks per iteration, chunks per second = 512 / time per iteration
+        QBENCHMARK
+        {
+            for(auto & info: chunks)
+            {
+                QVERIFY(region.readChunk(info.x, info.z) != nullptr);
+            }
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(RegionFileBench)
+
+#include "RegionFile_bench.moc"
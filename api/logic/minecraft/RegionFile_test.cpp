@@ -0,0 +1,168 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QtEndian>
+#include "TestUtil.h"
+
+#include "FileSystem.h"
+#include "GZip.h"
+#include "minecraft/RegionFile.h"
+
+#include <tag_compound.h>
+#include <tag_primitive.h>
+
+/// NBT of a chunk, with its position and a few KiB of block data
+static QByteArray makeChunkNbt(qint32 x, qint32 z)
+{
+    QByteArray data;
+    auto append = [&data](const void *bytes, int size) { data.append(static_cast<const char *>(bytes), size); };
+    auto tag = [&](char type, const QByteArray &name)
+    {
+        data.append(type);
+        uchar length[2];
+        qToBigEndian(quint16(name.size()), length);
+        append(length, 2);
+        data.append(name);
+    };
+    auto intTag = [&](const QByteArray &name, qint32 value)
+    {
+        tag(3, name);
+        uchar bytes[4];
+        qToBigEndian(value, bytes);
+        append(bytes, 4);
+    };
+    tag(10, "");
+    intTag("xPos", x);
+    intTag("zPos", z);
+    tag(12, "BlockStates");
+    uchar count[4];
+    qToBigEndian(qint32(512), count);
+    append(count, 4);
+    for(int i = 0; i < 512; i++)
+    {
+        uchar bytes[8];
+        qToBigEndian(qint64(i * x + z), bytes);
+        append(bytes, 8);
+    }
+    data.append(char(0));
+    return data;
+}
+
+/// Region r.1.-1 with every second chunk present, zlib compressed except for the first one which is gzipped
+static QByteArray makeRegion()
+{
+    QByteArray header(RegionFile::headerSize, '\0');
+    QByteArray sectors;
+    for(int i = 0; i < 1024; i += 2)
+    {
+        auto nbt = makeChunkNbt(32 + i % 32, -32 + i / 32);
+        QByteArray compressed;
+        char compression = 2;
+        if(i == 0)
+        {
+            GZip::zip(nbt, compressed);
+            compression = 1;
+        }
+        else
+        {
+            compressed = qCompress(nbt).mid(4);
+        }
+        QByteArray chunk;
+        uchar length[4];
+        qToBigEndian(quint32(compressed.size() + 1), length);
+        chunk.append((const char *)length, 4);
+        chunk.append(compression);
+        chunk.append(compressed);
+        int sectorCount = (chunk.size() + 4095) / 4096;
+        chunk.append(QByteArray(sectorCount * 4096 - chunk.size(), '\0'));
+
+        uchar location[4];
+        qToBigEndian(quint32((2 + sectors.size() / 4096) << 8 | sectorCount), location);
+        header.replace(i * 4, 4, (const char *)location, 4);
+        uchar timestamp[4];
+        qToBigEndian(quint32(1600000000 + i), timestamp);
+        header.replace(4096 + i * 4, 4, (const char *)timestamp, 4);
+        sectors.append(chunk);
+    }
+    return header + sectors;
+}
+
+class RegionFileTest : public QObject
+{
+    Q_OBJECT
+
+private
+slots:
+    void test_read()
+    {
+        QTemporaryDir tempDir;
+        QString path = FS::PathCombine(tempDir.path(), "r.1.-1.mca");
+        FS::write(path, makeRegion());
+
+        RegionFile region(path);
+        QVERIFY(region.open());
+        QCOMPARE(region.chunks().size(), 512);
+        QVERIFY(region.hasChunk(0, 0));
+        QVERIFY(!region.hasChunk(1, 0));
+        // absolute chunk coordinates work too
+        QVERIFY(region.hasChunk(34, -32));
+        QCOMPARE(region.timestamp(2, 0), quint32(1600000002));
+        QCOMPARE(region.compression(0, 0), int(RegionFile::GZip));
+        QCOMPARE(region.compression(2, 0), int(RegionFile::Zlib));
+
+        QByteArray data;
+        QVERIFY(region.readChunkData(4, 3, data));
+        QCOMPARE(data, makeChunkNbt(36, -29));
+
+        auto gzipped = region.readChunk(0, 0);
+        QVERIFY(gzipped != nullptr);
+        QCOMPARE(gzipped->at("xPos").as<nbt::tag_int>().get(), 32);
+        auto chunk = region.readChunk(6, 31);
+        QVERIFY(chunk != nullptr);
+        QCOMPARE(chunk->at("zPos").as<nbt::tag_int>().get(), -1);
+        QVERIFY(region.readChunk(1, 0) == nullptr);
+
+        int x = 0;
+        int z = 0;
+        QVERIFY(RegionFile::regionCoordinates("r.1.-1.mca", x, z));
+        QCOMPARE(x, 1);
+        QCOMPARE(z, -1);
+        QVERIFY(!RegionFile::regionCoordinates("level.dat", x, z));
+    }
+
+    void test_broken()
+    {
+        QTemporaryDir tempDir;
+        QString shortPath = FS::PathCombine(tempDir.path(), "r.0.0.mca");
+        FS::write(shortPath, "too short");
+        RegionFile shortRegion(shortPath);
+        QVERIFY(!shortRegion.open());
+
+        // the location of chunk 0 points past the end of the file
+        auto data = makeRegion();
+        data[0] = char(0x7f);
+        QString path = FS::PathCombine(tempDir.path(), "r.0.1.mca");
+        FS::write(path, data);
+        RegionFile region(path);
+        QVERIFY(region.open());
+        QByteArray chunk;
+        QVERIFY(!region.readChunkData(0, 0, chunk));
+        QVERIFY(region.readChunkData(2, 0, chunk));
+    }
+
+    void test_readAllChunks()
+    {
+        QTemporaryDir tempDir;
+        QString path = FS::PathCombine(tempDir.path(), "r.1.-1.mca");
+        FS::write(path, makeRegion());
+        RegionFile region(path);
+        QVERIFY(region.open());
+        for(auto & info: region.chunks())
+        {
+            QVERIFY(region.readChunk(info.x, info.z) != nullptr);
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(RegionFileTest)
+
+#include "RegionFile_test.moc"
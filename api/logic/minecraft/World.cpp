@@ -18,9 +18,11 @@
 #include <QDebug>
 #include <QSaveFile>
 #include "World.h"
+#include "LevelDatSummary.h"
 
 #include "GZip.h"
 #include <MSMCZip.h>
+#include "WorldArchive.h"
 #include <FileSystem.h>
 #include <sstream>
 #include <io/stream_reader.h>
@@ -192,15 +194,33 @@ World::World(const QFileInfo &file)
     repath(file);
 }
 
+World::World(const QFileInfo &file, const LevelDatSummary &summary)
+{
+    m_containerFile = file;
+    m_folderName = file.fileName();
+    QFileInfo assumedIconPath(file.absoluteFilePath() + "/icon.png");
+    if(assumedIconPath.exists()) {
+        m_iconFile = assumedIconPath.absoluteFilePath();
+    }
+    levelDatTime = file.lastModified();
+    applySummary(summary);
+}
+
 void World::repath(const QFileInfo &file)
 {
     m_containerFile = file;
     m_folderName = file.fileName();
-    if(file.isFile() && file.suffix() == "zip")
+    auto format = file.isFile() ? WorldArchive::formatOf(file.fileName()) : nonstd::nullopt;
+    if(format == WorldArchive::Format::Zip)
     {
         m_iconFile = QString();
         readFromZip(file);
     }
+    else if(format)
+    {
+        m_iconFile = QString();
+        readFromTar(file);
+    }
     else if(file.isDir())
     {
         QFileInfo assumedIconPath(file.absoluteFilePath() + "/icon.png");
@@ -231,8 +251,8 @@ void World::readFromFS(const QFileInfo &file)
         is_valid = false;
         return;
     }
-    loadFromLevelDat(bytes);
     levelDatTime = file.lastModified();
+    loadFromLevelDat(bytes);
 }
 
 void World::readFromZip(const QFileInfo &file)
@@ -274,25 +294,41 @@ void World::readFromZip(const QFileInfo &file)
     zippedFile.close();
 }
 
-bool World::install(const QString &to, const QString &name)
+void World::readFromTar(const QFileInfo &file)
 {
-    auto finalPath = FS::PathCombine(to, FS::DirNameFromString(m_actualName, to));
-    if(!FS::ensureFolderPathExists(finalPath))
+    QString location;
+    QDateTime modTime;
+    auto data = WorldArchive::readFromTar(file.absoluteFilePath(), "level.dat", location, &modTime);
+    is_valid = bool(data);
+    if (!is_valid)
     {
-        return false;
+        return;
     }
+    m_containerOffsetPath = location;
+    levelDatTime = modTime;
+    loadFromLevelDat(*data);
+}
+
+bool World::install(const QString &to, const QString &name)
+{
+    auto finalPath = FS::PathCombine(to, FS::DirNameFromString(m_actualName, to));
     bool ok = false;
     if(m_containerFile.isFile())
     {
-        QuaZip zip(m_containerFile.absoluteFilePath());
-        if (!zip.open(QuaZip::mdUnzip))
+        // straight into place, no copy of the extracted world
+        auto error = WorldArchive::importWorld(m_containerFile.absoluteFilePath(), m_containerOffsetPath, finalPath);
+        if(!error.isEmpty())
         {
-            return false;
+            qWarning() << "Failed to install world:" << error;
         }
-        ok = !MSMCZip::extractSubDir(&zip, m_containerOffsetPath, finalPath);
+        ok = error.isEmpty();
     }
     else if(m_containerFile.isDir())
     {
+        if(!FS::ensureFolderPathExists(finalPath))
+        {
+            return false;
+        }
         QString from = m_containerFile.filePath();
         ok = FS::copy(from, finalPath)();
     }
@@ -348,141 +384,24 @@ bool World::rename(const QString &newName)
     return true;
 }
 
-namespace {
-
-optional<QString> read_string (nbt::value& parent, const char * name)
-{
-    try
-    {
-        auto &namedValue = parent.at(name);
-        if(namedValue.get_type() != nbt::tag_type::String)
-        {
-            return nullopt;
-        }
-        auto & tag_str = namedValue.as<nbt::tag_string>();
-        return QString::fromStdString(tag_str.get());
-    }
-    catch (const std::out_of_range &e)
-    {
-        // fallback for old world formats
-        qWarning() << "String NBT tag" << name << "could not be found.";
-        return nullopt;
-    }
-    catch (const std::bad_cast &e)
-    {
-        // type mismatch
-        qWarning() << "NBT tag" << name << "could not be converted to string.";
-        return nullopt;
-    }
-}
-
-optional<int64_t> read_long (nbt::value& parent, const char * name)
-{
-    try
-    {
-        auto &namedValue = parent.at(name);
-        if(namedValue.get_type() != nbt::tag_type::Long)
-        {
-            return nullopt;
-        }
-        auto & tag_str = namedValue.as<nbt::tag_long>();
-        return tag_str.get();
-    }
-    catch (const std::out_of_range &e)
-    {
-        // fallback for old world formats
-        qWarning() << "Long NBT tag" << name << "could not be found.";
-        return nullopt;
-    }
-    catch (const std::bad_cast &e)
-    {
-        // type mismatch
-        qWarning() << "NBT tag" << name << "could not be converted to long.";
-        return nullopt;
-    }
-}
-
-optional<int> read_int (nbt::value& parent, const char * name)
+void World::loadFromLevelDat(QByteArray data)
 {
-    try
-    {
-        auto &namedValue = parent.at(name);
-        if(namedValue.get_type() != nbt::tag_type::Int)
-        {
-            return nullopt;
-        }
-        auto & tag_str = namedValue.as<nbt::tag_int>();
-        return tag_str.get();
-    }
-    catch (const std::out_of_range &e)
-    {
-        // fallback for old world formats
-        qWarning() << "Int NBT tag" << name << "could not be found.";
-        return nullopt;
-    }
-    catch (const std::bad_cast &e)
-    {
-        // type mismatch
-        qWarning() << "NBT tag" << name << "could not be converted to int.";
-        return nullopt;
-    }
-}
-
-GameType read_gametype(nbt::value& parent, const char * name) {
-    return GameType(read_int(parent, name));
-}
-
+    applySummary(LevelDatSummary::fromCompressed(data));
 }
 
-void World::loadFromLevelDat(QByteArray data)
+void World::applySummary(const LevelDatSummary &summary)
 {
-    auto levelData = parseLevelDat(data);
-    if(!levelData)
-    {
-        is_valid = false;
-        return;
-    }
-
-    nbt::value * valPtr = nullptr;
-    try {
-        valPtr = &levelData->at("Data");
-    }
-    catch (const std::out_of_range &e) {
-        qWarning() << "Unable to read NBT tags from " << m_folderName << ":" << e.what();
-        is_valid = false;
-        return;
-    }
-    nbt::value &val = *valPtr;
-
-    is_valid = val.get_type() == nbt::tag_type::Compound;
+    is_valid = summary.valid;
     if(!is_valid)
+    {
+        qWarning() << "Unable to read NBT tags from" << m_folderName;
         return;
-
-    auto name = read_string(val, "LevelName");
-    m_actualName = name ? *name : m_folderName;
-
-    auto timestamp = read_long(val, "LastPlayed");
-    m_lastPlayed = timestamp ? QDateTime::fromMSecsSinceEpoch(*timestamp) : levelDatTime;
-
-    m_gameType = read_gametype(val, "GameType");
-
-    optional<int64_t> randomSeed;
-    try {
-        auto &WorldGen_val = val.at("WorldGenSettings");
-        randomSeed = read_long(WorldGen_val, "seed");
     }
-    catch (const std::out_of_range &) {}
-    if(!randomSeed) {
-        randomSeed = read_long(val, "RandomSeed");
-    }
-    m_randomSeed = randomSeed ? *randomSeed : 0;
 
-    qDebug() << "World Name:" << m_actualName;
-    qDebug() << "Last Played:" << m_lastPlayed.toString();
-    if(randomSeed) {
-        qDebug() << "Seed:" << *randomSeed;
-    }
-    qDebug() << "GameType:" << m_gameType.toLogString();
+    m_actualName = summary.levelName ? *summary.levelName : m_folderName;
+    m_lastPlayed = summary.lastPlayed ? QDateTime::fromMSecsSinceEpoch(*summary.lastPlayed) : levelDatTime;
+    m_gameType = GameType(summary.gameType);
+    m_randomSeed = summary.seed ? *summary.seed : 0;
 }
 
 bool World::replace(World &with)
@@ -20,6 +20,8 @@
 
 #include "multiservermc_logic_export.h"
 
+struct LevelDatSummary;
+
 struct MULTISERVERMC_LOGIC_EXPORT GameType {
     GameType() = default;
     GameType (nonstd::optional<int> original);
@@ -42,6 +44,8 @@ class MULTISERVERMC_LOGIC_EXPORT World
 {
 public:
     World(const QFileInfo &file);
+    /// A world folder with an already read level.dat
+    World(const QFileInfo &file, const LevelDatSummary &summary);
     QString folderName() const
     {
         return m_folderName;
@@ -95,8 +99,10 @@ public:
 
 private:
     void readFromZip(const QFileInfo &file);
+    void readFromTar(const QFileInfo &file);
     void readFromFS(const QFileInfo &file);
     void loadFromLevelDat(QByteArray data);
+    void applySummary(const LevelDatSummary &summary);
 
 protected:
 
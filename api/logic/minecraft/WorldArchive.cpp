@@ -0,0 +1,1045 @@
+#include "WorldArchive.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSemaphore>
+#include <QSet>
+#include <QThreadPool>
+#include <QtConcurrentRun>
+#include <QDebug>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#include <quazip.h>
+#include <quazipfile.h>
+#include <quazipnewinfo.h>
+#include <zlib.h>
+
+#include "FileSystem.h"
+#include "tasks/ConcurrentProgress.h"
+#include "tasks/ParallelJobs.h"
+
+namespace {
+
+const int tarBlock = 512;
+// how much file data may be read ahead of the writers on import, and compressed ahead of the output on export
+const qint64 windowSize = 64 * 1024 * 1024;
+// tar entries bigger than this are written by the reader itself, piece by piece
+const qint64 streamedFileSize = 16 * 1024 * 1024;
+const qint64 streamPiece = 1024 * 1024;
+// long names and pax headers are small, anything bigger is garbage
+const qint64 maxMetadataSize = 1024 * 1024;
+
+qint64 paddedSize(qint64 size)
+{
+    return (size + tarBlock - 1) / tarBlock * tarBlock;
+}
+
+/// Reads a tar stream, inflating it on the way if it is gzipped. Gzip files made of several members are fine.
+class TarInput
+{
+public:
+    TarInput(QIODevice *device, bool gzipped) : m_device(device), m_gzipped(gzipped)
+    {
+        if(m_gzipped)
+        {
+            memset(&m_stream, 0, sizeof(m_stream));
+            m_ok = inflateInit2(&m_stream, 16 + MAX_WBITS) == Z_OK;
+            m_buffer.resize(256 * 1024);
+        }
+    }
+    ~TarInput()
+    {
+        if(m_gzipped && m_ok)
+        {
+            inflateEnd(&m_stream);
+        }
+    }
+
+    /// Read exactly size bytes, size has to fit in an int
+    bool read(char *data, qint64 size)
+    {
+        if(!m_ok)
+        {
+            return false;
+        }
+        if(!m_gzipped)
+        {
+            return m_device->read(data, size) == size;
+        }
+        m_stream.next_out = reinterpret_cast<Bytef *>(data);
+        m_stream.avail_out = uInt(size);
+        while(m_stream.avail_out > 0)
+        {
+            if(m_stream.avail_in == 0)
+            {
+                auto read = m_device->read(m_buffer.data(), m_buffer.size());
+                if(read <= 0)
+                {
+                    return false;
+                }
+                m_stream.next_in = reinterpret_cast<Bytef *>(m_buffer.data());
+                m_stream.avail_in = uInt(read);
+            }
+            int err = inflate(&m_stream, Z_NO_FLUSH);
+            if(err == Z_STREAM_END)
+            {
+                // on to the next member, if there is one
+                if(inflateReset(&m_stream) != Z_OK)
+                {
+                    m_ok = false;
+                    return false;
+                }
+            }
+            else if(err != Z_OK && err != Z_BUF_ERROR)
+            {
+                m_ok = false;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool skip(qint64 size)
+    {
+        if(!m_gzipped && !m_device->isSequential())
+        {
+            return m_device->seek(m_device->pos() + size);
+        }
+        QByteArray scratch(int(qMin(size, streamPiece)), Qt::Uninitialized);
+        while(size > 0)
+        {
+            qint64 piece = qMin<qint64>(size, scratch.size());
+            if(!read(scratch.data(), piece))
+            {
+                return false;
+            }
+            size -= piece;
+        }
+        return true;
+    }
+
+private:
+    QIODevice *m_device;
+    bool m_gzipped;
+    bool m_ok = true;
+    z_stream m_stream;
+    QByteArray m_buffer;
+};
+
+struct TarEntry
+{
+    QString path;
+    char type = '0';
+    qint64 size = 0;
+    qint64 modified = 0;
+};
+
+bool parseNumber(const char *field, int length, qint64 &value)
+{
+    auto bytes = reinterpret_cast<const uchar *>(field);
+    value = 0;
+    if(bytes[0] & 0x80)
+    {
+        // GNU base-256, for values that do not fit the octal field
+        for(int i = 1; i < length; i++)
+        {
+            value = (value << 8) | bytes[i];
+        }
+        return value >= 0;
+    }
+    int i = 0;
+    while(i < length && field[i] == ' ')
+    {
+        i++;
+    }
+    for(; i < length && field[i] >= '0' && field[i] <= '7'; i++)
+    {
+        value = value * 8 + (field[i] - '0');
+    }
+    return true;
+}
+
+void writeNumber(char *field, int length, qint64 value)
+{
+    if(value >= (qint64(1) << (3 * (length - 1))))
+    {
+        memset(field, 0, length);
+        field[0] = char(0x80);
+        for(int i = length - 1; i > 0 && value; i--, value >>= 8)
+        {
+            field[i] = char(value & 0xff);
+        }
+        return;
+    }
+    // zero padded octal digits and a terminating NUL
+    field[length - 1] = '\0';
+    for(int i = length - 2; i >= 0; i--, value >>= 3)
+    {
+        field[i] = char('0' + (value & 7));
+    }
+}
+
+QString fieldString(const char *field, int length)
+{
+    return QString::fromUtf8(field, int(qstrnlen(field, length)));
+}
+
+bool checksumMatches(const char *header)
+{
+    qint64 stored = 0;
+    parseNumber(header + 148, 8, stored);
+    qint64 sum = 0;
+    for(int i = 0; i < tarBlock; i++)
+    {
+        sum += (i >= 148 && i < 156) ? ' ' : uchar(header[i]);
+    }
+    return sum == stored;
+}
+
+void parsePax(const QByteArray &data, QString &path, qint64 &size)
+{
+    // records of "<length> <key>=<value>\n"
+    int pos = 0;
+    while(pos < data.size())
+    {
+        int space = data.indexOf(' ', pos);
+        if(space < 0)
+        {
+            return;
+        }
+        bool ok = false;
+        int length = data.mid(pos, space - pos).toInt(&ok);
+        if(!ok || length <= space - pos || pos + length > data.size())
+        {
+            return;
+        }
+        auto record = data.mid(space + 1, length - (space - pos) - 2);
+        int equals = record.indexOf('=');
+        if(equals > 0)
+        {
+            auto key = record.left(equals);
+            auto value = record.mid(equals + 1);
+            if(key == "path")
+            {
+                path = QString::fromUtf8(value);
+            }
+            else if(key == "size")
+            {
+                size = value.toLongLong();
+            }
+        }
+        pos += length;
+    }
+}
+
+/// Read the next entry header, the data of the entry is left for the caller
+bool readEntry(TarInput &input, TarEntry &entry, bool &end)
+{
+    QString longName;
+    QString paxPath;
+    qint64 paxSize = -1;
+    char header[tarBlock];
+    while(true)
+    {
+        if(!input.read(header, tarBlock))
+        {
+            return false;
+        }
+        if(std::all_of(header, header + tarBlock, [](char c) { return c == '\0'; }))
+        {
+            end = true;
+            return true;
+        }
+        if(!checksumMatches(header))
+        {
+            return false;
+        }
+        qint64 size = 0;
+        parseNumber(header + 124, 12, size);
+        char type = header[156];
+        if(type == 'L' || type == 'x' || type == 'g')
+        {
+            if(size > maxMetadataSize)
+            {
+                return false;
+            }
+            QByteArray data(int(paddedSize(size)), Qt::Uninitialized);
+            if(!input.read(data.data(), data.size()))
+            {
+                return false;
+            }
+            data.truncate(int(size));
+            if(type == 'L')
+            {
+                longName = fieldString(data.constData(), data.size());
+            }
+            else if(type == 'x')
+            {
+                parsePax(data, paxPath, paxSize);
+            }
+            continue;
+        }
+        entry.type = type;
+        entry.size = paxSize >= 0 ? paxSize : size;
+        parseNumber(header + 136, 12, entry.modified);
+        if(!paxPath.isEmpty())
+        {
+            entry.path = paxPath;
+        }
+        else if(!longName.isEmpty())
+        {
+            entry.path = longName;
+        }
+        else
+        {
+            entry.path = fieldString(header, 100);
+            auto prefix = fieldString(header + 345, 155);
+            if(memcmp(header + 257, "ustar", 5) == 0 && !prefix.isEmpty())
+            {
+                entry.path = prefix + '/' + entry.path;
+            }
+        }
+        while(entry.path.startsWith("./"))
+        {
+            entry.path.remove(0, 2);
+        }
+        return true;
+    }
+}
+
+bool isFileEntry(const TarEntry &entry)
+{
+    return entry.type == '0' || entry.type == '\0' || entry.type == '7';
+}
+
+/// Headers for an entry, with a GNU long name entry in front if the name does not fit
+QByteArray tarHeader(const QString &name, char type, qint64 size, qint64 modified)
+{
+    auto nameBytes = name.toUtf8();
+    QByteArray result;
+    if(nameBytes.size() > 100)
+    {
+        result += tarHeader("././@LongLink", 'L', nameBytes.size() + 1, 0);
+        QByteArray longName = nameBytes + '\0';
+        longName.append(QByteArray(int(paddedSize(longName.size()) - longName.size()), '\0'));
+        result += longName;
+    }
+    QByteArray block(tarBlock, '\0');
+    char *header = block.data();
+    memcpy(header, nameBytes.constData(), qMin(nameBytes.size(), 100));
+    writeNumber(header + 100, 8, type == '5' ? 0755 : 0644);
+    writeNumber(header + 108, 8, 0);
+    writeNumber(header + 116, 8, 0);
+    writeNumber(header + 124, 12, size);
+    writeNumber(header + 136, 12, modified);
+    header[156] = type;
+    memcpy(header + 257, "ustar", 6);
+    memcpy(header + 263, "00", 2);
+    memset(header + 148, ' ', 8);
+    qint64 sum = 0;
+    for(int i = 0; i < tarBlock; i++)
+    {
+        sum += uchar(header[i]);
+    }
+    // six digits, a NUL and the space that is already there
+    writeNumber(header + 148, 7, sum);
+    return result + block;
+}
+
+bool deflateData(const QByteArray &data, int windowBits, QByteArray &compressed)
+{
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if(deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        return false;
+    }
+    compressed.resize(int(deflateBound(&stream, uLong(data.size()))));
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.constData()));
+    stream.avail_in = uInt(data.size());
+    stream.next_out = reinterpret_cast<Bytef *>(compressed.data());
+    stream.avail_out = uInt(compressed.size());
+    int err = deflate(&stream, Z_FINISH);
+    deflateEnd(&stream);
+    if(err != Z_STREAM_END)
+    {
+        return false;
+    }
+    compressed.resize(int(stream.total_out));
+    return true;
+}
+
+bool writeFile(const QString &path, const QByteArray &data)
+{
+    QFile output(path);
+    return output.open(QIODevice::WriteOnly | QIODevice::Truncate) && output.write(data) == data.size();
+}
+
+bool streamFile(TarInput &input, const QString &path, qint64 size)
+{
+    QFile output(path);
+    if(!output.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        return false;
+    }
+    QByteArray buffer(int(streamPiece), Qt::Uninitialized);
+    while(size > 0)
+    {
+        qint64 piece = qMin(size, streamPiece);
+        if(!input.read(buffer.data(), piece) || output.write(buffer.constData(), piece) != piece)
+        {
+            return false;
+        }
+        size -= piece;
+    }
+    return true;
+}
+
+/// Where an archive path ends up below subdir, fails for paths outside of it
+bool relativeTo(const QString &subdir, const QString &path, QString &relative)
+{
+    if(!path.startsWith(subdir))
+    {
+        return false;
+    }
+    relative = path.mid(subdir.size());
+    return true;
+}
+
+bool isSafeRelativePath(const QString &path)
+{
+    auto clean = QDir::cleanPath(path);
+    return !QDir::isAbsolutePath(clean) && clean != ".." && !clean.startsWith("../");
+}
+
+QString importTar(const QString &archivePath, bool gzipped, const QString &subdir, const QString &stagingPath, MSMCZip::ExtractState *state)
+{
+    QFile file(archivePath);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        return QObject::tr("Could not open %1.").arg(archivePath);
+    }
+    if(state)
+    {
+        state->setTotal(file.size());
+    }
+    TarInput input(&file, gzipped);
+
+    // the stream is read on this thread, files that fit in the window are written by the pool
+    QThreadPool pool;
+    QSemaphore window(int(windowSize / 1024));
+    std::atomic<bool> failed {false};
+    QMutex failureLock;
+    QString failedPath;
+    QSet<QString> directories;
+    // writes handed to the pool by target, a later entry with the same name waits for them so the last one wins
+    QHash<QString, QFuture<void>> writes;
+    auto makeDirectory = [&](const QString &path) -> bool
+    {
+        if(directories.contains(path))
+        {
+            return true;
+        }
+        if(!QDir().mkpath(path))
+        {
+            return false;
+        }
+        directories.insert(path);
+        return true;
+    };
+
+    QString error;
+    qint64 reported = 0;
+    while(!failed && !(state && state->isCanceled()))
+    {
+        TarEntry entry;
+        bool end = false;
+        if(!readEntry(input, entry, end))
+        {
+            error = QObject::tr("%1 is damaged or not a tar archive.").arg(archivePath);
+            break;
+        }
+        if(end)
+        {
+            break;
+        }
+        qint64 padding = paddedSize(entry.size) - entry.size;
+        QString relative;
+        bool wanted = relativeTo(subdir, entry.path, relative);
+        if(wanted && !isSafeRelativePath(relative))
+        {
+            error = QObject::tr("Refusing to extract %1 outside of the world folder.").arg(entry.path);
+            break;
+        }
+        if(!wanted || !(isFileEntry(entry) || entry.type == '5'))
+        {
+            if(wanted)
+            {
+                qWarning() << "Skipping" << entry.path << "- only files and folders are extracted";
+            }
+            if(!input.skip(entry.size + padding))
+            {
+                error = QObject::tr("%1 is damaged.").arg(archivePath);
+                break;
+            }
+            continue;
+        }
+
+        auto targetPath = QDir::cleanPath(FS::PathCombine(stagingPath, relative));
+        if(entry.type == '5')
+        {
+            if(!makeDirectory(targetPath) || !input.skip(entry.size + padding))
+            {
+                error = QObject::tr("Could not extract %1.").arg(entry.path);
+                break;
+            }
+            continue;
+        }
+        if(!makeDirectory(QFileInfo(targetPath).absolutePath()))
+        {
+            error = QObject::tr("Could not extract %1.").arg(entry.path);
+            break;
+        }
+        auto earlier = writes.find(targetPath);
+        if(earlier != writes.end())
+        {
+            earlier->waitForFinished();
+            writes.erase(earlier);
+        }
+        if(entry.size > streamedFileSize)
+        {
+            if(!streamFile(input, targetPath, entry.size) || !input.skip(padding))
+            {
+                error = QObject::tr("Could not extract %1.").arg(entry.path);
+                break;
+            }
+        }
+        else
+        {
+            QByteArray data(int(entry.size), Qt::Uninitialized);
+            if(!input.read(data.data(), entry.size) || !input.skip(padding))
+            {
+                error = QObject::tr("%1 is damaged.").arg(archivePath);
+                break;
+            }
+            int cost = qMax(1, int(entry.size / 1024));
+            window.acquire(cost);
+            writes.insert(targetPath, QtConcurrent::run(&pool, [&, data, targetPath, cost]()
+            {
+                if(!writeFile(targetPath, data))
+                {
+                    QMutexLocker locker(&failureLock);
+                    failedPath = targetPath;
+                    failed = true;
+                }
+                window.release(cost);
+            }));
+        }
+        if(state)
+        {
+            qint64 position = file.pos();
+            state->addDone(position - reported);
+            reported = position;
+        }
+    }
+    pool.waitForDone();
+
+    if(error.isEmpty() && failed)
+    {
+        error = QObject::tr("Could not write %1.").arg(failedPath);
+    }
+    if(error.isEmpty() && directories.isEmpty())
+    {
+        error = QObject::tr("There is nothing to extract in %1.").arg(archivePath);
+    }
+    return error;
+}
+
+QString importZip(const QString &archivePath, const QString &subdir, const QString &stagingPath, MSMCZip::ExtractState *state)
+{
+    QuaZip zip(archivePath);
+    if(!zip.open(QuaZip::mdUnzip))
+    {
+        return QObject::tr("Could not open %1.").arg(archivePath);
+    }
+    if(!MSMCZip::extractSubDir(&zip, subdir, stagingPath, state))
+    {
+        return QObject::tr("Could not extract %1.").arg(archivePath);
+    }
+    return QString();
+}
+
+struct ExportEntry
+{
+    /// path in the archive, folders end with a slash
+    QString name;
+    /// path on disk, empty for folders
+    QString path;
+    qint64 size = 0;
+    QDateTime modified;
+    // filled in by the workers
+    QByteArray data;
+    quint32 crc = 0;
+    bool deflated = false;
+};
+
+QVector<ExportEntry> listWorld(const QDir &worldDir)
+{
+    QVector<ExportEntry> entries;
+    auto top = worldDir.dirName();
+    ExportEntry root;
+    root.name = top + '/';
+    root.modified = QFileInfo(worldDir.absolutePath()).lastModified();
+    entries.append(root);
+    QDirIterator iter(worldDir.absolutePath(), QDir::Files | QDir::Dirs | QDir::Hidden | QDir::NoDotAndDotDot | QDir::NoSymLinks, QDirIterator::Subdirectories);
+    while(iter.hasNext())
+    {
+        iter.next();
+        auto info = iter.fileInfo();
+        auto relativePath = worldDir.relativeFilePath(info.absoluteFilePath());
+        // held open by a running game, and meaningless anywhere else
+        if(relativePath == "session.lock")
+        {
+            continue;
+        }
+        ExportEntry entry;
+        entry.name = top + '/' + relativePath;
+        entry.modified = info.lastModified();
+        if(info.isDir())
+        {
+            entry.name += '/';
+        }
+        else
+        {
+            entry.path = info.absoluteFilePath();
+            entry.size = info.size();
+        }
+        entries.append(entry);
+    }
+    // parents before their contents
+    std::sort(entries.begin(), entries.end(), [](const ExportEntry &a, const ExportEntry &b)
+    {
+        return a.name < b.name;
+    });
+    return entries;
+}
+
+bool readEntryFile(ExportEntry &entry, QByteArray &data)
+{
+    QFile input(entry.path);
+    if(!input.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    data = input.readAll();
+    if(input.error() != QFile::NoError)
+    {
+        return false;
+    }
+    // the file may have changed since it was listed
+    entry.size = data.size();
+    return true;
+}
+
+/**
+ * Prepare the entries in windows of bounded size on all cores, then write them out in order.
+ * Returns the name of the entry that failed, empty on success.
+ */
+QString processInWindows(QVector<ExportEntry> &entries, const std::function<bool(ExportEntry &)> &prepare,
+                         const std::function<bool(ExportEntry &)> &write, ConcurrentProgress *progress)
+{
+    QMutex failureLock;
+    QString failed;
+    auto entriesData = entries.data();
+    int first = 0;
+    while(first < entries.size())
+    {
+        int last = first;
+        qint64 bytes = 0;
+        while(last < entries.size() && (last == first || bytes + entries.at(last).size <= windowSize))
+        {
+            bytes += entries.at(last).size;
+            last++;
+        }
+        bool ok = ParallelJobs::run(last - first, [&](int i) -> bool
+        {
+            auto & entry = entriesData[first + i];
+            qint64 listedSize = entry.size;
+            if(!prepare(entry))
+            {
+                QMutexLocker locker(&failureLock);
+                failed = entry.name;
+                return false;
+            }
+            if(progress)
+            {
+                progress->addDone(listedSize);
+            }
+            return true;
+        }, progress);
+        if(!ok)
+        {
+            return failed.isEmpty() ? entries.at(first).name : failed;
+        }
+        for(int i = first; i < last; i++)
+        {
+            if(!write(entriesData[i]))
+            {
+                return entries.at(i).name;
+            }
+            entriesData[i].data.clear();
+        }
+        first = last;
+    }
+    return QString();
+}
+
+QString writeZip(QVector<ExportEntry> &entries, const QString &path, ConcurrentProgress *progress)
+{
+    QuaZip zip(path);
+    zip.setZip64Enabled(true);
+    if(!zip.open(QuaZip::mdCreate))
+    {
+        return QObject::tr("Could not create %1.").arg(path);
+    }
+    auto prepare = [](ExportEntry &entry) -> bool
+    {
+        if(entry.path.isEmpty())
+        {
+            return true;
+        }
+        QByteArray data;
+        if(!readEntryFile(entry, data))
+        {
+            return false;
+        }
+        entry.crc = crc32(crc32(0, nullptr, 0), reinterpret_cast<const Bytef *>(data.constData()), uInt(data.size()));
+        // region files are mostly chunks compressed by the game, those are stored if deflating does not pay off
+        QByteArray compressed;
+        entry.deflated = deflateData(data, -MAX_WBITS, compressed) && compressed.size() < data.size();
+        entry.data = entry.deflated ? compressed : data;
+        return true;
+    };
+    auto write = [&zip](ExportEntry &entry) -> bool
+    {
+        QuaZipNewInfo info(entry.name);
+        info.dateTime = entry.modified;
+        info.uncompressedSize = entry.size;
+        QuaZipFile output(&zip);
+        bool opened;
+        if(entry.path.isEmpty())
+        {
+            opened = output.open(QIODevice::WriteOnly, info);
+        }
+        else
+        {
+            // already compressed by the workers, written as it is
+            opened = output.open(QIODevice::WriteOnly, info, nullptr, entry.crc, entry.deflated ? Z_DEFLATED : 0, Z_DEFAULT_COMPRESSION, true);
+        }
+        if(!opened || output.write(entry.data) != entry.data.size())
+        {
+            return false;
+        }
+        output.close();
+        return output.getZipError() == ZIP_OK;
+    };
+    auto failed = processInWindows(entries, prepare, write, progress);
+    zip.close();
+    if(!failed.isEmpty())
+    {
+        return QObject::tr("Could not pack %1.").arg(failed);
+    }
+    if(zip.getZipError() != ZIP_OK)
+    {
+        return QObject::tr("Could not finish %1.").arg(path);
+    }
+    return QString();
+}
+
+QString writeTar(QVector<ExportEntry> &entries, const QString &path, bool gzipped, ConcurrentProgress *progress)
+{
+    QFile output(path);
+    if(!output.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        return QObject::tr("Could not create %1.").arg(path);
+    }
+    // every entry becomes a gzip member of its own, so they can be compressed in parallel
+    auto prepare = [gzipped](ExportEntry &entry) -> bool
+    {
+        QByteArray data;
+        if(!entry.path.isEmpty() && !readEntryFile(entry, data))
+        {
+            return false;
+        }
+        auto modified = entry.modified.toMSecsSinceEpoch() / 1000;
+        QByteArray tarred = tarHeader(entry.name, entry.path.isEmpty() ? '5' : '0', data.size(), modified);
+        tarred.reserve(tarred.size() + int(paddedSize(data.size())));
+        tarred += data;
+        data.clear();
+        tarred.append(QByteArray(int(paddedSize(tarred.size()) - tarred.size()), '\0'));
+        if(gzipped)
+        {
+            return deflateData(tarred, 16 + MAX_WBITS, entry.data);
+        }
+        entry.data = tarred;
+        return true;
+    };
+    auto write = [&output](ExportEntry &entry) -> bool
+    {
+        return output.write(entry.data) == entry.data.size();
+    };
+    auto failed = processInWindows(entries, prepare, write, progress);
+    if(!failed.isEmpty())
+    {
+        return QObject::tr("Could not pack %1.").arg(failed);
+    }
+    QByteArray trailer(2 * tarBlock, '\0');
+    if(gzipped)
+    {
+        QByteArray compressed;
+        if(!deflateData(trailer, 16 + MAX_WBITS, compressed))
+        {
+            return QObject::tr("Could not finish %1.").arg(path);
+        }
+        trailer = compressed;
+    }
+    if(output.write(trailer) != trailer.size() || !output.flush())
+    {
+        return QObject::tr("Could not finish %1.").arg(path);
+    }
+    return QString();
+}
+
+}
+
+nonstd::optional<WorldArchive::Format> WorldArchive::formatOf(const QString &path)
+{
+    auto name = QFileInfo(path).fileName().toLower();
+    if(name.endsWith(".zip"))
+    {
+        return Format::Zip;
+    }
+    if(name.endsWith(".tar"))
+    {
+        return Format::Tar;
+    }
+    if(name.endsWith(".tar.gz") || name.endsWith(".tgz"))
+    {
+        return Format::TarGz;
+    }
+    return nonstd::nullopt;
+}
+
+nonstd::optional<QByteArray> WorldArchive::readFromTar(const QString &archivePath, const QString &fileName, QString &prefix, QDateTime *modified)
+{
+    auto format = formatOf(archivePath);
+    if(!format || *format == Format::Zip)
+    {
+        return nonstd::nullopt;
+    }
+    QFile file(archivePath);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        return nonstd::nullopt;
+    }
+    TarInput input(&file, *format == Format::TarGz);
+    while(true)
+    {
+        TarEntry entry;
+        bool end = false;
+        if(!readEntry(input, entry, end) || end)
+        {
+            return nonstd::nullopt;
+        }
+        bool matches = entry.path == fileName || entry.path.endsWith('/' + fileName);
+        if(isFileEntry(entry) && matches && entry.size <= streamedFileSize)
+        {
+            QByteArray data(int(entry.size), Qt::Uninitialized);
+            if(!input.read(data.data(), entry.size))
+            {
+                return nonstd::nullopt;
+            }
+            prefix = entry.path.left(entry.path.size() - fileName.size());
+            if(modified)
+            {
+                *modified = QDateTime::fromMSecsSinceEpoch(entry.modified * 1000);
+            }
+            return data;
+        }
+        if(!input.skip(paddedSize(entry.size)))
+        {
+            return nonstd::nullopt;
+        }
+    }
+}
+
+QString WorldArchive::importWorld(const QString &archivePath, const QString &subdir, const QString &targetPath, MSMCZip::ExtractState *state)
+{
+    auto format = formatOf(archivePath);
+    if(!format)
+    {
+        return QObject::tr("%1 is not a supported archive.").arg(archivePath);
+    }
+    QFileInfo target(targetPath);
+    if(target.exists())
+    {
+        return QObject::tr("%1 already exists.").arg(targetPath);
+    }
+
+    // extracted out of sight of the world list, on the same file system so the final rename is atomic
+    auto stagingPath = FS::PathCombine(target.absolutePath(), "." + target.fileName() + ".importing");
+    if(QFileInfo(stagingPath).exists() && !FS::deletePath(stagingPath))
+    {
+        return QObject::tr("Could not remove the leftovers of an earlier import in %1.").arg(stagingPath);
+    }
+    if(!FS::ensureFolderPathExists(stagingPath))
+    {
+        return QObject::tr("Could not create %1.").arg(stagingPath);
+    }
+
+    QString error;
+    if(*format == Format::Zip)
+    {
+        error = importZip(archivePath, subdir, stagingPath, state);
+    }
+    else
+    {
+        error = importTar(archivePath, *format == Format::TarGz, subdir, stagingPath, state);
+    }
+    if(error.isEmpty() && state && state->isCanceled())
+    {
+        error = QObject::tr("Aborted.");
+    }
+    if(!error.isEmpty())
+    {
+        FS::deletePath(stagingPath);
+        return error;
+    }
+    if(!QDir().rename(stagingPath, targetPath))
+    {
+        FS::deletePath(stagingPath);
+        return QObject::tr("Could not move the imported world to %1.").arg(targetPath);
+    }
+    qDebug() << "Imported" << archivePath << "to" << targetPath;
+    return QString();
+}
+
+QString WorldArchive::exportWorld(const QString &worldPath, const QString &archivePath, ConcurrentProgress *progress)
+{
+    auto format = formatOf(archivePath);
+    if(!format)
+    {
+        return QObject::tr("%1 is not a supported archive.").arg(archivePath);
+    }
+    QDir worldDir(worldPath);
+    if(!worldDir.exists())
+    {
+        return QObject::tr("The world folder %1 does not exist.").arg(worldPath);
+    }
+
+    auto entries = listWorld(worldDir);
+    if(progress)
+    {
+        qint64 total = 0;
+        for(auto & entry: entries)
+        {
+            total += entry.size;
+        }
+        progress->setTotal(total);
+    }
+
+    auto partPath = archivePath + ".part";
+    QString error;
+    if(*format == Format::Zip)
+    {
+        error = writeZip(entries, partPath, progress);
+    }
+    else
+    {
+        error = writeTar(entries, partPath, *format == Format::TarGz, progress);
+    }
+    if(progress && progress->isCanceled())
+    {
+        error = QObject::tr("Aborted.");
+    }
+    if(!error.isEmpty())
+    {
+        QFile::remove(partPath);
+        return error;
+    }
+    if(QFile::exists(archivePath) && !QFile::remove(archivePath))
+    {
+        QFile::remove(partPath);
+        return QObject::tr("Could not replace %1.").arg(archivePath);
+    }
+    if(!QFile::rename(partPath, archivePath))
+    {
+        QFile::remove(partPath);
+        return QObject::tr("Could not move the archive to %1.").arg(archivePath);
+    }
+    qDebug() << "Exported" << worldPath << "to" << archivePath << ":" << entries.size() << "entries";
+    return QString();
+}
+
+WorldExportTask::WorldExportTask(const QString &worldPath, const QString &archivePath)
+    : m_worldPath(worldPath), m_archivePath(archivePath)
+{
+    connect(&m_exportWatcher, &QFutureWatcher<QString>::finished, this, &WorldExportTask::exportFinished);
+}
+
+WorldExportTask::~WorldExportTask()
+{
+    if(m_progress)
+    {
+        m_progress->cancel();
+    }
+    m_exportWatcher.waitForFinished();
+}
+
+void WorldExportTask::executeTask()
+{
+    setStatus(tr("Exporting world..."));
+    m_progress = std::make_shared<ConcurrentProgress>();
+    connect(m_progress.get(), &ConcurrentProgress::progress, this, &WorldExportTask::setProgress);
+    auto worldPath = m_worldPath;
+    auto archivePath = m_archivePath;
+    auto progress = m_progress;
+    m_exportWatcher.setFuture(QtConcurrent::run(QThreadPool::globalInstance(), [worldPath, archivePath, progress]()
+    {
+        return WorldArchive::exportWorld(worldPath, archivePath, progress.get());
+    }));
+}
+
+void WorldExportTask::exportFinished()
+{
+    bool canceled = m_progress->isCanceled();
+    m_progress.reset();
+    if(canceled)
+    {
+        emitAborted();
+        return;
+    }
+    auto error = m_exportWatcher.result();
+    if(!error.isEmpty())
+    {
+        emitFailed(error);
+        return;
+    }
+    emitSucceeded();
+}
+
+bool WorldExportTask::abort()
+{
+    if(m_progress)
+    {
+        m_progress->cancel();
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <QString>
+#include <QByteArray>
+#include <QDateTime>
+#include <QFutureWatcher>
+#include <memory>
+#include <nonstd/optional>
+
+#include "tasks/Task.h"
+#include "MSMCZip.h"
+
+#include "multiservermc_logic_export.h"
+
+class ConcurrentProgress;
+
+/**
+ * Moving worlds in and out of archives without staging them anywhere else.
+ *
+ * Zip files and tar files (plain or gzipped) are supported. Imports are written straight into
+ * a hidden folder next to the target which is renamed to the target at the end, so the world
+ * list never sees a half imported world. Exports are written next to the archive and renamed
+ * over it at the end.
+ *
+ * Both directions work on many files at once: zip imports inflate entries in parallel, tar
+ * imports write files in parallel as they are read from the stream and exports compress
+ * entries in parallel, in windows of bounded size, writing them out in order.
+ */
+namespace WorldArchive
+{
+enum class Format
+{
+    Zip,
+    Tar,
+    TarGz
+};
+
+/// The format of an archive, by its file name
+MULTISERVERMC_LOGIC_EXPORT nonstd::optional<Format> formatOf(const QString &path);
+
+/**
+ * Find the first file called fileName in a tar archive and read it, without reading the rest.
+ *
+ * \param prefix set to the path of the folder it is in, with a trailing slash unless it is empty
+ * \param modified set to the modification time of the file, if not null
+ */
+MULTISERVERMC_LOGIC_EXPORT nonstd::optional<QByteArray> readFromTar(const QString &archivePath, const QString &fileName, QString &prefix, QDateTime *modified = nullptr);
+
+/**
+ * Extract the folder subdir of an archive as the new folder targetPath.
+ *
+ * \return an error message, empty on success
+ */
+MULTISERVERMC_LOGIC_EXPORT QString importWorld(const QString &archivePath, const QString &subdir, const QString &targetPath, MSMCZip::ExtractState *state = nullptr);
+
+/**
+ * Pack a world folder into an archive, in the format its name asks for.
+ * The world folder itself is the top level folder of the archive.
+ *
+ * \return an error message, empty on success
+ */
+MULTISERVERMC_LOGIC_EXPORT QString exportWorld(const QString &worldPath, const QString &archivePath, ConcurrentProgress *progress = nullptr);
+}
+
+/**
+ * Runs WorldArchive::exportWorld on a worker thread.
+ */
+class MULTISERVERMC_LOGIC_EXPORT WorldExportTask : public Task
+{
+    Q_OBJECT
+public:
+    WorldExportTask(const QString &worldPath, const QString &archivePath);
+    virtual ~WorldExportTask();
+
+    bool canAbort() const override
+    {
+        return true;
+    }
+    bool abort() override;
+
+protected:
+    void executeTask() override;
+
+private slots:
+    void exportFinished();
+
+private:
+    QString m_worldPath;
+    QString m_archivePath;
+    std::shared_ptr<ConcurrentProgress> m_progress;
+    QFutureWatcher<QString> m_exportWatcher;
+};
@@ -0,0 +1,49 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include "TestUtil.h"
+
+#include "FileSystem.h"
+#include "minecraft/WorldArchive.h"
+
+/// A world with one incompressible and one very compressible region file
+static void makeWorld(const QString &path)
+{
+    FS::write(FS::PathCombine(path, "level.dat"), "level");
+    QByteArray region;
+    for(int i = 0; i < 100000; i++)
+    {
+        region.append(char(i * 7919 % 251));
+    }
+    FS::write(FS::PathCombine(path, "region", "r.0.0.mca"), region);
+    FS::write(FS::PathCombine(path, "region", "r.0.1.mca"), QByteArray(20 * 1024 * 1024, 'x'));
+    FS::ensureFolderPathExists(FS::PathCombine(path, "datapacks"));
+}
+
+class WorldArchiveBench : public QObject
+{
+    Q_OBJECT
+private
+slots:
+    void bench_export_data()
+    {
+        QTest::addColumn<QString>("archiveName");
+        QTest::newRow("zip") << "world.zip";
+        QTest::newRow("tar.gz") << "world.tar.gz";
+    }
+    void bench_export()
+    {
+        QFETCH(QString, archiveName);
+        QTemporaryDir tempDir;
+        QString worldPath = FS::PathCombine(tempDir.path(), "world");
+        QString archivePath = FS::PathCombine(tempDir.path(), archiveName);
+        makeWorld(worldPath);
+        QBENCHMARK
+        {
+            QCOMPARE(WorldArchive::exportWorld(worldPath, archivePath), QString());
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(WorldArchiveBench)
+
+#include "WorldArchive_bench.moc"
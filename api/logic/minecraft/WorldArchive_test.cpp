@@ -0,0 +1,154 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QDirIterator>
+#include "TestUtil.h"
+
+#include "FileSystem.h"
+#include "minecraft/WorldArchive.h"
+
+static QMap<QString, QByteArray> readTree(const QString &root)
+{
+    QMap<QString, QByteArray> result;
+    QDir rootDir(root);
+    QDirIterator iter(root, QDir::Files | QDir::Dirs | QDir::Hidden | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while(iter.hasNext())
+    {
+        iter.next();
+        auto info = iter.fileInfo();
+        auto relativePath = rootDir.relativeFilePath(info.absoluteFilePath());
+        result.insert(relativePath, info.isDir() ? QByteArray("<dir>") : FS::read(info.absoluteFilePath()));
+    }
+    return result;
+}
+
+static void makeWorld(const QString &path)
+{
+    FS::write(FS::PathCombine(path, "level.dat"), "level");
+    FS::write(FS::PathCombine(path, "session.lock"), "lock");
+    QByteArray region;
+    for(int i = 0; i < 100000; i++)
+    {
+        region.append(char(i * 7919 % 251));
+    }
+    FS::write(FS::PathCombine(path, "region", "r.0.0.mca"), region);
+    FS::write(FS::PathCombine(path, "region", "r.0.1.mca"), QByteArray(20 * 1024 * 1024, 'x'));
+    FS::write(FS::PathCombine(path, "data", QString(120, 'n') + ".dat"), "a name that does not fit a tar header");
+    FS::ensureFolderPathExists(FS::PathCombine(path, "datapacks"));
+}
+
+/// Give the tar header at the given offset another name of the same length and fix up its checksum
+static bool renameTarEntry(QByteArray &data, int at, const QByteArray &name)
+{
+    if(at < 0)
+    {
+        return false;
+    }
+    data.replace(at, name.size(), name);
+    data.replace(at + 148, 8, "        ");
+    int checksum = 0;
+    for(int i = 0; i < 512; i++)
+    {
+        checksum += uchar(data[at + i]);
+    }
+    data.replace(at + 148, 7, QString("%1").arg(checksum, 6, 8, QChar('0')).toLatin1() + '\0');
+    return true;
+}
+
+class WorldArchiveTest : public QObject
+{
+    Q_OBJECT
+
+private
+slots:
+    void test_roundTrip_data()
+    {
+        QTest::addColumn<QString>("archiveName");
+        QTest::newRow("zip") << "world.zip";
+        QTest::newRow("tar") << "world.tar";
+        QTest::newRow("tar.gz") << "world.tar.gz";
+    }
+    void test_roundTrip()
+    {
+        QFETCH(QString, archiveName);
+        QTemporaryDir tempDir;
+        QString worldPath = FS::PathCombine(tempDir.path(), "saves", "world");
+        QString archivePath = FS::PathCombine(tempDir.path(), archiveName);
+        makeWorld(worldPath);
+
+        QCOMPARE(WorldArchive::exportWorld(worldPath, archivePath), QString());
+        QVERIFY(QFileInfo(archivePath).isFile());
+        QVERIFY(!QFileInfo(archivePath + ".part").exists());
+
+        QString importedPath = FS::PathCombine(tempDir.path(), "saves", "imported");
+        QCOMPARE(WorldArchive::importWorld(archivePath, "world/", importedPath), QString());
+        auto expected = readTree(worldPath);
+        expected.remove("session.lock");
+        QCOMPARE(readTree(importedPath), expected);
+
+        // never over an existing world
+        QVERIFY(!WorldArchive::importWorld(archivePath, "world/", importedPath).isEmpty());
+    }
+
+    void test_findLevelDat()
+    {
+        QTemporaryDir tempDir;
+        QString worldPath = FS::PathCombine(tempDir.path(), "My World");
+        QString archivePath = FS::PathCombine(tempDir.path(), "world.tgz");
+        makeWorld(worldPath);
+        QCOMPARE(WorldArchive::exportWorld(worldPath, archivePath), QString());
+
+        QString prefix;
+        auto levelDat = WorldArchive::readFromTar(archivePath, "level.dat", prefix);
+        QVERIFY(bool(levelDat));
+        QCOMPARE(*levelDat, QByteArray("level"));
+        QCOMPARE(prefix, QString("My World/"));
+        QVERIFY(!WorldArchive::readFromTar(archivePath, "missing.dat", prefix));
+    }
+
+    void test_outsideOfTarget()
+    {
+        QTemporaryDir tempDir;
+        QString worldPath = FS::PathCombine(tempDir.path(), "world");
+        QString archivePath = FS::PathCombine(tempDir.path(), "evil.tar");
+        FS::write(FS::PathCombine(worldPath, "level.dat"), "level");
+        FS::write(FS::PathCombine(worldPath, "xx", "evil"), "evil");
+        QCOMPARE(WorldArchive::exportWorld(worldPath, archivePath), QString());
+
+        // turn world/xx/evil into world/../evil
+        auto data = FS::read(archivePath);
+        QVERIFY(renameTarEntry(data, data.indexOf("world/xx/evil"), "world/../evil"));
+        FS::write(archivePath, data);
+
+        QString importedPath = FS::PathCombine(tempDir.path(), "imported");
+        QVERIFY(!WorldArchive::importWorld(archivePath, "world/", importedPath).isEmpty());
+        QVERIFY(!QFileInfo(importedPath).exists());
+        QVERIFY(!QFileInfo(FS::PathCombine(tempDir.path(), "evil")).exists());
+    }
+
+    void test_duplicateNames()
+    {
+        QTemporaryDir tempDir;
+        QString worldPath = FS::PathCombine(tempDir.path(), "world");
+        QString archivePath = FS::PathCombine(tempDir.path(), "twice.tar");
+        FS::write(FS::PathCombine(worldPath, "level.dat"), "level");
+        FS::write(FS::PathCombine(worldPath, "aa"), "first");
+        FS::write(FS::PathCombine(worldPath, "bb"), "later");
+        QCOMPARE(WorldArchive::exportWorld(worldPath, archivePath), QString());
+
+        // the entry that comes second gets the name of the first one
+        auto data = FS::read(archivePath);
+        int aa = data.indexOf("world/aa");
+        int bb = data.indexOf("world/bb");
+        QVERIFY(aa >= 0 && bb >= 0);
+        QVERIFY(renameTarEntry(data, qMax(aa, bb), aa < bb ? "world/aa" : "world/bb"));
+        FS::write(archivePath, data);
+
+        QString importedPath = FS::PathCombine(tempDir.path(), "imported");
+        QCOMPARE(WorldArchive::importWorld(archivePath, "world/", importedPath), QString());
+        QCOMPARE(FS::read(FS::PathCombine(importedPath, aa < bb ? "aa" : "bb")), QByteArray(aa < bb ? "later" : "first"));
+    }
+};
+
+QTEST_GUILESS_MAIN(WorldArchiveTest)
+
+#include "WorldArchive_test.moc"
@@ -20,8 +20,96 @@
 #include <QUuid>
 #include <QString>
 #include <QFileSystemWatcher>
+#include <QtConcurrentMap>
+#include <QDateTime>
+#include <QDataStream>
+#include <QLocale>
 #include <QDebug>
 
+#include "DirectoryEventWatcher.h"
+
+namespace {
+/// Reads one world folder on a worker thread, using the summary cache when level.dat did not change
+struct WorldScan
+{
+    typedef WorldList::ScannedWorld result_type;
+
+    WorldScan(const WorldSummaryCache &cache) : cache(cache)
+    {
+    }
+
+    WorldList::ScannedWorld operator()(const QFileInfo &entry) const
+    {
+        WorldList::ScannedWorld result;
+        result.folderName = entry.fileName();
+        QFileInfo levelDat(FS::PathCombine(entry.absoluteFilePath(), "level.dat"));
+        if(!levelDat.isFile())
+        {
+            return result;
+        }
+        auto cached = cache.validEntry(result.folderName, levelDat);
+        if(cached)
+        {
+            result.cacheEntry = *cached;
+        }
+        else
+        {
+            QFile file(levelDat.absoluteFilePath());
+            if(!file.open(QIODevice::ReadOnly))
+            {
+                return result;
+            }
+            result.cacheEntry.levelDatModified = levelDat.lastModified().toMSecsSinceEpoch();
+            result.cacheEntry.levelDatSize = levelDat.size();
+            result.cacheEntry.summary = LevelDatSummary::fromCompressed(file.readAll());
+        }
+        result.cacheable = true;
+        World world(entry, result.cacheEntry.summary);
+        if(world.isValid())
+        {
+            result.world = world;
+        }
+        return result;
+    }
+
+    WorldSummaryCache cache;
+};
+
+WorldList::StatsUpdate scanWorldStats(const WorldList::StatsUpdate &job)
+{
+    auto result = job;
+    if(result.full)
+    {
+        result.usage = WorldUsage::scan(result.path);
+    }
+    else
+    {
+        for(auto & directory: result.directories)
+        {
+            result.usage.rescanDirectory(directory);
+        }
+    }
+    result.stats = result.usage.stats();
+    return result;
+}
+
+QString formatSize(qint64 bytes)
+{
+    static const char *units[] = {"B", "KiB", "MiB", "GiB", "TiB"};
+    double value = bytes;
+    int unit = 0;
+    while(value >= 1024.0 && unit < 4)
+    {
+        value /= 1024.0;
+        unit++;
+    }
+    return QString("%1 %2").arg(QLocale().toString(value, 'f', unit ? 1 : 0), units[unit]);
+}
+
+const quint32 STATS_CACHE_MAGIC = 0x4d535753; // "MSWS"
+const quint32 STATS_CACHE_VERSION = 1;
+}
+
 WorldList::WorldList(const QString &dir)
     : QAbstractListModel(), m_dir(dir)
 {
@@ -33,6 +121,113 @@ WorldList::WorldList(const QString &dir)
     is_watching = false;
     connect(m_watcher, SIGNAL(directoryChanged(QString)), this,
             SLOT(directoryChanged(QString)));
+    connect(&m_scanWatcher, &QFutureWatcher<ScannedWorld>::finished, this, &WorldList::worldsScanned);
+
+    // region files are rewritten all the time while a server runs, there is no need to follow every save
+    m_statsWatcher = new DirectoryEventWatcher(this);
+    m_statsWatcher->setCoalesceInterval(2000);
+    m_statsWatcher->setMaximumLatency(10000);
+    connect(m_statsWatcher, &DirectoryEventWatcher::eventsReady, this, [this](const QString &path, const QList<DirectoryEvent> &)
+    {
+        queueStatsRescan(path);
+    });
+    connect(m_statsWatcher, &DirectoryEventWatcher::rescanRequired, this, &WorldList::queueStatsRescan);
+    connect(&m_statsScanWatcher, &QFutureWatcher<StatsUpdate>::finished, this, &WorldList::statsScanned);
+}
+
+WorldList::~WorldList()
+{
+    m_scanWatcher.cancel();
+    m_scanWatcher.waitForFinished();
+    m_statsScanWatcher.cancel();
+    m_statsScanWatcher.waitForFinished();
+}
+
+void WorldList::setSummaryCachePath(const QString &path)
+{
+    m_summaryCachePath = path;
+    m_summaryCache = WorldSummaryCache();
+    if(!path.isEmpty())
+    {
+        m_summaryCache.load(path);
+    }
+}
+
+void WorldList::setStatsCachePath(const QString &path)
+{
+    m_statsCachePath = path;
+    loadStatsCache();
+}
+
+void WorldList::loadStatsCache()
+{
+    if(m_statsCachePath.isEmpty())
+    {
+        return;
+    }
+    QByteArray data;
+    try
+    {
+        data = FS::read(m_statsCachePath);
+    }
+    catch (const FS::FileSystemException &)
+    {
+        return;
+    }
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_5_6);
+    quint32 magic = 0, version = 0, count = 0;
+    in >> magic >> version >> count;
+    if(magic != STATS_CACHE_MAGIC || version != STATS_CACHE_VERSION)
+    {
+        qDebug() << "Ignoring world stats cache" << m_statsCachePath << "with unknown format";
+        return;
+    }
+    QHash<QString, WorldStats> stats;
+    for(quint32 i = 0; i < count && in.status() == QDataStream::Ok; i++)
+    {
+        QString folderName;
+        WorldStats worldStats;
+        in >> folderName >> worldStats;
+        stats.insert(folderName, worldStats);
+    }
+    if(in.status() != QDataStream::Ok)
+    {
+        qWarning() << "World stats cache" << m_statsCachePath << "is truncated or corrupted";
+        return;
+    }
+    // anything scanned already is newer
+    for(auto iter = stats.begin(); iter != stats.end(); iter++)
+    {
+        if(!m_stats.contains(iter.key()))
+        {
+            m_stats.insert(iter.key(), *iter);
+        }
+    }
+}
+
+void WorldList::saveStatsCache()
+{
+    if(m_statsCachePath.isEmpty())
+    {
+        return;
+    }
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_6);
+    out << STATS_CACHE_MAGIC << STATS_CACHE_VERSION << quint32(m_stats.size());
+    for(auto iter = m_stats.begin(); iter != m_stats.end(); iter++)
+    {
+        out << iter.key() << *iter;
+    }
+    try
+    {
+        FS::write(m_statsCachePath, data);
+    }
+    catch (const FS::FileSystemException &e)
+    {
+        qWarning() << "Failed to write world stats cache:" << e.cause();
+    }
 }
 
 void WorldList::startWatching()
@@ -68,37 +263,225 @@ void WorldList::stopWatching()
     {
         qDebug() << "Failed to stop watching " << m_dir.absolutePath();
     }
+    updateStatsWatches();
 }
 
 bool WorldList::update()
+{
+    m_refreshAllStats = true;
+    return scanWorlds();
+}
+
+bool WorldList::scanWorlds()
 {
     if (!isValid())
         return false;
 
-    QList<World> newWorlds;
+    // changes that come in while reading are picked up by one more pass once it's done
+    if(m_scanWatcher.isRunning())
+    {
+        m_rescanPending = true;
+        return true;
+    }
+
+    QList<QFileInfo> folders;
     m_dir.refresh();
-    auto folderContents = m_dir.entryInfoList();
-    // if there are any untracked files...
-    for (QFileInfo entry : folderContents)
+    for (auto & entry : m_dir.entryInfoList())
     {
-        if(!entry.isDir())
-            continue;
+        if(entry.isDir())
+        {
+            folders.append(entry);
+        }
+    }
+    m_scanWatcher.setFuture(QtConcurrent::mapped(folders, WorldScan(m_summaryCache)));
+    return true;
+}
 
-        World w(entry);
-        if(w.isValid())
+void WorldList::worldsScanned()
+{
+    if(m_scanWatcher.isCanceled())
+    {
+        return;
+    }
+    QList<World> newWorlds;
+    WorldSummaryCache newCache;
+    for(auto & scanned: m_scanWatcher.future().results())
+    {
+        if(scanned.world)
+        {
+            newWorlds.append(*scanned.world);
+        }
+        if(scanned.cacheable)
         {
-            newWorlds.append(w);
+            newCache.insert(scanned.folderName, scanned.cacheEntry);
         }
     }
     beginResetModel();
     worlds.swap(newWorlds);
     endResetModel();
-    return true;
+
+    if(newCache != m_summaryCache)
+    {
+        m_summaryCache = newCache;
+        if(!m_summaryCachePath.isEmpty())
+        {
+            m_summaryCache.save(m_summaryCachePath);
+        }
+    }
+
+    // worlds that were there before are kept up to date by watching their dimension folders
+    QSet<QString> present;
+    for(auto & world: worlds)
+    {
+        present.insert(world.folderName());
+        if(m_refreshAllStats || !m_usage.contains(world.folderName()))
+        {
+            m_pendingFullScans.insert(world.folderName());
+        }
+    }
+    m_refreshAllStats = false;
+    for(auto & folderName: m_usage.keys())
+    {
+        if(!present.contains(folderName))
+        {
+            m_usage.remove(folderName);
+            m_stats.remove(folderName);
+            m_pendingRescans.remove(folderName);
+        }
+    }
+    updateStatsWatches();
+    startStatsScan();
+
+    if(m_rescanPending)
+    {
+        m_rescanPending = false;
+        scanWorlds();
+    }
 }
 
 void WorldList::directoryChanged(QString path)
 {
-    update();
+    scanWorlds();
+}
+
+void WorldList::queueStatsRescan(const QString &path)
+{
+    auto folderName = m_statsWatches.value(path);
+    if(folderName.isEmpty() || !m_usage.contains(folderName))
+    {
+        return;
+    }
+    QDir worldDir(m_dir.absoluteFilePath(folderName));
+    m_pendingRescans[folderName].insert(worldDir.relativeFilePath(path));
+    startStatsScan();
+}
+
+void WorldList::startStatsScan()
+{
+    if(m_statsScanWatcher.isRunning())
+    {
+        return;
+    }
+    QList<StatsUpdate> jobs;
+    for(auto & folderName: m_pendingFullScans)
+    {
+        StatsUpdate job;
+        job.folderName = folderName;
+        job.path = m_dir.absoluteFilePath(folderName);
+        job.full = true;
+        jobs.append(job);
+    }
+    for(auto iter = m_pendingRescans.begin(); iter != m_pendingRescans.end(); iter++)
+    {
+        if(m_pendingFullScans.contains(iter.key()) || !m_usage.contains(iter.key()))
+        {
+            continue;
+        }
+        StatsUpdate job;
+        job.folderName = iter.key();
+        job.path = m_dir.absoluteFilePath(iter.key());
+        job.full = false;
+        job.directories = iter->toList();
+        job.usage = m_usage.value(iter.key());
+        jobs.append(job);
+    }
+    m_pendingFullScans.clear();
+    m_pendingRescans.clear();
+    if(jobs.isEmpty())
+    {
+        return;
+    }
+    m_statsScanWatcher.setFuture(QtConcurrent::mapped(jobs, scanWorldStats));
+}
+
+void WorldList::statsScanned()
+{
+    if(m_statsScanWatcher.isCanceled())
+    {
+        return;
+    }
+    bool scannedFully = false;
+    for(auto & result: m_statsScanWatcher.future().results())
+    {
+        int row = -1;
+        for(int i = 0; i < worlds.size(); i++)
+        {
+            if(worlds[i].folderName() == result.folderName)
+            {
+                row = i;
+                break;
+            }
+        }
+        // removed while it was being scanned
+        if(row < 0)
+        {
+            continue;
+        }
+        m_usage.insert(result.folderName, result.usage);
+        m_stats.insert(result.folderName, result.stats);
+        scannedFully |= result.full;
+        emit dataChanged(index(row, SizeColumn), index(row, SizeColumn),
+                         {Qt::DisplayRole, Qt::ToolTipRole, SizeRole, RegionCountRole, DimensionStatsRole, LargestRegionsRole});
+    }
+    updateStatsWatches();
+    if(scannedFully)
+    {
+        saveStatsCache();
+    }
+    startStatsScan();
+}
+
+void WorldList::updateStatsWatches()
+{
+    QHash<QString, QString> wanted;
+    if(is_watching)
+    {
+        for(auto iter = m_usage.begin(); iter != m_usage.end(); iter++)
+        {
+            QDir worldDir(m_dir.absoluteFilePath(iter.key()));
+            for(auto & directory: iter->dimensionDirectories())
+            {
+                wanted.insert(worldDir.absoluteFilePath(directory), iter.key());
+            }
+        }
+    }
+    for(auto iter = m_statsWatches.begin(); iter != m_statsWatches.end();)
+    {
+        if(wanted.value(iter.key()) != *iter)
+        {
+            m_statsWatcher->removePath(iter.key());
+            iter = m_statsWatches.erase(iter);
+            continue;
+        }
+        iter++;
+    }
+    for(auto iter = wanted.begin(); iter != wanted.end(); iter++)
+    {
+        if(!m_statsWatches.contains(iter.key()) && m_statsWatcher->addPath(iter.key()))
+        {
+            m_statsWatches.insert(iter.key(), *iter);
+        }
+    }
 }
 
 bool WorldList::isValid()
@@ -151,7 +534,7 @@ bool WorldList::resetIcon(int row)
 
 int WorldList::columnCount(const QModelIndex &parent) const
 {
-    return 3;
+    return 4;
 }
 
 QVariant WorldList::data(const QModelIndex &index, int role) const
@@ -166,6 +549,8 @@ QVariant WorldList::data(const QModelIndex &index, int role) const
         return QVariant();
 
     auto & world = worlds[row];
+    auto statsIter = m_stats.find(world.folderName());
+    bool hasStats = statsIter != m_stats.end();
     switch (role)
     {
     case Qt::DisplayRole:
@@ -180,13 +565,35 @@ QVariant WorldList::data(const QModelIndex &index, int role) const
         case LastPlayedColumn:
             return world.lastPlayed();
 
+        case SizeColumn:
+            if(!hasStats)
+                return QVariant();
+            return formatSize(statsIter->totalBytes);
+
         default:
             return QVariant();
         }
 
     case Qt::ToolTipRole:
     {
-        return world.folderName();
+        if(column != SizeColumn || !hasStats)
+        {
+            return world.folderName();
+        }
+        QStringList lines;
+        for(auto & dimension: statsIter->dimensions)
+        {
+            lines.append(tr("%1: %2 in %n region file(s)", "", dimension.regionCount).arg(dimension.id, formatSize(dimension.bytes)));
+        }
+        if(!statsIter->largestRegions.isEmpty())
+        {
+            lines.append(tr("Largest region files:"));
+            for(auto & region: statsIter->largestRegions)
+            {
+                lines.append(QString("  %1 (%2)").arg(region.file, formatSize(region.size)));
+            }
+        }
+        return lines.join('\n');
     }
     case ObjectRole:
     {
@@ -212,6 +619,49 @@ QVariant WorldList::data(const QModelIndex &index, int role) const
     {
         return world.iconFile();
     }
+    case SizeRole:
+    {
+        if(!hasStats)
+            return QVariant();
+        return qVariantFromValue<qlonglong>(statsIter->totalBytes);
+    }
+    case RegionCountRole:
+    {
+        if(!hasStats)
+            return QVariant();
+        return statsIter->regionCount;
+    }
+    case DimensionStatsRole:
+    {
+        if(!hasStats)
+            return QVariant();
+        QVariantList dimensions;
+        for(auto & dimension: statsIter->dimensions)
+        {
+            QVariantMap entry;
+            entry["id"] = dimension.id;
+            entry["bytes"] = qlonglong(dimension.bytes);
+            entry["regionCount"] = dimension.regionCount;
+            entry["regionBytes"] = qlonglong(dimension.regionBytes);
+            dimensions.append(entry);
+        }
+        return dimensions;
+    }
+    case LargestRegionsRole:
+    {
+        if(!hasStats)
+            return QVariant();
+        QVariantList regions;
+        for(auto & region: statsIter->largestRegions)
+        {
+            QVariantMap entry;
+            entry["dimension"] = region.dimension;
+            entry["file"] = region.file;
+            entry["size"] = qlonglong(region.size);
+            regions.append(entry);
+        }
+        return regions;
+    }
     default:
         return QVariant();
     }
@@ -230,6 +680,8 @@ QVariant WorldList::headerData(int section, Qt::Orientation orientation, int rol
             return tr("Game Mode");
         case LastPlayedColumn:
             return tr("Last Played");
+        case SizeColumn:
+            return tr("Size");
         default:
             return QVariant();
         }
@@ -243,6 +695,8 @@ QVariant WorldList::headerData(int section, Qt::Orientation orientation, int rol
             return tr("Game mode of the world.");
         case LastPlayedColumn:
             return tr("Date and time the world was last played.");
+        case SizeColumn:
+            return tr("Disk space used by the world.");
         default:
             return QVariant();
         }
@@ -20,11 +20,17 @@
 #include <QDir>
 #include <QAbstractListModel>
 #include <QMimeData>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QSet>
 #include "minecraft/World.h"
+#include "minecraft/WorldSummaryCache.h"
+#include "minecraft/WorldStats.h"
 
 #include "multiservermc_logic_export.h"
 
 class QFileSystemWatcher;
+class DirectoryEventWatcher;
 
 class MULTISERVERMC_LOGIC_EXPORT WorldList : public QAbstractListModel
 {
@@ -34,7 +40,8 @@ public:
     {
         NameColumn,
         GameModeColumn,
-        LastPlayedColumn
+        LastPlayedColumn,
+        SizeColumn
     };
 
     enum Roles
@@ -45,10 +52,20 @@ public:
         NameRole,
         GameModeRole,
         LastPlayedRole,
-        IconFileRole
+        IconFileRole,
+        SizeRole,
+        RegionCountRole,
+        DimensionStatsRole,
+        LargestRegionsRole
     };
 
     WorldList(const QString &dir);
+    virtual ~WorldList();
+
+    /// Keep the level.dat summaries in the given file, worlds that did not change are not read again
+    void setSummaryCachePath(const QString &path);
+    /// Keep the last known disk usage of the worlds in the given file, shown until the worlds are scanned again
+    void setStatsCachePath(const QString &path);
 
     virtual QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
 
@@ -73,9 +90,19 @@ public:
         return worlds[index];
     }
 
-    /// Reloads the mod list and returns true if the list changed.
+    /**
+     * Starts reloading the world list in the background, the model is reset once it is done.
+     * The disk usage of all worlds is scanned again after that.
+     * Returns false if the world folder can't be read.
+     */
     virtual bool update();
 
+    /// A background reload is running
+    bool isLoading() const
+    {
+        return m_scanWatcher.isRunning();
+    }
+
     /// Install a world from location
     void installWorld(QFileInfo filename);
 
@@ -117,8 +144,38 @@ public:
         return worlds;
     }
 
+    /// What a background reload found out about one world folder
+    struct ScannedWorld
+    {
+        QString folderName;
+        nonstd::optional<World> world;
+        bool cacheable = false;
+        WorldSummaryCache::Entry cacheEntry;
+    };
+
+    /// Disk usage scan of one world, either everything or just some of its directories
+    struct StatsUpdate
+    {
+        QString folderName;
+        QString path;
+        bool full = true;
+        QStringList directories;
+        WorldUsage usage;
+        WorldStats stats;
+    };
+
 private slots:
     void directoryChanged(QString path);
+    void worldsScanned();
+    void statsScanned();
+
+private:
+    bool scanWorlds();
+    void queueStatsRescan(const QString &path);
+    void startStatsScan();
+    void updateStatsWatches();
+    void loadStatsCache();
+    void saveStatsCache();
 
 signals:
     void changed();
@@ -128,4 +185,19 @@ protected:
     bool is_watching;
     QDir m_dir;
     QList<World> worlds;
+    QFutureWatcher<ScannedWorld> m_scanWatcher;
+    bool m_rescanPending = false;
+    QString m_summaryCachePath;
+    WorldSummaryCache m_summaryCache;
+
+    DirectoryEventWatcher *m_statsWatcher;
+    QFutureWatcher<StatsUpdate> m_statsScanWatcher;
+    QHash<QString, WorldUsage> m_usage;
+    QHash<QString, WorldStats> m_stats;
+    QSet<QString> m_pendingFullScans;
+    QHash<QString, QSet<QString>> m_pendingRescans;
+    /// Watched dimension directories and the world folders they belong to
+    QHash<QString, QString> m_statsWatches;
+    bool m_refreshAllStats = false;
+    QString m_statsCachePath;
 };
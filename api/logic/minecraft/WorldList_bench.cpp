@@ -0,0 +1,184 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QSignalSpy>
+#include <QtEndian>
+#include "TestUtil.h"
+
+#include "FileSystem.h"
+#include "GZip.h"
+#include "minecraft/LevelDatSummary.h"
+#include "minecraft/WorldList.h"
+
+/// Just enough of an NBT writer to make level.dat files
+class NbtWriter
+{
+public:
+    void beginCompound(const QByteArray &name)
+    {
+        tag(10, name);
+    }
+    void endCompound()
+    {
+        m_data.append(char(0));
+    }
+    void string(const QByteArray &name, const QByteArray &value)
+    {
+        tag(8, name);
+        raw(value);
+    }
+    void intTag(const QByteArray &name, qint32 value)
+    {
+        tag(3, name);
+        bigEndian(value);
+    }
+    void longTag(const QByteArray &name, qint64 value)
+    {
+        tag(4, name);
+        bigEndian(value);
+    }
+    void longArray(const QByteArray &name, int count)
+    {
+        tag(12, name);
+        bigEndian(qint32(count));
+        m_data.append(QByteArray(count * 8, 'x'));
+    }
+    void compoundList(const QByteArray &name, int count)
+    {
+        tag(9, name);
+        m_data.append(char(10));
+        bigEndian(qint32(count));
+        for(int i = 0; i < count; i++)
+        {
+            string("id", "minecraft:stone");
+            intTag("Count", i);
+            endCompound();
+        }
+    }
+    QByteArray data() const
+    {
+        return m_data;
+    }
+
+private:
+    void tag(char type, const QByteArray &name)
+    {
+        m_data.append(type);
+        raw(name);
+    }
+    void raw(const QByteArray &value)
+    {
+        bigEndian(quint16(value.size()));
+        m_data.append(value);
+    }
+    template <typename T> void bigEndian(T value)
+    {
+        uchar buffer[sizeof(T)];
+        qToBigEndian(value, buffer);
+        m_data.append((const char *)buffer, sizeof(T));
+    }
+
+    QByteArray m_data;
+};
+
+class WorldListBench : public QObject
+{
+    Q_OBJECT
+
+    QByteArray makeLevelDat(const QByteArray &name, bool modernSeed, int padding = 0)
+    {
+        NbtWriter nbt;
+        nbt.beginCompound("");
+        nbt.beginCompound("Data");
+        // stuff that has to be skipped over
+        nbt.compoundList("Player", padding);
+        nbt.longArray("DataPacks", padding);
+        nbt.string("LevelName", name);
+        nbt.longTag("LastPlayed", 1600000000000);
+        nbt.intTag("GameType", 1);
+        if(modernSeed)
+        {
+            nbt.beginCompound("WorldGenSettings");
+            nbt.intTag("bonus_chest", 0);
+            nbt.longTag("seed", -42);
+            nbt.endCompound();
+        }
+        nbt.longTag("RandomSeed", 1234);
+        nbt.endCompound();
+        nbt.endCompound();
+        QByteArray compressed;
+        GZip::zip(nbt.data(), compressed);
+        return compressed;
+    }
+
+private
+slots:
+    void bench_summary_data()
+    {
+        QTest::addColumn<bool>("full");
+        QTest::newRow("summary") << false;
+        QTest::newRow("inflate everything") << true;
+    }
+    void bench_summary()
+    {
+        QFETCH(bool, full);
+        // a big player inventory ahead of the values, like in real single player worlds
+        auto levelDat = makeLevelDat("Benchmark", true, 5000);
+        QBENCHMARK
+        {
+            if(full)
+            {
+                QByteArray nbt;
+                GZip::unzip(levelDat, nbt);
+                LevelDatSummary::fromNbt(nbt);
+            }
+            else
+            {
+                LevelDatSummary::fromCompressed(levelDat);
+            }
+        }
+    }
+
+    void bench_update_data()
+    {
+        QTest::addColumn<bool>("useCache");
+        QTest::newRow("cold") << false;
+        QTest::newRow("cache") << true;
+    }
+    void bench_update()
+    {
+        QFETCH(bool, useCache);
+        QTemporaryDir tempDir;
+        QString savesDir = FS::PathCombine(tempDir.path(), "saves");
+        QString cachePath = FS::PathCombine(tempDir.path(), "worlds.cache");
+        auto levelDat = makeLevelDat("Benchmark", true, 2000);
+        for(int i = 0; i < 200; i++)
+        {
+            FS::write(FS::PathCombine(savesDir, QString("world%1").arg(i), "level.dat"), levelDat);
+        }
+        if(useCache)
+        {
+            WorldList list(savesDir);
+            list.setSummaryCachePath(cachePath);
+            QSignalSpy spy(&list, &QAbstractItemModel::modelReset);
+            list.update();
+            spy.wait(10000);
+        }
+
+        QBENCHMARK
+        {
+            WorldList list(savesDir);
+            if(useCache)
+            {
+                list.setSummaryCachePath(cachePath);
+            }
+            QSignalSpy spy(&list, &QAbstractItemModel::modelReset);
+            list.update();
+            QVERIFY(spy.wait(10000));
+            QCOMPARE(int(list.size()), 200);
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(WorldListBench)
+
+#include "WorldList_bench.moc"
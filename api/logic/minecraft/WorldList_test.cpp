@@ -0,0 +1,251 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QSignalSpy>
+#include <QtEndian>
+#include "TestUtil.h"
+
+#include "FileSystem.h"
+#include "GZip.h"
+#include "minecraft/LevelDatSummary.h"
+#include "minecraft/WorldList.h"
+
+/// Just enough of an NBT writer to make level.dat files
+class NbtWriter
+{
+public:
+    void beginCompound(const QByteArray &name)
+    {
+        tag(10, name);
+    }
+    void endCompound()
+    {
+        m_data.append(char(0));
+    }
+    void string(const QByteArray &name, const QByteArray &value)
+    {
+        tag(8, name);
+        raw(value);
+    }
+    void intTag(const QByteArray &name, qint32 value)
+    {
+        tag(3, name);
+        bigEndian(value);
+    }
+    void longTag(const QByteArray &name, qint64 value)
+    {
+        tag(4, name);
+        bigEndian(value);
+    }
+    void longArray(const QByteArray &name, int count)
+    {
+        tag(12, name);
+        bigEndian(qint32(count));
+        m_data.append(QByteArray(count * 8, 'x'));
+    }
+    void compoundList(const QByteArray &name, int count)
+    {
+        tag(9, name);
+        m_data.append(char(10));
+        bigEndian(qint32(count));
+        for(int i = 0; i < count; i++)
+        {
+            string("id", "minecraft:stone");
+            intTag("Count", i);
+            endCompound();
+        }
+    }
+    QByteArray data() const
+    {
+        return m_data;
+    }
+
+private:
+    void tag(char type, const QByteArray &name)
+    {
+        m_data.append(type);
+        raw(name);
+    }
+    void raw(const QByteArray &value)
+    {
+        bigEndian(quint16(value.size()));
+        m_data.append(value);
+    }
+    template <typename T> void bigEndian(T value)
+    {
+        uchar buffer[sizeof(T)];
+        qToBigEndian(value, buffer);
+        m_data.append((const char *)buffer, sizeof(T));
+    }
+
+    QByteArray m_data;
+};
+
+class WorldListTest : public QObject
+{
+    Q_OBJECT
+
+    QByteArray makeLevelDat(const QByteArray &name, bool modernSeed, int padding = 0)
+    {
+        NbtWriter nbt;
+        nbt.beginCompound("");
+        nbt.beginCompound("Data");
+        // stuff that has to be skipped over
+        nbt.compoundList("Player", padding);
+        nbt.longArray("DataPacks", padding);
+        nbt.string("LevelName", name);
+        nbt.longTag("LastPlayed", 1600000000000);
+        nbt.intTag("GameType", 1);
+        if(modernSeed)
+        {
+            nbt.beginCompound("WorldGenSettings");
+            nbt.intTag("bonus_chest", 0);
+            nbt.longTag("seed", -42);
+            nbt.endCompound();
+        }
+        nbt.longTag("RandomSeed", 1234);
+        nbt.endCompound();
+        nbt.endCompound();
+        QByteArray compressed;
+        GZip::zip(nbt.data(), compressed);
+        return compressed;
+    }
+
+    void makeWorld(const QString &savesDir, const QString &folder, const QByteArray &name)
+    {
+        FS::write(FS::PathCombine(savesDir, folder, "level.dat"), makeLevelDat(name, true));
+    }
+
+private
+slots:
+    void test_summary()
+    {
+        auto summary = LevelDatSummary::fromCompressed(makeLevelDat("Modern world", true, 100));
+        QVERIFY(summary.valid);
+        QCOMPARE(*summary.levelName, QString("Modern world"));
+        QCOMPARE(*summary.lastPlayed, int64_t(1600000000000));
+        QCOMPARE(*summary.gameType, 1);
+        QCOMPARE(*summary.seed, int64_t(-42));
+
+        // before 1.16 there is only RandomSeed
+        summary = LevelDatSummary::fromCompressed(makeLevelDat("Old world", false));
+        QVERIFY(summary.valid);
+        QCOMPARE(*summary.seed, int64_t(1234));
+    }
+
+    void test_summaryBroken()
+    {
+        QVERIFY(!LevelDatSummary::fromCompressed(QByteArray()).valid);
+        QVERIFY(!LevelDatSummary::fromCompressed("not gzip at all").valid);
+        QVERIFY(!LevelDatSummary::fromNbt(QByteArray("\x0a\x00\x00\x00", 4)).valid);
+
+        // cut off before the values are there
+        QByteArray nbt;
+        GZip::unzip(makeLevelDat("Cut", false, 10), nbt);
+        QVERIFY(!LevelDatSummary::fromNbt(nbt.left(nbt.size() / 2)).valid);
+
+        // everything needed comes before the cut, the rest is not read
+        NbtWriter early;
+        early.beginCompound("");
+        early.beginCompound("Data");
+        early.string("LevelName", "Early");
+        early.longTag("LastPlayed", 1);
+        early.intTag("GameType", 0);
+        early.beginCompound("WorldGenSettings");
+        early.longTag("seed", 7);
+        auto summary = LevelDatSummary::fromNbt(early.data());
+        QVERIFY(summary.valid);
+        QCOMPARE(*summary.seed, int64_t(7));
+    }
+
+    void test_update()
+    {
+        QTemporaryDir tempDir;
+        QString savesDir = FS::PathCombine(tempDir.path(), "saves");
+        QString cachePath = FS::PathCombine(tempDir.path(), "worlds.cache");
+        makeWorld(savesDir, "a", "World A");
+        makeWorld(savesDir, "b", "World B");
+        FS::ensureFolderPathExists(FS::PathCombine(savesDir, "not a world"));
+
+        {
+            WorldList list(savesDir);
+            list.setSummaryCachePath(cachePath);
+            QSignalSpy spy(&list, &QAbstractItemModel::modelReset);
+            QVERIFY(list.update());
+            QVERIFY(spy.wait(5000));
+            QCOMPARE(int(list.size()), 2);
+            QCOMPARE(list[0].name(), QString("World A"));
+            QCOMPARE(list[1].seed(), int64_t(-42));
+        }
+        QVERIFY(QFileInfo(cachePath).exists());
+
+        // a changed level.dat is read again, the cache is not trusted for it
+        FS::write(FS::PathCombine(savesDir, "b", "level.dat"), makeLevelDat("Renamed B", false, 5));
+        {
+            WorldList list(savesDir);
+            list.setSummaryCachePath(cachePath);
+            QSignalSpy spy(&list, &QAbstractItemModel::modelReset);
+            list.update();
+            QVERIFY(spy.wait(5000));
+            QCOMPARE(int(list.size()), 2);
+            QCOMPARE(list[0].name(), QString("World A"));
+            QCOMPARE(list[1].name(), QString("Renamed B"));
+            QCOMPARE(list[1].seed(), int64_t(1234));
+        }
+
+        // a broken cache is ignored
+        FS::write(cachePath, "garbage");
+        {
+            WorldList list(savesDir);
+            list.setSummaryCachePath(cachePath);
+            QSignalSpy spy(&list, &QAbstractItemModel::modelReset);
+            list.update();
+            QVERIFY(spy.wait(5000));
+            QCOMPARE(int(list.size()), 2);
+        }
+    }
+
+    void test_stats()
+    {
+        QTemporaryDir tempDir;
+        QString savesDir = FS::PathCombine(tempDir.path(), "saves");
+        makeWorld(savesDir, "a", "World A");
+        QString worldDir = FS::PathCombine(savesDir, "a");
+        FS::write(FS::PathCombine(worldDir, "region", "r.0.0.mca"), QByteArray(8192, 'x'));
+        FS::write(FS::PathCombine(worldDir, "region", "r.0.1.mca"), QByteArray(4096, 'x'));
+        FS::write(FS::PathCombine(worldDir, "DIM-1", "region", "r.0.0.mca"), QByteArray(16384, 'x'));
+        FS::write(FS::PathCombine(worldDir, "dimensions", "mymod", "caves", "region", "r.1.1.mca"), QByteArray(1000, 'x'));
+        FS::write(FS::PathCombine(worldDir, "playerdata", "player.dat"), QByteArray(100, 'x'));
+        qint64 levelDatSize = QFileInfo(FS::PathCombine(worldDir, "level.dat")).size();
+
+        WorldList list(savesDir);
+        QSignalSpy spy(&list, &QAbstractItemModel::dataChanged);
+        list.startWatching();
+        QVERIFY(spy.wait(5000));
+        auto index = list.index(0);
+        QCOMPARE(list.data(index, WorldList::SizeRole).toLongLong(), 8192 + 4096 + 16384 + 1000 + 100 + levelDatSize);
+        QCOMPARE(list.data(index, WorldList::RegionCountRole).toInt(), 4);
+
+        auto dimensions = list.data(index, WorldList::DimensionStatsRole).toList();
+        QCOMPARE(dimensions.size(), 3);
+        QCOMPARE(dimensions[0].toMap()["id"].toString(), QString("minecraft:overworld"));
+        QCOMPARE(dimensions[0].toMap()["regionCount"].toInt(), 2);
+        QCOMPARE(dimensions[1].toMap()["id"].toString(), QString("minecraft:the_nether"));
+        QCOMPARE(dimensions[2].toMap()["id"].toString(), QString("mymod:caves"));
+
+        auto largest = list.data(index, WorldList::LargestRegionsRole).toList();
+        QCOMPARE(largest.size(), 4);
+        QCOMPARE(largest[0].toMap()["file"].toString(), QString("DIM-1/region/r.0.0.mca"));
+
+        // a growing region folder is picked up without scanning everything again
+        spy.clear();
+        FS::write(FS::PathCombine(worldDir, "region", "r.5.5.mca"), QByteArray(100000, 'x'));
+        QVERIFY(spy.wait(15000));
+        QCOMPARE(list.data(index, WorldList::RegionCountRole).toInt(), 5);
+        largest = list.data(index, WorldList::LargestRegionsRole).toList();
+        QCOMPARE(largest[0].toMap()["file"].toString(), QString("region/r.5.5.mca"));
+    }
+};
+
+QTEST_GUILESS_MAIN(WorldListTest)
+
+#include "WorldList_test.moc"
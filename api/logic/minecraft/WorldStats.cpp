@@ -0,0 +1,258 @@
+#include "WorldStats.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QMap>
+#include <QVector>
+#include <QtConcurrentMap>
+#include <algorithm>
+
+#include "FileSystem.h"
+
+namespace {
+
+// symlinks are not followed, this only guards against absurdly deep trees
+const int maxScanDepth = 64;
+
+struct DirectoryLister
+{
+    typedef WorldUsage::DirectoryUsage result_type;
+
+    DirectoryLister(const QString &worldPath) : worldPath(worldPath)
+    {
+    }
+
+    WorldUsage::DirectoryUsage operator()(const QString &relativePath) const
+    {
+        WorldUsage::DirectoryUsage usage;
+        usage.path = relativePath;
+        QDir dir(relativePath.isEmpty() ? worldPath : FS::PathCombine(worldPath, relativePath));
+        if(!dir.exists())
+        {
+            return usage;
+        }
+        usage.listed = true;
+        auto filter = QDir::Files | QDir::Dirs | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot | QDir::NoSymLinks;
+        for(auto & entry: dir.entryInfoList(filter, QDir::Name))
+        {
+            auto entryPath = relativePath.isEmpty() ? entry.fileName() : relativePath + '/' + entry.fileName();
+            if(entry.isDir())
+            {
+                usage.subdirectories.append(entryPath);
+                continue;
+            }
+            usage.bytes += entry.size();
+            if(entry.suffix() == "mca" || entry.suffix() == "mcr")
+            {
+                usage.regionFiles.append(qMakePair(entry.fileName(), entry.size()));
+            }
+        }
+        return usage;
+    }
+
+    QString worldPath;
+};
+
+/// The dimension folder holding a region, entities or poi folder, null if it's something else
+QString dimensionRoot(const QString &relativePath, QString &kind)
+{
+    int slash = relativePath.lastIndexOf('/');
+    kind = relativePath.mid(slash + 1);
+    if(kind != "region" && kind != "entities" && kind != "poi")
+    {
+        return QString();
+    }
+    return slash < 0 ? QString("") : relativePath.left(slash);
+}
+
+QString dimensionId(const QString &root)
+{
+    if(root.isEmpty())
+    {
+        return "minecraft:overworld";
+    }
+    if(root == "DIM-1")
+    {
+        return "minecraft:the_nether";
+    }
+    if(root == "DIM1")
+    {
+        return "minecraft:the_end";
+    }
+    // dimensions/<namespace>/<path>
+    if(root.startsWith("dimensions/"))
+    {
+        auto parts = root.mid(11).split('/');
+        if(parts.size() >= 2)
+        {
+            auto ns = parts.takeFirst();
+            return ns + ':' + parts.join('/');
+        }
+    }
+    return root;
+}
+
+}
+
+QDataStream &operator<<(QDataStream &out, const WorldStats &stats)
+{
+    out << stats.totalBytes << qint32(stats.regionCount);
+    out << quint32(stats.dimensions.size());
+    for(auto & dimension: stats.dimensions)
+    {
+        out << dimension.id << dimension.bytes << qint32(dimension.regionCount) << dimension.regionBytes;
+    }
+    out << quint32(stats.largestRegions.size());
+    for(auto & region: stats.largestRegions)
+    {
+        out << region.dimension << region.file << region.size;
+    }
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, WorldStats &stats)
+{
+    stats = WorldStats();
+    qint32 regionCount = 0;
+    quint32 count = 0;
+    in >> stats.totalBytes >> regionCount >> count;
+    stats.regionCount = regionCount;
+    for(quint32 i = 0; i < count && in.status() == QDataStream::Ok; i++)
+    {
+        DimensionStats dimension;
+        qint32 dimensionRegions = 0;
+        in >> dimension.id >> dimension.bytes >> dimensionRegions >> dimension.regionBytes;
+        dimension.regionCount = dimensionRegions;
+        stats.dimensions.append(dimension);
+    }
+    in >> count;
+    for(quint32 i = 0; i < count && in.status() == QDataStream::Ok; i++)
+    {
+        RegionFileStats region;
+        in >> region.dimension >> region.file >> region.size;
+        stats.largestRegions.append(region);
+    }
+    return in;
+}
+
+WorldUsage WorldUsage::scan(const QString &worldPath)
+{
+    WorldUsage usage;
+    usage.m_path = worldPath;
+    QStringList level{QString("")};
+    for(int depth = 0; !level.isEmpty() && depth < maxScanDepth; depth++)
+    {
+        auto listed = QtConcurrent::blockingMapped<QList<DirectoryUsage>>(level, DirectoryLister(worldPath));
+        level.clear();
+        for(auto & directory: listed)
+        {
+            if(!directory.listed)
+            {
+                continue;
+            }
+            level.append(directory.subdirectories);
+            usage.m_directories.insert(directory.path, directory);
+        }
+    }
+    return usage;
+}
+
+void WorldUsage::rescanDirectory(const QString &relativePath)
+{
+    auto directory = DirectoryLister(m_path)(relativePath);
+    if(!directory.listed)
+    {
+        removeDirectory(relativePath);
+        return;
+    }
+    auto previous = m_directories.value(relativePath);
+    for(auto & subdirectory: previous.subdirectories)
+    {
+        if(!directory.subdirectories.contains(subdirectory))
+        {
+            removeDirectory(subdirectory);
+        }
+    }
+    m_directories.insert(relativePath, directory);
+}
+
+void WorldUsage::removeDirectory(const QString &relativePath)
+{
+    auto iter = m_directories.find(relativePath);
+    if(iter == m_directories.end())
+    {
+        return;
+    }
+    auto subdirectories = iter->subdirectories;
+    m_directories.erase(iter);
+    for(auto & subdirectory: subdirectories)
+    {
+        removeDirectory(subdirectory);
+    }
+}
+
+QStringList WorldUsage::dimensionDirectories() const
+{
+    QStringList result;
+    QString kind;
+    for(auto iter = m_directories.begin(); iter != m_directories.end(); iter++)
+    {
+        if(!dimensionRoot(iter.key(), kind).isNull())
+        {
+            result.append(iter.key());
+        }
+    }
+    result.sort();
+    return result;
+}
+
+WorldStats WorldUsage::stats() const
+{
+    WorldStats stats;
+    QMap<QString, DimensionStats> dimensions;
+    QVector<RegionFileStats> regions;
+    for(auto iter = m_directories.begin(); iter != m_directories.end(); iter++)
+    {
+        auto & directory = *iter;
+        stats.totalBytes += directory.bytes;
+
+        QString kind;
+        auto root = dimensionRoot(directory.path, kind);
+        if(root.isNull())
+        {
+            continue;
+        }
+        auto id = dimensionId(root);
+        auto & dimension = dimensions[id];
+        dimension.id = id;
+        dimension.bytes += directory.bytes;
+        if(kind != "region")
+        {
+            continue;
+        }
+        for(auto & regionFile: directory.regionFiles)
+        {
+            dimension.regionCount++;
+            dimension.regionBytes += regionFile.second;
+            RegionFileStats region;
+            region.dimension = id;
+            region.file = directory.path + '/' + regionFile.first;
+            region.size = regionFile.second;
+            regions.append(region);
+        }
+        stats.regionCount += directory.regionFiles.size();
+    }
+    stats.dimensions = dimensions.values();
+
+    auto biggestFirst = [](const RegionFileStats &a, const RegionFileStats &b)
+    {
+        return a.size > b.size || (a.size == b.size && a.file < b.file);
+    };
+    int top = qMin(regions.size(), int(WorldStats::largestRegionCount));
+    std::partial_sort(regions.begin(), regions.begin() + top, regions.end(), biggestFirst);
+    for(int i = 0; i < top; i++)
+    {
+        stats.largestRegions.append(regions[i]);
+    }
+    return stats;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QHash>
+#include <QPair>
+
+#include "multiservermc_logic_export.h"
+
+class QDataStream;
+
+struct DimensionStats
+{
+    /// Namespaced ID of the dimension, like minecraft:the_nether
+    QString id;
+    /// Bytes in the region, entities and poi folders of the dimension
+    qint64 bytes = 0;
+    int regionCount = 0;
+    qint64 regionBytes = 0;
+};
+
+struct RegionFileStats
+{
+    QString dimension;
+    /// Path relative to the world folder
+    QString file;
+    qint64 size = 0;
+};
+
+/// Disk usage numbers of one world
+struct MULTISERVERMC_LOGIC_EXPORT WorldStats
+{
+    static const int largestRegionCount = 5;
+
+    qint64 totalBytes = 0;
+    int regionCount = 0;
+    /// Sorted by dimension ID
+    QList<DimensionStats> dimensions;
+    /// The biggest region files of the world, biggest first
+    QList<RegionFileStats> largestRegions;
+};
+
+MULTISERVERMC_LOGIC_EXPORT QDataStream &operator<<(QDataStream &out, const WorldStats &stats);
+MULTISERVERMC_LOGIC_EXPORT QDataStream &operator>>(QDataStream &in, WorldStats &stats);
+
+/**
+ * Disk usage of a world folder, remembered per directory.
+ *
+ * A full scan lists all the directories of one depth in parallel before going deeper.
+ * Afterwards, single directories (usually the region folders, which change while the
+ * server runs) can be listed again without walking the rest of the world.
+ */
+class MULTISERVERMC_LOGIC_EXPORT WorldUsage
+{
+public:
+    struct DirectoryUsage
+    {
+        /// Path relative to the world folder, empty for the world folder itself
+        QString path;
+        bool listed = false;
+        /// Bytes in the files directly inside of this directory
+        qint64 bytes = 0;
+        QStringList subdirectories;
+        /// Region files (.mca, .mcr) directly inside of this directory, with sizes
+        QList<QPair<QString, qint64>> regionFiles;
+    };
+
+    static WorldUsage scan(const QString &worldPath);
+
+    /// List one directory again, keeping what is known about its subdirectories
+    void rescanDirectory(const QString &relativePath);
+
+    /// The region, entities and poi folders of all dimensions, relative to the world folder
+    QStringList dimensionDirectories() const;
+
+    WorldStats stats() const;
+
+    QString path() const
+    {
+        return m_path;
+    }
+    bool isEmpty() const
+    {
+        return m_directories.isEmpty();
+    }
+
+private:
+    void removeDirectory(const QString &relativePath);
+
+private:
+    QString m_path;
+    QHash<QString, DirectoryUsage> m_directories;
+};
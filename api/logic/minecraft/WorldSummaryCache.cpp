@@ -0,0 +1,167 @@
+#include "WorldSummaryCache.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+
+#include "FileSystem.h"
+
+namespace {
+const quint32 CACHE_MAGIC = 0x4d535743; // "MSWC"
+const quint32 CACHE_VERSION = 1;
+
+enum SummaryFields : quint8
+{
+    HasLevelName = 1,
+    HasLastPlayed = 2,
+    HasGameType = 4,
+    HasSeed = 8
+};
+
+void writeSummary(QDataStream &out, const LevelDatSummary &summary)
+{
+    quint8 fields = 0;
+    fields |= summary.levelName ? HasLevelName : 0;
+    fields |= summary.lastPlayed ? HasLastPlayed : 0;
+    fields |= summary.gameType ? HasGameType : 0;
+    fields |= summary.seed ? HasSeed : 0;
+    out << summary.valid << fields;
+    out << (summary.levelName ? *summary.levelName : QString());
+    out << qint64(summary.lastPlayed ? *summary.lastPlayed : 0);
+    out << qint32(summary.gameType ? *summary.gameType : 0);
+    out << qint64(summary.seed ? *summary.seed : 0);
+}
+
+LevelDatSummary readSummary(QDataStream &in)
+{
+    LevelDatSummary summary;
+    quint8 fields = 0;
+    QString levelName;
+    qint64 lastPlayed = 0;
+    qint32 gameType = 0;
+    qint64 seed = 0;
+    in >> summary.valid >> fields >> levelName >> lastPlayed >> gameType >> seed;
+    if(fields & HasLevelName)
+    {
+        summary.levelName = levelName;
+    }
+    if(fields & HasLastPlayed)
+    {
+        summary.lastPlayed = lastPlayed;
+    }
+    if(fields & HasGameType)
+    {
+        summary.gameType = gameType;
+    }
+    if(fields & HasSeed)
+    {
+        summary.seed = seed;
+    }
+    return summary;
+}
+}
+
+bool WorldSummaryCache::load(const QString &path)
+{
+    QByteArray data;
+    try
+    {
+        data = FS::read(path);
+    }
+    catch (const FS::FileSystemException &)
+    {
+        return false;
+    }
+
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_5_6);
+    quint32 magic = 0, version = 0, count = 0;
+    in >> magic >> version;
+    if(magic != CACHE_MAGIC || version != CACHE_VERSION)
+    {
+        qDebug() << "Ignoring world summary cache" << path << "with unknown format";
+        return false;
+    }
+    in >> count;
+
+    QHash<QString, Entry> entries;
+    for(quint32 i = 0; i < count && in.status() == QDataStream::Ok; i++)
+    {
+        QString folderName;
+        Entry entry;
+        in >> folderName >> entry.levelDatModified >> entry.levelDatSize;
+        entry.summary = readSummary(in);
+        entries.insert(folderName, entry);
+    }
+    if(in.status() != QDataStream::Ok)
+    {
+        qWarning() << "World summary cache" << path << "is truncated or corrupted";
+        return false;
+    }
+    m_entries = entries;
+    return true;
+}
+
+bool WorldSummaryCache::save(const QString &path) const
+{
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_6);
+    out << CACHE_MAGIC << CACHE_VERSION << quint32(m_entries.size());
+    for(auto iter = m_entries.begin(); iter != m_entries.end(); iter++)
+    {
+        out << iter.key() << iter->levelDatModified << iter->levelDatSize;
+        writeSummary(out, iter->summary);
+    }
+    try
+    {
+        FS::write(path, data);
+    }
+    catch (const FS::FileSystemException &e)
+    {
+        qWarning() << "Failed to write world summary cache:" << e.cause();
+        return false;
+    }
+    return true;
+}
+
+void WorldSummaryCache::insert(const QString &folderName, const Entry &entry)
+{
+    m_entries.insert(folderName, entry);
+}
+
+const WorldSummaryCache::Entry *WorldSummaryCache::validEntry(const QString &folderName, const QFileInfo &levelDatInfo) const
+{
+    auto iter = m_entries.find(folderName);
+    if(iter == m_entries.end())
+    {
+        return nullptr;
+    }
+    if(iter->levelDatModified != levelDatInfo.lastModified().toMSecsSinceEpoch() || iter->levelDatSize != levelDatInfo.size())
+    {
+        return nullptr;
+    }
+    return &(*iter);
+}
+
+bool WorldSummaryCache::operator==(const WorldSummaryCache &other) const
+{
+    if(m_entries.size() != other.m_entries.size())
+    {
+        return false;
+    }
+    for(auto iter = m_entries.begin(); iter != m_entries.end(); iter++)
+    {
+        auto otherIter = other.m_entries.find(iter.key());
+        if(otherIter == other.m_entries.end())
+        {
+            return false;
+        }
+        if(iter->levelDatModified != otherIter->levelDatModified || iter->levelDatSize != otherIter->levelDatSize
+            || iter->summary != otherIter->summary)
+        {
+            return false;
+        }
+    }
+    return true;
+}
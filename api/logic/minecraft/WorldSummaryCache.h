@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QString>
+#include <QHash>
+#include <QFileInfo>
+
+#include "minecraft/LevelDatSummary.h"
+
+#include "multiservermc_logic_export.h"
+
+/**
+ * Persisted level.dat summaries of the worlds in a world folder.
+ *
+ * An entry is only trusted while the world's level.dat still has the same modification
+ * time and size, so a world list can skip reading unchanged worlds completely.
+ */
+class MULTISERVERMC_LOGIC_EXPORT WorldSummaryCache
+{
+public:
+    struct Entry
+    {
+        qint64 levelDatModified = 0;
+        qint64 levelDatSize = 0;
+        LevelDatSummary summary;
+    };
+
+    /// Read a cache file, fails if it is unreadable or from an incompatible version
+    bool load(const QString &path);
+    bool save(const QString &path) const;
+
+    void insert(const QString &folderName, const Entry &entry);
+    /// The cached entry for folderName if the level.dat described by levelDatInfo did not change since
+    const Entry *validEntry(const QString &folderName, const QFileInfo &levelDatInfo) const;
+
+    bool operator==(const WorldSummaryCache &other) const;
+    bool operator!=(const WorldSummaryCache &other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    QHash<QString, Entry> m_entries;
+};
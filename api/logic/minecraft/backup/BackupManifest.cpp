@@ -0,0 +1,109 @@
+#include "BackupManifest.h"
+
+#include <QDataStream>
+#include <QDebug>
+
+#include "FileSystem.h"
+
+namespace {
+const quint32 MANIFEST_MAGIC = 0x4d53424d; // "MSBM"
+const quint32 MANIFEST_VERSION = 1;
+}
+
+bool BackupManifest::load(const QString &path)
+{
+    QByteArray compressed;
+    try
+    {
+        compressed = FS::read(path);
+    }
+    catch (const FS::FileSystemException &e)
+    {
+        qWarning() << "Failed to read backup manifest:" << e.cause();
+        return false;
+    }
+    auto data = qUncompress(compressed);
+
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_5_6);
+    quint32 magic = 0, version = 0, fileCount = 0;
+    in >> magic >> version;
+    if(magic != MANIFEST_MAGIC || version != MANIFEST_VERSION)
+    {
+        qWarning() << "Backup manifest" << path << "has an unknown format";
+        return false;
+    }
+    in >> id >> worldName >> created >> directories >> fileCount;
+    files.clear();
+    for(quint32 i = 0; i < fileCount && in.status() == QDataStream::Ok; i++)
+    {
+        File file;
+        quint32 chunkCount = 0;
+        in >> file.path >> file.size >> file.modified >> file.region >> file.blocks >> chunkCount;
+        file.chunks.reserve(chunkCount);
+        for(quint32 j = 0; j < chunkCount && in.status() == QDataStream::Ok; j++)
+        {
+            Chunk chunk;
+            in >> chunk.index >> chunk.sectorOffset >> chunk.sectorCount >> chunk.hash;
+            file.chunks.append(chunk);
+        }
+        files.append(file);
+    }
+    if(in.status() != QDataStream::Ok)
+    {
+        qWarning() << "Backup manifest" << path << "is truncated or corrupted";
+        return false;
+    }
+    return true;
+}
+
+bool BackupManifest::save(const QString &path) const
+{
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_6);
+    out << MANIFEST_MAGIC << MANIFEST_VERSION;
+    out << id << worldName << created << directories << quint32(files.size());
+    for(auto & file: files)
+    {
+        out << file.path << file.size << file.modified << file.region << file.blocks << quint32(file.chunks.size());
+        for(auto & chunk: file.chunks)
+        {
+            out << chunk.index << chunk.sectorOffset << chunk.sectorCount << chunk.hash;
+        }
+    }
+    try
+    {
+        FS::write(path, qCompress(data));
+    }
+    catch (const FS::FileSystemException &e)
+    {
+        qWarning() << "Failed to write backup manifest:" << e.cause();
+        return false;
+    }
+    return true;
+}
+
+QList<QByteArray> BackupManifest::objects() const
+{
+    QList<QByteArray> result;
+    for(auto & file: files)
+    {
+        result.append(file.blocks);
+        for(auto & chunk: file.chunks)
+        {
+            result.append(chunk.hash);
+        }
+    }
+    return result;
+}
+
+qint64 BackupManifest::totalSize() const
+{
+    qint64 total = 0;
+    for(auto & file: files)
+    {
+        total += file.size;
+    }
+    return total;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QVector>
+#include <QByteArray>
+#include <QDateTime>
+
+#include "multiservermc_logic_export.h"
+
+/**
+ * Everything needed to put one backed up world back together.
+ *
+ * Files are lists of objects in a WorldBackupStore. Region files are kept as their header
+ * plus one object per chunk, so a chunk that did not change between backups is stored once.
+ */
+struct MULTISERVERMC_LOGIC_EXPORT BackupManifest
+{
+    struct Chunk
+    {
+        /// Position in the region's location table
+        quint16 index = 0;
+        /// Where the chunk starts in the region file, in 4 KiB sectors
+        quint32 sectorOffset = 0;
+        quint8 sectorCount = 0;
+        QByteArray hash;
+    };
+
+    struct File
+    {
+        /// Path relative to the world folder, with forward slashes
+        QString path;
+        qint64 size = 0;
+        qint64 modified = 0;
+        bool region = false;
+        /// Plain files: hashes of consecutive blocks. Region files: the hash of the 8 KiB header.
+        QList<QByteArray> blocks;
+        QVector<Chunk> chunks;
+    };
+
+    bool load(const QString &path);
+    bool save(const QString &path) const;
+
+    /// All the object hashes the snapshot needs
+    QList<QByteArray> objects() const;
+    qint64 totalSize() const;
+
+    QString id;
+    QString worldName;
+    QDateTime created;
+    /// Directories relative to the world folder, so empty ones are restored too
+    QStringList directories;
+    QList<File> files;
+};
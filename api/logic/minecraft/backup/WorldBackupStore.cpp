@@ -0,0 +1,200 @@
+#include "WorldBackupStore.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSet>
+#include <QDebug>
+
+#include "FileSystem.h"
+
+namespace {
+// first byte of every object, tells how the rest is stored
+const char STORED_RAW = 'R';
+const char STORED_ZLIB = 'Z';
+
+// snapshot manifests handed out by newSnapshotId(), which may not be saved yet
+QMutex reservedSnapshotsMutex;
+QSet<QString> reservedSnapshots;
+}
+
+WorldBackupStore::WorldBackupStore(const QString &root) : m_root(root)
+{
+}
+
+QByteArray WorldBackupStore::hash(const QByteArray &data)
+{
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+}
+
+QString WorldBackupStore::objectPath(const QByteArray &hash) const
+{
+    auto hex = QString::fromLatin1(hash.toHex());
+    return FS::PathCombine(m_root, "objects", hex.left(2), hex.mid(2));
+}
+
+QString WorldBackupStore::snapshotPath(const QString &worldFolder, const QString &id) const
+{
+    return FS::PathCombine(m_root, "snapshots", worldFolder, id + ".manifest");
+}
+
+bool WorldBackupStore::contains(const QByteArray &hash) const
+{
+    return QFileInfo(objectPath(hash)).isFile();
+}
+
+bool WorldBackupStore::put(const QByteArray &hash, const QByteArray &data, bool compress)
+{
+    auto path = objectPath(hash);
+    if(QFileInfo(path).isFile())
+    {
+        return true;
+    }
+    QByteArray stored;
+    if(compress)
+    {
+        stored = STORED_ZLIB + qCompress(data, 3);
+    }
+    else
+    {
+        stored = STORED_RAW + data;
+    }
+    try
+    {
+        // written to a temporary file and renamed, another thread storing the same object does no harm
+        FS::write(path, stored);
+    }
+    catch (const FS::FileSystemException &e)
+    {
+        qWarning() << "Failed to store backup object:" << e.cause();
+        return false;
+    }
+    return true;
+}
+
+bool WorldBackupStore::get(const QByteArray &hash, QByteArray &data) const
+{
+    QByteArray stored;
+    try
+    {
+        stored = FS::read(objectPath(hash));
+    }
+    catch (const FS::FileSystemException &e)
+    {
+        qWarning() << "Backup object is missing:" << e.cause();
+        return false;
+    }
+    if(stored.isEmpty())
+    {
+        return false;
+    }
+    if(stored[0] == STORED_ZLIB)
+    {
+        data = qUncompress(stored.mid(1));
+    }
+    else if(stored[0] == STORED_RAW)
+    {
+        data = stored.mid(1);
+    }
+    else
+    {
+        return false;
+    }
+    if(WorldBackupStore::hash(data) != hash)
+    {
+        qWarning() << "Backup object" << hash.toHex() << "is corrupted";
+        return false;
+    }
+    return true;
+}
+
+QStringList WorldBackupStore::snapshots(const QString &worldFolder) const
+{
+    QDir dir(FS::PathCombine(m_root, "snapshots", worldFolder));
+    QStringList result;
+    // IDs are timestamps, sorting by name is sorting by age
+    for(auto & name: dir.entryList({"*.manifest"}, QDir::Files, QDir::Name))
+    {
+        result.append(name.left(name.size() - 9));
+    }
+    return result;
+}
+
+QString WorldBackupStore::newSnapshotId(const QString &worldFolder) const
+{
+    auto base = QDateTime::currentDateTimeUtc().toString("yyyyMMdd-HHmmss-zzz");
+    QMutexLocker locker(&reservedSnapshotsMutex);
+    auto id = base;
+    // padded, so the IDs still sort by age
+    for(int i = 1; reservedSnapshots.contains(QDir::cleanPath(snapshotPath(worldFolder, id))) || QFile::exists(snapshotPath(worldFolder, id)); i++)
+    {
+        id = QString("%1-%2").arg(base).arg(i, 3, 10, QChar('0'));
+    }
+    reservedSnapshots.insert(QDir::cleanPath(snapshotPath(worldFolder, id)));
+    return id;
+}
+
+void WorldBackupStore::releaseSnapshotId(const QString &worldFolder, const QString &id) const
+{
+    QMutexLocker locker(&reservedSnapshotsMutex);
+    reservedSnapshots.remove(QDir::cleanPath(snapshotPath(worldFolder, id)));
+}
+
+bool WorldBackupStore::loadSnapshot(const QString &worldFolder, const QString &id, BackupManifest &manifest) const
+{
+    return manifest.load(snapshotPath(worldFolder, id));
+}
+
+bool WorldBackupStore::saveSnapshot(const QString &worldFolder, const BackupManifest &manifest)
+{
+    return manifest.save(snapshotPath(worldFolder, manifest.id));
+}
+
+bool WorldBackupStore::removeSnapshot(const QString &worldFolder, const QString &id)
+{
+    return QFile::remove(snapshotPath(worldFolder, id));
+}
+
+qint64 WorldBackupStore::collectGarbage()
+{
+    QSet<QString> used;
+    QDir snapshotsDir(FS::PathCombine(m_root, "snapshots"));
+    for(auto & worldFolder: snapshotsDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot))
+    {
+        for(auto & id: snapshots(worldFolder))
+        {
+            BackupManifest manifest;
+            if(!loadSnapshot(worldFolder, id, manifest))
+            {
+                // better keep everything than break a snapshot that can't be read right now
+                qWarning() << "Not collecting backup garbage, snapshot" << id << "of" << worldFolder << "is unreadable";
+                return 0;
+            }
+            for(auto & hash: manifest.objects())
+            {
+                used.insert(QDir::cleanPath(objectPath(hash)));
+            }
+        }
+    }
+
+    qint64 freed = 0;
+    QDirIterator iter(FS::PathCombine(m_root, "objects"), QDir::Files, QDirIterator::Subdirectories);
+    while(iter.hasNext())
+    {
+        auto path = QDir::cleanPath(iter.next());
+        if(used.contains(path))
+        {
+            continue;
+        }
+        qint64 size = iter.fileInfo().size();
+        if(QFile::remove(path))
+        {
+            freed += size;
+        }
+    }
+    return freed;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <memory>
+
+#include "minecraft/backup/BackupManifest.h"
+
+#include "multiservermc_logic_export.h"
+
+/**
+ * Content addressed storage for world backups.
+ *
+ * Objects are stored once under the SHA-1 of their content, in objects/xx/yyyy... below the
+ * store root. Snapshots are manifests in snapshots/<world folder>/<id>.manifest. Worlds of
+ * the same instance share the objects, so copies of a world cost next to nothing either.
+ *
+ * Storing and reading objects is safe from several threads at once.
+ */
+class MULTISERVERMC_LOGIC_EXPORT WorldBackupStore
+{
+public:
+    explicit WorldBackupStore(const QString &root);
+
+    QString root() const
+    {
+        return m_root;
+    }
+
+    static QByteArray hash(const QByteArray &data);
+
+    bool contains(const QByteArray &hash) const;
+    /**
+     * Store data under hash, unless it is there already.
+     * Data that is already compressed (like chunks written by the game) should be stored with compress = false.
+     */
+    bool put(const QByteArray &hash, const QByteArray &data, bool compress = true);
+    /// Read an object back, fails if it is missing or does not match its hash
+    bool get(const QByteArray &hash, QByteArray &data) const;
+
+    /// Snapshot IDs of a world, oldest first
+    QStringList snapshots(const QString &worldFolder) const;
+    /**
+     * A new snapshot ID for a world: the current time, with a counter appended if that ID is taken
+     * already. IDs handed out are taken even before their snapshot is saved, across all stores.
+     */
+    QString newSnapshotId(const QString &worldFolder) const;
+    /// Give back an ID from newSnapshotId() once its snapshot is saved, or won't be
+    void releaseSnapshotId(const QString &worldFolder, const QString &id) const;
+    bool loadSnapshot(const QString &worldFolder, const QString &id, BackupManifest &manifest) const;
+    bool saveSnapshot(const QString &worldFolder, const BackupManifest &manifest);
+    bool removeSnapshot(const QString &worldFolder, const QString &id);
+
+    /// Delete the objects no snapshot refers to anymore, returns the number of bytes freed
+    qint64 collectGarbage();
+
+private:
+    QString objectPath(const QByteArray &hash) const;
+    QString snapshotPath(const QString &worldFolder, const QString &id) const;
+
+private:
+    QString m_root;
+};
+
+typedef std::shared_ptr<WorldBackupStore> WorldBackupStorePtr;
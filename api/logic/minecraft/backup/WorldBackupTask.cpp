@@ -0,0 +1,396 @@
+#include "WorldBackupTask.h"
+
+#include <QDirIterator>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRegularExpression>
+#include <QtConcurrentRun>
+#include <QThreadPool>
+#include <QtEndian>
+#include <QDebug>
+
+#include "FileSystem.h"
+#include "tasks/ConcurrentProgress.h"
+#include "tasks/ParallelJobs.h"
+#include "minecraft/launch/ServerLog.h"
+
+namespace {
+
+// plain files are split into blocks of this size, so big files that only grow share most of them
+const qint64 blockSize = 1024 * 1024;
+const int sectorSize = 4096;
+const int regionHeaderSize = 2 * sectorSize;
+// 1024 chunks of at most 255 sectors after the header, anything bigger is read in blocks like any other file
+const qint64 maxRegionSize = regionHeaderSize + qint64(1024 * 255) * sectorSize;
+
+bool isRegionFile(const QString &path)
+{
+    return path.endsWith(".mca") || path.endsWith(".mcr");
+}
+
+/**
+ * Find the chunks of a region file. Fails if the location table points outside of the file
+ * or at data that is not a chunk, the file is then backed up like any other file.
+ */
+bool splitRegion(const QByteArray &data, QVector<BackupManifest::Chunk> &chunks)
+{
+    if(data.size() < regionHeaderSize)
+    {
+        return false;
+    }
+    auto bytes = reinterpret_cast<const uchar *>(data.constData());
+    qint64 sectors = data.size() / sectorSize;
+    for(int index = 0; index < 1024; index++)
+    {
+        quint32 location = qFromBigEndian<quint32>(bytes + index * 4);
+        if(location == 0)
+        {
+            continue;
+        }
+        BackupManifest::Chunk chunk;
+        chunk.index = index;
+        chunk.sectorOffset = location >> 8;
+        chunk.sectorCount = location & 0xff;
+        if(chunk.sectorOffset < 2 || chunk.sectorCount == 0 || chunk.sectorOffset + chunk.sectorCount > sectors)
+        {
+            return false;
+        }
+        quint32 length = qFromBigEndian<quint32>(bytes + qint64(chunk.sectorOffset) * sectorSize);
+        if(length == 0 || qint64(length) + 4 > qint64(chunk.sectorCount) * sectorSize)
+        {
+            return false;
+        }
+        chunks.append(chunk);
+    }
+    return true;
+}
+
+bool storeRegion(const QByteArray &data, WorldBackupStore &store, BackupManifest::File &file)
+{
+    QVector<BackupManifest::Chunk> chunks;
+    if(!splitRegion(data, chunks))
+    {
+        return false;
+    }
+    auto header = QByteArray::fromRawData(data.constData(), regionHeaderSize);
+    auto headerHash = WorldBackupStore::hash(header);
+    if(!store.put(headerHash, header))
+    {
+        return false;
+    }
+    for(auto & chunk: chunks)
+    {
+        auto start = data.constData() + qint64(chunk.sectorOffset) * sectorSize;
+        quint32 length = qFromBigEndian<quint32>(reinterpret_cast<const uchar *>(start));
+        // the length, the compression type and the data, without the padding up to the next sector
+        auto payload = QByteArray::fromRawData(start, qint64(length) + 4);
+        quint8 compression = payload.at(4);
+        // gzip, zlib and LZ4 are compressed by the game already, 0x80 marks chunks kept in .mcc files
+        bool compressed = (compression == 1 || compression == 2 || compression == 4);
+        chunk.hash = WorldBackupStore::hash(payload);
+        if(!store.put(chunk.hash, payload, !compressed))
+        {
+            return false;
+        }
+    }
+    file.region = true;
+    file.blocks = {headerHash};
+    file.chunks = chunks;
+    return true;
+}
+
+bool storeBlocks(QFile &input, WorldBackupStore &store, BackupManifest::File &file)
+{
+    file.blocks.clear();
+    file.size = 0;
+    while(true)
+    {
+        auto block = input.read(blockSize);
+        if(block.isEmpty())
+        {
+            return input.error() == QFile::NoError;
+        }
+        auto hash = WorldBackupStore::hash(block);
+        if(!store.put(hash, block))
+        {
+            return false;
+        }
+        file.blocks.append(hash);
+        file.size += block.size();
+    }
+}
+
+bool storeFile(const QString &path, WorldBackupStore &store, BackupManifest::File &file)
+{
+    QFile input(path);
+    if(!input.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    if(isRegionFile(file.path) && input.size() <= maxRegionSize)
+    {
+        auto data = input.readAll();
+        if(input.error() != QFile::NoError)
+        {
+            return false;
+        }
+        if(storeRegion(data, store, file))
+        {
+            file.size = data.size();
+            return true;
+        }
+        qDebug() << "Backing up" << file.path << "as a plain file, it does not look like a region file";
+        input.seek(0);
+    }
+    return storeBlocks(input, store, file);
+}
+
+QString backupWorld(const QString &worldPath, WorldBackupStorePtr store, const QString &id, ConcurrentProgress *progress)
+{
+    QDir worldDir(worldPath);
+    auto worldFolder = QFileInfo(worldPath).fileName();
+    if(!worldDir.exists())
+    {
+        return QObject::tr("The world folder %1 does not exist.").arg(worldPath);
+    }
+
+    // files that did not change since the last snapshot are taken from it without reading them
+    BackupManifest previous;
+    QHash<QString, int> previousFiles;
+    auto existing = store->snapshots(worldFolder);
+    if(!existing.isEmpty() && store->loadSnapshot(worldFolder, existing.last(), previous))
+    {
+        for(int i = 0; i < previous.files.size(); i++)
+        {
+            previousFiles.insert(previous.files[i].path, i);
+        }
+    }
+
+    BackupManifest manifest;
+    manifest.id = id;
+    manifest.worldName = worldFolder;
+    manifest.created = QDateTime::currentDateTimeUtc();
+
+    QVector<BackupManifest::File> files;
+    QVector<int> toRead;
+    qint64 bytesToRead = 0;
+    QDirIterator iter(worldPath, QDir::Files | QDir::Dirs | QDir::Hidden | QDir::NoDotAndDotDot | QDir::NoSymLinks, QDirIterator::Subdirectories);
+    while(iter.hasNext())
+    {
+        iter.next();
+        auto info = iter.fileInfo();
+        auto relativePath = worldDir.relativeFilePath(info.absoluteFilePath());
+        if(info.isDir())
+        {
+            manifest.directories.append(relativePath);
+            continue;
+        }
+        // held open by a running game, and meaningless anywhere else
+        if(relativePath == "session.lock")
+        {
+            continue;
+        }
+        BackupManifest::File file;
+        file.path = relativePath;
+        file.size = info.size();
+        file.modified = info.lastModified().toMSecsSinceEpoch();
+        auto previousIter = previousFiles.find(relativePath);
+        if(previousIter != previousFiles.end())
+        {
+            auto & previousFile = previous.files[*previousIter];
+            if(previousFile.size == file.size && previousFile.modified == file.modified)
+            {
+                files.append(previousFile);
+                continue;
+            }
+        }
+        toRead.append(files.size());
+        bytesToRead += file.size;
+        files.append(file);
+    }
+    manifest.directories.sort();
+
+    if(progress)
+    {
+        progress->setTotal(bytesToRead);
+    }
+    QMutex failureLock;
+    QString failedPath;
+    auto worldRoot = worldDir.absolutePath();
+    auto filesData = files.data();
+    bool ok = ParallelJobs::run(toRead.size(), [&](int i) -> bool
+    {
+        auto & file = filesData[toRead.at(i)];
+        qint64 expectedSize = file.size;
+        if(!storeFile(FS::PathCombine(worldRoot, file.path), *store, file))
+        {
+            QMutexLocker locker(&failureLock);
+            failedPath = file.path;
+            return false;
+        }
+        if(progress)
+        {
+            progress->addDone(expectedSize);
+        }
+        return true;
+    }, progress);
+    if(progress && progress->isCanceled())
+    {
+        return QObject::tr("Aborted.");
+    }
+    if(!ok)
+    {
+        return QObject::tr("Could not back up %1.").arg(failedPath);
+    }
+
+    manifest.files = files.toList();
+    if(!store->saveSnapshot(worldFolder, manifest))
+    {
+        return QObject::tr("Could not save the backup manifest.");
+    }
+    qDebug() << "Backed up" << worldPath << "as" << id << ":" << manifest.files.size() << "files," << toRead.size() << "read";
+    return QString();
+}
+
+}
+
+WorldBackupTask::WorldBackupTask(const QString &worldPath, WorldBackupStorePtr store, shared_qobject_ptr<LaunchTask> server)
+    : m_worldPath(worldPath), m_store(store), m_server(server)
+{
+    m_saveTimeout.setSingleShot(true);
+    m_saveTimeout.setInterval(60000);
+    connect(&m_saveTimeout, &QTimer::timeout, this, &WorldBackupTask::saveTimedOut);
+    connect(&m_backupWatcher, &QFutureWatcher<QString>::finished, this, &WorldBackupTask::filesBackedUp);
+}
+
+WorldBackupTask::~WorldBackupTask()
+{
+    if(m_progress)
+    {
+        m_progress->cancel();
+    }
+    m_backupWatcher.waitForFinished();
+    resumeServerSaving();
+    releaseSnapshotId();
+}
+
+void WorldBackupTask::executeTask()
+{
+    m_snapshotId = m_store->newSnapshotId(QFileInfo(m_worldPath).fileName());
+    if(m_server && m_server->isRunning())
+    {
+        connect(m_server.get(), &LaunchTask::lineLogged, this, &WorldBackupTask::serverLogged);
+        setStatus(tr("Waiting for the server to save the world..."));
+        m_serverSavingOff = true;
+        if(!m_server->commands().send("save-off") || !m_server->commands().send("save-all flush"))
+        {
+            disconnect(m_server.get(), &LaunchTask::lineLogged, this, &WorldBackupTask::serverLogged);
+            resumeServerSaving();
+            releaseSnapshotId();
+            emitFailed(tr("The server has too many commands waiting, it could not be asked to save the world."));
+            return;
+        }
+        m_saveTimeout.start();
+        return;
+    }
+    startBackup();
+}
+
+void WorldBackupTask::serverLogged(const QString &line, MessageLevel::Enum)
+{
+    // "Saved the game" since 1.13, "Saved the world" before. From the start of the message, players could say it too.
+    static const QRegularExpression saved("^Saved the (game|world)\\s*$");
+    if(!m_saveTimeout.isActive() || !saved.match(ServerLog::stripDecorations(line)).hasMatch())
+    {
+        return;
+    }
+    m_saveTimeout.stop();
+    disconnect(m_server.get(), &LaunchTask::lineLogged, this, &WorldBackupTask::serverLogged);
+    startBackup();
+}
+
+void WorldBackupTask::saveTimedOut()
+{
+    disconnect(m_server.get(), &LaunchTask::lineLogged, this, &WorldBackupTask::serverLogged);
+    resumeServerSaving();
+    releaseSnapshotId();
+    emitFailed(tr("The server did not report saving the world in time."));
+}
+
+void WorldBackupTask::startBackup()
+{
+    setStatus(tr("Backing up world..."));
+    m_progress = std::make_shared<ConcurrentProgress>();
+    connect(m_progress.get(), &ConcurrentProgress::progress, this, &WorldBackupTask::setProgress);
+    auto worldPath = m_worldPath;
+    auto store = m_store;
+    auto id = m_snapshotId;
+    auto progress = m_progress;
+    m_backupWatcher.setFuture(QtConcurrent::run(QThreadPool::globalInstance(), [worldPath, store, id, progress]()
+    {
+        return backupWorld(worldPath, store, id, progress.get());
+    }));
+}
+
+void WorldBackupTask::filesBackedUp()
+{
+    resumeServerSaving();
+    // saved or failed, the manifest is there or the ID is free again either way
+    releaseSnapshotId();
+    bool canceled = m_progress->isCanceled();
+    m_progress.reset();
+    if(canceled)
+    {
+        emitAborted();
+        return;
+    }
+    auto error = m_backupWatcher.result();
+    if(!error.isEmpty())
+    {
+        emitFailed(error);
+        return;
+    }
+    emitSucceeded();
+}
+
+void WorldBackupTask::resumeServerSaving()
+{
+    if(!m_serverSavingOff)
+    {
+        return;
+    }
+    m_serverSavingOff = false;
+    // the queue being full is no reason to leave the server not saving at all
+    if(m_server && m_server->isRunning() && !m_server->commands().send("save-on"))
+    {
+        m_server->writeToStdin("save-on\n");
+    }
+}
+
+void WorldBackupTask::releaseSnapshotId()
+{
+    if(!m_snapshotId.isEmpty())
+    {
+        m_store->releaseSnapshotId(QFileInfo(m_worldPath).fileName(), m_snapshotId);
+    }
+}
+
+bool WorldBackupTask::abort()
+{
+    if(m_saveTimeout.isActive())
+    {
+        m_saveTimeout.stop();
+        disconnect(m_server.get(), &LaunchTask::lineLogged, this, &WorldBackupTask::serverLogged);
+        resumeServerSaving();
+        releaseSnapshotId();
+        emitAborted();
+        return true;
+    }
+    if(m_progress)
+    {
+        m_progress->cancel();
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <QFutureWatcher>
+#include <QTimer>
+#include <memory>
+
+#include "tasks/Task.h"
+#include "launch/LaunchTask.h"
+#include "minecraft/backup/WorldBackupStore.h"
+
+#include "multiservermc_logic_export.h"
+
+class ConcurrentProgress;
+
+/**
+ * Makes a snapshot of a world folder in a WorldBackupStore.
+ *
+ * Only what changed since the last snapshot of the world is read again: files with the same
+ * size and modification time are taken over from the previous manifest, and of the files that
+ * did change, only the chunks and blocks that are not in the store yet are written.
+ *
+ * If the world belongs to a running server, the server is told to stop saving (save-off),
+ * flush everything to disk (save-all flush) and to start saving again (save-on) once the
+ * files are read, through the stdin of its launch.
+ */
+class MULTISERVERMC_LOGIC_EXPORT WorldBackupTask : public Task
+{
+    Q_OBJECT
+public:
+    WorldBackupTask(const QString &worldPath, WorldBackupStorePtr store, shared_qobject_ptr<LaunchTask> server = nullptr);
+    virtual ~WorldBackupTask();
+
+    /// ID of the snapshot that was made, once the task succeeded
+    QString snapshotId() const
+    {
+        return m_snapshotId;
+    }
+
+    bool canAbort() const override
+    {
+        return true;
+    }
+    bool abort() override;
+
+    /// How long to wait for the server to report that it saved the world
+    void setSaveTimeout(int msec)
+    {
+        m_saveTimeout.setInterval(msec);
+    }
+
+protected:
+    void executeTask() override;
+
+private slots:
+    void serverLogged(const QString &line, MessageLevel::Enum level);
+    void saveTimedOut();
+    void filesBackedUp();
+
+private:
+    void startBackup();
+    void resumeServerSaving();
+    void releaseSnapshotId();
+
+private:
+    QString m_worldPath;
+    WorldBackupStorePtr m_store;
+    shared_qobject_ptr<LaunchTask> m_server;
+    bool m_serverSavingOff = false;
+    QTimer m_saveTimeout;
+    std::shared_ptr<ConcurrentProgress> m_progress;
+    QFutureWatcher<QString> m_backupWatcher;
+    QString m_snapshotId;
+};
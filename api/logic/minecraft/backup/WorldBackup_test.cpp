@@ -0,0 +1,186 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QSignalSpy>
+#include <QDirIterator>
+#include <QtEndian>
+#include "TestUtil.h"
+
+#if defined Q_OS_WIN32
+    #include <sys/utime.h>
+#else
+    #include <utime.h>
+#endif
+
+#include "FileSystem.h"
+#include "minecraft/backup/WorldBackupStore.h"
+#include "minecraft/backup/WorldBackupTask.h"
+#include "minecraft/backup/WorldRestoreTask.h"
+
+/// Region file with one sector sized, zlib 'compressed' chunk per entry of contents
+static QByteArray makeRegion(const QList<QByteArray> &contents)
+{
+    QByteArray data(2 * 4096, '\0');
+    for(int i = 0; i < contents.size(); i++)
+    {
+        int sector = 2 + i;
+        uchar location[4];
+        qToBigEndian(quint32(sector << 8 | 1), location);
+        data.replace(i * 4, 4, (const char *)location, 4);
+
+        QByteArray chunk(4096, '\0');
+        uchar length[4];
+        qToBigEndian(quint32(contents[i].size() + 1), length);
+        chunk.replace(0, 4, (const char *)length, 4);
+        chunk[4] = 2;
+        chunk.replace(5, contents[i].size(), contents[i]);
+        data.append(chunk);
+    }
+    return data;
+}
+
+/// Unchanged files are recognized by size and modification time, set it instead of waiting for the clock
+static bool setModified(const QString &path, const QDateTime &time)
+{
+    struct utimbuf times;
+    times.actime = times.modtime = time.toTime_t();
+#if defined Q_OS_WIN32
+    return _wutime(path.toStdWString().c_str(), &times) == 0;
+#else
+    return utime(QFile::encodeName(path).constData(), &times) == 0;
+#endif
+}
+
+static int countObjects(const QString &storePath)
+{
+    int count = 0;
+    QDirIterator iter(FS::PathCombine(storePath, "objects"), QDir::Files, QDirIterator::Subdirectories);
+    while(iter.hasNext())
+    {
+        iter.next();
+        count++;
+    }
+    return count;
+}
+
+static bool runTask(Task &task)
+{
+    QSignalSpy spy(&task, &Task::finished);
+    task.start();
+    if(spy.isEmpty() && !spy.wait(10000))
+    {
+        return false;
+    }
+    return task.wasSuccessful();
+}
+
+class WorldBackupTest : public QObject
+{
+    Q_OBJECT
+
+private
+slots:
+    void test_backupAndRestore()
+    {
+        QTemporaryDir tempDir;
+        QString worldPath = FS::PathCombine(tempDir.path(), "saves", "world");
+        QString regionPath = FS::PathCombine(worldPath, "region", "r.0.0.mca");
+        QString storePath = FS::PathCombine(tempDir.path(), "backups");
+        FS::write(FS::PathCombine(worldPath, "level.dat"), "level");
+        FS::write(FS::PathCombine(worldPath, "session.lock"), "lock");
+        FS::write(regionPath, makeRegion({"first chunk", "second chunk", "third chunk"}));
+        FS::ensureFolderPathExists(FS::PathCombine(worldPath, "data"));
+        auto written = QDateTime::fromString("2020-01-01T12:00:00Z", Qt::ISODate);
+        QVERIFY(setModified(regionPath, written));
+
+        auto store = std::make_shared<WorldBackupStore>(storePath);
+        WorldBackupTask first(worldPath, store);
+        QVERIFY(runTask(first));
+        // level.dat, the region header and three chunks
+        QCOMPARE(countObjects(storePath), 5);
+
+        // one changed chunk, one new one
+        auto changed = makeRegion({"first chunk", "second chunk, changed", "third chunk", "fourth chunk"});
+        FS::write(regionPath, changed);
+        QVERIFY(setModified(regionPath, written.addSecs(60)));
+        WorldBackupTask second(worldPath, store);
+        QVERIFY(runTask(second));
+        QCOMPARE(countObjects(storePath), 5 + 3);
+        QCOMPARE(store->snapshots("world"), QStringList({first.snapshotId(), second.snapshotId()}));
+
+        BackupManifest manifest;
+        QVERIFY(store->loadSnapshot("world", second.snapshotId(), manifest));
+        QCOMPARE(manifest.files.size(), 2);
+
+        QString restoredPath = FS::PathCombine(tempDir.path(), "saves", "restored");
+        WorldRestoreTask restore(store, "world", first.snapshotId(), restoredPath);
+        QVERIFY(runTask(restore));
+        QCOMPARE(FS::read(FS::PathCombine(restoredPath, "region", "r.0.0.mca")), makeRegion({"first chunk", "second chunk", "third chunk"}));
+        QCOMPARE(FS::read(FS::PathCombine(restoredPath, "level.dat")), QByteArray("level"));
+        QVERIFY(QFileInfo(FS::PathCombine(restoredPath, "data")).isDir());
+        QVERIFY(!QFileInfo(FS::PathCombine(restoredPath, "session.lock")).exists());
+
+        // never over an existing world
+        WorldRestoreTask again(store, "world", second.snapshotId(), restoredPath);
+        QVERIFY(!runTask(again));
+
+        // dropping the first snapshot frees what only it used: its header and the old chunk
+        QVERIFY(store->removeSnapshot("world", first.snapshotId()));
+        QVERIFY(store->collectGarbage() > 0);
+        QCOMPARE(countObjects(storePath), 6);
+        QString latestPath = FS::PathCombine(tempDir.path(), "saves", "latest");
+        WorldRestoreTask latest(store, "world", second.snapshotId(), latestPath);
+        QVERIFY(runTask(latest));
+        QCOMPARE(FS::read(FS::PathCombine(latestPath, "region", "r.0.0.mca")), changed);
+    }
+
+    // several snapshots within the same millisecond must not overwrite each other
+    void test_uniqueSnapshotIds()
+    {
+        QTemporaryDir tempDir;
+        WorldBackupStore store(tempDir.path());
+        WorldBackupStore sameStore(tempDir.path());
+        QStringList ids;
+        for(int i = 0; i < 20; i++)
+        {
+            ids.append(store.newSnapshotId("world"));
+            ids.append(sameStore.newSnapshotId("world"));
+        }
+        QCOMPARE(ids.toSet().size(), ids.size());
+        auto sorted = ids;
+        sorted.sort();
+        QCOMPARE(sorted, ids);
+
+        // a saved snapshot is taken too
+        BackupManifest manifest;
+        manifest.id = QDateTime::currentDateTimeUtc().toString("yyyyMMdd-HHmmss-zzz");
+        QVERIFY(store.saveSnapshot("other", manifest));
+        QVERIFY(store.newSnapshotId("other") != manifest.id);
+    }
+
+    void test_corruptedObject()
+    {
+        QTemporaryDir tempDir;
+        QString worldPath = FS::PathCombine(tempDir.path(), "world");
+        QString storePath = FS::PathCombine(tempDir.path(), "backups");
+        FS::write(FS::PathCombine(worldPath, "level.dat"), "level");
+
+        auto store = std::make_shared<WorldBackupStore>(storePath);
+        WorldBackupTask backup(worldPath, store);
+        QVERIFY(runTask(backup));
+
+        auto hash = WorldBackupStore::hash("level");
+        QVERIFY(store->contains(hash));
+        auto hex = QString::fromLatin1(hash.toHex());
+        FS::write(FS::PathCombine(storePath, "objects", hex.left(2), hex.mid(2)), "Rlevel, but different");
+
+        QString restoredPath = FS::PathCombine(tempDir.path(), "restored");
+        WorldRestoreTask restore(store, "world", backup.snapshotId(), restoredPath);
+        QVERIFY(!runTask(restore));
+        QVERIFY(!QFileInfo(restoredPath).exists());
+        QVERIFY(!QFileInfo(FS::PathCombine(tempDir.path(), ".restored.restoring")).exists());
+    }
+};
+
+QTEST_GUILESS_MAIN(WorldBackupTest)
+
+#include "WorldBackup_test.moc"
@@ -0,0 +1,213 @@
+#include "WorldRestoreTask.h"
+
+#include <QDir>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QtConcurrentRun>
+#include <QThreadPool>
+#include <QDebug>
+#include <cstring>
+
+#include "FileSystem.h"
+#include "tasks/ConcurrentProgress.h"
+#include "tasks/ParallelJobs.h"
+
+namespace {
+
+const int sectorSize = 4096;
+
+bool restoreFile(const BackupManifest::File &file, const WorldBackupStore &store, const QString &path)
+{
+    QSaveFile output(path);
+    if(!output.open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+    if(file.region)
+    {
+        // a region is assembled in memory, it has at most 1024 chunks of 255 sectors after its header
+        if(file.size < 0 || file.size > qint64(2 + 1024 * 255) * sectorSize)
+        {
+            return false;
+        }
+        QByteArray header;
+        if(file.blocks.size() != 1 || !store.get(file.blocks.first(), header))
+        {
+            return false;
+        }
+        // chunks go back where they were, unused sectors are zeroed
+        QByteArray data(int(file.size), '\0');
+        memcpy(data.data(), header.constData(), qMin<qint64>(header.size(), data.size()));
+        for(auto & chunk: file.chunks)
+        {
+            QByteArray payload;
+            if(!store.get(chunk.hash, payload))
+            {
+                return false;
+            }
+            qint64 offset = qint64(chunk.sectorOffset) * sectorSize;
+            if(offset + payload.size() > data.size())
+            {
+                return false;
+            }
+            memcpy(data.data() + offset, payload.constData(), payload.size());
+        }
+        if(output.write(data) != data.size())
+        {
+            return false;
+        }
+    }
+    else
+    {
+        // other files are written block by block, they can be bigger than a QByteArray can hold
+        qint64 written = 0;
+        for(auto & hash: file.blocks)
+        {
+            QByteArray block;
+            if(!store.get(hash, block) || output.write(block) != block.size())
+            {
+                return false;
+            }
+            written += block.size();
+        }
+        if(written != file.size)
+        {
+            return false;
+        }
+    }
+    return output.commit();
+}
+
+QString restoreWorld(WorldBackupStorePtr store, const QString &worldFolder, const QString &id, const QString &targetPath, ConcurrentProgress *progress)
+{
+    BackupManifest manifest;
+    if(!store->loadSnapshot(worldFolder, id, manifest))
+    {
+        return QObject::tr("Could not read the backup %1 of %2.").arg(id, worldFolder);
+    }
+    QFileInfo target(targetPath);
+    if(target.exists())
+    {
+        return QObject::tr("%1 already exists.").arg(targetPath);
+    }
+
+    // assemble everything out of sight of the world list first
+    auto stagingPath = FS::PathCombine(target.absolutePath(), "." + target.fileName() + ".restoring");
+    if(QFileInfo(stagingPath).exists() && !FS::deletePath(stagingPath))
+    {
+        return QObject::tr("Could not remove the leftovers of an earlier restore in %1.").arg(stagingPath);
+    }
+    if(!FS::ensureFolderPathExists(stagingPath))
+    {
+        return QObject::tr("Could not create %1.").arg(stagingPath);
+    }
+    for(auto & directory: manifest.directories)
+    {
+        if(!FS::ensureFolderPathExists(FS::PathCombine(stagingPath, directory)))
+        {
+            return QObject::tr("Could not create %1.").arg(directory);
+        }
+    }
+
+    if(progress)
+    {
+        progress->setTotal(manifest.totalSize());
+    }
+    QMutex failureLock;
+    QString failedPath;
+    const auto & files = manifest.files;
+    bool ok = ParallelJobs::run(files.size(), [&](int i) -> bool
+    {
+        auto & file = files.at(i);
+        if(!restoreFile(file, *store, FS::PathCombine(stagingPath, file.path)))
+        {
+            QMutexLocker locker(&failureLock);
+            failedPath = file.path;
+            return false;
+        }
+        if(progress)
+        {
+            progress->addDone(file.size);
+        }
+        return true;
+    }, progress);
+
+    if(!ok || (progress && progress->isCanceled()))
+    {
+        FS::deletePath(stagingPath);
+        if(progress && progress->isCanceled())
+        {
+            return QObject::tr("Aborted.");
+        }
+        return QObject::tr("Could not restore %1, the backup is incomplete or damaged.").arg(failedPath);
+    }
+    if(!QDir().rename(stagingPath, targetPath))
+    {
+        FS::deletePath(stagingPath);
+        return QObject::tr("Could not move the restored world to %1.").arg(targetPath);
+    }
+    qDebug() << "Restored backup" << id << "of" << worldFolder << "to" << targetPath;
+    return QString();
+}
+
+}
+
+WorldRestoreTask::WorldRestoreTask(WorldBackupStorePtr store, const QString &worldFolder, const QString &snapshotId, const QString &targetPath)
+    : m_store(store), m_worldFolder(worldFolder), m_snapshotId(snapshotId), m_targetPath(targetPath)
+{
+    connect(&m_restoreWatcher, &QFutureWatcher<QString>::finished, this, &WorldRestoreTask::filesRestored);
+}
+
+WorldRestoreTask::~WorldRestoreTask()
+{
+    if(m_progress)
+    {
+        m_progress->cancel();
+    }
+    m_restoreWatcher.waitForFinished();
+}
+
+void WorldRestoreTask::executeTask()
+{
+    setStatus(tr("Restoring world..."));
+    m_progress = std::make_shared<ConcurrentProgress>();
+    connect(m_progress.get(), &ConcurrentProgress::progress, this, &WorldRestoreTask::setProgress);
+    auto store = m_store;
+    auto worldFolder = m_worldFolder;
+    auto id = m_snapshotId;
+    auto targetPath = m_targetPath;
+    auto progress = m_progress;
+    m_restoreWatcher.setFuture(QtConcurrent::run(QThreadPool::globalInstance(), [store, worldFolder, id, targetPath, progress]()
+    {
+        return restoreWorld(store, worldFolder, id, targetPath, progress.get());
+    }));
+}
+
+void WorldRestoreTask::filesRestored()
+{
+    bool canceled = m_progress->isCanceled();
+    m_progress.reset();
+    if(canceled)
+    {
+        emitAborted();
+        return;
+    }
+    auto error = m_restoreWatcher.result();
+    if(!error.isEmpty())
+    {
+        emitFailed(error);
+        return;
+    }
+    emitSucceeded();
+}
+
+bool WorldRestoreTask::abort()
+{
+    if(m_progress)
+    {
+        m_progress->cancel();
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QFutureWatcher>
+#include <memory>
+
+#include "tasks/Task.h"
+#include "minecraft/backup/WorldBackupStore.h"
+
+#include "multiservermc_logic_export.h"
+
+class ConcurrentProgress;
+
+/**
+ * Puts a world snapshot from a WorldBackupStore back together in a new folder.
+ *
+ * Files are rebuilt in parallel next to the target, in a hidden folder that is only renamed
+ * to the target once everything was restored and checked against the stored hashes.
+ */
+class MULTISERVERMC_LOGIC_EXPORT WorldRestoreTask : public Task
+{
+    Q_OBJECT
+public:
+    WorldRestoreTask(WorldBackupStorePtr store, const QString &worldFolder, const QString &snapshotId, const QString &targetPath);
+    virtual ~WorldRestoreTask();
+
+    bool canAbort() const override
+    {
+        return true;
+    }
+    bool abort() override;
+
+protected:
+    void executeTask() override;
+
+private slots:
+    void filesRestored();
+
+private:
+    WorldBackupStorePtr m_store;
+    QString m_worldFolder;
+    QString m_snapshotId;
+    QString m_targetPath;
+    std::shared_ptr<ConcurrentProgress> m_progress;
+    QFutureWatcher<QString> m_restoreWatcher;
+};
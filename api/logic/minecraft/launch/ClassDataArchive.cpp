@@ -0,0 +1,191 @@
+#include "ClassDataArchive.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonObject>
+#include <QDebug>
+
+#include "launch/LaunchTask.h"
+#include "ServerLog.h"
+#include "java/JavaVersion.h"
+#include "Exception.h"
+#include "FileSystem.h"
+#include "Json.h"
+
+ClassDataArchive::ClassDataArchive(const QString &directory, const QStringList &watchedFolders, QObject *parent)
+    : QObject(parent), m_directory(directory), m_watchedFolders(watchedFolders)
+{
+}
+
+QString ClassDataArchive::archivePath() const
+{
+    return FS::PathCombine(m_directory, "server.jsa");
+}
+
+QString ClassDataArchive::statePath() const
+{
+    return FS::PathCombine(m_directory, "state.json");
+}
+
+bool ClassDataArchive::supported(const QString &javaVersion)
+{
+    JavaVersion version(javaVersion);
+    return version.major() >= 13;
+}
+
+QString ClassDataArchive::fingerprint(const QString &javaPath, const QString &javaVersion, const QStringList &files)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(javaPath.toUtf8());
+    hash.addData("\n");
+    hash.addData(javaVersion.toUtf8());
+    hash.addData("\n");
+    for(auto & file: files)
+    {
+        // the contents would be better, but reading hundreds of megabytes on every launch would eat what the archive saves
+        QFileInfo info(file);
+        hash.addData(QString("%1 %2 %3\n").arg(info.absoluteFilePath()).arg(info.size()).arg(info.lastModified().toMSecsSinceEpoch()).toUtf8());
+    }
+    return hash.result().toHex();
+}
+
+QStringList ClassDataArchive::javaArguments(const QString &javaPath, const QString &javaVersion, const QStringList &jvmArgs,
+                                            const QStringList &classPath)
+{
+    m_mode = Off;
+    m_startupSeen = false;
+    if(!supported(javaVersion))
+    {
+        m_description = tr("Not using a class data archive, Java %1 can't create one. It needs Java 13 or newer.").arg(javaVersion);
+        return {};
+    }
+    for(auto & arg: jvmArgs)
+    {
+        if(arg.startsWith("-Xshare") || arg.startsWith("-XX:SharedArchiveFile") || arg.startsWith("-XX:ArchiveClassesAtExit")
+            || arg.contains("AutoCreateSharedArchive"))
+        {
+            m_description = tr("Not using a class data archive, the JVM arguments already set up class data sharing.");
+            return {};
+        }
+    }
+    QStringList files;
+    for(auto & entry: classPath)
+    {
+        // the JVM refuses to archive classes loaded from directories
+        if(QFileInfo(entry).isDir())
+        {
+            m_description = tr("Not using a class data archive, the class path contains the folder %1.").arg(entry);
+            return {};
+        }
+        files.append(entry);
+    }
+    for(auto & folder: m_watchedFolders)
+    {
+        for(auto & info: QDir(folder).entryInfoList(QDir::Files, QDir::Name))
+        {
+            files.append(info.absoluteFilePath());
+        }
+    }
+    m_fingerprint = fingerprint(javaPath, javaVersion, files);
+
+    QString trainedFingerprint;
+    m_trainedStartup = 0;
+    try
+    {
+        if(QFileInfo::exists(statePath()))
+        {
+            auto state = Json::requireObject(Json::requireDocument(statePath(), "Class data archive state"));
+            trainedFingerprint = Json::ensureString(state, "fingerprint");
+            m_trainedStartup = Json::ensureDouble(state, "trainedStartup", 0);
+        }
+    }
+    catch(const Exception &e)
+    {
+        qWarning() << "Couldn't read the class data archive state:" << e.cause();
+    }
+
+    if(trainedFingerprint == m_fingerprint && QFileInfo::exists(archivePath()))
+    {
+        m_mode = Using;
+        m_description = tr("Using the class data archive %1.").arg(archivePath());
+        return {"-XX:SharedArchiveFile=" + archivePath()};
+    }
+
+    // stale or missing, the training run writes a new one when the server stops
+    if(!trainedFingerprint.isEmpty() && trainedFingerprint != m_fingerprint)
+    {
+        m_description = tr("The class path, the mods or Java changed since the class data archive was made. "
+                           "This run trains a new one, it is written when the server stops.");
+    }
+    else
+    {
+        m_description = tr("This run trains a class data archive, it is written when the server stops.");
+    }
+    QFile::remove(archivePath());
+    m_trainedStartup = 0;
+    try
+    {
+        FS::ensureFolderPathExists(m_directory);
+        QJsonObject state;
+        state.insert("fingerprint", m_fingerprint);
+        Json::write(state, statePath());
+    }
+    catch(const Exception &e)
+    {
+        m_description = tr("Not using a class data archive, its state couldn't be saved: %1").arg(e.cause());
+        return {};
+    }
+    m_mode = Training;
+    return {"-XX:ArchiveClassesAtExit=" + archivePath()};
+}
+
+void ClassDataArchive::attach(LaunchTask *task)
+{
+    connect(task, &LaunchTask::lineLogged, this, &ClassDataArchive::lineLogged);
+}
+
+void ClassDataArchive::lineLogged(const QString &line)
+{
+    double seconds = 0;
+    if(m_mode == Off || m_startupSeen || !ServerLog::parseDone(line, seconds))
+    {
+        return;
+    }
+    m_startupSeen = true;
+    auto task = qobject_cast<LaunchTask *>(sender());
+    if(m_mode == Training)
+    {
+        m_trainedStartup = seconds;
+        try
+        {
+            QJsonObject state;
+            state.insert("fingerprint", m_fingerprint);
+            state.insert("trainedStartup", seconds);
+            Json::write(state, statePath());
+        }
+        catch(const Exception &e)
+        {
+            qWarning() << "Couldn't save the class data archive state:" << e.cause();
+        }
+        if(task)
+        {
+            task->onLogLine(tr("Startup took %1 s without the class data archive.").arg(seconds, 0, 'f', 3), MessageLevel::MultiServerMC);
+        }
+        return;
+    }
+    if(!task)
+    {
+        return;
+    }
+    if(m_trainedStartup > 0)
+    {
+        task->onLogLine(tr("Startup took %1 s with the class data archive, %2 s less than the %3 s of the training run.")
+                            .arg(seconds, 0, 'f', 3).arg(m_trainedStartup - seconds, 0, 'f', 3).arg(m_trainedStartup, 0, 'f', 3),
+                        MessageLevel::MultiServerMC);
+    }
+    else
+    {
+        task->onLogLine(tr("Startup took %1 s with the class data archive.").arg(seconds, 0, 'f', 3), MessageLevel::MultiServerMC);
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+#include "multiservermc_logic_export.h"
+
+class LaunchTask;
+
+/**
+ * A dynamic AppCDS archive of the classes a server loads, kept in a folder of the instance.
+ *
+ * The first launch is a training run with -XX:ArchiveClassesAtExit and the JVM writes the archive
+ * when the server stops. Later launches map it with -XX:SharedArchiveFile instead of loading and
+ * verifying all those classes again. An archive only fits the class path, mods and JVM it was made
+ * with, so once their fingerprint changes it is deleted and the next launch trains a new one.
+ *
+ * The startup time of the training run is remembered, so launches using the archive can report
+ * how much time it saved.
+ */
+class MULTISERVERMC_LOGIC_EXPORT ClassDataArchive : public QObject
+{
+    Q_OBJECT
+public:
+    enum Mode
+    {
+        /// the JVM can't do it, or the user already handles class data sharing
+        Off,
+        Training,
+        Using
+    };
+
+    /// watchedFolders are searched for files that change what the server loads, like the mods folder
+    explicit ClassDataArchive(const QString &directory, const QStringList &watchedFolders, QObject *parent = nullptr);
+
+    /// decides between training and using the archive, returns the JVM arguments for that
+    QStringList javaArguments(const QString &javaPath, const QString &javaVersion, const QStringList &jvmArgs,
+                              const QStringList &classPath);
+    Mode mode() const
+    {
+        return m_mode;
+    }
+    /// what javaArguments() decided and why, for the log
+    QString describe() const
+    {
+        return m_description;
+    }
+
+    /// listen for the server reporting its startup time
+    void attach(LaunchTask *task);
+
+    QString archivePath() const;
+    QString statePath() const;
+
+    /// dynamic archives need Java 13 or newer
+    static bool supported(const QString &javaVersion);
+    /// hash of the JVM and the paths, sizes and modification times of the files
+    static QString fingerprint(const QString &javaPath, const QString &javaVersion, const QStringList &files);
+
+private slots:
+    void lineLogged(const QString &line);
+
+private:
+    QString m_directory;
+    QStringList m_watchedFolders;
+    Mode m_mode = Off;
+    QString m_description;
+    QString m_fingerprint;
+    /// seconds the training run took to start, 0 when unknown
+    double m_trainedStartup = 0;
+    bool m_startupSeen = false;
+};
@@ -0,0 +1,88 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QFileInfo>
+#include "TestUtil.h"
+
+#include "minecraft/launch/ClassDataArchive.h"
+#include "FileSystem.h"
+
+class ClassDataArchiveTest : public QObject
+{
+    Q_OBJECT
+private
+slots:
+    void test_supported()
+    {
+        QVERIFY(!ClassDataArchive::supported("1.8.0_292"));
+        QVERIFY(!ClassDataArchive::supported("11.0.12"));
+        QVERIFY(ClassDataArchive::supported("13"));
+        QVERIFY(ClassDataArchive::supported("17.0.2"));
+        QVERIFY(!ClassDataArchive::supported(""));
+    }
+
+    void test_trainThenUse()
+    {
+        QTemporaryDir tempDir;
+        QVERIFY(tempDir.isValid());
+        auto jar = FS::PathCombine(tempDir.path(), "server.jar");
+        auto mods = FS::PathCombine(tempDir.path(), "mods");
+        FS::write(jar, "server");
+        QVERIFY(FS::ensureFolderPathExists(mods));
+        FS::write(FS::PathCombine(mods, "a.jar"), "a");
+
+        ClassDataArchive archive(FS::PathCombine(tempDir.path(), "cds"), {mods});
+        auto args = archive.javaArguments("/usr/bin/java", "17.0.2", {"-Xmx2G"}, {jar});
+        QCOMPARE(archive.mode(), ClassDataArchive::Training);
+        QCOMPARE(args, QStringList{"-XX:ArchiveClassesAtExit=" + archive.archivePath()});
+
+        // the training run didn't get to write it, so it trains again
+        archive.javaArguments("/usr/bin/java", "17.0.2", {"-Xmx2G"}, {jar});
+        QCOMPARE(archive.mode(), ClassDataArchive::Training);
+
+        // written when the server stopped
+        FS::write(archive.archivePath(), "archive");
+        args = archive.javaArguments("/usr/bin/java", "17.0.2", {"-Xmx2G"}, {jar});
+        QCOMPARE(archive.mode(), ClassDataArchive::Using);
+        QCOMPARE(args, QStringList{"-XX:SharedArchiveFile=" + archive.archivePath()});
+
+        // a new mod makes it stale
+        FS::write(FS::PathCombine(mods, "b.jar"), "b");
+        archive.javaArguments("/usr/bin/java", "17.0.2", {"-Xmx2G"}, {jar});
+        QCOMPARE(archive.mode(), ClassDataArchive::Training);
+        QVERIFY(!QFileInfo::exists(archive.archivePath()));
+    }
+
+    void test_javaChanges()
+    {
+        QTemporaryDir tempDir;
+        QVERIFY(tempDir.isValid());
+        auto jar = FS::PathCombine(tempDir.path(), "server.jar");
+        FS::write(jar, "server");
+
+        ClassDataArchive archive(FS::PathCombine(tempDir.path(), "cds"), {});
+        archive.javaArguments("/usr/bin/java", "17.0.2", {}, {jar});
+        FS::write(archive.archivePath(), "archive");
+        archive.javaArguments("/usr/bin/java", "17.0.3", {}, {jar});
+        QCOMPARE(archive.mode(), ClassDataArchive::Training);
+    }
+
+    void test_off()
+    {
+        QTemporaryDir tempDir;
+        QVERIFY(tempDir.isValid());
+        auto jar = FS::PathCombine(tempDir.path(), "server.jar");
+        FS::write(jar, "server");
+
+        ClassDataArchive archive(FS::PathCombine(tempDir.path(), "cds"), {});
+        QVERIFY(archive.javaArguments("/usr/bin/java", "1.8.0_292", {}, {jar}).isEmpty());
+        QCOMPARE(archive.mode(), ClassDataArchive::Off);
+        QVERIFY(archive.javaArguments("/usr/bin/java", "17.0.2", {"-Xshare:off"}, {jar}).isEmpty());
+        QCOMPARE(archive.mode(), ClassDataArchive::Off);
+        QVERIFY(archive.javaArguments("/usr/bin/java", "17.0.2", {}, {jar, tempDir.path()}).isEmpty());
+        QCOMPARE(archive.mode(), ClassDataArchive::Off);
+    }
+};
+
+QTEST_GUILESS_MAIN(ClassDataArchiveTest)
+
+#include "ClassDataArchive_test.moc"
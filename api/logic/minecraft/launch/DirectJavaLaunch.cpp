@@ -24,39 +24,56 @@ DirectJavaLaunch::DirectJavaLaunch(LaunchTask *parent) : LaunchStep(parent)
 {
     connect(&m_process, &LoggedProcess::log, this, &DirectJavaLaunch::logLines);
     connect(&m_process, &LoggedProcess::stateChanged, this, &DirectJavaLaunch::on_state);
+    connect(this, &LaunchStep::stdinWrittenTo, &m_process, &LoggedProcess::writeToStdin);
 }
 
 void DirectJavaLaunch::executeTask()
 {
     auto instance = m_parent->instance();
     std::shared_ptr<MinecraftInstance> minecraftInstance = std::dynamic_pointer_cast<MinecraftInstance>(instance);
-    QStringList args = minecraftInstance->javaArguments();
+    m_processStarted = false;
+    auto plan = minecraftInstance->launchPlan(m_serverPort);
+    if(!plan)
+    {
+        const char *reason = QT_TR_NOOP("Couldn't apply the version profile of the instance.");
+        emit logLine(reason, MessageLevel::Fatal);
+        emitFailed(tr(reason));
+        return;
+    }
+    QStringList args = plan->javaArguments;
+    if(m_classDataArchive)
+    {
+        auto javaVersion = instance->settings()->get("JavaVersion").toString();
+        args.append(m_classDataArchive->javaArguments(plan->javaPath, javaVersion, plan->javaArguments, plan->classPath));
+        emit logLine(m_classDataArchive->describe() + "\n\n", MessageLevel::MultiServerMC);
+    }
 
-    args.append("-Djava.library.path=" + minecraftInstance->getNativePath());
+    args.append("-Djava.library.path=" + plan->nativePath);
 
-    auto classPathEntries = minecraftInstance->getClassPath();
     args.append("-cp");
     QString classpath;
 #ifdef Q_OS_WIN32
-    classpath = classPathEntries.join(';');
+    classpath = plan->classPath.join(';');
 #else
-    classpath = classPathEntries.join(':');
+    classpath = plan->classPath.join(':');
 #endif
     args.append(classpath);
-    args.append(minecraftInstance->getMainClass());
+    args.append(plan->mainClass);
 
     QString allArgs = args.join(", ");
     emit logLine("Java Arguments:\n[" + m_parent->censorPrivateInfo(allArgs) + "]\n\n", MessageLevel::MultiServerMC);
 
-    auto javaPath = FS::ResolveExecutable(instance->settings()->get("JavaPath").toString());
+    auto javaPath = plan->javaPath;
 
-    m_process.setProcessEnvironment(instance->createEnvironment());
+    m_process.setProcessEnvironment(plan->environment);
 
     // make detachable - this will keep the process running even if the object is destroyed
     m_process.setDetachable(true);
 
-    auto mcArgs = minecraftInstance->processMinecraftArgs(m_serverPort);
-    args.append(mcArgs);
+    auto cgroup = m_parent->cgroup();
+    m_process.setCGroupProcsPath(cgroup ? cgroup->procsPath() : QString());
+
+    args.append(plan->minecraftArguments);
 
     QString wrapperCommandStr = instance->getWrapperCommand().trimmed();
     if(!wrapperCommandStr.isEmpty())
@@ -105,7 +122,7 @@ void DirectJavaLaunch::on_state(LoggedProcess::State state)
             m_parent->setPid(-1);
             // if the exit code wasn't 0, report this as a crash
             auto exitCode = m_process.exitCode();
-            if(exitCode != 0)
+            if(exitCode != 0 && !m_process.stopRequested())
             {
                 emitFailed(tr("Game crashed."));
                 return;
@@ -118,6 +135,7 @@ void DirectJavaLaunch::on_state(LoggedProcess::State state)
         }
         case LoggedProcess::Running:
             emit logLine(QString("Minecraft process ID: %1\n\n").arg(m_process.processId()), MessageLevel::MultiServerMC);
+            m_processStarted = true;
             m_parent->setPid(m_process.processId());
             m_parent->instance()->setLastLaunch();
             break;
@@ -139,7 +157,13 @@ void DirectJavaLaunch::proceed()
 bool DirectJavaLaunch::abort()
 {
     auto state = m_process.state();
-    if (state == LoggedProcess::Running || state == LoggedProcess::Starting)
+    if (state == LoggedProcess::Running)
+    {
+        // let the server save its worlds
+        auto timeout = m_parent->instance()->settings()->get("StopTimeout").toInt();
+        m_process.stop("stop\n", timeout * 1000);
+    }
+    else if (state == LoggedProcess::Starting)
     {
         m_process.kill();
     }
@@ -19,6 +19,9 @@
 #include <LoggedProcess.h>
 
 #include "MinecraftServerTarget.h"
+#include "ClassDataArchive.h"
+
+#include <memory>
 
 class DirectJavaLaunch: public LaunchStep
 {
@@ -34,6 +37,10 @@ public:
     {
         return true;
     }
+    bool canRestart() const override
+    {
+        return m_processStarted;
+    }
     void setWorkingDirectory(const QString &wd);
 
     void setServerPort(int serverPort)
@@ -41,6 +48,12 @@ public:
         m_serverPort = std::move(serverPort);
     }
 
+    /// train or use a class data archive, nullptr to launch without one
+    void setClassDataArchive(std::shared_ptr<ClassDataArchive> archive)
+    {
+        m_classDataArchive = archive;
+    }
+
 private slots:
     void on_state(LoggedProcess::State state);
 
@@ -48,5 +61,7 @@ private:
     LoggedProcess m_process;
     QString m_command;
     int m_serverPort;
+    std::shared_ptr<ClassDataArchive> m_classDataArchive;
+    bool m_processStarted = false;
 };
 
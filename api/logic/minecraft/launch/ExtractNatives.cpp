@@ -77,7 +77,13 @@ void ExtractNatives::executeTask()
 {
     auto instance = m_parent->instance();
     std::shared_ptr<MinecraftInstance> minecraftInstance = std::dynamic_pointer_cast<MinecraftInstance>(instance);
-    auto toExtract = minecraftInstance->getNativeJars();
+    auto plan = minecraftInstance->launchPlan(m_serverPort);
+    if(!plan)
+    {
+        emitFailed(tr("Couldn't apply the version profile of the instance."));
+        return;
+    }
+    auto toExtract = plan->nativeJars;
     if(toExtract.isEmpty())
     {
         emitSucceeded();
@@ -87,7 +93,7 @@ void ExtractNatives::executeTask()
     bool nativeOpenAL = settings->get("UseNativeOpenAL").toBool();
     bool nativeGLFW = settings->get("UseNativeGLFW").toBool();
 
-    auto outputPath  = minecraftInstance->getNativePath();
+    auto outputPath  = plan->nativePath;
     auto javaVersion = minecraftInstance->getJavaVersion();
     bool jniHackEnabled = javaVersion.major() >= 8;
     for(const auto &source: toExtract)
@@ -23,7 +23,7 @@ class ExtractNatives: public LaunchStep
 {
     Q_OBJECT
 public:
-    explicit ExtractNatives(LaunchTask *parent) : LaunchStep(parent){};
+    explicit ExtractNatives(LaunchTask *parent, int serverPort) : LaunchStep(parent), m_serverPort(serverPort) {};
     virtual ~ExtractNatives(){};
 
     void executeTask() override;
@@ -32,6 +32,9 @@ public:
         return false;
     }
     void finalize() override;
+
+private:
+    int m_serverPort;
 };
 
 
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QMap>
+#include <QProcessEnvironment>
+#include <memory>
+
+class LaunchProfile;
+
+/**
+ * Everything needed to start the server process of an instance, computed once.
+ *
+ * MinecraftInstance keeps the last plan until its components, its settings, the global settings
+ * or the game folder change, so repeated launches of the same instance skip the library walk.
+ */
+struct LaunchPlan
+{
+    /// the launch profile the plan was made from, a new profile means a new plan
+    std::shared_ptr<LaunchProfile> profile;
+    QString gameRoot;
+    int serverPort = 0;
+
+    QString javaPath;
+    /// JVM arguments, without the library path and class path
+    QStringList javaArguments;
+    QStringList classPath;
+    QStringList nativeJars;
+    QString nativePath;
+    QString mainClass;
+    QStringList minecraftArguments;
+    /// script for the launcher part, see LauncherPartLaunch
+    QString launchScript;
+    QMap<QString, QString> variables;
+    QProcessEnvironment environment;
+};
@@ -0,0 +1,112 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include "TestUtil.h"
+
+#include "FileSystem.h"
+#include "minecraft/MinecraftInstance.h"
+#include "minecraft/PackProfile.h"
+#include "settings/INISettingsObject.h"
+
+class LaunchPlanTest : public QObject
+{
+    Q_OBJECT
+
+    /// the global settings a MinecraftInstance overrides or passes through
+    SettingsObjectPtr makeGlobalSettings(const QString &path)
+    {
+        auto settings = std::make_shared<INISettingsObject>(FS::PathCombine(path, "global.cfg"));
+        settings->registerSetting("PreLaunchCommand", "");
+        settings->registerSetting("WrapperCommand", "");
+        settings->registerSetting("PostExitCommand", "");
+        settings->registerSetting("ShowConsole", false);
+        settings->registerSetting("AutoCloseConsole", false);
+        settings->registerSetting("ShowConsoleOnError", true);
+        settings->registerSetting("LogPrePostOutput", true);
+        settings->registerSetting("ConsoleMaxLines", 100000);
+        settings->registerSetting("ConsoleOverflowStop", true);
+        settings->registerSetting("JavaPath", "/opt/java-a/bin/java");
+        settings->registerSetting("JvmArgs", "");
+        settings->registerSetting("JavaTimestamp", 0);
+        settings->registerSetting("JavaVersion", "17.0.2");
+        settings->registerSetting("JavaArchitecture", "64");
+        settings->registerSetting("LaunchMaximized", false);
+        settings->registerSetting("MinecraftWinWidth", 854);
+        settings->registerSetting("MinecraftWinHeight", 480);
+        settings->registerSetting("MinMemAlloc", 512);
+        settings->registerSetting("MaxMemAlloc", 1024);
+        settings->registerSetting("PermGen", 128);
+        settings->registerSetting("MCLaunchMethod", "LauncherPart");
+        settings->registerSetting("UseNativeOpenAL", false);
+        settings->registerSetting("UseNativeGLFW", false);
+        settings->registerSetting("ShowGameTime", true);
+        settings->registerSetting("RecordGameTime", true);
+        return settings;
+    }
+
+private
+slots:
+    void test_cached()
+    {
+        QTemporaryDir tempDir;
+        auto instDir = FS::PathCombine(tempDir.path(), "inst");
+        MinecraftInstance instance(makeGlobalSettings(tempDir.path()),
+                                   std::make_shared<INISettingsObject>(FS::PathCombine(instDir, "instance.cfg")), instDir);
+
+        auto plan = instance.launchPlan(25565);
+        QVERIFY(plan != nullptr);
+        QVERIFY(instance.launchPlan(25565) == plan);
+
+        // bookkeeping doesn't change how the server starts
+        instance.settings()->set("totalTimePlayed", 1234);
+        instance.settings()->set("lastLaunchTime", 5678);
+        instance.settings()->set("notes", "a note");
+        QVERIFY(instance.launchPlan(25565) == plan);
+
+        // another port is another plan
+        QVERIFY(instance.launchPlan(25566) != plan);
+    }
+
+    void test_invalidated()
+    {
+        QTemporaryDir tempDir;
+        auto instDir = FS::PathCombine(tempDir.path(), "inst");
+        auto globalSettings = makeGlobalSettings(tempDir.path());
+        MinecraftInstance instance(globalSettings, std::make_shared<INISettingsObject>(FS::PathCombine(instDir, "instance.cfg")),
+                                   instDir);
+
+        // a setting of the instance
+        auto plan = instance.launchPlan(25565);
+        QVERIFY(plan->javaArguments.contains("-Xmx1024m"));
+        instance.settings()->set("OverrideMemory", true);
+        instance.settings()->set("MaxMemAlloc", 2048);
+        auto next = instance.launchPlan(25565);
+        QVERIFY(next != plan);
+        QVERIFY(next->javaArguments.contains("-Xmx2048m"));
+
+        // the global java path, and the java path of the instance overriding it
+        plan = next;
+        QCOMPARE(plan->variables.value("INST_JAVA"), QString("/opt/java-a/bin/java"));
+        globalSettings->set("JavaPath", "/opt/java-b/bin/java");
+        next = instance.launchPlan(25565);
+        QVERIFY(next != plan);
+        QCOMPARE(next->variables.value("INST_JAVA"), QString("/opt/java-b/bin/java"));
+        plan = next;
+        instance.settings()->set("OverrideJavaLocation", true);
+        instance.settings()->set("JavaPath", "/opt/java-c/bin/java");
+        next = instance.launchPlan(25565);
+        QVERIFY(next != plan);
+        QCOMPARE(next->variables.value("INST_JAVA"), QString("/opt/java-c/bin/java"));
+
+        // the components, they make a new launch profile
+        plan = next;
+        QVERIFY(instance.getPackProfile()->installEmpty("org.multiservermc.test", "Test"));
+        next = instance.launchPlan(25565);
+        QVERIFY(next != plan);
+        QVERIFY(next->profile != plan->profile);
+        QVERIFY(instance.launchPlan(25565) == next);
+    }
+};
+
+QTEST_GUILESS_MAIN(LaunchPlanTest)
+
+#include "LaunchPlan_test.moc"
@@ -59,23 +59,41 @@ void LauncherPartLaunch::executeTask()
 {
     auto instance = m_parent->instance();
     std::shared_ptr<MinecraftInstance> minecraftInstance = std::dynamic_pointer_cast<MinecraftInstance>(instance);
+    m_processStarted = false;
 
-    m_launchScript = minecraftInstance->createLaunchScript(m_serverPort);
-    QStringList args = minecraftInstance->javaArguments();
+    auto plan = minecraftInstance->launchPlan(m_serverPort);
+    if(!plan)
+    {
+        const char *reason = QT_TR_NOOP("Couldn't apply the version profile of the instance.");
+        emit logLine(reason, MessageLevel::Fatal);
+        emitFailed(tr(reason));
+        return;
+    }
+    m_launchScript = plan->launchScript;
+    auto classPath = plan->classPath;
+    classPath.prepend(FS::PathCombine(ENV.getJarsPath(), "NewLaunch.jar"));
+
+    QStringList args = plan->javaArguments;
+    if(m_classDataArchive)
+    {
+        auto javaVersion = instance->settings()->get("JavaVersion").toString();
+        args.append(m_classDataArchive->javaArguments(plan->javaPath, javaVersion, plan->javaArguments, classPath));
+        emit logLine(m_classDataArchive->describe() + "\n\n", MessageLevel::MultiServerMC);
+    }
     QString allArgs = args.join(", ");
     emit logLine("Java Arguments:\n[" + m_parent->censorPrivateInfo(allArgs) + "]\n\n", MessageLevel::MultiServerMC);
 
-    auto javaPath = FS::ResolveExecutable(instance->settings()->get("JavaPath").toString());
+    auto javaPath = plan->javaPath;
 
-    m_process.setProcessEnvironment(instance->createEnvironment());
+    m_process.setProcessEnvironment(plan->environment);
 
     // make detachable - this will keep the process running even if the object is destroyed
     m_process.setDetachable(true);
 
-    auto classPath = minecraftInstance->getClassPath();
-    classPath.prepend(FS::PathCombine(ENV.getJarsPath(), "NewLaunch.jar"));
+    auto cgroup = m_parent->cgroup();
+    m_process.setCGroupProcsPath(cgroup ? cgroup->procsPath() : QString());
 
-    auto natPath = minecraftInstance->getNativePath();
+    auto natPath = plan->nativePath;
 #ifdef Q_OS_WIN
     if (!fitsInLocal8bit(natPath))
     {
@@ -158,7 +176,7 @@ void LauncherPartLaunch::on_state(LoggedProcess::State state)
             m_parent->setPid(-1);
             // if the exit code wasn't 0, report this as a crash
             auto exitCode = m_process.exitCode();
-            if(exitCode != 0)
+            if(exitCode != 0 && !m_process.stopRequested())
             {
                 emitFailed(tr("Game crashed."));
                 return;
@@ -171,6 +189,7 @@ void LauncherPartLaunch::on_state(LoggedProcess::State state)
         }
         case LoggedProcess::Running:
             emit logLine(QString("Minecraft process ID: %1\n\n").arg(m_process.processId()), MessageLevel::MultiServerMC);
+            m_processStarted = true;
             m_parent->setPid(m_process.processId());
             m_parent->instance()->setLastLaunch();
             // send the launch script to the launcher part
@@ -210,7 +229,13 @@ bool LauncherPartLaunch::abort()
     else
     {
         auto state = m_process.state();
-        if (state == LoggedProcess::Running || state == LoggedProcess::Starting)
+        if (state == LoggedProcess::Running)
+        {
+            // let the server save its worlds
+            auto timeout = m_parent->instance()->settings()->get("StopTimeout").toInt();
+            m_process.stop("stop\n", timeout * 1000);
+        }
+        else if (state == LoggedProcess::Starting)
         {
             m_process.kill();
         }
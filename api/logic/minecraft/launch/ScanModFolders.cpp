@@ -21,6 +21,8 @@
 #include "minecraft/MinecraftInstance.h"
 #include "minecraft/mod/ModFolderModel.h"
 
+#include <QtConcurrentRun>
+
 void ScanModFolders::executeTask()
 {
     auto m_inst = std::dynamic_pointer_cast<MinecraftInstance>(m_parent->instance());
@@ -54,6 +56,40 @@ void ScanModFolders::coreModsDone()
 void ScanModFolders::checkDone()
 {
     if(m_modsDone && m_coreModsDone) {
+        findConflicts();
+    }
+}
+
+void ScanModFolders::findConflicts()
+{
+    if(m_conflictsStarted) {
+        return;
+    }
+    m_conflictsStarted = true;
+
+    auto m_inst = std::dynamic_pointer_cast<MinecraftInstance>(m_parent->instance());
+    m_conflictIndex = std::make_shared<ModConflictIndex>();
+    m_conflictIndex->addMods("mods", m_inst->loaderModList()->allMods());
+    m_conflictIndex->addMods("coremods", m_inst->coreModList()->allMods());
+    if(m_conflictIndex->entries().isEmpty()) {
         emitSucceeded();
+        return;
+    }
+
+    auto index = m_conflictIndex;
+    m_conflictFuture = QtConcurrent::run(QThreadPool::globalInstance(), [index]() {
+        return index->findConflicts();
+    });
+    connect(&m_conflictFutureWatcher, &QFutureWatcher<QList<ModConflict>>::finished, this, &ScanModFolders::conflictsDone);
+    m_conflictFutureWatcher.setFuture(m_conflictFuture);
+}
+
+void ScanModFolders::conflictsDone()
+{
+    auto conflicts = m_conflictFuture.result();
+    for(auto & conflict: conflicts) {
+        emit logLine(conflict.describe(), conflict.isSevere() ? MessageLevel::Warning : MessageLevel::MultiServerMC);
     }
+    m_conflictIndex.reset();
+    emitSucceeded();
 }
@@ -16,8 +16,11 @@
 #pragma once
 
 #include <launch/LaunchStep.h>
+#include <QFutureWatcher>
 #include <memory>
 
+#include "minecraft/mod/ModConflictIndex.h"
+
 class ScanModFolders: public LaunchStep
 {
     Q_OBJECT
@@ -33,10 +36,16 @@ public:
 private slots:
     void coreModsDone();
     void modsDone();
+    void conflictsDone();
 private:
     void checkDone();
+    void findConflicts();
 
 private: // DATA
     bool m_modsDone = false;
     bool m_coreModsDone = false;
+    bool m_conflictsStarted = false;
+    std::shared_ptr<ModConflictIndex> m_conflictIndex;
+    QFuture<QList<ModConflict>> m_conflictFuture;
+    QFutureWatcher<QList<ModConflict>> m_conflictFutureWatcher;
 };
@@ -0,0 +1,34 @@
+#include "ServerLog.h"
+
+#include <QRegularExpression>
+
+QString ServerLog::stripDecorations(const QString &line)
+{
+    static const QRegularExpression colors("\x1b\\[[0-9;]*m");
+    static const QRegularExpression prefix("^(?:(?:\\[[^\\]]*\\] )*\\[[^\\]]*\\]: |\\d{4}-\\d\\d-\\d\\d \\d\\d:\\d\\d:\\d\\d \\[[A-Z]+\\] )");
+    QString stripped = line;
+    stripped.remove(colors);
+    stripped.remove(prefix);
+    return stripped;
+}
+
+bool ServerLog::parseDone(const QString &line, double &seconds)
+{
+    // old servers print nanoseconds, and some locales use a decimal comma
+    static const QRegularExpression doneRe("^Done \\((\\d+(?:[.,]\\d+)?)(n?s)\\)!");
+    if(!line.contains("Done ("))
+    {
+        return false;
+    }
+    auto match = doneRe.match(stripDecorations(line));
+    if(!match.hasMatch())
+    {
+        return false;
+    }
+    seconds = match.captured(1).replace(',', '.').toDouble();
+    if(match.captured(2) == "ns")
+    {
+        seconds /= 1e9;
+    }
+    return true;
+}
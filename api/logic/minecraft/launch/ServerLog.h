@@ -0,0 +1,24 @@
+#pragma once
+
+#include <QString>
+
+#include "multiservermc_logic_export.h"
+
+/**
+ * Reading the console lines of a Minecraft server.
+ */
+namespace ServerLog
+{
+/**
+ * The message of a console line, without terminal colors and without the time and thread prefix:
+ * "[12:34:56] [Server thread/INFO]: " of vanilla and Forge, "[12:34:56 INFO]: " of Paper and
+ * "2013-01-01 12:34:56 [INFO] " of old servers.
+ *
+ * Anything the players say starts with their name after that, so a message can be matched from
+ * its start without chat passing for it.
+ */
+MULTISERVERMC_LOGIC_EXPORT QString stripDecorations(const QString &line);
+
+/// the startup time in a "Done (12.345s)!" line
+MULTISERVERMC_LOGIC_EXPORT bool parseDone(const QString &line, double &seconds);
+}
@@ -0,0 +1,61 @@
+#include <QTest>
+#include "TestUtil.h"
+
+#include "minecraft/launch/ServerLog.h"
+
+class ServerLogTest : public QObject
+{
+    Q_OBJECT
+private
+slots:
+    void test_stripDecorations_data()
+    {
+        QTest::addColumn<QString>("line");
+        QTest::addColumn<QString>("message");
+
+        QTest::newRow("vanilla") << "[12:00:00] [Server thread/INFO]: Saved the game" << "Saved the game";
+        QTest::newRow("forge") << "[12:00:00] [Server thread/INFO] [minecraft/DedicatedServer]: Saved the game" << "Saved the game";
+        QTest::newRow("paper") << "[12:00:00 INFO]: Saved the game" << "Saved the game";
+        QTest::newRow("old") << "2013-01-01 12:00:00 [INFO] Saved the world" << "Saved the world";
+        QTest::newRow("colors") << "\x1b[33m[12:00:00 WARN]: \x1b[0mCan't keep up!" << "Can't keep up!";
+        QTest::newRow("chat") << "[12:00:00] [Server thread/INFO]: <Steve> Saved the game" << "<Steve> Saved the game";
+        QTest::newRow("no prefix") << "Saved the game" << "Saved the game";
+    }
+    void test_stripDecorations()
+    {
+        QFETCH(QString, line);
+        QFETCH(QString, message);
+        QCOMPARE(ServerLog::stripDecorations(line), message);
+    }
+
+    void test_parseDone_data()
+    {
+        QTest::addColumn<QString>("line");
+        QTest::addColumn<bool>("done");
+        QTest::addColumn<double>("seconds");
+
+        QTest::newRow("vanilla") << "[12:00:00] [Server thread/INFO]: Done (3.456s)! For help, type \"help\"" << true << 3.456;
+        QTest::newRow("decimal comma") << "[12:00:00 INFO]: Done (12,5s)! For help, type \"help\"" << true << 12.5;
+        QTest::newRow("nanoseconds") << "2013-01-01 12:00:00 [INFO] Done (2500000000ns)! For help, type \"help\" or \"?\"" << true << 2.5;
+        QTest::newRow("unrelated") << "[12:00:00] [Server thread/INFO]: Preparing spawn area: 97%" << false << 0.0;
+        QTest::newRow("chat") << "[12:00:00] [Server thread/INFO]: <Steve> Done (soon)!" << false << 0.0;
+        QTest::newRow("chat with a time") << "[12:00:00] [Server thread/INFO]: <Steve> Done (1.5s)!" << false << 0.0;
+    }
+    void test_parseDone()
+    {
+        QFETCH(QString, line);
+        QFETCH(bool, done);
+        QFETCH(double, seconds);
+
+        double parsed = 0;
+        QCOMPARE(ServerLog::parseDone(line, parsed), done);
+        if(done)
+        {
+            QCOMPARE(parsed, seconds);
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(ServerLogTest)
+
+#include "ServerLog_test.moc"
@@ -0,0 +1,201 @@
+#include "TickMonitor.h"
+
+#include <QRegularExpression>
+
+#include "launch/LaunchTask.h"
+#include "ServerLog.h"
+
+TickMonitor::TickMonitor(QObject *parent) : QObject(parent)
+{
+    connect(&m_probeTimer, &QTimer::timeout, this, &TickMonitor::probe);
+}
+
+void TickMonitor::setProbe(const QString &command, int intervalSecs)
+{
+    m_probeCommand = command.trimmed();
+    m_probeTimer.setInterval(qMax(intervalSecs, 5) * 1000);
+}
+
+void TickMonitor::attach(LaunchTask *task)
+{
+    detach();
+    m_task = task;
+    m_expect = Expect::Nothing;
+    if(!task)
+    {
+        return;
+    }
+    connect(task, &LaunchTask::lineLogged, this, &TickMonitor::parseLine);
+    connect(task, &Task::finished, this, &TickMonitor::detach);
+    if(!m_probeCommand.isEmpty())
+    {
+        m_probeTimer.start();
+    }
+}
+
+void TickMonitor::detach()
+{
+    m_probeTimer.stop();
+    if(m_task)
+    {
+        disconnect(m_task, nullptr, this, nullptr);
+    }
+    m_task = nullptr;
+}
+
+void TickMonitor::probe()
+{
+    // nothing to ask while the server is starting up again or being prepared
+    if(!m_task || m_task->pid() <= 0)
+    {
+        return;
+    }
+    m_task->commands().send(m_probeCommand);
+}
+
+bool TickMonitor::parseLine(const QString &rawLine)
+{
+    // from the start of the message like the others, players could say all of it in chat
+    static const QRegularExpression lagRe("^Can't keep up!.* Running (\\d+)ms ");
+    static const QRegularExpression forgeRe("^Overall\\s*: Mean tick time: ([\\d.]+) ms\\. Mean TPS: ([\\d.]+)");
+    static const QRegularExpression neoForgeRe("^Overall\\s*: ([\\d.]+) TPS \\(([\\d.]+) ms/tick\\)");
+    static const QRegularExpression tpsHeaderRe("^TPS from last [^:]*:\\s*(?:\\*?([\\d.]+))?");
+    static const QRegularExpression sparkMsptHeaderRe("^Tick durations \\(min/med/95%ile/max ms\\) from last");
+    static const QRegularExpression paperMsptHeaderRe("^Server tick times \\(avg/min/max\\) from last");
+    static const QRegularExpression firstNumberRe("^\\W*\\*?([\\d.]+)");
+    static const QRegularExpression durationsRe("^\\W*([\\d.]+)/([\\d.]+)/([\\d.]+)");
+
+    // the cheap test first, most lines are about something else entirely
+    auto expect = m_expect;
+    m_expect = Expect::Nothing;
+    if(expect == Expect::Nothing && !rawLine.contains("TPS") && !rawLine.contains("tick", Qt::CaseInsensitive) && !rawLine.contains("keep up"))
+    {
+        return false;
+    }
+    auto line = ServerLog::stripDecorations(rawLine);
+
+    TickSample sample;
+    switch(expect)
+    {
+        case Expect::SparkTps:
+        {
+            auto match = firstNumberRe.match(line);
+            if(match.hasMatch())
+            {
+                sample.source = TickSample::Spark;
+                sample.tps = match.captured(1).toDouble();
+                addSample(sample);
+                return true;
+            }
+            break;
+        }
+        case Expect::SparkMspt:
+        case Expect::PaperMspt:
+        {
+            auto match = durationsRe.match(line);
+            if(match.hasMatch())
+            {
+                // spark lists min/med/95%ile/max, Paper avg/min/max
+                sample.source = expect == Expect::SparkMspt ? TickSample::Spark : TickSample::Paper;
+                sample.mspt = match.captured(expect == Expect::SparkMspt ? 2 : 1).toDouble();
+                addSample(sample);
+                return true;
+            }
+            break;
+        }
+        case Expect::Nothing:
+            break;
+    }
+
+    auto match = lagRe.match(line);
+    if(match.hasMatch())
+    {
+        sample.source = TickSample::Lag;
+        sample.behindMs = match.captured(1).toLongLong();
+        addSample(sample);
+        return true;
+    }
+    match = forgeRe.match(line);
+    if(match.hasMatch())
+    {
+        sample.source = TickSample::Forge;
+        sample.mspt = match.captured(1).toDouble();
+        sample.tps = match.captured(2).toDouble();
+        addSample(sample);
+        return true;
+    }
+    match = neoForgeRe.match(line);
+    if(match.hasMatch())
+    {
+        sample.source = TickSample::Forge;
+        sample.tps = match.captured(1).toDouble();
+        sample.mspt = match.captured(2).toDouble();
+        addSample(sample);
+        return true;
+    }
+    match = tpsHeaderRe.match(line);
+    if(match.hasMatch())
+    {
+        // Paper puts the numbers on the same line, spark on the next one
+        if(match.captured(1).isEmpty())
+        {
+            m_expect = Expect::SparkTps;
+            return true;
+        }
+        sample.source = TickSample::Paper;
+        sample.tps = match.captured(1).toDouble();
+        addSample(sample);
+        return true;
+    }
+    if(sparkMsptHeaderRe.match(line).hasMatch())
+    {
+        m_expect = Expect::SparkMspt;
+        return true;
+    }
+    if(paperMsptHeaderRe.match(line).hasMatch())
+    {
+        m_expect = Expect::PaperMspt;
+        return true;
+    }
+    return false;
+}
+
+void TickMonitor::addSample(TickSample sample)
+{
+    sample.time = QDateTime::currentMSecsSinceEpoch();
+    if(m_samples.size() >= MaxSamples)
+    {
+        m_samples.remove(0, m_samples.size() - MaxSamples + 1);
+    }
+    m_samples.append(sample);
+    emit sampled(sample);
+    check(sample);
+}
+
+void TickMonitor::check(const TickSample &sample)
+{
+    if(m_thresholds.minTps > 0 && !qIsNaN(sample.tps) && sample.tps < m_thresholds.minTps)
+    {
+        raise("tps", tr("The server runs at %1 TPS, below the alert threshold of %2.").arg(sample.tps, 0, 'f', 1).arg(m_thresholds.minTps));
+    }
+    if(m_thresholds.maxMspt > 0 && !qIsNaN(sample.mspt) && sample.mspt > m_thresholds.maxMspt)
+    {
+        raise("mspt", tr("A server tick takes %1 ms, above the alert threshold of %2 ms.").arg(sample.mspt, 0, 'f', 1).arg(m_thresholds.maxMspt));
+    }
+    if(m_thresholds.maxBehindMs > 0 && sample.behindMs >= m_thresholds.maxBehindMs)
+    {
+        raise("behind", tr("The server fell %1 ms behind, the alert threshold is %2 ms.").arg(sample.behindMs).arg(m_thresholds.maxBehindMs));
+    }
+}
+
+void TickMonitor::raise(const QString &kind, const QString &message)
+{
+    auto now = QDateTime::currentDateTimeUtc();
+    auto last = m_lastAlerts.value(kind);
+    if(last.isValid() && last.secsTo(now) < m_thresholds.cooldown)
+    {
+        return;
+    }
+    m_lastAlerts[kind] = now;
+    emit alert(message);
+}
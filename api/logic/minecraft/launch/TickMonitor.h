@@ -0,0 +1,117 @@
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <QPointer>
+#include <QVector>
+#include <QMap>
+#include <QDateTime>
+#include <QtNumeric>
+
+#include "multiservermc_logic_export.h"
+
+class LaunchTask;
+
+/// One measurement of how the server keeps up, from a single report in its log
+struct TickSample
+{
+    enum Source
+    {
+        /// vanilla "Can't keep up!" warning, only has behindMs
+        Lag,
+        /// /forge tps
+        Forge,
+        /// /spark tps
+        Spark,
+        /// /tps and /mspt of Paper and its forks
+        Paper
+    };
+
+    /// msecs since epoch
+    qint64 time = 0;
+    Source source = Lag;
+    /// ticks per second, NaN when the report has none
+    double tps = qQNaN();
+    /// milliseconds per tick, NaN when the report has none
+    double mspt = qQNaN();
+    /// how far the server fell behind, 0 when the report isn't about that
+    qint64 behindMs = 0;
+};
+
+/// When TickMonitor warns, a value of 0 turns the check off
+struct TickThresholds
+{
+    double minTps = 15.0;
+    double maxMspt = 50.0;
+    qint64 maxBehindMs = 5000;
+    /// seconds between two warnings about the same thing
+    int cooldown = 300;
+};
+
+/**
+ * Watches the log of a running server for tick time reports and keeps them as a time series.
+ *
+ * Vanilla servers only complain when they fall behind, so the monitor can also type a command like
+ * "forge tps" or "spark tps" into the server console at an interval. Everything goes through the
+ * server console, the server itself doesn't need anything installed for this beyond what provides
+ * the command.
+ */
+class MULTISERVERMC_LOGIC_EXPORT TickMonitor : public QObject
+{
+    Q_OBJECT
+public:
+    /// samples kept, older ones are dropped
+    static const int MaxSamples = 720;
+
+    explicit TickMonitor(QObject *parent = nullptr);
+
+    void setThresholds(const TickThresholds &thresholds)
+    {
+        m_thresholds = thresholds;
+    }
+    /// command to write to the server console every intervalSecs, empty for none
+    void setProbe(const QString &command, int intervalSecs);
+
+    /// watch the log of the given launch, and probe while its server is running
+    void attach(LaunchTask *task);
+
+    /// look at one line of the server log, returns whether it was a tick report
+    bool parseLine(const QString &line);
+
+    const QVector<TickSample> &samples() const
+    {
+        return m_samples;
+    }
+
+signals:
+    void sampled(const TickSample &sample);
+    /// a threshold was crossed
+    void alert(const QString &message);
+
+private slots:
+    void probe();
+    void detach();
+
+private:
+    void addSample(TickSample sample);
+    void check(const TickSample &sample);
+    void raise(const QString &kind, const QString &message);
+
+private:
+    enum class Expect
+    {
+        Nothing,
+        SparkTps,
+        SparkMspt,
+        PaperMspt
+    };
+    Expect m_expect = Expect::Nothing;
+
+    QVector<TickSample> m_samples;
+    TickThresholds m_thresholds;
+    QMap<QString, QDateTime> m_lastAlerts;
+
+    QPointer<LaunchTask> m_task;
+    QString m_probeCommand;
+    QTimer m_probeTimer;
+};
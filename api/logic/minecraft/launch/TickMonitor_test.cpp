@@ -0,0 +1,108 @@
+#include <QTest>
+#include <QSignalSpy>
+#include "TestUtil.h"
+
+#include "minecraft/launch/TickMonitor.h"
+
+class TickMonitorTest : public QObject
+{
+    Q_OBJECT
+private
+slots:
+    void test_vanillaLag()
+    {
+        TickMonitor monitor;
+        QVERIFY(monitor.parseLine("[12:00:00] [Server thread/WARN]: Can't keep up! Is the server overloaded? Running 2345ms or 46 ticks behind"));
+        QVERIFY(monitor.parseLine("[12:00:00] [Server thread/WARN]: Can't keep up! Did the system time change, or is the server overloaded? Running 2064ms behind, skipping 41 tick(s)"));
+        QCOMPARE(monitor.samples().size(), 2);
+        QCOMPARE(monitor.samples()[0].source, TickSample::Lag);
+        QCOMPARE(monitor.samples()[0].behindMs, qint64(2345));
+        QCOMPARE(monitor.samples()[1].behindMs, qint64(2064));
+        QVERIFY(qIsNaN(monitor.samples()[0].tps));
+    }
+
+    void test_forge()
+    {
+        TickMonitor monitor;
+        QVERIFY(!monitor.parseLine("[12:00:00] [Server thread/INFO]: Dim  0 (overworld) : Mean tick time: 12.345 ms. Mean TPS: 20.000"));
+        QVERIFY(monitor.parseLine("[12:00:00] [Server thread/INFO]: Overall : Mean tick time: 62.500 ms. Mean TPS: 16.000"));
+        QVERIFY(monitor.parseLine("[12:00:00] [Server thread/INFO]: Overall: 19.500 TPS (51.282 ms/tick)"));
+        QCOMPARE(monitor.samples().size(), 2);
+        QCOMPARE(monitor.samples()[0].tps, 16.0);
+        QCOMPARE(monitor.samples()[0].mspt, 62.5);
+        QCOMPARE(monitor.samples()[1].tps, 19.5);
+        QCOMPARE(monitor.samples()[1].mspt, 51.282);
+    }
+
+    void test_spark()
+    {
+        TickMonitor monitor;
+        QVERIFY(monitor.parseLine("[12:00:00 INFO]: TPS from last 5s, 10s, 1m, 5m, 15m:"));
+        QVERIFY(monitor.parseLine("[12:00:00 INFO]:  *20.0, 19.8, 19.9, 20.0, 20.0"));
+        QVERIFY(monitor.parseLine("[12:00:00 INFO]: Tick durations (min/med/95%ile/max ms) from last 10s, 1m:"));
+        QVERIFY(monitor.parseLine("[12:00:00 INFO]:  1.2/3.4/5.6/7.8;  1.1/3.3/5.5/9.9"));
+        // the numbers only count right after their header
+        QVERIFY(!monitor.parseLine("[12:00:00 INFO]:  1.2/3.4/5.6/7.8;  1.1/3.3/5.5/9.9"));
+        QCOMPARE(monitor.samples().size(), 2);
+        QCOMPARE(monitor.samples()[0].source, TickSample::Spark);
+        QCOMPARE(monitor.samples()[0].tps, 20.0);
+        QCOMPARE(monitor.samples()[1].mspt, 3.4);
+    }
+
+    void test_paper()
+    {
+        TickMonitor monitor;
+        QVERIFY(monitor.parseLine("[12:00:00 INFO]: TPS from last 1m, 5m, 15m: 18.2, 19.5, 19.9"));
+        QVERIFY(monitor.parseLine("[12:00:00 INFO]: Server tick times (avg/min/max) from last 5s, 10s, 1m:"));
+        QVERIFY(monitor.parseLine(QString::fromUtf8("[12:00:00 INFO]: \xe2\x97\xb4 12.5/0.5/40.1, 11.0/0.5/45.0, 10.0/0.4/50.2")));
+        QCOMPARE(monitor.samples().size(), 2);
+        QCOMPARE(monitor.samples()[0].source, TickSample::Paper);
+        QCOMPARE(monitor.samples()[0].tps, 18.2);
+        QCOMPARE(monitor.samples()[1].mspt, 12.5);
+    }
+
+    void test_unrelated()
+    {
+        TickMonitor monitor;
+        QVERIFY(!monitor.parseLine("[12:00:00] [Server thread/INFO]: Done (3.2s)! For help, type \"help\""));
+        QVERIFY(!monitor.parseLine("[12:00:00] [Server thread/INFO]: <Steve> the TPS is fine"));
+        QVERIFY(!monitor.parseLine("[12:00:00] [Server thread/INFO]: <Steve> Can't keep up! Is the server overloaded? Running 99999ms or 2000 ticks behind"));
+        QVERIFY(monitor.samples().isEmpty());
+    }
+
+    void test_alerts()
+    {
+        TickMonitor monitor;
+        TickThresholds thresholds;
+        thresholds.minTps = 18;
+        thresholds.maxMspt = 0;
+        thresholds.maxBehindMs = 3000;
+        thresholds.cooldown = 300;
+        monitor.setThresholds(thresholds);
+        QSignalSpy alerts(&monitor, &TickMonitor::alert);
+
+        monitor.parseLine("Overall : Mean tick time: 62.500 ms. Mean TPS: 16.000");
+        QCOMPARE(alerts.size(), 1);
+        // same problem again within the cooldown
+        monitor.parseLine("Overall : Mean tick time: 60.000 ms. Mean TPS: 16.500");
+        QCOMPARE(alerts.size(), 1);
+        monitor.parseLine("Can't keep up! Is the server overloaded? Running 2000ms or 40 ticks behind");
+        QCOMPARE(alerts.size(), 1);
+        monitor.parseLine("Can't keep up! Is the server overloaded? Running 4000ms or 80 ticks behind");
+        QCOMPARE(alerts.size(), 2);
+    }
+
+    void test_bounded()
+    {
+        TickMonitor monitor;
+        for(int i = 0; i < TickMonitor::MaxSamples + 5; i++)
+        {
+            monitor.parseLine("Overall : Mean tick time: 50.000 ms. Mean TPS: 20.000");
+        }
+        QCOMPARE(monitor.samples().size(), int(TickMonitor::MaxSamples));
+    }
+};
+
+QTEST_GUILESS_MAIN(TickMonitorTest)
+
+#include "TickMonitor_test.moc"
@@ -207,6 +207,8 @@ std::shared_ptr<WorldList> LegacyInstance::worldList() const
     if (!m_world_list)
     {
         m_world_list.reset(new WorldList(savesDir()));
+        m_world_list->setSummaryCachePath(FS::PathCombine(instanceRoot(), "worlds.cache"));
+        m_world_list->setStatsCachePath(FS::PathCombine(instanceRoot(), "worldstats.cache"));
     }
     return m_world_list;
 }
@@ -0,0 +1,315 @@
+#include "ModConflictIndex.h"
+#include "LocalModParseTask.h"
+
+#include <QDateTime>
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QPair>
+#include <QSet>
+#include <QtConcurrentMap>
+#include <QDebug>
+#include <quazip.h>
+
+namespace {
+
+// what was read from a mod file, kept for the next launch as long as the file stays the same
+struct ScannedMod
+{
+    qint64 size = -1;
+    QDateTime lastModified;
+    std::shared_ptr<ModDetails> details;
+    bool classesRead = false;
+    QStringList classes;
+};
+
+QMutex scannedMutex;
+QHash<QString, ScannedMod> scannedMods;
+
+QStringList readClasses(const QString &path)
+{
+    QStringList classes;
+    // only the central directory is read here, nothing is inflated
+    QuaZip zip(path);
+    if(!zip.open(QuaZip::mdUnzip))
+    {
+        return classes;
+    }
+    for(auto & name: zip.getFileNameList())
+    {
+        if(!name.endsWith(".class") || name.startsWith("META-INF/"))
+        {
+            continue;
+        }
+        if(name.endsWith("module-info.class") || name.endsWith("package-info.class"))
+        {
+            continue;
+        }
+        classes.append(name);
+    }
+    zip.close();
+    return classes;
+}
+
+// Fill in whatever is needed for the index and not already known
+void scanEntry(ModConflictIndex::Entry & entry, bool checkClasses)
+{
+    QFileInfo file(entry.file.filePath());
+    bool needsDetails = !entry.details || entry.details->mod_id.isEmpty();
+    bool needsClasses = checkClasses && entry.enabled && (entry.type == Mod::MOD_ZIPFILE || entry.type == Mod::MOD_LITEMOD);
+    if(!file.isFile())
+    {
+        // the time of a folder doesn't change with what is in it, and a missing file has nothing to remember
+        if(needsDetails)
+        {
+            LocalModParseTask parse(0, entry.type, entry.file);
+            parse.run();
+            entry.details = parse.result()->details;
+        }
+        return;
+    }
+
+    ScannedMod scanned;
+    {
+        QMutexLocker locker(&scannedMutex);
+        scanned = scannedMods.value(file.filePath());
+    }
+    if(scanned.size != file.size() || scanned.lastModified != file.lastModified())
+    {
+        scanned = ScannedMod();
+        scanned.size = file.size();
+        scanned.lastModified = file.lastModified();
+    }
+
+    bool changed = false;
+    if(needsDetails)
+    {
+        if(!scanned.details)
+        {
+            LocalModParseTask parse(0, entry.type, entry.file);
+            parse.run();
+            scanned.details = parse.result()->details;
+            changed = true;
+        }
+        entry.details = scanned.details;
+    }
+    if(needsClasses)
+    {
+        if(!scanned.classesRead)
+        {
+            scanned.classes = readClasses(file.filePath());
+            scanned.classesRead = true;
+            changed = true;
+        }
+        entry.classes = scanned.classes;
+    }
+    if(changed)
+    {
+        QMutexLocker locker(&scannedMutex);
+        auto & stored = scannedMods[file.filePath()];
+        if(stored.size != scanned.size || stored.lastModified != scanned.lastModified)
+        {
+            stored = scanned;
+        }
+        else
+        {
+            // another index may have read the other half in the meantime
+            if(scanned.details)
+            {
+                stored.details = scanned.details;
+            }
+            if(scanned.classesRead)
+            {
+                stored.classes = scanned.classes;
+                stored.classesRead = true;
+            }
+        }
+    }
+}
+
+void scanEntryWithClasses(ModConflictIndex::Entry & entry)
+{
+    scanEntry(entry, true);
+}
+
+void scanEntryWithoutClasses(ModConflictIndex::Entry & entry)
+{
+    scanEntry(entry, false);
+}
+
+QString modIdOf(const ModConflictIndex::Entry & entry)
+{
+    if(entry.details)
+    {
+        return entry.details->mod_id;
+    }
+    return QString();
+}
+
+QString versionOf(const ModConflictIndex::Entry & entry)
+{
+    if(entry.details)
+    {
+        return entry.details->version;
+    }
+    return QString();
+}
+
+}
+
+QString ModConflict::describe() const
+{
+    switch(type)
+    {
+        case DuplicateId:
+            return QObject::tr("Mod '%1' is installed more than once: %2").arg(modId, files.join(", "));
+        case ConflictingVersions:
+            return QObject::tr("Mod '%1' is installed in several versions (%2): %3").arg(modId, versions.join(", "), files.join(", "));
+        case DisabledCopy:
+            return QObject::tr("Mod '%1' has a disabled copy next to the enabled one: %2").arg(modId, files.join(", "));
+        case OverlappingClasses:
+            return QObject::tr("%1 share %2 class files (for example %3)").arg(files.join(" and ")).arg(overlapCount).arg(exampleClass);
+    }
+    return QString();
+}
+
+void ModConflictIndex::addMods(const QString &listName, const QList<Mod> &mods)
+{
+    for(auto & mod: mods)
+    {
+        if(mod.type() == Mod::MOD_UNKNOWN)
+        {
+            continue;
+        }
+        Entry entry;
+        entry.list = listName;
+        entry.file = mod.filename();
+        entry.type = mod.type();
+        entry.enabled = mod.enabled();
+        auto & details = mod.details();
+        if(!details.mod_id.isEmpty())
+        {
+            entry.details = std::make_shared<ModDetails>(details);
+        }
+        m_entries.append(entry);
+    }
+}
+
+QList<ModConflict> ModConflictIndex::findConflicts()
+{
+    if(m_checkClasses)
+    {
+        QtConcurrent::blockingMap(m_entries, scanEntryWithClasses);
+    }
+    else
+    {
+        QtConcurrent::blockingMap(m_entries, scanEntryWithoutClasses);
+    }
+
+    QList<ModConflict> result;
+
+    // group everything by mod ID
+    QMap<QString, QList<int>> byId;
+    for(int i = 0; i < m_entries.size(); i++)
+    {
+        auto modId = modIdOf(m_entries[i]);
+        if(modId.isEmpty())
+        {
+            continue;
+        }
+        byId[modId].append(i);
+    }
+    for(auto iter = byId.begin(); iter != byId.end(); iter++)
+    {
+        auto & indexes = iter.value();
+        if(indexes.size() < 2)
+        {
+            continue;
+        }
+        QStringList enabledFiles;
+        QStringList disabledFiles;
+        QStringList versions;
+        for(auto i: indexes)
+        {
+            auto & entry = m_entries[i];
+            if(entry.enabled)
+            {
+                enabledFiles.append(entry.file.fileName());
+                auto version = versionOf(entry);
+                if(!versions.contains(version))
+                {
+                    versions.append(version);
+                }
+            }
+            else
+            {
+                disabledFiles.append(entry.file.fileName());
+            }
+        }
+        if(enabledFiles.size() > 1)
+        {
+            ModConflict conflict;
+            conflict.type = versions.size() > 1 ? ModConflict::ConflictingVersions : ModConflict::DuplicateId;
+            conflict.modId = iter.key();
+            conflict.files = enabledFiles;
+            conflict.versions = versions;
+            result.append(conflict);
+        }
+        if(enabledFiles.size() && disabledFiles.size())
+        {
+            ModConflict conflict;
+            conflict.type = ModConflict::DisabledCopy;
+            conflict.modId = iter.key();
+            conflict.files = enabledFiles + disabledFiles;
+            result.append(conflict);
+        }
+    }
+
+    if(!m_checkClasses)
+    {
+        return result;
+    }
+
+    // find class files provided by more than one mod, every pair of them is a conflict
+    QHash<QString, QList<int>> classOwners;
+    QMap<QPair<int, int>, QPair<int, QString>> overlaps;
+    for(int i = 0; i < m_entries.size(); i++)
+    {
+        auto & entry = m_entries[i];
+        auto modId = modIdOf(entry);
+        for(auto & className: entry.classes)
+        {
+            auto & owners = classOwners[className];
+            for(auto owner: owners)
+            {
+                auto ownerId = modIdOf(m_entries[owner]);
+                // already reported as the same mod
+                if(!ownerId.isEmpty() && ownerId == modId)
+                {
+                    continue;
+                }
+                auto & overlap = overlaps[qMakePair(owner, i)];
+                if(overlap.first == 0)
+                {
+                    overlap.second = className;
+                }
+                overlap.first++;
+            }
+            owners.append(i);
+        }
+    }
+    for(auto iter = overlaps.begin(); iter != overlaps.end(); iter++)
+    {
+        ModConflict conflict;
+        conflict.type = ModConflict::OverlappingClasses;
+        conflict.files = QStringList{
+            m_entries[iter.key().first].file.fileName(),
+            m_entries[iter.key().second].file.fileName()
+        };
+        conflict.modId = modIdOf(m_entries[iter.key().second]);
+        conflict.overlapCount = iter.value().first;
+        conflict.exampleClass = iter.value().second;
+        result.append(conflict);
+    }
+    return result;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QFileInfo>
+#include <memory>
+
+#include "Mod.h"
+#include "ModDetails.h"
+
+#include "multiservermc_logic_export.h"
+
+/**
+ * A problem found between the mods of an instance.
+ */
+struct MULTISERVERMC_LOGIC_EXPORT ModConflict
+{
+    enum Type
+    {
+        DuplicateId,            //!< The same mod (same ID and version) is installed more than once
+        ConflictingVersions,    //!< The same mod ID is installed in several different versions
+        DisabledCopy,           //!< A disabled copy of an enabled mod is present, only informational
+        OverlappingClasses      //!< Two different mods contain the same class files
+    };
+    Type type;
+    QString modId;
+    QStringList files;
+    QStringList versions;
+    int overlapCount = 0;
+    QString exampleClass;
+
+    /// Is this likely to break the launch or only worth a mention?
+    bool isSevere() const
+    {
+        return type != DisabledCopy;
+    }
+    QString describe() const;
+};
+
+/**
+ * Index of the mods of an instance, used to find duplicate and conflicting mods.
+ *
+ * Mods are added from the mod lists on the GUI thread, then findConflicts() does the heavy lifting
+ * (parsing details that are not resolved yet, reading the jar file lists) and can run on a worker thread.
+ * What it reads from a mod file is kept for the whole process, until the size or time of the file changes.
+ */
+class MULTISERVERMC_LOGIC_EXPORT ModConflictIndex
+{
+public:
+    struct Entry
+    {
+        QString list;
+        QFileInfo file;
+        Mod::ModType type = Mod::MOD_UNKNOWN;
+        bool enabled = true;
+        std::shared_ptr<ModDetails> details;
+        QStringList classes;
+    };
+
+    void addMods(const QString &listName, const QList<Mod> &mods);
+
+    /// Set to false to skip reading the jar contents (and finding overlapping classes)
+    void setCheckClasses(bool checkClasses)
+    {
+        m_checkClasses = checkClasses;
+    }
+
+    QList<ModConflict> findConflicts();
+
+    const QList<Entry> &entries() const
+    {
+        return m_entries;
+    }
+
+private:
+    QList<Entry> m_entries;
+    bool m_checkClasses = true;
+};
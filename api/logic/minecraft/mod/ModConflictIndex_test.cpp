@@ -0,0 +1,224 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include "TestUtil.h"
+
+#if defined Q_OS_WIN32
+    #include <sys/utime.h>
+#else
+    #include <utime.h>
+#endif
+
+#include <quazip.h>
+#include <quazipfile.h>
+
+#include "FileSystem.h"
+#include "minecraft/mod/ModConflictIndex.h"
+
+/// Changed mods are recognized by size and modification time, set it instead of waiting for the clock
+static bool setModified(const QString &path, const QDateTime &time)
+{
+    struct utimbuf times;
+    times.actime = times.modtime = time.toTime_t();
+#if defined Q_OS_WIN32
+    return _wutime(path.toStdWString().c_str(), &times) == 0;
+#else
+    return utime(QFile::encodeName(path).constData(), &times) == 0;
+#endif
+}
+
+class ModConflictIndexTest : public QObject
+{
+    Q_OBJECT
+
+    // a fabric mod with the given ID and version, containing the given files
+    Mod makeMod(const QString &folder, const QString &fileName, const QString &id, const QString &version, const QStringList &files)
+    {
+        QString path = FS::PathCombine(folder, fileName);
+        QuaZip zip(path);
+        if(!zip.open(QuaZip::mdCreate))
+        {
+            return Mod();
+        }
+        auto add = [&](const QString &name, const QByteArray &data)
+        {
+            QuaZipFile file(&zip);
+            file.open(QIODevice::WriteOnly, QuaZipNewInfo(name));
+            file.write(data);
+            file.close();
+        };
+        add("fabric.mod.json", QString("{\"schemaVersion\": 1, \"id\": \"%1\", \"version\": \"%2\"}").arg(id, version).toUtf8());
+        for(auto & name: files)
+        {
+            add(name, name.toUtf8());
+        }
+        zip.close();
+        return Mod(QFileInfo(path));
+    }
+
+    QList<ModConflict> ofType(const QList<ModConflict> &conflicts, ModConflict::Type type)
+    {
+        QList<ModConflict> result;
+        for(auto & conflict: conflicts)
+        {
+            if(conflict.type == type)
+            {
+                result.append(conflict);
+            }
+        }
+        return result;
+    }
+
+private
+slots:
+    // classes in more than one mod are a conflict, resources like assets and metadata are not
+    void test_overlappingClasses()
+    {
+        QTemporaryDir tempDir;
+        QList<Mod> mods;
+        mods.append(makeMod(tempDir.path(), "a.jar", "a", "1.0", {
+            "com/example/Shared.class", "com/example/Other.class", "com/a/A.class",
+            "assets/shared/lang/en_us.json", "pack.mcmeta", "META-INF/versions/9/Foo.class"
+        }));
+        mods.append(makeMod(tempDir.path(), "b.jar", "b", "1.0", {
+            "com/example/Shared.class", "com/example/Other.class", "com/b/B.class",
+            "assets/shared/lang/en_us.json", "pack.mcmeta", "META-INF/versions/9/Foo.class", "module-info.class"
+        }));
+        mods.append(makeMod(tempDir.path(), "c.jar", "c", "1.0", {"com/c/C.class", "assets/shared/lang/en_us.json"}));
+
+        ModConflictIndex index;
+        index.addMods("mods", mods);
+        auto conflicts = index.findConflicts();
+        QCOMPARE(conflicts.size(), 1);
+        auto & conflict = conflicts.first();
+        QCOMPARE(conflict.type, ModConflict::OverlappingClasses);
+        QCOMPARE(conflict.files, QStringList({"a.jar", "b.jar"}));
+        QCOMPARE(conflict.overlapCount, 2);
+        QVERIFY(conflict.exampleClass.startsWith("com/example/"));
+        QVERIFY(conflict.isSevere());
+
+        // nothing at all without looking into the jars
+        ModConflictIndex withoutClasses;
+        withoutClasses.setCheckClasses(false);
+        withoutClasses.addMods("mods", mods);
+        QVERIFY(withoutClasses.findConflicts().isEmpty());
+    }
+
+    // every mod that shares a class with another one is reported, not only the first one to have it
+    void test_overlapsBetweenMany()
+    {
+        QTemporaryDir tempDir;
+        QList<Mod> mods;
+        mods.append(makeMod(tempDir.path(), "a.jar", "a", "1.0", {"com/example/Shared.class"}));
+        mods.append(makeMod(tempDir.path(), "b.jar", "b", "1.0", {"com/example/Shared.class"}));
+        mods.append(makeMod(tempDir.path(), "c.jar", "c", "1.0", {"com/example/Shared.class", "com/example/BAndC.class"}));
+        mods.append(makeMod(tempDir.path(), "d.jar", "d", "1.0", {"com/example/BAndC.class"}));
+
+        ModConflictIndex index;
+        index.addMods("mods", mods);
+        auto conflicts = ofType(index.findConflicts(), ModConflict::OverlappingClasses);
+        QList<QStringList> pairs;
+        for(auto & conflict: conflicts)
+        {
+            pairs.append(conflict.files);
+        }
+        QCOMPARE(pairs, QList<QStringList>({
+            {"a.jar", "b.jar"}, {"a.jar", "c.jar"}, {"b.jar", "c.jar"}, {"c.jar", "d.jar"}
+        }));
+    }
+
+    // the jars are only read again once they change
+    void test_cachedScan()
+    {
+        QTemporaryDir tempDir;
+        QList<Mod> mods;
+        mods.append(makeMod(tempDir.path(), "a.jar", "a", "1.0", {"com/example/Shared.class"}));
+        mods.append(makeMod(tempDir.path(), "b.jar", "b", "1.0", {"com/example/Shared.class"}));
+        auto path = FS::PathCombine(tempDir.path(), "b.jar");
+        auto modified = QDateTime::currentDateTime().addSecs(-100);
+        QVERIFY(setModified(path, modified));
+        {
+            ModConflictIndex index;
+            index.addMods("mods", mods);
+            QCOMPARE(index.findConflicts().size(), 1);
+        }
+
+        // same size and time, different class: still the old list
+        makeMod(tempDir.path(), "b.jar", "b", "1.0", {"com/example/Sharef.class"});
+        QCOMPARE(QFileInfo(path).size(), QFileInfo(FS::PathCombine(tempDir.path(), "a.jar")).size());
+        QVERIFY(setModified(path, modified));
+        {
+            ModConflictIndex index;
+            index.addMods("mods", mods);
+            QCOMPARE(index.findConflicts().size(), 1);
+        }
+
+        // a new time means a new scan
+        QVERIFY(setModified(path, modified.addSecs(10)));
+        ModConflictIndex index;
+        index.addMods("mods", mods);
+        QVERIFY(index.findConflicts().isEmpty());
+    }
+
+    void test_duplicatesAndVersions()
+    {
+        QTemporaryDir tempDir;
+        QList<Mod> mods;
+        mods.append(makeMod(tempDir.path(), "a-1.jar", "a", "1.0", {"com/a/A.class"}));
+        mods.append(makeMod(tempDir.path(), "a-1-copy.jar", "a", "1.0", {"com/a/A.class"}));
+        mods.append(makeMod(tempDir.path(), "b-1.jar", "b", "1.0", {"com/b/B.class"}));
+        mods.append(makeMod(tempDir.path(), "b-2.jar", "b", "2.0", {"com/b/B.class"}));
+
+        ModConflictIndex index;
+        index.addMods("mods", mods);
+        auto conflicts = index.findConflicts();
+        auto duplicates = ofType(conflicts, ModConflict::DuplicateId);
+        QCOMPARE(duplicates.size(), 1);
+        QCOMPARE(duplicates.first().modId, QString("a"));
+        auto versions = ofType(conflicts, ModConflict::ConflictingVersions);
+        QCOMPARE(versions.size(), 1);
+        QCOMPARE(versions.first().modId, QString("b"));
+        QCOMPARE(versions.first().versions, QStringList({"1.0", "2.0"}));
+        // the same mod twice is reported once, not again for its classes
+        QVERIFY(ofType(conflicts, ModConflict::OverlappingClasses).isEmpty());
+    }
+
+    // a disabled copy is only mentioned, and its classes don't count
+    void test_disabledMod()
+    {
+        QTemporaryDir tempDir;
+        QList<Mod> mods;
+        mods.append(makeMod(tempDir.path(), "a.jar", "a", "2.0", {"com/example/Shared.class"}));
+        mods.append(makeMod(tempDir.path(), "a-old.jar.disabled", "a", "1.0", {"com/example/Shared.class"}));
+        mods.append(makeMod(tempDir.path(), "b.jar.disabled", "b", "1.0", {"com/example/Shared.class"}));
+        QVERIFY(!mods[1].enabled());
+
+        ModConflictIndex index;
+        index.addMods("mods", mods);
+        auto conflicts = index.findConflicts();
+        QCOMPARE(conflicts.size(), 1);
+        QCOMPARE(conflicts.first().type, ModConflict::DisabledCopy);
+        QCOMPARE(conflicts.first().modId, QString("a"));
+        QCOMPARE(conflicts.first().files, QStringList({"a.jar", "a-old.jar.disabled"}));
+        QVERIFY(!conflicts.first().isSevere());
+    }
+
+    // a mod deleted after the list was read is skipped, not reported or crashed on
+    void test_removedMod()
+    {
+        QTemporaryDir tempDir;
+        QList<Mod> mods;
+        mods.append(makeMod(tempDir.path(), "a.jar", "a", "1.0", {"com/example/Shared.class"}));
+        mods.append(makeMod(tempDir.path(), "gone.jar", "a", "1.0", {"com/example/Shared.class"}));
+        QVERIFY(QFile::remove(FS::PathCombine(tempDir.path(), "gone.jar")));
+
+        ModConflictIndex index;
+        index.addMods("mods", mods);
+        QVERIFY(index.findConflicts().isEmpty());
+        QCOMPARE(index.entries().size(), 2);
+        QVERIFY(index.entries()[1].classes.isEmpty());
+    }
+};
+
+QTEST_GUILESS_MAIN(ModConflictIndexTest)
+
+#include "ModConflictIndex_test.moc"
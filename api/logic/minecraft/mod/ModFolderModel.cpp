@@ -19,7 +19,6 @@
 #include <QUrl>
 #include <QUuid>
 #include <QString>
-#include <QFileSystemWatcher>
 #include <QDebug>
 #include "ModFolderLoadTask.h"
 #include <QThreadPool>
@@ -31,8 +30,9 @@ ModFolderModel::ModFolderModel(const QString &dir) : QAbstractListModel(), m_dir
     FS::ensureFolderPathExists(m_dir.absolutePath());
     m_dir.setFilter(QDir::Readable | QDir::NoDotAndDotDot | QDir::Files | QDir::Dirs | QDir::NoSymLinks);
     m_dir.setSorting(QDir::Name | QDir::IgnoreCase | QDir::LocaleAware);
-    m_watcher = new QFileSystemWatcher(this);
-    connect(m_watcher, SIGNAL(directoryChanged(QString)), this, SLOT(directoryChanged(QString)));
+    m_watcher = new DirectoryEventWatcher(this);
+    connect(m_watcher, &DirectoryEventWatcher::rescanRequired, this, &ModFolderModel::directoryChanged);
+    connect(m_watcher, &DirectoryEventWatcher::eventsReady, this, &ModFolderModel::directoryEvents);
 }
 
 void ModFolderModel::startWatching()
@@ -105,13 +105,7 @@ void ModFolderModel::finishUpdate()
                 // no significant change, ignore...
                 continue;
             }
-            auto & oldMod = mods[row];
-            if(oldMod.isResolving()) {
-                activeTickets.remove(oldMod.resolutionTicket());
-            }
-            oldMod = newMod;
-            resolveMod(mods[row]);
-            emit dataChanged(index(row, 0), index(row, columnCount(QModelIndex()) - 1));
+            replaceMod(row, newMod);
         }
     }
 
@@ -136,28 +130,29 @@ void ModFolderModel::finishUpdate()
         }
     }
 
-    // add new mods to the end
+    // add new mods in file name order, all at once into an empty list
     {
         QSet<QString> added = newSet;
         added.subtract(currentSet);
-        beginInsertRows(QModelIndex(), mods.size(), mods.size() + added.size() - 1);
-        for(auto & addedMod: added) {
-            mods.append(newMods[addedMod]);
-            resolveMod(mods.last());
+        auto addedMods = added.toList();
+        std::sort(addedMods.begin(), addedMods.end());
+        if(mods.isEmpty() && !addedMods.isEmpty()) {
+            beginInsertRows(QModelIndex(), 0, addedMods.size() - 1);
+            for(auto & addedMod: addedMods) {
+                mods.append(newMods[addedMod]);
+                resolveMod(mods.last());
+            }
+            endInsertRows();
         }
-        endInsertRows();
-    }
-
-    // update index
-    {
-        modsIndex.clear();
-        int idx = 0;
-        for(auto & mod: mods) {
-            modsIndex[mod.msmc_id()] = idx;
-            idx++;
+        else {
+            for(auto & addedMod: addedMods) {
+                insertMod(newMods[addedMod]);
+            }
         }
     }
 
+    rebuildIndex();
+
     m_update.reset();
 
     emit updateFinished();
@@ -168,6 +163,143 @@ void ModFolderModel::finishUpdate()
     }
 }
 
+void ModFolderModel::replaceMod(int row, const Mod &newMod)
+{
+    auto & oldMod = mods[row];
+    if(oldMod.isResolving()) {
+        activeTickets.remove(oldMod.resolutionTicket());
+    }
+    oldMod = newMod;
+    resolveMod(mods[row]);
+    emit dataChanged(index(row, 0), index(row, columnCount(QModelIndex()) - 1));
+}
+
+void ModFolderModel::insertMod(const Mod &newMod)
+{
+    auto id = newMod.msmc_id();
+    auto iter = std::lower_bound(mods.begin(), mods.end(), id, [](const Mod & mod, const QString & id) {
+        return mod.msmc_id() < id;
+    });
+    int row = iter - mods.begin();
+    beginInsertRows(QModelIndex(), row, row);
+    mods.insert(row, newMod);
+    rebuildIndex();
+    resolveMod(mods[row]);
+    endInsertRows();
+}
+
+void ModFolderModel::rebuildIndex()
+{
+    modsIndex.clear();
+    int idx = 0;
+    for(auto & mod: mods) {
+        modsIndex[mod.msmc_id()] = idx;
+        idx++;
+    }
+}
+
+void ModFolderModel::directoryEvents(const QString &, const QList<DirectoryEvent> &events)
+{
+    if(m_update) {
+        // a full reload is running, it will not see everything we were told about
+        scheduled_update = true;
+        return;
+    }
+    for(auto & event: events) {
+        switch(event.type) {
+            case DirectoryEvent::Created:
+            case DirectoryEvent::Modified:
+                updateSingleMod(event.name);
+                break;
+            case DirectoryEvent::Removed:
+                removeSingleMod(event.name);
+                break;
+            case DirectoryEvent::Renamed:
+                renameSingleMod(event.oldName, event.name);
+                break;
+        }
+    }
+    emit updateFinished();
+}
+
+void ModFolderModel::updateSingleMod(const QString &name)
+{
+    QFileInfo entry(m_dir.absoluteFilePath(name));
+    // same as the filter used for listing the whole folder
+    if(!entry.exists() || entry.isSymLink() || entry.isHidden() || !entry.isReadable()) {
+        removeSingleMod(name);
+        return;
+    }
+    Mod newMod(entry);
+    auto iter = modsIndex.find(newMod.msmc_id());
+    if(iter != modsIndex.end()) {
+        int row = *iter;
+        if(newMod.dateTimeChanged() == mods[row].dateTimeChanged()) {
+            return;
+        }
+        replaceMod(row, newMod);
+        return;
+    }
+    insertMod(newMod);
+}
+
+void ModFolderModel::removeSingleMod(const QString &name)
+{
+    auto iter = modsIndex.find(name);
+    if(iter == modsIndex.end()) {
+        return;
+    }
+    int row = *iter;
+    beginRemoveRows(QModelIndex(), row, row);
+    auto removedIter = mods.begin() + row;
+    if(removedIter->isResolving()) {
+        activeTickets.remove(removedIter->resolutionTicket());
+    }
+    mods.erase(removedIter);
+    rebuildIndex();
+    endRemoveRows();
+}
+
+void ModFolderModel::renameSingleMod(const QString &oldName, const QString &newName)
+{
+    // NOTE: setModStatus renames files itself and has already updated the index in that case
+    if(!modsIndex.contains(oldName) || modsIndex.contains(newName)) {
+        removeSingleMod(oldName);
+        updateSingleMod(newName);
+        return;
+    }
+    QFileInfo entry(m_dir.absoluteFilePath(newName));
+    if(!entry.exists()) {
+        removeSingleMod(oldName);
+        return;
+    }
+    // a jar that became a folder or the other way around is read from scratch, its details don't apply anymore
+    if(Mod(entry).type() != mods[modsIndex[oldName]].type()) {
+        removeSingleMod(oldName);
+        updateSingleMod(newName);
+        return;
+    }
+    // keep the row and the already resolved details, only the path changes
+    int row = modsIndex.take(oldName);
+    auto & mod = mods[row];
+    mod.repath(entry);
+    modsIndex[mod.msmc_id()] = row;
+    rekeyTicket(mod);
+    emit dataChanged(index(row, 0), index(row, columnCount(QModelIndex()) - 1));
+}
+
+void ModFolderModel::rekeyTicket(Mod& m)
+{
+    // a parse still running for the old ID reports back under the new one
+    if(!m.isResolving()) {
+        return;
+    }
+    auto iter = activeTickets.find(m.resolutionTicket());
+    if(iter != activeTickets.end()) {
+        (*iter)->id = m.msmc_id();
+    }
+}
+
 void ModFolderModel::resolveMod(Mod& m)
 {
     if(!m.shouldResolve()) {
@@ -193,7 +325,12 @@ void ModFolderModel::finishModParse(int token)
     }
     auto result = *iter;
     activeTickets.remove(token);
-    int row = modsIndex[result->id];
+    // the mod may be gone by now, don't let the default row stand in for it
+    auto rowIter = modsIndex.find(result->id);
+    if(rowIter == modsIndex.end()) {
+        return;
+    }
+    int row = *rowIter;
     auto & mod = mods[row];
     mod.finishResolvingWithDetails(result->details);
     emit dataChanged(index(row), index(row, columnCount(QModelIndex()) - 1));
@@ -447,6 +584,7 @@ bool ModFolderModel::setModStatus(int row, ModFolderModel::ModStatusAction actio
     }
     modsIndex.remove(oldId);
     modsIndex[newId] = row;
+    rekeyTicket(mod);
     emit dataChanged(index(row, 0), index(row, columnCount(QModelIndex()) - 1));
     return true;
 }
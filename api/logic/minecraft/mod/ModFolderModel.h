@@ -27,10 +27,10 @@
 #include "multiservermc_logic_export.h"
 #include "ModFolderLoadTask.h"
 #include "LocalModParseTask.h"
+#include "DirectoryEventWatcher.h"
 
 class LegacyInstance;
 class BaseInstance;
-class QFileSystemWatcher;
 
 /**
  * A legacy mod list.
@@ -125,6 +125,7 @@ public slots:
 private
 slots:
     void directoryChanged(QString path);
+    void directoryEvents(const QString &path, const QList<DirectoryEvent> &events);
     void finishUpdate();
     void finishModParse(int token);
 
@@ -135,8 +136,19 @@ private:
     void resolveMod(Mod& m);
     bool setModStatus(int index, ModStatusAction action);
 
+    /// Adds or refreshes the mod with the given file name, without listing the folder
+    void updateSingleMod(const QString &name);
+    /// Removes the mod with the given file name, if present
+    void removeSingleMod(const QString &name);
+    void renameSingleMod(const QString &oldName, const QString &newName);
+    void rekeyTicket(Mod& m);
+    void replaceMod(int row, const Mod &newMod);
+    /// Inserts a new mod at the row its file name sorts to
+    void insertMod(const Mod &newMod);
+    void rebuildIndex();
+
 protected:
-    QFileSystemWatcher *m_watcher;
+    DirectoryEventWatcher *m_watcher;
     bool is_watching = false;
     ModFolderLoadTask::ResultPtr m_update;
     bool scheduled_update = false;
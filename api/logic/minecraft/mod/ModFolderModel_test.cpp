@@ -3,6 +3,9 @@
 #include <QTemporaryDir>
 #include "TestUtil.h"
 
+#include <quazip.h>
+#include <quazipfile.h>
+
 #include "FileSystem.h"
 #include "minecraft/mod/ModFolderModel.h"
 
@@ -45,6 +48,89 @@ slots:
             verify(tempDir.path());
         }
     }
+
+    // changes in a watched folder are applied to the model without reloading it
+    void test_incrementalUpdate()
+    {
+        QTemporaryDir tempDir;
+        ModFolderModel m(tempDir.path());
+        m.startWatching();
+        QTRY_COMPARE(m.rowCount(QModelIndex()), 0);
+
+        auto touch = [&](const QString & name)
+        {
+            QFile f(FS::PathCombine(tempDir.path(), name));
+            QVERIFY(f.open(QIODevice::WriteOnly));
+            f.write("foo");
+        };
+
+        touch("a.jar");
+        touch("b.jar");
+        QTRY_COMPARE(m.rowCount(QModelIndex()), 2);
+
+        QVERIFY(QFile::rename(FS::PathCombine(tempDir.path(), "a.jar"), FS::PathCombine(tempDir.path(), "c.jar")));
+        QTRY_VERIFY(m.allMods().size() == 2 && (m.at(0).msmc_id() == "c.jar" || m.at(1).msmc_id() == "c.jar"));
+
+        QVERIFY(QFile::remove(FS::PathCombine(tempDir.path(), "b.jar")));
+        QTRY_COMPARE(m.rowCount(QModelIndex()), 1);
+        QCOMPARE(m.at(0).msmc_id(), QString("c.jar"));
+        m.stopWatching();
+    }
+
+    // mods that show up later go where a full load would have put them
+    void test_incrementalSorted()
+    {
+        QTemporaryDir tempDir;
+        auto touch = [&](const QString & name)
+        {
+            QFile f(FS::PathCombine(tempDir.path(), name));
+            QVERIFY(f.open(QIODevice::WriteOnly));
+            f.write("foo");
+        };
+        touch("b.jar");
+        touch("d.jar");
+        ModFolderModel m(tempDir.path());
+        m.startWatching();
+        QTRY_COMPARE(m.rowCount(QModelIndex()), 2);
+
+        touch("c.jar");
+        touch("a.jar");
+        QTRY_COMPARE(m.rowCount(QModelIndex()), 4);
+        QStringList ids;
+        for(auto & mod: m.allMods())
+        {
+            ids.append(mod.msmc_id());
+        }
+        QCOMPARE(ids, QStringList({"a.jar", "b.jar", "c.jar", "d.jar"}));
+        m.stopWatching();
+    }
+
+    // renamed into another kind of mod, the details of the old kind don't apply
+    void test_renameChangesType()
+    {
+        QTemporaryDir tempDir;
+        QString path = FS::PathCombine(tempDir.path(), "a.jar");
+        {
+            QuaZip zip(path);
+            QVERIFY(zip.open(QuaZip::mdCreate));
+            QuaZipFile file(&zip);
+            QVERIFY(file.open(QIODevice::WriteOnly, QuaZipNewInfo("fabric.mod.json")));
+            file.write("{\"schemaVersion\": 1, \"id\": \"a\", \"version\": \"1.0\"}");
+            file.close();
+            zip.close();
+        }
+        ModFolderModel m(tempDir.path());
+        m.startWatching();
+        QTRY_COMPARE(m.rowCount(QModelIndex()), 1);
+        QTRY_COMPARE(m.at(0).details().mod_id, QString("a"));
+
+        QVERIFY(QFile::rename(path, FS::PathCombine(tempDir.path(), "a.litemod")));
+        QTRY_COMPARE(m.at(0).msmc_id(), QString("a.litemod"));
+        QCOMPARE(m.at(0).type(), Mod::MOD_LITEMOD);
+        QTRY_VERIFY(!m[0].isResolving());
+        QVERIFY(m.at(0).details().mod_id.isEmpty());
+        m.stopWatching();
+    }
 };
 
 QTEST_GUILESS_MAIN(ModFolderModelTest)
@@ -9,6 +9,7 @@
 
 #include "BuildConfig.h"
 #include "FileSystem.h"
+#include "tasks/ParallelJobs.h"
 #include "Json.h"
 #include "minecraft/MinecraftInstance.h"
 #include "minecraft/PackProfile.h"
@@ -28,6 +29,14 @@ PackInstallTask::PackInstallTask(UserInteractionSupport *support, QString pack,
 
 bool PackInstallTask::abort()
 {
+    if(m_extractState)
+    {
+        m_extractState->cancel();
+    }
+    if(m_modExtractProgress)
+    {
+        m_modExtractProgress->cancel();
+    }
     return true;
 }
 
@@ -442,9 +451,24 @@ void PackInstallTask::extractConfigs()
         return;
     }
 
-    m_extractFuture = QtConcurrent::run(QThreadPool::globalInstance(), MSMCZip::extractDir, archivePath, extractDir.absolutePath() + "/minecraft");
+    m_extractState = std::make_shared<MSMCZip::ExtractState>();
+    connect(m_extractState.get(), &MSMCZip::ExtractState::progress, this, &PackInstallTask::setProgress);
+    auto state = m_extractState;
+    auto source = archivePath;
+    auto target = extractDir.absolutePath() + "/minecraft";
+    m_extractFuture = QtConcurrent::run(QThreadPool::globalInstance(), [source, target, state]()
+    {
+        return MSMCZip::extractDir(source, target, state.get());
+    });
     connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::finished, this, [&]()
     {
+        bool canceled = m_extractState->isCanceled();
+        m_extractState.reset();
+        if(canceled)
+        {
+            emitAborted();
+            return;
+        }
         downloadMods();
     });
     connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::canceled, this, [&]()
@@ -586,7 +610,21 @@ void PackInstallTask::onModsDownloaded() {
     jobPtr.reset();
 
     if(!modsToExtract.empty() || !modsToDecomp.empty() || !modsToCopy.empty()) {
-        m_modExtractFuture = QtConcurrent::run(QThreadPool::globalInstance(), this, &PackInstallTask::extractMods, modsToExtract, modsToDecomp, modsToCopy);
+        setStatus(tr("Extracting mods..."));
+        m_modExtractProgress = std::make_shared<ConcurrentProgress>();
+        connect(m_modExtractProgress.get(), &ConcurrentProgress::progress, this, [&](qint64 current, qint64 total)
+        {
+            setStatus(tr("Extracting mods (%1/%2)...").arg(current).arg(total));
+            setProgress(current, total);
+        });
+        auto progress = m_modExtractProgress;
+        auto extract = modsToExtract;
+        auto decomp = modsToDecomp;
+        auto copy = modsToCopy;
+        m_modExtractFuture = QtConcurrent::run(QThreadPool::globalInstance(), [this, progress, extract, decomp, copy]()
+        {
+            return extractMods(extract, decomp, copy, progress.get());
+        });
         connect(&m_modExtractFutureWatcher, &QFutureWatcher<QStringList>::finished, this, &PackInstallTask::onModsExtracted);
         connect(&m_modExtractFutureWatcher, &QFutureWatcher<QStringList>::canceled, this, [&]()
         {
@@ -601,6 +639,12 @@ void PackInstallTask::onModsDownloaded() {
 
 void PackInstallTask::onModsExtracted() {
     qDebug() << "PackInstallTask::onModsExtracted: " << QThread::currentThreadId();
+    bool canceled = m_modExtractProgress->isCanceled();
+    m_modExtractProgress.reset();
+    if(canceled) {
+        emitAborted();
+        return;
+    }
     if(m_modExtractFuture.result()) {
         install();
     }
@@ -612,11 +656,15 @@ void PackInstallTask::onModsExtracted() {
 bool PackInstallTask::extractMods(
     const QMap<QString, VersionMod> &toExtract,
     const QMap<QString, VersionMod> &toDecomp,
-    const QMap<QString, QString> &toCopy
+    const QMap<QString, QString> &toCopy,
+    ConcurrentProgress * progress
 ) {
     qDebug() << "PackInstallTask::extractMods: " << QThread::currentThreadId();
 
-    setStatus(tr("Extracting mods..."));
+    QDir stagingDir(m_stagingPath);
+
+    // one job per archive, so archives that need both extracting and decompressing are only opened once
+    QMap<QString, ModArchiveJob> archiveJobs;
     for (auto iter = toExtract.begin(); iter != toExtract.end(); iter++) {
         auto &modPath = iter.key();
         auto &mod = iter.value();
@@ -632,20 +680,18 @@ bool PackInstallTask::extractMods(
             extractToDir = FS::PathCombine("resourcepacks", "extracted");
         }
 
-        QDir extractDir(m_stagingPath);
-        auto extractToPath = FS::PathCombine(extractDir.absolutePath(), "minecraft", extractToDir);
-
         QString folderToExtract = "";
         if(mod.type == ModType::Extract) {
             folderToExtract = mod.extractFolder;
             folderToExtract.remove(QRegExp("^/"));
         }
 
-        qDebug() << "Extracting " + mod.file + " to " + extractToDir;
-        if(!MSMCZip::extractDir(modPath, folderToExtract, extractToPath)) {
-            // assume error
-            return false;
-        }
+        auto &job = archiveJobs[modPath];
+        job.archive = modPath;
+        job.extract = true;
+        job.extractFolder = folderToExtract;
+        job.extractToPath = FS::PathCombine(stagingDir.absolutePath(), "minecraft", extractToDir);
+        job.name = mod.file;
     }
 
     for (auto iter = toDecomp.begin(); iter != toDecomp.end(); iter++) {
@@ -653,26 +699,135 @@ bool PackInstallTask::extractMods(
         auto &mod = iter.value();
         auto extractToDir = getDirForModType(mod.decompType, mod.decompType_raw);
 
-        QDir extractDir(m_stagingPath);
-        auto extractToPath = FS::PathCombine(extractDir.absolutePath(), "minecraft", extractToDir, mod.decompFile);
+        auto &job = archiveJobs[modPath];
+        job.archive = modPath;
+        job.decomp = true;
+        job.decompFile = mod.decompFile;
+        job.decompToPath = FS::PathCombine(stagingDir.absolutePath(), "minecraft", extractToDir, mod.decompFile);
+        job.name = mod.file;
+    }
+
+    auto jobs = archiveJobs.values();
+    progress->setTotal(jobs.size() + toCopy.size());
 
-        qDebug() << "Extracting " + mod.decompFile + " to " + extractToDir;
-        if(!MSMCZip::extractFile(modPath, mod.decompFile, extractToPath)) {
-            qWarning() << "Failed to extract" << mod.decompFile;
-            return false;
+    // archives writing into the same folder are extracted one after the other, in the order above,
+    // so which file ends up there does not depend on the timing
+    auto targetsOf = [](const ModArchiveJob &job)
+    {
+        QStringList targets;
+        if(job.extract) {
+            targets.append(QDir::cleanPath(job.extractToPath));
+        }
+        if(job.decomp) {
+            targets.append(QFileInfo(QDir::cleanPath(job.decompToPath)).absolutePath());
+        }
+        return targets;
+    };
+    auto overlaps = [](const QString &a, const QString &b)
+    {
+        return a == b || a.startsWith(b + '/') || b.startsWith(a + '/');
+    };
+    // jobs with overlapping targets end up in one chain, in the order of their indices
+    auto chainsOf = [&overlaps](const QList<QStringList> &jobTargets)
+    {
+        QList<QList<int>> chains;
+        QList<QStringList> chainTargets;
+        for (int i = 0; i < jobTargets.size(); i++) {
+            auto &targets = jobTargets.at(i);
+            QList<int> chain {i};
+            QStringList merged = targets;
+            for (int c = chains.size() - 1; c >= 0; c--) {
+                bool shared = false;
+                for (auto &target: targets) {
+                    for (auto &other: chainTargets.at(c)) {
+                        shared = shared || overlaps(target, other);
+                    }
+                }
+                if(shared) {
+                    chain = chains.takeAt(c) + chain;
+                    merged += chainTargets.takeAt(c);
+                }
+            }
+            std::sort(chain.begin(), chain.end());
+            chains.append(chain);
+            chainTargets.append(merged);
         }
+        return chains;
+    };
+    QList<QStringList> extractTargets;
+    for (auto &job: jobs) {
+        extractTargets.append(targetsOf(job));
     }
+    auto chains = chainsOf(extractTargets);
 
-    for (auto iter = toCopy.begin(); iter != toCopy.end(); iter++) {
-        auto &from = iter.key();
-        auto &to = iter.value();
-        FS::copy fileCopyOperation(from, to);
-        if(!fileCopyOperation()) {
-            qWarning() << "Failed to copy" << from << "to" << to;
-            return false;
+    // the first failure stops the other extractions too, the staging folder is thrown away anyway
+    ConcurrentProgress siblings(progress);
+    auto extractJob = [&](int chainIndex) -> bool
+    {
+        for (int index: chains.at(chainIndex)) {
+            if(siblings.isCanceled()) {
+                return false;
+            }
+            auto &job = jobs.at(index);
+            QuaZip zip(job.archive);
+            if (!zip.open(QuaZip::mdUnzip)) {
+                qWarning() << "Could not open archive" << job.archive << "Error:" << zip.getZipError();
+                siblings.cancel();
+                return false;
+            }
+            if(job.extract) {
+                qDebug() << "Extracting " + job.name + " to " + job.extractToPath;
+                // this is a worker of the pool below already
+                MSMCZip::ExtractState state(&siblings);
+                state.setThreads(1);
+                if(!MSMCZip::extractSubDir(&zip, job.extractFolder, job.extractToPath, &state)) {
+                    if(!siblings.isCanceled()) {
+                        qWarning() << "Failed to extract" << job.name;
+                        siblings.cancel();
+                    }
+                    return false;
+                }
+            }
+            if(job.decomp) {
+                qDebug() << "Extracting " + job.decompFile + " to " + job.decompToPath;
+                if(!MSMCZip::extractRelFile(&zip, job.decompFile, job.decompToPath)) {
+                    qWarning() << "Failed to extract" << job.decompFile;
+                    siblings.cancel();
+                    return false;
+                }
+            }
+            progress->addDone(1);
         }
+        return true;
+    };
+    // extractions first, copies after, same order of precedence as when this was done serially
+    if(!ParallelJobs::run(chains.size(), extractJob, progress)) {
+        return false;
     }
-    return true;
+
+    // copies to the same place are chained the same way, the last one wins like it did serially
+    auto copyFrom = toCopy.keys();
+    auto copyTo = toCopy.values();
+    QList<QStringList> copyTargets;
+    for (auto &to: copyTo) {
+        copyTargets.append({QDir::cleanPath(to)});
+    }
+    auto copyChains = chainsOf(copyTargets);
+    auto copyJob = [&](int chainIndex) -> bool
+    {
+        for (int index: copyChains.at(chainIndex)) {
+            auto &from = copyFrom.at(index);
+            auto &to = copyTo.at(index);
+            FS::copy fileCopyOperation(from, to);
+            if(!fileCopyOperation.threads(1)()) {
+                qWarning() << "Failed to copy" << from << "to" << to;
+                return false;
+            }
+            progress->addDone(1);
+        }
+        return true;
+    };
+    return ParallelJobs::run(copyChains.size(), copyJob, progress);
 }
 
 void PackInstallTask::install()
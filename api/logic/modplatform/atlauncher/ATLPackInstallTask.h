@@ -10,9 +10,15 @@
 #include "minecraft/MinecraftInstance.h"
 #include "minecraft/PackProfile.h"
 #include "meta/Version.h"
+#include "tasks/ConcurrentProgress.h"
 
 #include <nonstd/optional>
 
+namespace MSMCZip
+{
+    class ExtractState;
+}
+
 namespace ATLauncher {
 
 class MULTISERVERMC_LOGIC_EXPORT UserInteractionSupport {
@@ -31,6 +37,25 @@ public:
 
 };
 
+/**
+ * Everything that has to be extracted from one downloaded archive.
+ */
+struct ModArchiveJob
+{
+    QString archive;
+    QString name;
+
+    // extract a folder of the archive (the whole archive if empty) into a directory
+    bool extract = false;
+    QString extractFolder;
+    QString extractToPath;
+
+    // extract a single file of the archive
+    bool decomp = false;
+    QString decompFile;
+    QString decompToPath;
+};
+
 class MULTISERVERMC_LOGIC_EXPORT PackInstallTask : public InstanceTask
 {
 Q_OBJECT
@@ -65,7 +90,8 @@ private:
     bool extractMods(
         const QMap<QString, VersionMod> &toExtract,
         const QMap<QString, VersionMod> &toDecomp,
-        const QMap<QString, QString> &toCopy
+        const QMap<QString, QString> &toCopy,
+        ConcurrentProgress * progress
     );
     void install();
 
@@ -90,9 +116,11 @@ private:
 
     QFuture<nonstd::optional<QStringList>> m_extractFuture;
     QFutureWatcher<nonstd::optional<QStringList>> m_extractFutureWatcher;
+    std::shared_ptr<MSMCZip::ExtractState> m_extractState;
 
     QFuture<bool> m_modExtractFuture;
     QFutureWatcher<bool> m_modExtractFutureWatcher;
+    std::shared_ptr<ConcurrentProgress> m_modExtractProgress;
 
 };
 
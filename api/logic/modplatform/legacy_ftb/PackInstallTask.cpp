@@ -88,14 +88,39 @@ void PackInstallTask::unzip()
         return;
     }
 
-    m_extractFuture = QtConcurrent::run(QThreadPool::globalInstance(), MSMCZip::extractDir, archivePath, extractDir.absolutePath() + "/unzip");
+    m_extractState = std::make_shared<MSMCZip::ExtractState>();
+    connect(m_extractState.get(), &MSMCZip::ExtractState::progress, this, &PackInstallTask::onUnzipProgress);
+    auto state = m_extractState;
+    auto source = archivePath;
+    auto target = extractDir.absolutePath() + "/unzip";
+    m_extractFuture = QtConcurrent::run(QThreadPool::globalInstance(), [source, target, state]()
+    {
+        return MSMCZip::extractDir(source, target, state.get());
+    });
     connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::finished, this, &PackInstallTask::onUnzipFinished);
     connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::canceled, this, &PackInstallTask::onUnzipCanceled);
     m_extractFutureWatcher.setFuture(m_extractFuture);
 }
 
+void PackInstallTask::onUnzipProgress(qint64 current, qint64 total)
+{
+    progress(total * 2 + current, total * 4);
+}
+
 void PackInstallTask::onUnzipFinished()
 {
+    bool canceled = m_extractState->isCanceled();
+    m_extractState.reset();
+    if(canceled)
+    {
+        emitAborted();
+        return;
+    }
+    if(!m_extractFuture.result())
+    {
+        emitFailed(tr("Failed to extract modpack"));
+        return;
+    }
     install();
 }
 
@@ -208,6 +233,11 @@ bool PackInstallTask::abort()
     {
         return netJobContainer->abort();
     }
+    if(m_extractState)
+    {
+        m_extractState->cancel();
+        return true;
+    }
     return false;
 }
 
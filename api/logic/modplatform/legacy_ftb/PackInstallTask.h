@@ -10,6 +10,11 @@
 
 #include <nonstd/optional>
 
+namespace MSMCZip
+{
+    class ExtractState;
+}
+
 namespace LegacyFTB {
 
 class MULTISERVERMC_LOGIC_EXPORT PackInstallTask : public InstanceTask
@@ -36,6 +41,7 @@ private slots:
     void onDownloadFailed(QString reason);
     void onDownloadProgress(qint64 current, qint64 total);
 
+    void onUnzipProgress(qint64 current, qint64 total);
     void onUnzipFinished();
     void onUnzipCanceled();
 
@@ -44,6 +50,7 @@ private: /* data */
     std::unique_ptr<QuaZip> m_packZip;
     QFuture<nonstd::optional<QStringList>> m_extractFuture;
     QFutureWatcher<nonstd::optional<QStringList>> m_extractFutureWatcher;
+    std::shared_ptr<MSMCZip::ExtractState> m_extractState;
     NetJobPtr netJobContainer;
     QString archivePath;
 
@@ -28,6 +28,21 @@ Technic::SingleZipPackInstallTask::SingleZipPackInstallTask(const QUrl &sourceUr
     m_minecraftVersion = minecraftVersion;
 }
 
+bool Technic::SingleZipPackInstallTask::canAbort() const
+{
+    return m_extractState != nullptr;
+}
+
+bool Technic::SingleZipPackInstallTask::abort()
+{
+    if(!m_extractState)
+    {
+        return false;
+    }
+    m_extractState->cancel();
+    return true;
+}
+
 void Technic::SingleZipPackInstallTask::executeTask()
 {
     setStatus(tr("Downloading modpack:\n%1").arg(m_sourceUrl.toString()));
@@ -58,7 +73,15 @@ void Technic::SingleZipPackInstallTask::downloadSucceeded()
         emitFailed(tr("Unable to open supplied modpack zip file."));
         return;
     }
-    m_extractFuture = QtConcurrent::run(QThreadPool::globalInstance(), MSMCZip::extractSubDir, m_packZip.get(), QString(""), extractDir.absolutePath());
+    m_extractState = std::make_shared<MSMCZip::ExtractState>();
+    connect(m_extractState.get(), &MSMCZip::ExtractState::progress, this, &Technic::SingleZipPackInstallTask::extractProgressChanged);
+    auto zip = m_packZip.get();
+    auto state = m_extractState;
+    auto target = extractDir.absolutePath();
+    m_extractFuture = QtConcurrent::run(QThreadPool::globalInstance(), [zip, target, state]()
+    {
+        return MSMCZip::extractSubDir(zip, QString(""), target, state.get());
+    });
     connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::finished, this, &Technic::SingleZipPackInstallTask::extractFinished);
     connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::canceled, this, &Technic::SingleZipPackInstallTask::extractAborted);
     m_extractFutureWatcher.setFuture(m_extractFuture);
@@ -76,9 +99,21 @@ void Technic::SingleZipPackInstallTask::downloadProgressChanged(qint64 current,
     setProgress(current / 2, total);
 }
 
+void Technic::SingleZipPackInstallTask::extractProgressChanged(qint64 current, qint64 total)
+{
+    setProgress(total / 2 + current / 2, total);
+}
+
 void Technic::SingleZipPackInstallTask::extractFinished()
 {
     m_packZip.reset();
+    bool canceled = m_extractState->isCanceled();
+    m_extractState.reset();
+    if (canceled)
+    {
+        emitAborted();
+        return;
+    }
     if (!m_extractFuture.result())
     {
         emitFailed(tr("Failed to extract modpack"));
@@ -27,6 +27,11 @@
 
 #include <nonstd/optional>
 
+namespace MSMCZip
+{
+    class ExtractState;
+}
+
 namespace Technic {
 
 class MULTISERVERMC_LOGIC_EXPORT SingleZipPackInstallTask : public InstanceTask
@@ -36,6 +41,9 @@ class MULTISERVERMC_LOGIC_EXPORT SingleZipPackInstallTask : public InstanceTask
 public:
     SingleZipPackInstallTask(const QUrl &sourceUrl, const QString &minecraftVersion);
 
+    bool canAbort() const override;
+    bool abort() override;
+
 protected:
     void executeTask() override;
 
@@ -44,6 +52,7 @@ private slots:
     void downloadSucceeded();
     void downloadFailed(QString reason);
     void downloadProgressChanged(qint64 current, qint64 total);
+    void extractProgressChanged(qint64 current, qint64 total);
     void extractFinished();
     void extractAborted();
 
@@ -55,6 +64,7 @@ private:
     std::unique_ptr<QuaZip> m_packZip;
     QFuture<nonstd::optional<QStringList>> m_extractFuture;
     QFutureWatcher<nonstd::optional<QStringList>> m_extractFutureWatcher;
+    std::shared_ptr<MSMCZip::ExtractState> m_extractState;
 };
 
 } // namespace Technic
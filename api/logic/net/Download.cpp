@@ -18,17 +18,43 @@
 #include <QFileInfo>
 #include <QDateTime>
 #include <QDebug>
+#include <QHash>
 #include "Env.h"
 #include <FileSystem.h>
 #include "ChecksumValidator.h"
 #include "MetaCacheSink.h"
 #include "ByteArraySink.h"
 
+namespace {
+// the running download of each file, so instances sharing a library fetch and hash it only once
+// all downloads run on the main thread
+QHash<QString, Net::Download *> inFlight;
+}
+
 namespace Net {
 
 Download::Download():NetAction()
 {
     m_status = Job_NotStarted;
+    // connected first, so the file is free again before anyone else hears about the result
+    auto leave = [this](int)
+    {
+        if(inFlight.value(m_target_path) == this)
+        {
+            inFlight.remove(m_target_path);
+        }
+    };
+    connect(this, &NetAction::succeeded, this, leave);
+    connect(this, &NetAction::failed, this, leave);
+    connect(this, &NetAction::aborted, this, leave);
+}
+
+Download::~Download()
+{
+    if(inFlight.value(m_target_path) == this)
+    {
+        inFlight.remove(m_target_path);
+    }
 }
 
 Download::Ptr Download::makeCached(QUrl url, MetaEntryPtr entry, Options options)
@@ -58,6 +84,7 @@ Download::Ptr Download::makeFile(QUrl url, QString path, Options options)
     dl->m_url = url;
     dl->m_options = options;
     dl->m_sink.reset(new FileSink(path));
+    dl->m_target_path = path;
     return std::shared_ptr<Download>(dl);
 }
 
@@ -74,6 +101,16 @@ void Download::start()
         emit aborted(m_index_within_job);
         return;
     }
+    if(!m_target_path.isEmpty())
+    {
+        auto leader = inFlight.value(m_target_path);
+        if(leader && leader != this)
+        {
+            follow(leader);
+            return;
+        }
+        inFlight.insert(m_target_path, this);
+    }
     QNetworkRequest request(m_url);
     m_status = m_sink->init(request);
     switch(m_status)
@@ -106,6 +143,46 @@ void Download::start()
     connect(rep, &QNetworkReply::readyRead, this, &Download::downloadReadyRead);
 }
 
+void Download::follow(Download * leader)
+{
+    qDebug() << "Waiting for another download of" << m_target_path;
+    m_status = Job_InProgress;
+    m_following.append(connect(leader, &NetAction::netActionProgress, this, [this](int, qint64 current, qint64 total)
+    {
+        downloadProgress(current, total);
+    }));
+    m_following.append(connect(leader, &NetAction::succeeded, this, [this](int)
+    {
+        stopFollowing();
+        m_status = Job_Finished;
+        emit succeeded(m_index_within_job);
+    }));
+    m_following.append(connect(leader, &NetAction::failed, this, [this](int)
+    {
+        stopFollowing();
+        m_status = Job_Failed;
+        emit failed(m_index_within_job);
+    }));
+    // someone else gave up on the file, that doesn't mean this one has to
+    auto retry = [this]()
+    {
+        stopFollowing();
+        m_status = Job_NotStarted;
+        start();
+    };
+    m_following.append(connect(leader, &NetAction::aborted, this, retry));
+    m_following.append(connect(leader, &QObject::destroyed, this, retry));
+}
+
+void Download::stopFollowing()
+{
+    for(auto & connection: m_following)
+    {
+        disconnect(connection);
+    }
+    m_following.clear();
+}
+
 void Download::downloadProgress(qint64 bytesReceived, qint64 bytesTotal)
 {
     m_total_progress = bytesTotal;
@@ -295,6 +372,12 @@ bool Net::Download::abort()
     {
         m_reply->abort();
     }
+    else if(!m_following.isEmpty())
+    {
+        stopFollowing();
+        m_status = Job_Aborted;
+        emit aborted(m_index_within_job);
+    }
     else
     {
         m_status = Job_Aborted;
@@ -38,7 +38,7 @@ public: /* types */
 protected: /* con/des */
     explicit Download();
 public:
-    virtual ~Download(){};
+    virtual ~Download();
     static Download::Ptr makeCached(QUrl url, MetaEntryPtr entry, Options options = Option::NoOptions);
     static Download::Ptr makeByteArray(QUrl url, QByteArray *output, Options options = Option::NoOptions);
     static Download::Ptr makeFile(QUrl url, QString path, Options options = Option::NoOptions);
@@ -54,6 +54,9 @@ public: /* methods */
 
 private: /* methods */
     bool handleRedirect();
+    /// waits for another running download of the same file and takes over its result
+    void follow(Download * leader);
+    void stopFollowing();
 
 protected slots:
     void downloadProgress(qint64 bytesReceived, qint64 bytesTotal) override;
@@ -70,6 +73,8 @@ private: /* data */
     QString m_target_path;
     std::unique_ptr<Sink> m_sink;
     Options m_options;
+    /// connections to the download of the same file this one waits for
+    QList<QMetaObject::Connection> m_following;
 };
 }
 
@@ -0,0 +1,87 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QSignalSpy>
+#include "TestUtil.h"
+
+#include "FileSystem.h"
+#include "net/Download.h"
+
+class DownloadTest : public QObject
+{
+    Q_OBJECT
+
+    QUrl source(const QString &dir, const QString &name, const QByteArray &data)
+    {
+        auto path = FS::PathCombine(dir, name);
+        FS::write(path, data);
+        return QUrl::fromLocalFile(path);
+    }
+
+private
+slots:
+    // a second download of the same file waits for the first one and takes its result
+    void test_sameTarget()
+    {
+        QTemporaryDir tempDir;
+        auto target = FS::PathCombine(tempDir.path(), "libraries", "lib.jar");
+        auto first = Net::Download::makeFile(source(tempDir.path(), "a", "first"), target);
+        auto second = Net::Download::makeFile(source(tempDir.path(), "b", "second"), target);
+        QSignalSpy firstDone(first.get(), &NetAction::succeeded);
+        QSignalSpy secondDone(second.get(), &NetAction::succeeded);
+
+        first->start();
+        second->start();
+        QVERIFY(secondDone.wait(5000));
+        QCOMPARE(firstDone.size(), 1);
+        QVERIFY(second->wasSuccessful());
+        QCOMPARE(FS::read(target), QByteArray("first"));
+
+        // nothing is running anymore, so the next one downloads it again
+        auto third = Net::Download::makeFile(source(tempDir.path(), "c", "third"), target);
+        QSignalSpy thirdDone(third.get(), &NetAction::succeeded);
+        third->start();
+        QVERIFY(thirdDone.wait(5000));
+        QCOMPARE(FS::read(target), QByteArray("third"));
+    }
+
+    // when the one downloading gets aborted, the one waiting downloads the file itself
+    void test_leaderAborted()
+    {
+        QTemporaryDir tempDir;
+        auto target = FS::PathCombine(tempDir.path(), "lib.jar");
+        auto first = Net::Download::makeFile(source(tempDir.path(), "a", "first"), target);
+        auto second = Net::Download::makeFile(source(tempDir.path(), "b", "second"), target);
+        QSignalSpy firstAborted(first.get(), &NetAction::aborted);
+        QSignalSpy secondDone(second.get(), &NetAction::succeeded);
+
+        first->start();
+        second->start();
+        first->abort();
+        QVERIFY(secondDone.wait(5000));
+        QCOMPARE(firstAborted.size(), 1);
+        QCOMPARE(FS::read(target), QByteArray("second"));
+    }
+
+    void test_followerAborted()
+    {
+        QTemporaryDir tempDir;
+        auto target = FS::PathCombine(tempDir.path(), "lib.jar");
+        auto first = Net::Download::makeFile(source(tempDir.path(), "a", "first"), target);
+        auto second = Net::Download::makeFile(source(tempDir.path(), "b", "second"), target);
+        QSignalSpy firstDone(first.get(), &NetAction::succeeded);
+        QSignalSpy secondAborted(second.get(), &NetAction::aborted);
+        QSignalSpy secondDone(second.get(), &NetAction::succeeded);
+
+        first->start();
+        second->start();
+        second->abort();
+        QCOMPARE(secondAborted.size(), 1);
+        QVERIFY(firstDone.wait(5000));
+        QCOMPARE(secondDone.size(), 0);
+        QCOMPARE(FS::read(target), QByteArray("first"));
+    }
+};
+
+QTEST_GUILESS_MAIN(DownloadTest)
+
+#include "Download_test.moc"
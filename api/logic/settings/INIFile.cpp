@@ -17,11 +17,62 @@
 #include <FileSystem.h>
 
 #include <QFile>
-#include <QTextStream>
-#include <QStringList>
 #include <QSaveFile>
 #include <QDebug>
 
+#include <cstring>
+
+namespace {
+inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+void trim(const char *&begin, const char *&end)
+{
+    while(begin < end && isSpace(*begin))
+        begin++;
+    while(end > begin && isSpace(*(end - 1)))
+        end--;
+}
+
+// same as INIFile::unescape, on the raw bytes of a value
+QString unescapeValue(const char *begin, const char *end)
+{
+    // most values have nothing to unescape
+    if(!memchr(begin, '\\', end - begin))
+    {
+        return QString::fromUtf8(begin, end - begin);
+    }
+    QByteArray out;
+    out.reserve(end - begin);
+    bool escaped = false;
+    for(const char *p = begin; p < end; p++)
+    {
+        char c = *p;
+        if(escaped)
+        {
+            if(c == 'n')
+                out += '\n';
+            else if(c == 't')
+                out += '\t';
+            else
+                out += c;
+            escaped = false;
+        }
+        else if(c == '\\')
+        {
+            escaped = true;
+        }
+        else
+        {
+            out += c;
+        }
+    }
+    return QString::fromUtf8(out);
+}
+}
+
 INIFile::INIFile()
 {
 }
@@ -116,34 +167,53 @@ bool INIFile::loadFile(QString fileName)
 
 bool INIFile::loadFile(QByteArray file)
 {
-    QTextStream in(file);
-    in.setCodec("UTF-8");
-
-    QStringList lines = in.readAll().split('\n');
-    for (int i = 0; i < lines.count(); i++)
+    // a single pass over the raw bytes, only the keys and values themselves get decoded
+    const char *data = file.constData();
+    const char *end = data + file.size();
+    if(file.startsWith("\xEF\xBB\xBF"))
     {
-        QString &lineRaw = lines[i];
-        // Ignore comments.
-        int commentIndex = 0;
-        QString line = lineRaw;
-        // Search for comments until no more escaped # are available
-        while((commentIndex = line.indexOf('#', commentIndex + 1)) != -1) {
-            if(commentIndex > 0 && line.at(commentIndex - 1) == '\\') {
-                continue;
-            }
-            line = line.left(lineRaw.indexOf('#')).trimmed();
+        // UTF-8 byte order mark
+        data += 3;
+    }
+    while(data < end)
+    {
+        auto lineEnd = static_cast<const char *>(memchr(data, '\n', end - data));
+        if(!lineEnd)
+        {
+            lineEnd = end;
         }
 
-        int eqPos = line.indexOf('=');
-        if (eqPos == -1)
-            continue;
-        QString key = line.left(eqPos).trimmed();
-        QString valueStr = line.right(line.length() - eqPos - 1).trimmed();
-
-        valueStr = unescape(valueStr);
+        // find the separator and where the comment starts (at the first # that is not escaped)
+        const char *separator = nullptr;
+        const char *contentEnd = lineEnd;
+        for(const char *p = data; p < lineEnd; p++)
+        {
+            if(*p == '\\')
+            {
+                p++;
+            }
+            else if(*p == '#')
+            {
+                contentEnd = p;
+                break;
+            }
+            else if(*p == '=' && !separator)
+            {
+                separator = p;
+            }
+        }
 
-        QVariant value(valueStr);
-        this->operator[](key) = value;
+        if(separator)
+        {
+            const char *keyBegin = data;
+            const char *keyEnd = separator;
+            trim(keyBegin, keyEnd);
+            const char *valueBegin = separator + 1;
+            const char *valueEnd = contentEnd;
+            trim(valueBegin, valueEnd);
+            insert(QString::fromUtf8(keyBegin, keyEnd - keyBegin), QVariant(unescapeValue(valueBegin, valueEnd)));
+        }
+        data = lineEnd + 1;
     }
 
     return true;
@@ -0,0 +1,28 @@
+#include <QTest>
+#include "TestUtil.h"
+
+#include "settings/INIFile.h"
+
+class IniFileBench : public QObject
+{
+    Q_OBJECT
+private
+slots:
+    void bench_Load()
+    {
+        QByteArray data;
+        for(int i = 0; i < 100; i++)
+        {
+            data += QString("key%1=some value with \\#escapes\\n and a bit of text %1\n").arg(i).toUtf8();
+        }
+        QBENCHMARK
+        {
+            INIFile f;
+            f.loadFile(data);
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(IniFileBench)
+
+#include "INIFile_bench.moc"
@@ -56,6 +56,34 @@ slots:
         QCOMPARE(a, f2.get("a","NOT SET").toString());
         QCOMPARE(b, f2.get("b","NOT SET").toString());
     }
+
+    void test_Parse()
+    {
+        QByteArray data =
+            "\xEF\xBB\xBF# a comment\r\n"
+            "plain=value\r\n"
+            "  spaced  =   some value   \n"
+            "comment=before # after\n"
+            "hash=not\\#a comment\n"
+            "escapes=a\\nb\\tc\\\\d\n"
+            "unicode=\xC5\xBElu\xC5\xA5ou\xC4\x8Dk\xC3\xBD\n"
+            "equals=a=b\n"
+            "no separator here\n"
+            "empty=\n"
+            "last=no newline";
+        INIFile f;
+        QVERIFY(f.loadFile(data));
+        QCOMPARE(f.get("plain", "NOT SET").toString(), QString("value"));
+        QCOMPARE(f.get("spaced", "NOT SET").toString(), QString("some value"));
+        QCOMPARE(f.get("comment", "NOT SET").toString(), QString("before"));
+        QCOMPARE(f.get("hash", "NOT SET").toString(), QString("not#a comment"));
+        QCOMPARE(f.get("escapes", "NOT SET").toString(), QString("a\nb\tc\\d"));
+        QCOMPARE(f.get("unicode", "NOT SET").toString(), QString::fromUtf8("\xC5\xBElu\xC5\xA5ou\xC4\x8Dk\xC3\xBD"));
+        QCOMPARE(f.get("equals", "NOT SET").toString(), QString("a=b"));
+        QCOMPARE(f.get("empty", "NOT SET").toString(), QString(""));
+        QCOMPARE(f.get("last", "NOT SET").toString(), QString("no newline"));
+        QCOMPARE(f.size(), 9);
+    }
 };
 
 QTEST_GUILESS_MAIN(IniFileTest)
@@ -16,21 +16,92 @@
 #include "INISettingsObject.h"
 #include "Setting.h"
 
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSet>
+#include <QThread>
+
+namespace {
+// pending changes are written at most this long after the first one...
+const int maxSaveLatency = 2000;
+// ...or once this many have piled up
+const int maxPendingChanges = 100;
+
+// every live object, so everything can be written out on exit
+QMutex liveObjectsMutex;
+QSet<INISettingsObject *> liveObjects;
+}
+
 INISettingsObject::INISettingsObject(const QString &path, QObject *parent)
     : SettingsObject(parent)
 {
     m_filePath = path;
     m_ini.loadFile(path);
+    init();
+}
+
+INISettingsObject::INISettingsObject(const QString &path, const INIFile &contents, QObject *parent)
+    : SettingsObject(parent)
+{
+    m_filePath = path;
+    m_ini = contents;
+    init();
+}
+
+void INISettingsObject::init()
+{
+    m_saveTimer.setSingleShot(true);
+    connect(&m_saveTimer, &QTimer::timeout, this, &INISettingsObject::saveNow);
+    QMutexLocker locker(&liveObjectsMutex);
+    liveObjects.insert(this);
+}
+
+INISettingsObject::~INISettingsObject()
+{
+    {
+        QMutexLocker locker(&liveObjectsMutex);
+        liveObjects.remove(this);
+    }
+    saveNow();
+}
+
+void INISettingsObject::saveAll()
+{
+    // holding the list keeps the objects alive, and saveNow() locks each object's own state
+    QMutexLocker locker(&liveObjectsMutex);
+    for(auto object: liveObjects)
+    {
+        object->saveNow();
+    }
 }
 
 void INISettingsObject::setFilePath(const QString &filePath)
 {
+    // whatever is pending belongs to the old file
+    saveNow();
+    QMutexLocker locker(&m_mutex);
     m_filePath = filePath;
 }
 
+void INISettingsObject::setContents(const INIFile &contents)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_ini = contents;
+    }
+    invalidateCaches();
+}
+
 bool INISettingsObject::reload()
 {
-    return m_ini.loadFile(m_filePath) && SettingsObject::reload();
+    saveNow();
+    bool loaded;
+    {
+        QMutexLocker locker(&m_mutex);
+        loaded = m_ini.loadFile(m_filePath);
+    }
+    invalidateCaches();
+    return loaded && SettingsObject::reload();
 }
 
 void INISettingsObject::suspendSave()
@@ -43,27 +114,52 @@ void INISettingsObject::resumeSave()
     m_suspendSave = false;
     if(m_doSave)
     {
-        m_ini.saveFile(m_filePath);
+        // the end of a batch, no reason to wait any longer
+        m_doSave = false;
+        {
+            QMutexLocker locker(&m_mutex);
+            m_dirty = true;
+        }
+        saveNow();
+    }
+}
+
+void INISettingsObject::saveNow()
+{
+    if(m_saveTimer.isActive() && QThread::currentThread() == thread())
+    {
+        m_saveTimer.stop();
+    }
+    QMutexLocker locker(&m_mutex);
+    if(!m_dirty)
+    {
+        return;
     }
+    m_dirty = false;
+    m_pendingChanges = 0;
+    m_ini.saveFile(m_filePath);
 }
 
 void INISettingsObject::changeSetting(const Setting &setting, QVariant value)
 {
     if (contains(setting.id()))
     {
-        // valid value -> set the main config, remove all the sysnonyms
-        if (value.isValid())
         {
-            auto list = setting.configKeys();
-            m_ini.set(list.takeFirst(), value);
-            for(auto iter: list)
-                m_ini.remove(iter);
-        }
-        // invalid -> remove all (just like resetSetting)
-        else
-        {
-            for(auto iter: setting.configKeys())
-                m_ini.remove(iter);
+            QMutexLocker locker(&m_mutex);
+            // valid value -> set the main config, remove all the sysnonyms
+            if (value.isValid())
+            {
+                auto list = setting.configKeys();
+                m_ini.set(list.takeFirst(), value);
+                for(auto iter: list)
+                    m_ini.remove(iter);
+            }
+            // invalid -> remove all (just like resetSetting)
+            else
+            {
+                for(auto iter: setting.configKeys())
+                    m_ini.remove(iter);
+            }
         }
         doSave();
     }
@@ -74,11 +170,30 @@ void INISettingsObject::doSave()
     if(m_suspendSave)
     {
         m_doSave = true;
+        return;
+    }
+    bool tooMany;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_dirty = true;
+        tooMany = ++m_pendingChanges >= maxPendingChanges;
     }
-    else
+    // the timer only works on the thread this object lives on
+    if(m_saveDelay <= 0 || tooMany || QThread::currentThread() != thread())
     {
-        m_ini.saveFile(m_filePath);
+        saveNow();
+        return;
     }
+    if(!m_saveTimer.isActive())
+    {
+        m_firstChange.start();
+    }
+    else if(m_firstChange.elapsed() >= maxSaveLatency)
+    {
+        saveNow();
+        return;
+    }
+    m_saveTimer.start(m_saveDelay);
 }
 
 void INISettingsObject::resetSetting(const Setting &setting)
@@ -86,8 +201,11 @@ void INISettingsObject::resetSetting(const Setting &setting)
     // if we have the setting, remove all the synonyms. ALL OF THEM
     if (contains(setting.id()))
     {
-        for(auto iter: setting.configKeys())
-            m_ini.remove(iter);
+        {
+            QMutexLocker locker(&m_mutex);
+            for(auto iter: setting.configKeys())
+                m_ini.remove(iter);
+        }
         doSave();
     }
 }
@@ -97,6 +215,7 @@ QVariant INISettingsObject::retrieveValue(const Setting &setting)
     // if we have the setting, return value of the first matching synonym
     if (contains(setting.id()))
     {
+        QMutexLocker locker(&m_mutex);
         for(auto iter: setting.configKeys())
         {
             if(m_ini.contains(iter))
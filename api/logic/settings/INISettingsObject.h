@@ -16,6 +16,9 @@
 #pragma once
 
 #include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QMutex>
 
 #include "settings/INIFile.h"
 
@@ -25,12 +28,23 @@
 
 /*!
  * \brief A settings object that stores its settings in an INIFile.
+ *
+ * Changes are written right away, unless a save delay is set with setSaveDelay(). Then they are
+ * collected and written together once the settings were left alone for a moment, with an upper bound
+ * on both the delay and the number of pending changes. Pending changes are written when the object is
+ * destroyed, by saveNow() and by saveAll().
+ *
+ * Only long-lived objects should use a delay. One that is filled and dropped again, like the settings
+ * of an instance being staged, has to be on disk before the caller moves on.
  */
 class MULTISERVERMC_LOGIC_EXPORT INISettingsObject : public SettingsObject
 {
     Q_OBJECT
 public:
     explicit INISettingsObject(const QString &path, QObject *parent = 0);
+    /// Use contents that were already read from the file at path
+    INISettingsObject(const QString &path, const INIFile &contents, QObject *parent = 0);
+    virtual ~INISettingsObject();
 
     /*!
      * \brief Gets the path to the INI file.
@@ -49,8 +63,24 @@ public:
 
     bool reload() override;
 
+    /// Replace the settings with contents read from the file elsewhere, does not save them
+    void setContents(const INIFile &contents);
+
     void suspendSave() override;
     void resumeSave() override;
+    void saveNow() override;
+
+    /*!
+     * \brief Sets how long the settings have to be left alone before changes are written.
+     * 0, the default, writes every change right away.
+     */
+    void setSaveDelay(int msec)
+    {
+        m_saveDelay = msec;
+    }
+
+    /// Write the pending changes of all INI settings objects, used before exiting. Safe to call from any thread.
+    static void saveAll();
 
 protected slots:
     virtual void changeSetting(const Setting &setting, QVariant value) override;
@@ -60,7 +90,19 @@ protected:
     virtual QVariant retrieveValue(const Setting &setting) override;
     void doSave();
 
+private:
+    void init();
+
 protected:
     INIFile m_ini;
     QString m_filePath;
+
+private:
+    QTimer m_saveTimer;
+    QElapsedTimer m_firstChange;
+    int m_saveDelay = 0;
+    int m_pendingChanges = 0;
+    bool m_dirty = false;
+    /// guards the contents, the path and the dirty state, saveAll() may write from another thread
+    mutable QMutex m_mutex;
 };
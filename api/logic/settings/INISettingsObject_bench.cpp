@@ -0,0 +1,60 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include "TestUtil.h"
+
+#include "FileSystem.h"
+#include "settings/INISettingsObject.h"
+
+class INISettingsObjectBench : public QObject
+{
+    Q_OBJECT
+private
+slots:
+    void bench_changes_data()
+    {
+        QTest::addColumn<int>("saveDelay");
+        QTest::addColumn<int>("instances");
+        QTest::addColumn<int>("changes");
+        QTest::newRow("immediate, 200 instances x 10 changes") << 0 << 200 << 10;
+        QTest::newRow("coalesced, 200 instances x 10 changes") << 250 << 200 << 10;
+        QTest::newRow("immediate, 10 instances x 200 changes") << 0 << 10 << 200;
+        QTest::newRow("coalesced, 10 instances x 200 changes") << 250 << 10 << 200;
+    }
+    void bench_changes()
+    {
+        QFETCH(int, saveDelay);
+        QFETCH(int, instances);
+        QFETCH(int, changes);
+        QTemporaryDir tempDir;
+
+        QList<std::shared_ptr<INISettingsObject>> objects;
+        for(int i = 0; i < instances; i++)
+        {
+            auto object = std::make_shared<INISettingsObject>(FS::PathCombine(tempDir.path(), QString("%1.cfg").arg(i)));
+            object->setSaveDelay(saveDelay);
+            object->registerSetting("JavaPath", "");
+            object->registerSetting("JvmArgs", "");
+            object->registerSetting("totalTimePlayed", 0);
+            objects.append(object);
+        }
+
+        // includes writing everything out, like on exit
+        QBENCHMARK
+        {
+            for(int change = 0; change < changes; change++)
+            {
+                for(auto & object: objects)
+                {
+                    object->set("JavaPath", QString("/usr/lib/jvm/java-%1/bin/java").arg(change));
+                    object->set("JvmArgs", "-XX:+UseG1GC");
+                    object->set("totalTimePlayed", change);
+                }
+            }
+            INISettingsObject::saveAll();
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(INISettingsObjectBench)
+
+#include "INISettingsObject_bench.moc"
@@ -0,0 +1,149 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QSignalSpy>
+#include "TestUtil.h"
+
+#include "FileSystem.h"
+#include "settings/INIFile.h"
+#include "settings/INISettingsObject.h"
+#include "settings/Setting.h"
+
+class INISettingsObjectTest : public QObject
+{
+    Q_OBJECT
+
+    QVariant valueOnDisk(const QString &path, const QString &key)
+    {
+        INIFile file;
+        file.loadFile(path);
+        return file.get(key, QVariant());
+    }
+
+private
+slots:
+    void test_coalescedSave()
+    {
+        QTemporaryDir tempDir;
+        QString path = FS::PathCombine(tempDir.path(), "test.cfg");
+        INISettingsObject settings(path);
+        settings.setSaveDelay(250);
+        settings.registerSetting("number", 0);
+
+        for(int i = 1; i <= 10; i++)
+        {
+            settings.set("number", i);
+        }
+        QCOMPARE(settings.get("number").toInt(), 10);
+        // nothing written yet
+        QVERIFY(!QFileInfo(path).exists());
+
+        // written once the settings are left alone
+        QTRY_COMPARE(valueOnDisk(path, "number").toInt(), 10);
+    }
+
+    void test_saveNow()
+    {
+        QTemporaryDir tempDir;
+        QString path = FS::PathCombine(tempDir.path(), "test.cfg");
+        INISettingsObject settings(path);
+        settings.setSaveDelay(250);
+        settings.registerSetting("text", "");
+        settings.set("text", "hello");
+        settings.saveNow();
+        QCOMPARE(valueOnDisk(path, "text").toString(), QString("hello"));
+    }
+
+    void test_saveOnDestruction()
+    {
+        QTemporaryDir tempDir;
+        QString path = FS::PathCombine(tempDir.path(), "test.cfg");
+        {
+            INISettingsObject settings(path);
+            settings.setSaveDelay(250);
+            settings.registerSetting("text", "");
+            settings.set("text", "goodbye");
+        }
+        QCOMPARE(valueOnDisk(path, "text").toString(), QString("goodbye"));
+    }
+
+    void test_saveAll()
+    {
+        QTemporaryDir tempDir;
+        QString pathA = FS::PathCombine(tempDir.path(), "a.cfg");
+        QString pathB = FS::PathCombine(tempDir.path(), "b.cfg");
+        INISettingsObject a(pathA);
+        INISettingsObject b(pathB);
+        a.setSaveDelay(250);
+        b.setSaveDelay(250);
+        a.registerSetting("text", "");
+        b.registerSetting("text", "");
+        a.set("text", "a");
+        b.set("text", "b");
+        INISettingsObject::saveAll();
+        QCOMPARE(valueOnDisk(pathA, "text").toString(), QString("a"));
+        QCOMPARE(valueOnDisk(pathB, "text").toString(), QString("b"));
+    }
+
+    void test_pendingLimit()
+    {
+        QTemporaryDir tempDir;
+        QString path = FS::PathCombine(tempDir.path(), "test.cfg");
+        INISettingsObject settings(path);
+        settings.setSaveDelay(60000);
+        settings.registerSetting("number", 0);
+        for(int i = 1; i <= 1000; i++)
+        {
+            settings.set("number", i);
+        }
+        // too many changes piled up, some were written without waiting for the timer
+        QVERIFY(QFileInfo(path).exists());
+        QVERIFY(valueOnDisk(path, "number").toInt() >= 100);
+    }
+
+    void test_immediateSave()
+    {
+        QTemporaryDir tempDir;
+        QString path = FS::PathCombine(tempDir.path(), "test.cfg");
+        // no delay unless asked for one, settings filled in for a staged instance are on disk right away
+        INISettingsObject settings(path);
+        settings.registerSetting("number", 0);
+        settings.set("number", 5);
+        QCOMPARE(valueOnDisk(path, "number").toInt(), 5);
+    }
+
+    void test_cachedValues()
+    {
+        QTemporaryDir tempDir;
+        INISettingsObject global(FS::PathCombine(tempDir.path(), "global.cfg"));
+        INISettingsObject local(FS::PathCombine(tempDir.path(), "local.cfg"));
+        auto javaPath = global.registerSetting("JavaPath", "java");
+        auto overrideJava = local.registerSetting("OverrideJava", false);
+        local.registerOverride(javaPath, overrideJava);
+
+        QCOMPARE(local.get("JavaPath").toString(), QString("java"));
+
+        // a change of the global setting shows through the cached override
+        global.set("JavaPath", "/opt/java/bin/java");
+        QCOMPARE(local.get("JavaPath").toString(), QString("/opt/java/bin/java"));
+
+        // and so does the gate
+        local.set("OverrideJava", true);
+        local.set("JavaPath", "/usr/bin/java");
+        QCOMPARE(local.get("JavaPath").toString(), QString("/usr/bin/java"));
+        local.reset("OverrideJava");
+        QCOMPARE(local.get("JavaPath").toString(), QString("/opt/java/bin/java"));
+
+        // the new value is there for anything reacting to the change
+        QString seen;
+        connect(&global, &SettingsObject::SettingChanged, [&](const Setting &, QVariant)
+        {
+            seen = local.get("JavaPath").toString();
+        });
+        global.set("JavaPath", "/elsewhere/java");
+        QCOMPARE(seen, QString("/elsewhere/java"));
+    }
+};
+
+QTEST_GUILESS_MAIN(INISettingsObjectTest)
+
+#include "INISettingsObject_test.moc"
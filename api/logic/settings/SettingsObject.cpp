@@ -18,9 +18,16 @@
 #include "settings/OverrideSetting.h"
 #include "PassthroughSetting.h"
 #include <QDebug>
+#include <QAtomicInt>
+#include <QThread>
 
 #include <QVariant>
 
+namespace {
+// bumped on every change, caches from an older generation are stale
+QAtomicInt cacheGeneration;
+}
+
 SettingsObject::SettingsObject(QObject *parent) : QObject(parent)
 {
 }
@@ -90,8 +97,38 @@ std::shared_ptr<Setting> SettingsObject::getSetting(const QString &id) const
 
 QVariant SettingsObject::get(const QString &id) const
 {
+    // the cache is only used from the thread this object lives on, it is not thread safe
+    bool useCache = QThread::currentThread() == thread();
+    if(useCache)
+    {
+        int generation = cacheGeneration.load();
+        if(generation != m_cacheGeneration)
+        {
+            m_cache.clear();
+            m_cacheGeneration = generation;
+        }
+        auto iter = m_cache.constFind(id);
+        if(iter != m_cache.constEnd())
+        {
+            return *iter;
+        }
+    }
     auto setting = getSetting(id);
-    return (setting ? setting->get() : QVariant());
+    if(!setting)
+    {
+        return QVariant();
+    }
+    auto value = setting->get();
+    if(useCache)
+    {
+        m_cache.insert(id, value);
+    }
+    return value;
+}
+
+void SettingsObject::invalidateCaches()
+{
+    cacheGeneration.ref();
 }
 
 bool SettingsObject::set(const QString &id, QVariant value)
@@ -132,6 +169,9 @@ bool SettingsObject::reload()
 
 void SettingsObject::connectSignals(const Setting &setting)
 {
+    // first, so everything reacting to the change already sees the new value
+    connect(&setting, &Setting::SettingChanged, this, &SettingsObject::invalidateCaches);
+    connect(&setting, &Setting::settingReset, this, &SettingsObject::invalidateCaches);
     connect(&setting, SIGNAL(SettingChanged(const Setting &, QVariant)),
             SLOT(changeSetting(const Setting &, QVariant)));
     connect(&setting, SIGNAL(SettingChanged(const Setting &, QVariant)),
@@ -17,6 +17,7 @@
 
 #include <QObject>
 #include <QMap>
+#include <QHash>
 #include <QStringList>
 #include <QVariant>
 #include <memory>
@@ -118,6 +119,8 @@ public:
      * \param id The ID of the setting to get.
      * \return The setting's value as a QVariant.
      * If no setting with the given ID exists, returns an invalid QVariant.
+     *
+     * Resolved values are cached until any setting changes.
      */
     QVariant get(const QString &id) const;
 
@@ -151,6 +154,10 @@ public:
 
     virtual void suspendSave() = 0;
     virtual void resumeSave() = 0;
+    /*!
+     * \brief Writes out any changes that are still waiting to be saved.
+     */
+    virtual void saveNow() = 0;
 signals:
     /*!
      * \brief Signal emitted when one of this SettingsObject object's settings changes.
@@ -197,6 +204,12 @@ protected:
      */
     void connectSignals(const Setting &setting);
 
+    /*!
+     * \brief Drops the cached values of all settings objects.
+     * Settings can resolve to settings of other objects (overrides), so all of them go at once.
+     */
+    static void invalidateCaches();
+
     /*!
      * \brief Function used by Setting objects to get their values from the SettingsObject.
      * \param setting The
@@ -208,6 +221,8 @@ protected:
 
 private:
     QMap<QString, std::shared_ptr<Setting>> m_settings;
+    mutable QHash<QString, QVariant> m_cache;
+    mutable int m_cacheGeneration = -1;
 protected:
     bool m_suspendSave = false;
     bool m_doSave = false;
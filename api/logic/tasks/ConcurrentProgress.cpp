@@ -0,0 +1,32 @@
+#include "ConcurrentProgress.h"
+
+#include <algorithm>
+
+void ConcurrentProgress::setTotal(qint64 total)
+{
+    m_total = total;
+    emit progress(m_done, total);
+}
+
+void ConcurrentProgress::addTotal(qint64 total)
+{
+    qint64 newTotal = m_total += total;
+    emit progress(m_done, newTotal);
+}
+
+void ConcurrentProgress::addDone(qint64 done)
+{
+    qint64 current = m_done += done;
+    qint64 total = m_total;
+    // report every percent or so, this is called from many threads for every item
+    qint64 step = std::max<qint64>(total / 100, 1);
+    qint64 reported = m_reported;
+    if(current - reported < step && current != total)
+    {
+        return;
+    }
+    if(m_reported.compare_exchange_strong(reported, current))
+    {
+        emit progress(current, total);
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <QObject>
+#include <atomic>
+
+#include "multiservermc_logic_export.h"
+
+/**
+ * Progress and cancellation of work running on worker threads.
+ *
+ * Create it on the thread that wants the progress signals and hand it to the workers.
+ * cancel() can be called from anywhere, the workers are expected to check isCanceled() regularly.
+ * A progress made with cancelWith is also canceled when that one is, so a part of the work can be
+ * stopped on its own or together with everything else.
+ */
+class MULTISERVERMC_LOGIC_EXPORT ConcurrentProgress : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ConcurrentProgress(const ConcurrentProgress * cancelWith = nullptr) : m_cancelWith(cancelWith)
+    {
+    }
+
+    void cancel()
+    {
+        m_canceled = true;
+    }
+    bool isCanceled() const
+    {
+        return m_canceled || (m_cancelWith && m_cancelWith->isCanceled());
+    }
+
+    // thread safe, used by the workers
+    void setTotal(qint64 total);
+    void addTotal(qint64 total);
+    void addDone(qint64 done);
+
+    qint64 done() const
+    {
+        return m_done;
+    }
+    qint64 total() const
+    {
+        return m_total;
+    }
+
+signals:
+    void progress(qint64 current, qint64 total);
+
+private:
+    const ConcurrentProgress * m_cancelWith;
+    std::atomic<bool> m_canceled {false};
+    std::atomic<qint64> m_done {0};
+    std::atomic<qint64> m_total {0};
+    std::atomic<qint64> m_reported {0};
+};
@@ -0,0 +1,76 @@
+#include "ParallelJobs.h"
+#include "ConcurrentProgress.h"
+
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+
+#include <algorithm>
+#include <atomic>
+
+namespace {
+
+class JobWorker : public QRunnable
+{
+public:
+    JobWorker(int count, const std::function<bool(int)> &job, std::atomic<int> &next, std::atomic<bool> &failed, ConcurrentProgress * progress)
+        : m_count(count), m_job(job), m_next(next), m_failed(failed), m_progress(progress)
+    {
+    }
+    void run() override
+    {
+        while(!m_failed && !(m_progress && m_progress->isCanceled()))
+        {
+            int index = m_next++;
+            if(index >= m_count)
+            {
+                return;
+            }
+            if(!m_job(index))
+            {
+                m_failed = true;
+                return;
+            }
+        }
+    }
+
+private:
+    int m_count;
+    const std::function<bool(int)> &m_job;
+    std::atomic<int> &m_next;
+    std::atomic<bool> &m_failed;
+    ConcurrentProgress * m_progress;
+};
+
+}
+
+bool ParallelJobs::run(int count, const std::function<bool(int)> &job, ConcurrentProgress * progress, int threads)
+{
+    if(threads <= 0)
+    {
+        threads = QThread::idealThreadCount();
+    }
+    threads = std::max(1, std::min(threads, count));
+
+    std::atomic<int> next {0};
+    std::atomic<bool> failed {false};
+    if(threads == 1)
+    {
+        JobWorker(count, job, next, failed, progress).run();
+    }
+    else
+    {
+        QThreadPool pool;
+        pool.setMaxThreadCount(threads);
+        for(int i = 0; i < threads; i++)
+        {
+            pool.start(new JobWorker(count, job, next, failed, progress));
+        }
+        pool.waitForDone();
+    }
+    if(progress && progress->isCanceled())
+    {
+        return false;
+    }
+    return !failed;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <functional>
+
+#include "multiservermc_logic_export.h"
+
+class ConcurrentProgress;
+
+namespace ParallelJobs
+{
+/**
+ * Runs job(0) ... job(count - 1) on a pool of worker threads and waits for them to finish.
+ *
+ * Jobs are handed out in order, as the workers become free. Once a job fails or the progress
+ * gets canceled, no more jobs are started (the ones already running are left to finish).
+ *
+ * \param threads the maximum number of jobs running at the same time, 0 for one per CPU core
+ * \return true if all of the jobs ran and succeeded
+ */
+MULTISERVERMC_LOGIC_EXPORT bool run(int count, const std::function<bool(int)> &job, ConcurrentProgress * progress = nullptr, int threads = 0);
+}
@@ -5,6 +5,7 @@
 #include "pages/BasePage.h"
 #include "pages/BasePageProvider.h"
 #include "pages/instance/LogPage.h"
+#include "pages/instance/TelemetryPage.h"
 #include "pages/instance/VersionPage.h"
 #include "pages/instance/ModFolderPage.h"
 #include "pages/instance/NotesPage.h"
@@ -30,6 +31,7 @@ public:
     {
         QList<BasePage *> values;
         values.append(new LogPage(inst));
+        values.append(new TelemetryPage(inst));
         std::shared_ptr<MinecraftInstance> onesix = std::dynamic_pointer_cast<MinecraftInstance>(inst);
         if(onesix)
         {
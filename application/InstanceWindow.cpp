@@ -20,6 +20,7 @@
 #include <QMessageBox>
 #include <QHBoxLayout>
 #include <QPushButton>
+#include <QLabel>
 #include <qlayoutitem.h>
 #include <QCloseEvent>
 
@@ -67,6 +68,10 @@ InstanceWindow::InstanceWindow(InstancePtr instance, QWidget *parent)
         auto spacer = new QSpacerItem(40, 20, QSizePolicy::Expanding, QSizePolicy::Minimum);
         horizontalLayout->addSpacerItem(spacer);
 
+        m_restartLabel = new QLabel();
+        m_restartLabel->setVisible(false);
+        horizontalLayout->addWidget(m_restartLabel);
+
         m_killButton = new QPushButton();
         horizontalLayout->addWidget(m_killButton);
         connect(m_killButton, SIGNAL(clicked(bool)), SLOT(on_btnKillMinecraft_clicked()));
@@ -117,9 +122,9 @@ void InstanceWindow::updateLaunchButtons()
 {
     if(m_instance->isRunning())
     {
-        m_killButton->setText(tr("Kill"));
+        m_killButton->setText(tr("Stop"));
         m_killButton->setObjectName("killButton");
-        m_killButton->setToolTip(tr("Kill the running instance"));
+        m_killButton->setToolTip(tr("Stop the running server"));
     }
     else if(!m_instance->canLaunch())
     {
@@ -139,9 +144,36 @@ void InstanceWindow::updateLaunchButtons()
     m_killButton->setStyleSheet(QString());
 }
 
+void InstanceWindow::updateRestartStatus()
+{
+    if(!m_proc || (!m_proc->restartCount() && !m_proc->nextRestart().isValid()))
+    {
+        m_restartLabel->setVisible(false);
+        return;
+    }
+    QString text = tr("Restarts: %1").arg(m_proc->restartCount());
+    auto nextRestart = m_proc->nextRestart();
+    if(nextRestart.isValid())
+    {
+        text += " " + tr("(next at %1)").arg(nextRestart.toLocalTime().time().toString());
+    }
+    m_restartLabel->setText(text);
+    m_restartLabel->setToolTip(tr("Last restart reason: %1").arg(m_proc->lastRestartReason()));
+    m_restartLabel->setVisible(true);
+}
+
 void InstanceWindow::on_InstanceLaunchTask_changed(shared_qobject_ptr<LaunchTask> proc)
 {
+    if(m_proc)
+    {
+        disconnect(m_proc.get(), &LaunchTask::restartsChanged, this, &InstanceWindow::updateRestartStatus);
+    }
     m_proc = proc;
+    if(m_proc)
+    {
+        connect(m_proc.get(), &LaunchTask::restartsChanged, this, &InstanceWindow::updateRestartStatus);
+    }
+    updateRestartStatus();
 }
 
 void InstanceWindow::on_RunningState_changed(bool running)
@@ -23,6 +23,7 @@
 #include "pages/BasePageContainer.h"
 
 class QPushButton;
+class QLabel;
 class PageContainer;
 class InstanceWindow : public QMainWindow, public BasePageContainer
 {
@@ -60,6 +61,7 @@ protected:
 
 private:
     void updateLaunchButtons();
+    void updateRestartStatus();
 
 private:
     shared_qobject_ptr<LaunchTask> m_proc;
@@ -68,4 +70,5 @@ private:
     PageContainer *m_container = nullptr;
     QPushButton *m_closeButton = nullptr;
     QPushButton *m_killButton = nullptr;
+    QLabel *m_restartLabel = nullptr;
 };
@@ -149,10 +149,11 @@ bool LaunchController::abort()
     {
         return false;
     }
+    auto timeout = m_instance->settings()->get("StopTimeout").toInt();
     auto response = CustomMessageBox::selectable(
-            m_parentWidget, tr("Kill Minecraft?"),
-            tr("This can cause the instance to get corrupted and should only be used if Minecraft "
-            "is frozen for some reason"),
+            m_parentWidget, tr("Stop the server?"),
+            tr("The server is asked to stop and save its worlds first. If it is still running after %1 seconds, "
+            "it gets terminated, which can corrupt the worlds.").arg(timeout),
             QMessageBox::Question, QMessageBox::Yes | QMessageBox::No, QMessageBox::Yes)->exec();
     if (response == QMessageBox::Yes)
     {
@@ -645,6 +645,12 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), ui(new MainWindow
     }
 
     setSelectedInstanceById(MSMC->settings()->get("SelectedInstance").toString());
+    // the instance may not be in the list yet, try again once it is loaded
+    if (MSMC->instances()->isLoading())
+    {
+        m_pendingSelection = MSMC->settings()->get("SelectedInstance").toString();
+        connect(MSMC->instances().get(), &InstanceList::loadingFinished, this, &MainWindow::instancesLoaded);
+    }
 
     // removing this looks stupid
     view->setFocus();
@@ -974,7 +980,7 @@ void MainWindow::on_actionCopyInstance_triggered()
     if (!copyInstDlg.exec())
         return;
 
-    auto copyTask = new InstanceCopyTask(m_selectedInstance, copyInstDlg.shouldCopySaves(), copyInstDlg.shouldKeepPlaytime());
+    auto copyTask = new InstanceCopyTask(m_selectedInstance, copyInstDlg.shouldCopySaves(), copyInstDlg.shouldKeepPlaytime(), copyInstDlg.shouldLinkMods());
     copyTask->setName(copyInstDlg.instName());
     copyTask->setGroup(copyInstDlg.instGroup());
     copyTask->setIcon(copyInstDlg.iconKey());
@@ -1406,6 +1412,15 @@ void MainWindow::instanceSelectRequest(QString id)
     setSelectedInstanceById(id);
 }
 
+void MainWindow::instancesLoaded()
+{
+    disconnect(MSMC->instances().get(), &InstanceList::loadingFinished, this, &MainWindow::instancesLoaded);
+    // the user picked something in the meantime
+    if (m_selectedInstance)
+        return;
+    setSelectedInstanceById(m_pendingSelection);
+}
+
 void MainWindow::instanceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
 {
     auto current = view->selectionModel()->currentIndex();
@@ -130,6 +130,8 @@ private slots:
 
     void instanceSelectRequest(QString id);
 
+    void instancesLoaded();
+
     void instanceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
 
     void selectionBad();
@@ -175,6 +177,8 @@ private:
 
     InstancePtr m_selectedInstance;
     QString m_currentInstIcon;
+    /// the instance selected last time, applied again once the instance list finished loading
+    QString m_pendingSelection;
 
     // managed by the application object
     Task *m_versionLoadTask = nullptr;
@@ -31,6 +31,8 @@
 #include <QLibraryInfo>
 #include <QList>
 #include <QStringList>
+#include <QTextStream>
+#include <QRegularExpression>
 #include <QDebug>
 #include <QStyleFactory>
 
@@ -59,6 +61,8 @@
 #include <FileSystem.h>
 #include <DesktopServices.h>
 #include <LocalPeer.h>
+#include <launch/LaunchTask.h>
+#include <minecraft/launch/ServerLog.h>
 
 #include <sys.h>
 
@@ -196,6 +200,45 @@ MultiServerMC::MultiServerMC(int &argc, char **argv) : QApplication(argc, argv)
         parser.addOption("import");
         parser.addShortOpt("import", 'I');
         parser.addDocumentation("import", "Import instance from specified zip (local path or URL)");
+        // --batch
+        parser.addOption("batch");
+        parser.addDocumentation("batch", "Start the specified instances without any windows (comma separated instance IDs)");
+        // --group
+        parser.addOption("group");
+        parser.addDocumentation("group", "Start all instances of the specified group without any windows");
+        // --parallel
+        parser.addOption("parallel", BatchLaunchOptions().parallel);
+        parser.addDocumentation("parallel", "How many instances may update or start up at the same time "
+                                            "(only valid in combination with --batch or --group)");
+        // --stagger
+        parser.addOption("stagger", BatchLaunchOptions().stagger / 1000);
+        parser.addDocumentation("stagger", "Seconds between two server starts "
+                                           "(only valid in combination with --batch or --group)");
+        // --ready-timeout
+        parser.addOption("ready-timeout", BatchLaunchOptions().readyTimeout);
+        parser.addDocumentation("ready-timeout", "Seconds a server gets to finish starting up "
+                                                 "(only valid in combination with --batch or --group)");
+        // --stop
+        parser.addSwitch("stop");
+        parser.addDocumentation("stop", "Stop the instances instead, in the MultiServerMC that started them "
+                                        "(only valid in combination with --batch or --group)");
+        // --send
+        parser.addOption("send");
+        parser.addDocumentation("send", "Send console commands to the server of the specified instance "
+                                        "in the running MultiServerMC (by instance ID), print what became of each "
+                                        "and fail unless all of them were sent and answered");
+        // --command
+        parser.addOption("command");
+        parser.addDocumentation("command", "The console command to send, '-' reads one command per line from stdin "
+                                           "(only valid in combination with --send)");
+        // --expect
+        parser.addOption("expect");
+        parser.addDocumentation("expect", "Wait for a console line matching this regular expression after each command "
+                                          "before sending the next (only valid in combination with --send)");
+        // --timeout
+        parser.addOption("timeout", 10);
+        parser.addDocumentation("timeout", "Seconds to wait for the line given with --expect "
+                                           "(only valid in combination with --send)");
 
         // parse the arguments
         try
@@ -233,6 +276,35 @@ MultiServerMC::MultiServerMC(int &argc, char **argv) : QApplication(argc, argv)
     m_serverPort = args["port"].toInt();
     m_liveCheck = args["alive"].toBool();
     m_zipToImport = args["import"].toUrl();
+    m_batchIds = args["batch"].toString().split(',', QString::SkipEmptyParts);
+    m_batchGroup = args["group"].toString();
+    m_batchOptions.parallel = args["parallel"].toInt();
+    m_batchOptions.stagger = args["stagger"].toInt() * 1000;
+    m_batchOptions.readyTimeout = args["ready-timeout"].toInt();
+    m_batchStop = args["stop"].toBool();
+    m_sendTo = args["send"].toString();
+    m_sendExpect = args["expect"].toString();
+    m_sendTimeout = args["timeout"].toInt();
+    {
+        auto command = args["command"].toString();
+        if(command == "-")
+        {
+            // one per line, for scripts pushing lots of them
+            QTextStream in(stdin);
+            while(!in.atEnd())
+            {
+                auto line = in.readLine().trimmed();
+                if(!line.isEmpty())
+                {
+                    m_sendCommands.append(line);
+                }
+            }
+        }
+        else if(!command.isEmpty())
+        {
+            m_sendCommands.append(command);
+        }
+    }
 
     QString origcwdPath = QDir::currentPath();
     QString binPath = applicationDirPath();
@@ -299,6 +371,64 @@ MultiServerMC::MultiServerMC(int &argc, char **argv) : QApplication(argc, argv)
         return;
     }
 
+    bool batch = !m_batchIds.isEmpty() || !m_batchGroup.isEmpty();
+    if(batch && !m_instanceIdToLaunch.isEmpty())
+    {
+        std::cerr << "--batch and --group can't be used in combination with --launch!" << std::endl;
+        m_status = MultiServerMC::Failed;
+        return;
+    }
+    if(!batch && (m_batchStop || args["parallel"].toInt() != BatchLaunchOptions().parallel
+        || args["stagger"].toInt() != BatchLaunchOptions().stagger / 1000
+        || args["ready-timeout"].toInt() != BatchLaunchOptions().readyTimeout))
+    {
+        std::cerr << "--parallel, --stagger, --ready-timeout and --stop can only be used in combination with --batch or --group!" << std::endl;
+        m_status = MultiServerMC::Failed;
+        return;
+    }
+    if(m_batchOptions.parallel < 1 || m_batchOptions.stagger < 0 || m_batchOptions.readyTimeout < 1)
+    {
+        std::cerr << "--parallel and --ready-timeout must be positive and --stagger can't be negative!" << std::endl;
+        m_status = MultiServerMC::Failed;
+        return;
+    }
+    if(m_sendTo.isEmpty() != args["command"].toString().isEmpty())
+    {
+        std::cerr << "--send and --command can only be used together!" << std::endl;
+        m_status = MultiServerMC::Failed;
+        return;
+    }
+    if(m_sendTo.isEmpty() && (!m_sendExpect.isEmpty() || m_sendTimeout != 10))
+    {
+        std::cerr << "--expect and --timeout can only be used in combination with --send!" << std::endl;
+        m_status = MultiServerMC::Failed;
+        return;
+    }
+    if(!m_sendTo.isEmpty() && (batch || !m_instanceIdToLaunch.isEmpty()))
+    {
+        std::cerr << "--send can't be used in combination with --launch, --batch or --group!" << std::endl;
+        m_status = MultiServerMC::Failed;
+        return;
+    }
+    if(!m_sendTo.isEmpty() && m_sendCommands.isEmpty())
+    {
+        std::cerr << "There are no commands to send!" << std::endl;
+        m_status = MultiServerMC::Failed;
+        return;
+    }
+    if(m_sendTimeout < 1)
+    {
+        std::cerr << "--timeout must be positive!" << std::endl;
+        m_status = MultiServerMC::Failed;
+        return;
+    }
+    if(!m_sendExpect.isEmpty() && !QRegularExpression(m_sendExpect).isValid())
+    {
+        std::cerr << "--expect is not a valid regular expression!" << std::endl;
+        m_status = MultiServerMC::Failed;
+        return;
+    }
+
     /*
      * Establish the mechanism for communication with an already running MultiServerMC that uses the same data path.
      * If there is one, tell it what the user actually wanted to do and exit.
@@ -309,11 +439,64 @@ MultiServerMC::MultiServerMC(int &argc, char **argv) : QApplication(argc, argv)
         // FIXME: you can run the same binaries with multiple data dirs and they won't clash. This could cause issues for updates.
         m_peerInstance = new LocalPeer(this, appID);
         connect(m_peerInstance, &LocalPeer::messageReceived, this, &MultiServerMC::messageReceived);
+        connect(m_peerInstance, &LocalPeer::requestReceived, this, &MultiServerMC::requestReceived);
         if(m_peerInstance->isClient())
         {
             int timeout = 2000;
 
-            if(m_instanceIdToLaunch.isEmpty())
+            if(!m_sendTo.isEmpty())
+            {
+                // "command <id> <timeout msecs> <expect, percent encoded, or ->" and then one command per line
+                QString expect = m_sendExpect.isEmpty() ? QString("-") : QString::fromUtf8(QUrl::toPercentEncoding(m_sendExpect));
+                QString header = QString("command %1 %2 %3").arg(m_sendTo).arg(m_sendTimeout * 1000).arg(expect);
+                // the reply comes once every command is through, the queue goes at a few commands per second at least
+                int perCommand = m_sendExpect.isEmpty() ? 1000 : m_sendTimeout * 1000 + 1000;
+                int replyTimeout = 30000 + m_sendCommands.size() * perCommand;
+                QString reply;
+                if(!m_peerInstance->sendRequest(header + "\n" + m_sendCommands.join('\n'), timeout, replyTimeout, reply))
+                {
+                    std::cerr << "Couldn't reach the running MultiServerMC, or it didn't answer in time!" << std::endl;
+                    m_status = MultiServerMC::Failed;
+                    return;
+                }
+                // "<status>\t<command>\t<response>" for each command
+                auto lines = reply.split('\n', QString::SkipEmptyParts);
+                if(lines.isEmpty())
+                {
+                    std::cerr << "The running MultiServerMC couldn't take the commands, see its log." << std::endl;
+                }
+                bool allAnswered = !lines.isEmpty();
+                for(auto & line: lines)
+                {
+                    auto status = line.section('\t', 0, 0);
+                    auto sentCommand = line.section('\t', 1, 1);
+                    auto response = line.section('\t', 2);
+                    allAnswered = allAnswered && (status == "sent" || status == "answered");
+                    std::cout << qPrintable(status) << ": " << qPrintable(sentCommand);
+                    if(!response.isEmpty())
+                    {
+                        std::cout << " -> " << qPrintable(response);
+                    }
+                    std::cout << std::endl;
+                }
+                m_status = allAnswered ? MultiServerMC::Succeeded : MultiServerMC::Failed;
+                return;
+            }
+            else if(batch)
+            {
+                // "ids <id,id,...>" or "group <name>", the group name may contain spaces
+                QString selector = m_batchGroup.isEmpty() ? "ids " + m_batchIds.join(',') : "group " + m_batchGroup;
+                if(m_batchStop)
+                {
+                    m_peerInstance->sendMessage("stop " + selector, timeout);
+                }
+                else
+                {
+                    m_peerInstance->sendMessage(QString("batch %1 %2 %3 ").arg(m_batchOptions.parallel)
+                        .arg(m_batchOptions.stagger).arg(m_batchOptions.readyTimeout) + selector, timeout);
+                }
+            }
+            else if(m_instanceIdToLaunch.isEmpty())
             {
                 m_peerInstance->sendMessage("activate", timeout);
 
@@ -339,6 +522,19 @@ MultiServerMC::MultiServerMC(int &argc, char **argv) : QApplication(argc, argv)
         }
     }
 
+    if(m_batchStop)
+    {
+        std::cerr << "--stop needs the MultiServerMC that started the instances to be running!" << std::endl;
+        m_status = MultiServerMC::Failed;
+        return;
+    }
+    if(!m_sendTo.isEmpty())
+    {
+        std::cerr << "--send needs the MultiServerMC that runs the server to be running!" << std::endl;
+        m_status = MultiServerMC::Failed;
+        return;
+    }
+
     // init the logger
     {
         static const QString logBase = "MultiServerMC-%0.log";
@@ -417,6 +613,10 @@ MultiServerMC::MultiServerMC(int &argc, char **argv) : QApplication(argc, argv)
         {
             qDebug() << "Port of server  :" << m_serverPort;
         }
+        if(batch)
+        {
+            qDebug() << "Instances to batch launch  : " << (m_batchGroup.isEmpty() ? m_batchIds.join(',') : "group " + m_batchGroup);
+        }
         qDebug() << "<> Paths set.";
     }
 
@@ -443,7 +643,9 @@ MultiServerMC::MultiServerMC(int &argc, char **argv) : QApplication(argc, argv)
 
     // Initialize application settings
     {
-        m_settings.reset(new INISettingsObject("multiservermc.cfg", this));
+        auto settings = new INISettingsObject("multiservermc.cfg", this);
+        settings->setSaveDelay(250);
+        m_settings.reset(settings);
         // Updates
         m_settings->registerSetting("UpdateChannel", BuildConfig.VERSION_CHANNEL);
         m_settings->registerSetting("AutoUpdate", true);
@@ -653,10 +855,21 @@ MultiServerMC::MultiServerMC(int &argc, char **argv) : QApplication(argc, argv)
             qWarning() << "Your instance path contains \'!\' and this is known to cause java problems!";
         }
         m_instances.reset(new InstanceList(m_settings, instDir, this));
+        m_instances->setSnapshotPath(FS::PathCombine("cache", "instancelist.snapshot"));
         connect(InstDirSetting.get(), &Setting::SettingChanged, m_instances.get(), &InstanceList::on_InstFolderChanged);
-        qDebug() << "Loading Instances...";
-        m_instances->loadList();
-        qDebug() << "<> Instances loaded.";
+        if(m_instanceIdToLaunch.isEmpty() && m_batchIds.isEmpty() && m_batchGroup.isEmpty())
+        {
+            // the main window fills up as the instances are read
+            qDebug() << "Loading Instances in the background...";
+            m_instances->loadListAsync();
+        }
+        else
+        {
+            // the instances to launch have to be there before the startup action runs
+            qDebug() << "Loading Instances...";
+            m_instances->loadList();
+            qDebug() << "<> Instances loaded.";
+        }
     }
 
     // init the http meta cache
@@ -698,6 +911,8 @@ MultiServerMC::MultiServerMC(int &argc, char **argv) : QApplication(argc, argv)
             // save any remaining instance state
             m_instances->saveNow();
         }
+        // write out settings changes that are still waiting
+        INISettingsObject::saveAll();
         if(logFile)
         {
             logFile->flush();
@@ -791,6 +1006,20 @@ void MultiServerMC::performMainStartupAction()
             return;
         }
     }
+    if(!m_batchIds.isEmpty() || !m_batchGroup.isEmpty())
+    {
+        // no windows, the process exits once all the servers have stopped
+        auto batch = batchInstances(m_batchIds, m_batchGroup);
+        if(batch.isEmpty())
+        {
+            std::cerr << "None of the instances to batch launch exist!" << std::endl;
+            m_status = MultiServerMC::Failed;
+            exit(1);
+            return;
+        }
+        startBatch(batch, m_batchOptions);
+        return;
+    }
     if(!m_mainWindow)
     {
         // normal main window
@@ -831,6 +1060,128 @@ MultiServerMC::~MultiServerMC()
 #endif
 }
 
+void MultiServerMC::requestReceived(int requestId, const QString& message)
+{
+    QString header = message.section('\n', 0, 0);
+    QString command = header.section(' ', 0, 0);
+    if(status() != Initialized || command != "command")
+    {
+        qWarning() << "Received request" << header << "that can't be answered now.";
+        m_peerInstance->reply(requestId, QString());
+        return;
+    }
+
+    QString instanceID = header.section(' ', 1, 1);
+    int timeoutMs = header.section(' ', 2, 2).toInt();
+    QString expect = header.section(' ', 3, 3);
+    QStringList commands = message.section('\n', 1).split('\n', QString::SkipEmptyParts);
+    if(instanceID.isEmpty() || commands.isEmpty())
+    {
+        qWarning() << "Received" << command << "request without an instance ID or commands.";
+        m_peerInstance->reply(requestId, QString());
+        return;
+    }
+    expect = expect == "-" ? QString() : QUrl::fromPercentEncoding(expect.toUtf8());
+    auto inst = instances()->getInstanceById(instanceID);
+    shared_qobject_ptr<LaunchTask> task;
+    if(inst)
+    {
+        task = inst->getLaunchTask();
+    }
+    if(!task || !inst->isRunning())
+    {
+        qWarning() << "Can't send commands to" << instanceID << "because it isn't running.";
+        QStringList lines;
+        for(auto & line: commands)
+        {
+            lines.append("not-running\t" + line);
+        }
+        m_peerInstance->reply(requestId, lines.join('\n'));
+        return;
+    }
+
+    // the reply goes out once the result of every queued command is in, in the order they were sent
+    auto channel = &task->commands();
+    auto ids = std::make_shared<QList<quint64>>();
+    auto results = std::make_shared<QMap<quint64, QString>>();
+    auto refused = std::make_shared<QStringList>();
+    auto connections = std::make_shared<QList<QMetaObject::Connection>>();
+    auto sending = std::make_shared<bool>(true);
+    auto replyIfDone = [this, requestId, commands, ids, results, refused, connections, sending](bool gone)
+    {
+        if(*sending)
+        {
+            return;
+        }
+        QStringList lines;
+        for(int i = 0; i < ids->size(); i++)
+        {
+            auto id = ids->at(i);
+            if(!results->contains(id) && !gone)
+            {
+                return;
+            }
+            // the server went away along with its queue
+            lines.append(results->value(id, "dropped\t" + commands.at(i)));
+        }
+        for(auto & line: *refused)
+        {
+            lines.append("refused\t" + line);
+        }
+        for(auto & connection: *connections)
+        {
+            disconnect(connection);
+        }
+        connections->clear();
+        m_peerInstance->reply(requestId, lines.join('\n'));
+    };
+    connections->append(connect(channel, &CommandChannel::finished, this, [results, replyIfDone](const CommandResult &result)
+    {
+        QString status;
+        switch(result.status)
+        {
+            case CommandResult::Sent:
+                status = "sent";
+                break;
+            case CommandResult::Answered:
+                status = "answered";
+                break;
+            case CommandResult::TimedOut:
+                status = "timed-out";
+                break;
+            case CommandResult::Dropped:
+                status = "dropped";
+                break;
+        }
+        results->insert(result.id, status + "\t" + result.command + "\t" + result.response);
+        replyIfDone(false);
+    }));
+    connections->append(connect(channel, &QObject::destroyed, this, [replyIfDone]()
+    {
+        replyIfDone(true);
+    }));
+
+    for(auto & line: commands)
+    {
+        // once one is refused the rest is too, or they would go out in the wrong order
+        quint64 id = refused->isEmpty() ? channel->send(line, expect, timeoutMs) : 0;
+        if(!id)
+        {
+            refused->append(line);
+            continue;
+        }
+        ids->append(id);
+    }
+    qDebug() << "<> Queued" << ids->size() << "of" << commands.size() << "commands for" << instanceID;
+    if(!refused->isEmpty())
+    {
+        task->onLogLine(tr("Only %1 of %2 commands fit into the queue, the rest were dropped.").arg(ids->size()).arg(commands.size()),
+                        MessageLevel::MultiServerMC);
+    }
+    *sending = false;
+    replyIfDone(false);
+}
+
 void MultiServerMC::messageReceived(const QString& message)
 {
     if(status() != Initialized)
@@ -863,6 +1214,11 @@ void MultiServerMC::messageReceived(const QString& message)
             qWarning() << "Received" << command << "message without an instance ID.";
             return;
         }
+        if(instances()->isLoading())
+        {
+            // the instance may not have been read yet
+            instances()->loadList();
+        }
         auto inst = instances()->getInstanceById(arg);
         if(inst)
         {
@@ -883,6 +1239,11 @@ void MultiServerMC::messageReceived(const QString& message)
             qWarning() << "Received" << command << "message without a server port number.";
             return;
         }
+        if(instances()->isLoading())
+        {
+            // the instance may not have been read yet
+            instances()->loadList();
+        }
         auto inst = instances()->getInstanceById(instanceID);
         if(inst)
         {
@@ -894,12 +1255,184 @@ void MultiServerMC::messageReceived(const QString& message)
             );
         }
     }
+    else if(command == "batch")
+    {
+        BatchLaunchOptions options;
+        options.parallel = message.section(' ', 1, 1).toInt();
+        options.stagger = message.section(' ', 2, 2).toInt();
+        options.readyTimeout = message.section(' ', 3, 3).toInt();
+        QString selector = message.section(' ', 4, 4);
+        QString arg = message.section(' ', 5);
+        if(options.parallel < 1 || options.readyTimeout < 1 || arg.isEmpty())
+        {
+            qWarning() << "Received invalid" << command << "message" << message;
+            return;
+        }
+        startBatch(selector == "group" ? batchInstances({}, arg) : batchInstances(arg.split(','), QString()), options);
+    }
+    else if(command == "stop")
+    {
+        QString selector = message.section(' ', 1, 1);
+        QString arg = message.section(' ', 2);
+        if(arg.isEmpty())
+        {
+            qWarning() << "Received" << command << "message without instances.";
+            return;
+        }
+        stopBatch(selector == "group" ? batchInstances({}, arg) : batchInstances(arg.split(','), QString()));
+    }
     else
     {
         qWarning() << "Received invalid message" << message;
     }
 }
 
+QList<InstancePtr> MultiServerMC::batchInstances(const QStringList & ids, const QString & group)
+{
+    if(instances()->isLoading())
+    {
+        // the instances may not have been read yet
+        instances()->loadList();
+    }
+    QList<InstancePtr> result;
+    if(!group.isEmpty())
+    {
+        for(int i = 0; i < instances()->count(); i++)
+        {
+            auto inst = instances()->at(i);
+            if(instances()->getInstanceGroup(inst->id()) == group)
+            {
+                result.append(inst);
+            }
+        }
+        if(result.isEmpty())
+        {
+            qWarning() << "There are no instances in group" << group;
+        }
+        return result;
+    }
+    for(auto & id: ids)
+    {
+        auto inst = instances()->getInstanceById(id);
+        if(!inst)
+        {
+            qWarning() << "There is no instance with ID" << id;
+            continue;
+        }
+        result.append(inst);
+    }
+    return result;
+}
+
+void MultiServerMC::startBatch(const QList<InstancePtr> & instances, const BatchLaunchOptions & options)
+{
+    if(m_updateRunning)
+    {
+        qDebug() << "Cannot launch instances while an update is running. Please try again when updates are completed.";
+        return;
+    }
+    for(auto & launcher: m_batchLaunchers)
+    {
+        if(launcher->isRunning())
+        {
+            qWarning() << "A batch launch is already running, ignoring another one.";
+            return;
+        }
+    }
+    auto batchOptions = options;
+    batchOptions.isReady = ServerLog::parseDone;
+    shared_qobject_ptr<BatchLauncher> launcher(new BatchLauncher(instances, batchOptions));
+    m_batchLaunchers.append(launcher);
+    auto batch = launcher.get();
+    connect(batch, &BatchLauncher::instanceStateChanged, this, [this](InstancePtr instance, BatchLauncher::State state, const QString & detail)
+    {
+        QString what;
+        switch(state)
+        {
+            case BatchLauncher::State::Queued:
+                what = "queued";
+                break;
+            case BatchLauncher::State::Updating:
+                what = "updating";
+                break;
+            case BatchLauncher::State::Starting:
+                what = "starting";
+                addRunningInstance();
+                break;
+            case BatchLauncher::State::Ready:
+                what = "ready after " + detail + "s";
+                break;
+            case BatchLauncher::State::Failed:
+                what = "failed: " + detail;
+                break;
+        }
+        // meant for scripts, one line per change
+        std::cout << qPrintable(instance->id()) << ": " << qPrintable(what) << std::endl;
+        qDebug() << "<> Batch:" << instance->id() << what;
+    });
+    connect(batch, &BatchLauncher::serverFinished, this, [this, batch](InstancePtr)
+    {
+        subRunningInstance();
+        batchProgressed(batch);
+    });
+    connect(batch, &Task::finished, this, [this, batch]()
+    {
+        qDebug() << "<> Batch launch finished:" << (batch->wasSuccessful() ? QString("all servers are ready") : batch->failReason());
+        batchProgressed(batch);
+    });
+    batch->start();
+}
+
+void MultiServerMC::batchProgressed(BatchLauncher * batch)
+{
+    if(batch->isRunning())
+    {
+        return;
+    }
+    bool succeeded = batch->wasSuccessful();
+    if(!batch->serversRunning())
+    {
+        // deleted later, this is called from its signals
+        for(int i = 0; i < m_batchLaunchers.size(); i++)
+        {
+            if(m_batchLaunchers[i].get() == batch)
+            {
+                m_batchLaunchers.removeAt(i);
+                break;
+            }
+        }
+    }
+    // nothing left that would keep the process around
+    if(shouldExitNow())
+    {
+        m_status = succeeded ? Status::Succeeded : Status::Failed;
+        exit(succeeded ? 0 : 1);
+    }
+}
+
+void MultiServerMC::stopBatch(const QList<InstancePtr> & instances)
+{
+    for(auto & inst: instances)
+    {
+        auto task = inst->getLaunchTask();
+        if(!inst->isRunning() || !task)
+        {
+            qDebug() << "<> Not stopping" << inst->id() << "because it isn't running.";
+            continue;
+        }
+        qDebug() << "<> Stopping" << inst->id();
+        auto & extras = m_instanceExtras[inst->id()];
+        if(extras.controller)
+        {
+            extras.controller->abort();
+        }
+        else
+        {
+            task->abort();
+        }
+    }
+}
+
 std::shared_ptr<TranslationsModel> MultiServerMC::translations()
 {
     return m_translations;
@@ -10,6 +10,7 @@
 #include <updater/GoUpdate.h>
 
 #include <BaseInstance.h>
+#include <launch/BatchLauncher.h>
 
 #include "minecraft/launch/MinecraftServerTarget.h"
 
@@ -151,6 +152,7 @@ public slots:
 private slots:
     void on_windowClose();
     void messageReceived(const QString & message);
+    void requestReceived(int requestId, const QString & message);
     void controllerSucceeded();
     void controllerFailed(const QString & error);
     void setupWizardFinished(int status);
@@ -159,6 +161,13 @@ private:
     bool createSetupWizard();
     void performMainStartupAction();
 
+    /// the instances named on the command line or in a message, either by ID or by group
+    QList<InstancePtr> batchInstances(const QStringList & ids, const QString & group);
+    void startBatch(const QList<InstancePtr> & instances, const BatchLaunchOptions & options);
+    void stopBatch(const QList<InstancePtr> & instances);
+    /// forget the launcher if it is done with everything, and exit if nothing else is left
+    void batchProgressed(BatchLauncher * batch);
+
     // sets the fatal error message and m_status to Failed.
     void showFatalErrorMessage(const QString & title, const QString & content);
 
@@ -211,10 +220,22 @@ private:
     LocalPeer * m_peerInstance = nullptr;
 
     SetupWizard * m_setupWizard = nullptr;
+
+    // the running --batch, if any
+    /// kept until all the servers they started stopped, see BatchLauncher::serversRunning()
+    QList<shared_qobject_ptr<BatchLauncher>> m_batchLaunchers;
 public:
     QString m_instanceIdToLaunch;
     int m_serverPort;
     bool m_liveCheck = false;
     QUrl m_zipToImport;
+    QStringList m_batchIds;
+    QString m_batchGroup;
+    BatchLaunchOptions m_batchOptions;
+    bool m_batchStop = false;
+    QString m_sendTo;
+    QStringList m_sendCommands;
+    QString m_sendExpect;
+    int m_sendTimeout = 10;
     std::unique_ptr<QFile> logFile;
 };
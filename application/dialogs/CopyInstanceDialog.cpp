@@ -54,6 +54,7 @@ CopyInstanceDialog::CopyInstanceDialog(InstancePtr original, QWidget *parent)
     ui->groupBox->lineEdit()->setPlaceholderText(tr("No group"));
     ui->copySavesCheckbox->setChecked(m_copySaves);
     ui->keepPlaytimeCheckbox->setChecked(m_keepPlaytime);
+    ui->linkModsCheckbox->setChecked(m_linkMods);
 }
 
 CopyInstanceDialog::~CopyInstanceDialog()
@@ -142,3 +143,20 @@ void CopyInstanceDialog::on_keepPlaytimeCheckbox_stateChanged(int state)
         m_keepPlaytime = true;
     }
 }
+
+bool CopyInstanceDialog::shouldLinkMods() const
+{
+    return m_linkMods;
+}
+
+void CopyInstanceDialog::on_linkModsCheckbox_stateChanged(int state)
+{
+    if(state == Qt::Unchecked)
+    {
+        m_linkMods = false;
+    }
+    else if(state == Qt::Checked)
+    {
+        m_linkMods = true;
+    }
+}
@@ -41,6 +41,7 @@ public:
     QString iconKey() const;
     bool shouldCopySaves() const;
     bool shouldKeepPlaytime() const;
+    bool shouldLinkMods() const;
 
 private
 slots:
@@ -48,6 +49,7 @@ slots:
     void on_instNameTextBox_textChanged(const QString &arg1);
     void on_copySavesCheckbox_stateChanged(int state);
     void on_keepPlaytimeCheckbox_stateChanged(int state);
+    void on_linkModsCheckbox_stateChanged(int state);
 
 private:
     Ui::CopyInstanceDialog *ui;
@@ -55,4 +57,5 @@ private:
     InstancePtr m_original;
     bool m_copySaves = true;
     bool m_keepPlaytime = true;
+    bool m_linkMods = false;
 };
@@ -401,6 +401,9 @@ bool ExportInstanceDialog::doExport()
 
     SaveIcon(m_instance);
 
+    // the instance.cfg in the archive should have everything that was changed
+    m_instance->settings()->saveNow();
+
     auto & blocked = proxyModel->blockedPaths();
     using std::placeholders::_1;
     if (!JlCompress::compressDir(output, m_instance->instanceRoot(), name, std::bind(&SeparatorPrefixTree<'/'>::covers, blocked, _1)))
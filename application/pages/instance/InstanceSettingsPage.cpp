@@ -66,6 +66,34 @@ void InstanceSettingsPage::applySettings()
     int serverPort = ui->portNumberSpinBox->value();
     m_settings->set("ServerPort", serverPort);
 
+    // restarts
+    static const QStringList restartPolicies = {"Never", "OnCrash", "Always"};
+    m_settings->set("RestartPolicy", restartPolicies.value(ui->restartPolicyComboBox->currentIndex(), "Never"));
+    m_settings->set("RestartBackoffMax", ui->restartBackoffSpinBox->value());
+    m_settings->set("CrashLoopRestarts", ui->crashLoopRestartsSpinBox->value());
+    m_settings->set("CrashLoopWindow", ui->crashLoopWindowSpinBox->value() * 60);
+    m_settings->set("StopTimeout", ui->stopTimeoutSpinBox->value());
+
+    // resource limits
+    m_settings->set("ResourceLimits", ui->resourceLimitsGroupBox->isChecked());
+    m_settings->set("CpuWeight", ui->cpuWeightSpinBox->value());
+    m_settings->set("CpuQuota", ui->cpuQuotaSpinBox->value());
+    m_settings->set("MemoryMax", ui->memoryMaxSpinBox->value());
+    m_settings->set("IoWeight", ui->ioWeightSpinBox->value());
+
+    // telemetry
+    m_settings->set("TelemetryEnabled", ui->telemetryGroupBox->isChecked());
+    m_settings->set("TelemetryInterval", ui->telemetryIntervalSpinBox->value());
+    m_settings->set("TelemetryGcParsing", ui->telemetryGcCheckBox->isChecked());
+
+    // tick time alerts
+    m_settings->set("TickAlertTps", ui->tickAlertTpsSpinBox->value());
+    m_settings->set("TickAlertMspt", ui->tickAlertMsptSpinBox->value());
+    m_settings->set("TickAlertBehind", ui->tickAlertBehindSpinBox->value());
+    m_settings->set("TickAlertCooldown", ui->tickAlertCooldownSpinBox->value());
+    m_settings->set("TickProbeCommand", ui->tickProbeCommandEdit->text().trimmed());
+    m_settings->set("TickProbeInterval", ui->tickProbeIntervalSpinBox->value());
+
 
     // Memory
     bool memory = ui->memoryGroupBox->isChecked();
@@ -117,6 +145,7 @@ void InstanceSettingsPage::applySettings()
     {
         m_settings->reset("JvmArgs");
     }
+    m_settings->set("ClassDataSharing", ui->classDataSharingCheckBox->isChecked());
 
     // old generic 'override both' is removed.
     m_settings->reset("OverrideJava");
@@ -158,6 +187,34 @@ void InstanceSettingsPage::loadSettings()
     int serverPort = m_settings->get("ServerPort").toInt();
     ui->portNumberSpinBox->setValue(serverPort);
 
+    // restarts
+    auto restartPolicy = m_settings->get("RestartPolicy").toString();
+    ui->restartPolicyComboBox->setCurrentIndex(restartPolicy == "Always" ? 2 : restartPolicy == "OnCrash" ? 1 : 0);
+    ui->restartBackoffSpinBox->setValue(m_settings->get("RestartBackoffMax").toInt());
+    ui->crashLoopRestartsSpinBox->setValue(m_settings->get("CrashLoopRestarts").toInt());
+    ui->crashLoopWindowSpinBox->setValue(m_settings->get("CrashLoopWindow").toInt() / 60);
+    ui->stopTimeoutSpinBox->setValue(m_settings->get("StopTimeout").toInt());
+
+    // resource limits
+    ui->resourceLimitsGroupBox->setChecked(m_settings->get("ResourceLimits").toBool());
+    ui->cpuWeightSpinBox->setValue(m_settings->get("CpuWeight").toInt());
+    ui->cpuQuotaSpinBox->setValue(m_settings->get("CpuQuota").toInt());
+    ui->memoryMaxSpinBox->setValue(m_settings->get("MemoryMax").toInt());
+    ui->ioWeightSpinBox->setValue(m_settings->get("IoWeight").toInt());
+
+    // telemetry
+    ui->telemetryGroupBox->setChecked(m_settings->get("TelemetryEnabled").toBool());
+    ui->telemetryIntervalSpinBox->setValue(m_settings->get("TelemetryInterval").toInt());
+    ui->telemetryGcCheckBox->setChecked(m_settings->get("TelemetryGcParsing").toBool());
+
+    // tick time alerts
+    ui->tickAlertTpsSpinBox->setValue(m_settings->get("TickAlertTps").toDouble());
+    ui->tickAlertMsptSpinBox->setValue(m_settings->get("TickAlertMspt").toDouble());
+    ui->tickAlertBehindSpinBox->setValue(m_settings->get("TickAlertBehind").toInt());
+    ui->tickAlertCooldownSpinBox->setValue(m_settings->get("TickAlertCooldown").toInt());
+    ui->tickProbeCommandEdit->setText(m_settings->get("TickProbeCommand").toString());
+    ui->tickProbeIntervalSpinBox->setValue(m_settings->get("TickProbeInterval").toInt());
+
     // Memory
     ui->memoryGroupBox->setChecked(m_settings->get("OverrideMemory").toBool());
     int min = m_settings->get("MinMemAlloc").toInt();
@@ -189,6 +246,7 @@ void InstanceSettingsPage::loadSettings()
 
     ui->javaArgumentsGroupBox->setChecked(overrideArgs);
     ui->jvmArgsTextBox->setPlainText(m_settings->get("JvmArgs").toString());
+    ui->classDataSharingCheckBox->setChecked(m_settings->get("ClassDataSharing").toBool());
 
     // Custom commands
     ui->customCommands->initialize(
@@ -196,9 +196,15 @@ void LogPage::UIToModelState()
 
 void LogPage::setInstanceLaunchTaskChanged(shared_qobject_ptr<LaunchTask> proc, bool initial)
 {
+    if(m_process)
+    {
+        disconnect(&m_process->commands(), nullptr, this, nullptr);
+    }
     m_process = proc;
+    ui->commandStatusLabel->clear();
     if(m_process)
     {
+        connect(&m_process->commands(), &CommandChannel::queueChanged, this, &LogPage::commandQueueChanged);
         m_model = proc->getLogModel();
         m_proxy->setSourceModel(m_model.get());
         if(initial)
@@ -288,7 +294,32 @@ void LogPage::on_wrapCheckbox_clicked(bool checked)
 
 void LogPage::on_runCommandButton_clicked()
 {
-    m_process->writeToStdin(ui->commandBar->text().append("\n").toUtf8());
+    if(!m_process)
+    {
+        return;
+    }
+    auto command = ui->commandBar->text();
+    if(command.contains('\n') || command.contains('\r'))
+    {
+        ui->commandStatusLabel->setText(tr("Only a single line can be sent as a command."));
+        return;
+    }
+    if(!m_process->commands().send(command))
+    {
+        ui->commandStatusLabel->setText(tr("Too many commands are waiting already."));
+    }
+}
+
+void LogPage::commandQueueChanged(int queued)
+{
+    if(queued)
+    {
+        ui->commandStatusLabel->setText(tr("%n command(s) waiting", "", queued));
+    }
+    else
+    {
+        ui->commandStatusLabel->clear();
+    }
 }
 
 void LogPage::runCommandActivated()
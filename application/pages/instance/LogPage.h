@@ -68,6 +68,7 @@ private slots:
     void runCommandActivated();
 
     void onInstanceLaunchTaskChanged(shared_qobject_ptr<LaunchTask> proc);
+    void commandQueueChanged(int queued);
 
 private:
     void modelStateToUI();
@@ -0,0 +1,148 @@
+#include "TelemetryPage.h"
+#include "ui_TelemetryPage.h"
+
+#include <QtMath>
+
+#include "launch/LaunchTask.h"
+#include "launch/TelemetryRing.h"
+#include "minecraft/MinecraftInstance.h"
+#include "minecraft/launch/TickMonitor.h"
+
+namespace {
+// the charts only change when there is a new sample, this is often enough not to miss one by much
+const int refreshInterval = 1000;
+
+QString mebibytes(double bytes)
+{
+    return QObject::tr("%1 MiB").arg(bytes / (1024 * 1024), 0, 'f', 0);
+}
+}
+
+TelemetryPage::TelemetryPage(InstancePtr instance, QWidget *parent)
+    : QWidget(parent), ui(new Ui::TelemetryPage), m_instance(instance)
+{
+    ui->setupUi(this);
+    ui->cpuChart->setTitle(tr("CPU"));
+    ui->cpuChart->setFormatter([](double value) { return QString("%1%").arg(value, 0, 'f', 0); });
+    ui->memoryChart->setTitle(tr("Resident memory"));
+    ui->memoryChart->setFormatter(mebibytes);
+    ui->gcChart->setTitle(tr("Longest GC pause"));
+    ui->gcChart->setFormatter([](double value) { return tr("%1 ms").arg(value, 0, 'f', 1); });
+    ui->threadsChart->setTitle(tr("Threads"));
+    ui->tpsChart->setTitle(tr("TPS"));
+    ui->tpsChart->setFormatter([](double value) { return QString::number(value, 'f', 1); });
+    ui->msptChart->setTitle(tr("MSPT"));
+    ui->msptChart->setFormatter([](double value) { return tr("%1 ms").arg(value, 0, 'f', 1); });
+    connect(&m_refreshTimer, &QTimer::timeout, this, &TelemetryPage::refresh);
+}
+
+TelemetryPage::~TelemetryPage()
+{
+    delete ui;
+}
+
+void TelemetryPage::openedImpl()
+{
+    refresh();
+    m_refreshTimer.start(refreshInterval);
+}
+
+void TelemetryPage::closedImpl()
+{
+    m_refreshTimer.stop();
+}
+
+void TelemetryPage::refreshTicks()
+{
+    auto minecraft = std::dynamic_pointer_cast<MinecraftInstance>(m_instance);
+    if(!minecraft)
+    {
+        return;
+    }
+    QVector<QPointF> tps, mspt;
+    TickSample lastTps, lastMspt, lastLag;
+    int lagWarnings = 0;
+    for(auto & sample: minecraft->tickMonitor()->samples())
+    {
+        if(!qIsNaN(sample.tps))
+        {
+            tps.append(QPointF(sample.time, sample.tps));
+            lastTps = sample;
+        }
+        if(!qIsNaN(sample.mspt))
+        {
+            mspt.append(QPointF(sample.time, sample.mspt));
+            lastMspt = sample;
+        }
+        if(sample.behindMs)
+        {
+            lagWarnings++;
+            lastLag = sample;
+        }
+    }
+    ui->tpsChart->setSeries(tps, tps.isEmpty() ? QString() : QString::number(lastTps.tps, 'f', 1));
+    ui->msptChart->setSeries(mspt, mspt.isEmpty() ? QString() : tr("%1 ms").arg(lastMspt.mspt, 0, 'f', 1));
+    if(lagWarnings)
+    {
+        ui->tickLabel->setText(tr("The server fell behind %1 times, last by %2 ms at %3.")
+            .arg(lagWarnings).arg(lastLag.behindMs).arg(QDateTime::fromMSecsSinceEpoch(lastLag.time).toString(Qt::SystemLocaleShortDate)));
+    }
+    else if(tps.isEmpty() && mspt.isEmpty())
+    {
+        ui->tickLabel->setText(tr("Tick times show up here when the server reports them. Set a probe command in the instance settings to ask for them regularly."));
+    }
+    else
+    {
+        ui->tickLabel->setText(tr("The server did not report falling behind."));
+    }
+}
+
+void TelemetryPage::refresh()
+{
+    refreshTicks();
+    auto samples = m_instance->telemetry()->snapshot();
+    QVector<QPointF> cpu, memory, gc, threads;
+    qint64 lastPid = -1;
+    for(auto & sample: samples)
+    {
+        // a new process, don't connect it to the previous one
+        if(lastPid != -1 && sample.pid != lastPid)
+        {
+            QPointF gap(sample.time, qQNaN());
+            cpu.append(gap);
+            memory.append(gap);
+            gc.append(gap);
+            threads.append(gap);
+        }
+        lastPid = sample.pid;
+        cpu.append(QPointF(sample.time, sample.cpuPercent));
+        memory.append(QPointF(sample.time, sample.rssBytes));
+        gc.append(QPointF(sample.time, sample.gcPauseMaxMs));
+        threads.append(QPointF(sample.time, sample.threads));
+    }
+
+    if(samples.isEmpty())
+    {
+        ui->cpuChart->setSeries(cpu, QString());
+        ui->memoryChart->setSeries(memory, QString());
+        ui->gcChart->setSeries(gc, QString());
+        ui->threadsChart->setSeries(threads, QString());
+        ui->statusLabel->setText(tr("Nothing was sampled yet. Samples are taken while the server runs."));
+        return;
+    }
+
+    auto last = samples.last();
+    ui->cpuChart->setSeries(cpu, QString("%1%").arg(last.cpuPercent, 0, 'f', 1));
+    ui->memoryChart->setSeries(memory, mebibytes(last.rssBytes));
+    ui->gcChart->setSeries(gc, tr("%1 pauses, %2 ms").arg(last.gcPauses).arg(last.gcPauseTotalMs, 0, 'f', 1));
+    ui->threadsChart->setSeries(threads, QString::number(last.threads));
+
+    auto status = tr("Proportional memory: %1, swapped: %2, disk read/written: %3/%4")
+        .arg(mebibytes(last.pssBytes), mebibytes(last.swapBytes), mebibytes(last.ioReadBytes), mebibytes(last.ioWriteBytes));
+    auto task = m_instance->getLaunchTask();
+    if(task && task->telemetry().pid() > 0)
+    {
+        status += "\n" + tr("Sampling overhead: %1% of one CPU").arg(task->telemetry().overheadPercent(), 0, 'f', 4);
+    }
+    ui->statusLabel->setText(status);
+}
@@ -0,0 +1,66 @@
+/* Copyright 2013-2021 MultiServerMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QWidget>
+#include <QTimer>
+
+#include "BaseInstance.h"
+#include "pages/BasePage.h"
+#include <MultiServerMC.h>
+
+namespace Ui
+{
+class TelemetryPage;
+}
+
+class TelemetryPage : public QWidget, public BasePage
+{
+    Q_OBJECT
+
+public:
+    explicit TelemetryPage(InstancePtr instance, QWidget *parent = 0);
+    virtual ~TelemetryPage();
+    virtual QString displayName() const override
+    {
+        return tr("Telemetry");
+    }
+    virtual QIcon icon() const override
+    {
+        return MSMC->getThemedIcon("status-running");
+    }
+    virtual QString id() const override
+    {
+        return "telemetry";
+    }
+    virtual QString helpPage() const override
+    {
+        return "Telemetry";
+    }
+    virtual void openedImpl() override;
+    virtual void closedImpl() override;
+
+private slots:
+    void refresh();
+
+private:
+    void refreshTicks();
+
+private:
+    Ui::TelemetryPage *ui;
+    InstancePtr m_instance;
+    QTimer m_refreshTimer;
+};
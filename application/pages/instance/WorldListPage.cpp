@@ -16,6 +16,11 @@
 #include "WorldListPage.h"
 #include "ui_WorldListPage.h"
 #include "minecraft/WorldList.h"
+#include "minecraft/WorldArchive.h"
+#include "minecraft/backup/WorldBackupTask.h"
+#include "minecraft/backup/WorldRestoreTask.h"
+#include "dialogs/CustomMessageBox.h"
+#include "dialogs/ProgressDialog.h"
 #include <DesktopServices.h>
 #include <QEvent>
 #include <QMenu>
@@ -24,6 +29,9 @@
 #include <QMessageBox>
 #include <QTreeView>
 #include <QInputDialog>
+#include <QFileDialog>
+#include <QLineEdit>
+#include <algorithm>
 #include <tools/MCEditTool.h>
 
 #include "MultiServerMC.h"
@@ -55,6 +63,16 @@ public:
 
         return sourceIndex.data(role);
     }
+
+protected:
+    virtual bool lessThan(const QModelIndex &left, const QModelIndex &right) const
+    {
+        if (left.column() == WorldList::SizeColumn)
+        {
+            return left.data(WorldList::SizeRole).toLongLong() < right.data(WorldList::SizeRole).toLongLong();
+        }
+        return QSortFilterProxyModel::lessThan(left, right);
+    }
 };
 
 
@@ -78,6 +96,7 @@ WorldListPage::WorldListPage(BaseInstance *inst, std::shared_ptr<WorldList> worl
     auto head = ui->worldTreeView->header();
     head->setSectionResizeMode(0, QHeaderView::Stretch);
     head->setSectionResizeMode(1, QHeaderView::ResizeToContents);
+    head->setSectionResizeMode(3, QHeaderView::ResizeToContents);
 
     connect(ui->worldTreeView->selectionModel(), &QItemSelectionModel::currentChanged, this, &WorldListPage::worldChanged);
     worldChanged(QModelIndex(), QModelIndex());
@@ -209,6 +228,110 @@ QModelIndex WorldListPage::getSelectedWorld()
     return proxy->mapToSource(index);
 }
 
+WorldBackupStorePtr WorldListPage::backupStore() const
+{
+    return std::make_shared<WorldBackupStore>(FS::PathCombine(m_inst->instanceRoot(), "backups"));
+}
+
+void WorldListPage::on_actionExport_triggered()
+{
+    QModelIndex index = getSelectedWorld();
+
+    if (!index.isValid())
+    {
+        return;
+    }
+
+    if(!worldSafetyNagQuestion())
+        return;
+
+    auto fullPath = m_worlds->data(index, WorldList::FolderRole).toString();
+    auto name = FS::RemoveInvalidFilenameChars(m_worlds->data(index, WorldList::NameRole).toString());
+    auto output = QFileDialog::getSaveFileName(
+        this, tr("Export %1").arg(name), FS::PathCombine(QDir::homePath(), name + ".zip"),
+        tr("Zip (*.zip);;Gzipped tar (*.tar.gz);;Tar (*.tar)"));
+    if (output.isEmpty())
+    {
+        return;
+    }
+    if (!WorldArchive::formatOf(output))
+    {
+        output += ".zip";
+    }
+
+    WorldExportTask task(fullPath, output);
+    ProgressDialog dialog(this);
+    dialog.execWithTask(&task);
+    if(!task.wasSuccessful())
+    {
+        CustomMessageBox::selectable(this, tr("Export failed"), task.failReason(), QMessageBox::Warning)->show();
+    }
+}
+
+void WorldListPage::on_actionBackup_triggered()
+{
+    QModelIndex index = getSelectedWorld();
+
+    if (!index.isValid())
+    {
+        return;
+    }
+
+    auto fullPath = m_worlds->data(index, WorldList::FolderRole).toString();
+    // a running server is asked to flush the world and hold off saving while it is read
+    WorldBackupTask task(fullPath, backupStore(), m_inst->getLaunchTask());
+    ProgressDialog dialog(this);
+    dialog.execWithTask(&task);
+    if(!task.wasSuccessful())
+    {
+        CustomMessageBox::selectable(this, tr("Backup failed"), task.failReason(), QMessageBox::Warning)->show();
+    }
+}
+
+void WorldListPage::on_actionRestore_Backup_triggered()
+{
+    QModelIndex index = getSelectedWorld();
+
+    if (!index.isValid())
+    {
+        return;
+    }
+
+    auto worldFolder = QFileInfo(m_worlds->data(index, WorldList::FolderRole).toString()).fileName();
+    auto store = backupStore();
+    auto snapshots = store->snapshots(worldFolder);
+    if(snapshots.isEmpty())
+    {
+        QMessageBox::information(this, tr("Restore Backup"), tr("There are no backups of this world yet."));
+        return;
+    }
+
+    // newest first
+    std::reverse(snapshots.begin(), snapshots.end());
+    bool ok = false;
+    auto snapshotId = QInputDialog::getItem(this, tr("Restore Backup"), tr("Backup to restore:"), snapshots, 0, false, &ok);
+    if(!ok)
+    {
+        return;
+    }
+    auto targetFolder = QInputDialog::getText(this, tr("Restore Backup"), tr("The backup is restored as a new world in:"),
+                                              QLineEdit::Normal, worldFolder + "-" + snapshotId, &ok);
+    if(!ok || targetFolder.isEmpty())
+    {
+        return;
+    }
+    targetFolder = FS::DirNameFromString(targetFolder, m_worlds->dir().absolutePath());
+
+    WorldRestoreTask task(store, worldFolder, snapshotId, m_worlds->dir().absoluteFilePath(targetFolder));
+    ProgressDialog dialog(this);
+    dialog.execWithTask(&task);
+    if(!task.wasSuccessful())
+    {
+        CustomMessageBox::selectable(this, tr("Restore failed"), task.failReason(), QMessageBox::Warning)->show();
+    }
+    m_worlds->update();
+}
+
 void WorldListPage::on_actionCopy_Seed_triggered()
 {
     QModelIndex index = getSelectedWorld();
@@ -315,6 +438,9 @@ void WorldListPage::worldChanged(const QModelIndex &current, const QModelIndex &
     ui->actionCopy->setEnabled(enable);
     ui->actionRename->setEnabled(enable);
     ui->actionDatapacks->setEnabled(enable);
+    ui->actionExport->setEnabled(enable);
+    ui->actionBackup->setEnabled(enable);
+    ui->actionRestore_Backup->setEnabled(enable);
     bool hasIcon = !index.data(WorldList::IconFileRole).isNull();
     ui->actionReset_Icon->setEnabled(enable && hasIcon);
 }
@@ -324,7 +450,7 @@ void WorldListPage::on_actionAdd_triggered()
     auto list = GuiUtil::BrowseForFiles(
         displayName(),
         tr("Select a Minecraft world zip"),
-        tr("Minecraft World Zip File (*.zip)"), QString(), this->parentWidget());
+        tr("Minecraft World Archive (*.zip *.tar *.tar.gz *.tgz)"), QString(), this->parentWidget());
     if (!list.empty())
     {
         m_worlds->stopWatching();
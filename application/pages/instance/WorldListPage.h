@@ -18,6 +18,7 @@
 #include <QMainWindow>
 
 #include "minecraft/MinecraftInstance.h"
+#include "minecraft/backup/WorldBackupStore.h"
 #include "pages/BasePage.h"
 #include <MultiServerMC.h>
 #include <LoggedProcess.h>
@@ -74,6 +75,7 @@ private:
     bool isWorldSafe(QModelIndex index);
     bool worldSafetyNagQuestion();
     void mceditError();
+    WorldBackupStorePtr backupStore() const;
 
 private:
     Ui::WorldListPage *ui;
@@ -92,6 +94,9 @@ private slots:
     void on_actionView_Folder_triggered();
     void on_actionDatapacks_triggered();
     void on_actionReset_Icon_triggered();
+    void on_actionExport_triggered();
+    void on_actionBackup_triggered();
+    void on_actionRestore_Backup_triggered();
     void worldChanged(const QModelIndex &current, const QModelIndex &previous);
     void mceditState(LoggedProcess::State state);
 
@@ -0,0 +1,120 @@
+#include "TelemetryChart.h"
+
+#include <QPainter>
+#include <QPainterPath>
+#include <QtMath>
+
+TelemetryChart::TelemetryChart(QWidget *parent) : QWidget(parent)
+{
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    m_formatter = [](double value)
+    {
+        return QString::number(value, 'f', 0);
+    };
+}
+
+QSize TelemetryChart::sizeHint() const
+{
+    return QSize(300, 150);
+}
+
+QSize TelemetryChart::minimumSizeHint() const
+{
+    return QSize(150, 80);
+}
+
+void TelemetryChart::setTitle(const QString &title)
+{
+    m_title = title;
+    update();
+}
+
+void TelemetryChart::setSeries(const QVector<QPointF> &points, const QString &current)
+{
+    m_points = points;
+    m_current = current;
+    update();
+}
+
+void TelemetryChart::setFormatter(std::function<QString(double)> formatter)
+{
+    m_formatter = formatter;
+    update();
+}
+
+void TelemetryChart::paintEvent(QPaintEvent *)
+{
+    QPainter p(this);
+    p.setRenderHint(QPainter::Antialiasing);
+    auto pal = palette();
+    auto textHeight = fontMetrics().height();
+
+    p.setPen(pal.color(QPalette::WindowText));
+    p.drawText(QRect(0, 0, width(), textHeight), Qt::AlignLeft | Qt::AlignVCenter, m_title);
+    p.drawText(QRect(0, 0, width(), textHeight), Qt::AlignRight | Qt::AlignVCenter, m_current);
+
+    QRectF plot(0, textHeight + 2, width() - 1, height() - textHeight - 3);
+    p.fillRect(plot, pal.color(QPalette::Base));
+    p.setPen(pal.color(QPalette::Mid));
+    p.drawRect(plot);
+
+    double minX = 0, maxX = 0, maxY = 0;
+    bool any = false;
+    for(auto & point: m_points)
+    {
+        if(qIsNaN(point.y()))
+        {
+            continue;
+        }
+        minX = any ? qMin(minX, point.x()) : point.x();
+        maxX = any ? qMax(maxX, point.x()) : point.x();
+        maxY = qMax(maxY, point.y());
+        any = true;
+    }
+    if(!any)
+    {
+        p.setPen(pal.color(QPalette::Disabled, QPalette::Text));
+        p.drawText(plot, Qt::AlignCenter, tr("No data"));
+        return;
+    }
+    // leave some room above the highest value
+    maxY = maxY > 0 ? maxY * 1.1 : 1;
+    auto spanX = qMax(maxX - minX, 1.0);
+
+    p.setPen(QPen(pal.color(QPalette::Midlight), 1, Qt::DotLine));
+    for(int i = 1; i < 4; i++)
+    {
+        auto y = plot.top() + plot.height() * i / 4;
+        p.drawLine(QPointF(plot.left(), y), QPointF(plot.right(), y));
+    }
+    p.setPen(pal.color(QPalette::Disabled, QPalette::Text));
+    p.drawText(plot.adjusted(4, 2, -4, -2), Qt::AlignLeft | Qt::AlignTop, m_formatter(maxY));
+
+    auto map = [&](const QPointF &point)
+    {
+        return QPointF(plot.left() + (point.x() - minX) / spanX * plot.width(),
+                       plot.bottom() - point.y() / maxY * plot.height());
+    };
+    QPainterPath path;
+    bool broken = true;
+    for(auto & point: m_points)
+    {
+        if(qIsNaN(point.y()))
+        {
+            broken = true;
+            continue;
+        }
+        if(broken)
+        {
+            path.moveTo(map(point));
+            broken = false;
+        }
+        else
+        {
+            path.lineTo(map(point));
+        }
+    }
+    p.setClipRect(plot);
+    p.setPen(QPen(pal.color(QPalette::Highlight), 1.5));
+    p.drawPath(path);
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <QWidget>
+#include <QVector>
+#include <QPointF>
+#include <functional>
+
+/**
+ * A small line chart of one telemetry value over time.
+ *
+ * x is the time in msecs, y the value. A point with a NaN value breaks the line, so samples of
+ * different processes are not connected.
+ */
+class TelemetryChart : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit TelemetryChart(QWidget *parent = nullptr);
+
+    virtual QSize sizeHint() const override;
+    virtual QSize minimumSizeHint() const override;
+
+    void setTitle(const QString &title);
+    /// the points to show and a text for the newest value
+    void setSeries(const QVector<QPointF> &points, const QString &current);
+    /// how values are printed on the scale
+    void setFormatter(std::function<QString(double)> formatter);
+
+protected:
+    virtual void paintEvent(QPaintEvent *) override;
+
+private:
+    QString m_title;
+    QString m_current;
+    QVector<QPointF> m_points;
+    std::function<QString(double)> m_formatter;
+};
@@ -46,3 +46,20 @@ function(add_unit_test name)
 
     add_test(NAME ${name} COMMAND ${name}_test WORKING_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR})
 endfunction()
+
+# Benchmarks are only built with MultiServerMC_BUILD_BENCHMARKS and never registered with ctest, run <name>_bench by hand.
+function(add_benchmark name)
+    if(NOT MultiServerMC_BUILD_BENCHMARKS)
+        return()
+    endif()
+
+    set(options "")
+    set(oneValueArgs "")
+    set(multiValueArgs SOURCES LIBS)
+
+    cmake_parse_arguments(OPT "${options}" "${oneValueArgs}" "${multiValueArgs}" ${ARGN} )
+
+    add_executable(${name}_bench ${OPT_SOURCES})
+    target_link_libraries(${name}_bench Qt5::Test ${OPT_LIBS})
+    target_include_directories(${name}_bench PRIVATE "${TEST_RESOURCE_PATH}/UnitTest/")
+endfunction()
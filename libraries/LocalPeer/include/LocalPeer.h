@@ -41,10 +41,12 @@
 #pragma once
 #include <QObject>
 #include <QString>
+#include <QMap>
 #include <memory>
 
 
 class QLocalServer;
+class QLocalSocket;
 class LockedFile;
 
 class ApplicationId
@@ -84,17 +86,28 @@ public:
     ~LocalPeer();
     bool isClient();
     bool sendMessage(const QString &message, int timeout);
+    // like sendMessage, then waits up to replyTimeout msecs for the other side to reply()
+    bool sendRequest(const QString &message, int timeout, int replyTimeout, QString &reply);
+    // answer a request, nothing happens if the sender gave up waiting already
+    void reply(int requestId, const QString &reply);
     ApplicationId applicationId() const;
 
 Q_SIGNALS:
     void messageReceived(const QString &message);
+    void requestReceived(int requestId, const QString &message);
 
 protected Q_SLOTS:
     void receiveConnection();
 
+protected:
+    bool connectAndSend(QLocalSocket &socket, char type, const QString &message, int timeout);
+
 protected:
     ApplicationId id;
     QString socketName;
     std::unique_ptr<QLocalServer> server;
     std::unique_ptr<LockedFile> lockFile;
+    // connections of requests that didn't get their reply yet
+    QMap<int, QLocalSocket *> pendingRequests;
+    int nextRequestId = 1;
 };
@@ -42,6 +42,7 @@
 #include "LocalPeer.h"
 #include <QCoreApplication>
 #include <QDataStream>
+#include <QElapsedTimer>
 #include <QTime>
 #include <QLocalServer>
 #include <QLocalSocket>
@@ -64,6 +65,9 @@ static PProcessIdToSessionId pProcessIdToSessionId = 0;
 #include <QCryptographicHash>
 
 static const char* ack = "ack";
+// the first byte of what is sent, both sides are the same version
+static const char messageType = 'm';
+static const char requestType = 'r';
 
 ApplicationId ApplicationId::fromTraditionalApp()
 {
@@ -156,11 +160,68 @@ bool LocalPeer::isClient()
 
 
 bool LocalPeer::sendMessage(const QString &message, int timeout)
+{
+    QLocalSocket socket;
+    return connectAndSend(socket, messageType, message, timeout);
+}
+
+
+bool LocalPeer::sendRequest(const QString &message, int timeout, int replyTimeout, QString &reply)
+{
+    QLocalSocket socket;
+    if (!connectAndSend(socket, requestType, message, timeout))
+    {
+        return false;
+    }
+
+    // the reply is sent like the message, with its size in front
+    QElapsedTimer timer;
+    timer.start();
+    QByteArray data;
+    while (true)
+    {
+        data += socket.readAll();
+        if (data.size() >= (int)sizeof(quint32))
+        {
+            QDataStream ds(data);
+            quint32 size;
+            ds >> size;
+            if (quint32(data.size()) - sizeof(quint32) >= size)
+            {
+                reply = QString::fromUtf8(data.mid(sizeof(quint32), size));
+                return true;
+            }
+        }
+        qint64 left = replyTimeout - timer.elapsed();
+        if (left <= 0 || !socket.waitForReadyRead(int(left)))
+        {
+            return false;
+        }
+    }
+}
+
+
+void LocalPeer::reply(int requestId, const QString &reply)
+{
+    QLocalSocket* socket = pendingRequests.take(requestId);
+    if (!socket)
+    {
+        return;
+    }
+    QByteArray uReply(reply.toUtf8());
+    QDataStream ds(socket);
+    ds.writeBytes(uReply.constData(), uReply.size());
+    socket->waitForBytesWritten(1000);
+    socket->disconnectFromServer();
+    socket->deleteLater();
+}
+
+
+bool LocalPeer::connectAndSend(QLocalSocket &socket, char type, const QString &message, int timeout)
 {
     if (!isClient())
         return false;
 
-    QLocalSocket socket;
     bool connOk = false;
     for(int i = 0; i < 2; i++) {
         // Try twice, in case the other instance is just starting up
@@ -177,7 +238,8 @@ bool LocalPeer::sendMessage(const QString &message, int timeout)
         return false;
     }
 
-    QByteArray uMsg(message.toUtf8());
+    QByteArray uMsg(1, type);
+    uMsg += message.toUtf8();
     QDataStream ds(&socket);
 
     ds.writeBytes(uMsg.constData(), uMsg.size());
@@ -232,9 +294,26 @@ void LocalPeer::receiveConnection()
         delete socket;
         return;
     }
-    QString message(QString::fromUtf8(uMsg));
+    char type = uMsg.isEmpty() ? messageType : uMsg.at(0);
+    QString message(QString::fromUtf8(uMsg.mid(1)));
     socket->write(ack, qstrlen(ack));
     socket->waitForBytesWritten(1000);
+    if (type == requestType)
+    {
+        // kept open for the reply, unless the sender stops waiting for it
+        int requestId = nextRequestId++;
+        pendingRequests.insert(requestId, socket);
+        connect(socket, &QLocalSocket::disconnected, this, [this, requestId]()
+        {
+            QLocalSocket* gone = pendingRequests.take(requestId);
+            if (gone)
+            {
+                gone->deleteLater();
+            }
+        });
+        emit requestReceived(requestId, message);
+        return;
+    }
     socket->waitForDisconnected(1000); // make sure client reads ack
     delete socket;
     emit messageReceived(message); //### (might take a long time to return)